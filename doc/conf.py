@@ -133,6 +133,7 @@ man_pages = [
     ('man1/flux-mini', 'flux-mini', 'Minimal Job Submission Tool', [author], 1),
     ('man1/flux-job', 'flux-job', 'Job Housekeeping Tool', [author], 1),
     ('man1/flux-module', 'flux-module', 'manage Flux extension modules', [author], 1),
+    ('man1/flux-stats', 'flux-stats', 'Collect Flux metrics in Prometheus format', [author], 1),
     ('man1/flux-ping', 'flux-ping', 'measure round-trip latency to Flux services', [author], 1),
     ('man1/flux-proxy', 'flux-proxy', 'create proxy environment for Flux instance', [author], 1),
     ('man1/flux-start', 'flux-start', 'bootstrap a local Flux instance', [author], 1),
@@ -150,6 +151,10 @@ man_pages = [
     ('man3/flux_content_load', 'flux_content_store', 'load/store content', [author], 3),
     ('man3/flux_content_load', 'flux_content_store_get', 'load/store content', [author], 3),
     ('man3/flux_content_load', 'flux_content_load', 'load/store content', [author], 3),
+    ('man3/flux_content_load', 'flux_content_load_batch', 'load/store content', [author], 3),
+    ('man3/flux_content_load', 'flux_content_load_batch_get', 'load/store content', [author], 3),
+    ('man3/flux_content_load', 'flux_content_store_batch', 'load/store content', [author], 3),
+    ('man3/flux_content_load', 'flux_content_store_batch_get', 'load/store content', [author], 3),
     ('man3/flux_core_version', 'flux_core_version_string', 'get flux-core version', [author], 3),
     ('man3/flux_core_version', 'flux_core_version', 'get flux-core version', [author], 3),
     ('man3/flux_event_decode', 'flux_event_decode_raw', 'encode/decode a Flux event message', [author], 3),
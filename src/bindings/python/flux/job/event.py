@@ -10,7 +10,9 @@
 import json
 import errno
 
+import flux.constants
 from flux.future import Future
+from flux.rpc import RPC
 from flux.job._wrapper import _RAW as RAW
 from _flux._core import ffi
 
@@ -169,6 +171,99 @@ def event_watch(flux_handle, jobid, eventlog="eventlog"):
         event = watcher.get_event()
 
 
+class JobEventsWatchFuture(RPC):
+    """
+    A future returned from job.events_watch_async().
+    Adds get_events() method to return a list of (jobid, EventLogEvent)
+    """
+
+    def __del__(self):
+        if self.needs_cancel is not False:
+            self.cancel()
+        try:
+            super().__del__()
+        except AttributeError:
+            pass
+
+    def __init__(self, flux_handle, payload):
+        super().__init__(
+            flux_handle,
+            "job-manager.events-watch",
+            payload,
+            flags=flux.constants.FLUX_RPC_STREAMING,
+        )
+        self.needs_cancel = True
+        self.inactive = []
+
+    def get_events(self, autoreset=True):
+        """
+        Return the next list of (jobid, EventLogEvent) tuples from a
+        JobEventsWatchFuture, or None if the event stream has terminated.
+
+        Only events that appear in the job eventlog are returned.  Any
+        watched jobs that were not active when the watch began are
+        appended to the ``inactive`` attribute.
+
+        The future is auto-reset unless autoreset=False, so a subsequent
+        call to get_events() will try to fetch the next events and thus
+        may block.
+        """
+        try:
+            resp = self.get()
+        except OSError as exc:
+            if exc.errno == errno.ENODATA:
+                self.needs_cancel = False
+                return None
+            # re-raise all other exceptions
+            raise
+        self.inactive.extend(resp.get("inactive", []))
+        events = [
+            (entry["id"], EventLogEvent(entry["entry"]))
+            for entry in resp["events"]
+            if entry["eventlog_seq"] >= 0
+        ]
+        if autoreset is True:
+            self.reset()
+        return events
+
+    def cancel(self):
+        """Cancel a streaming job.events_watch_async() future"""
+        self.flux_handle.rpc(
+            "job-manager.events-watch-cancel",
+            {"matchtag": self.pimpl.get_matchtag()},
+            flags=flux.constants.FLUX_RPC_NORESPONSE,
+        )
+        self.needs_cancel = False
+
+
+def events_watch_async(flux_handle, jobids=None):
+    """Asynchronously watch events of many jobs on one stream
+
+    Watch the main eventlog events of the jobs in ``jobids``, or if
+    ``jobids`` is None, of all jobs submitted through ``flux_handle``
+    that post events after the watch begins.  This uses one request to
+    the job manager rather than one job-info eventlog watch per job.
+
+    Only events posted while a job is active are available.  When
+    ``jobids`` is given, recent events of those jobs are replayed first,
+    and the stream terminates once all of the jobs are inactive.
+
+    Returns a JobEventsWatchFuture. Call .get_events() from the then
+    callback to get the currently returned events from the Future object.
+
+    :param flux_handle: handle for Flux broker from flux.Flux()
+    :type flux_handle: Flux
+    :param jobids: iterable of job IDs to watch
+        (default: all jobs submitted through ``flux_handle``)
+    :returns: a JobEventsWatchFuture object
+    :rtype: JobEventsWatchFuture
+    """
+    payload = {}
+    if jobids is not None:
+        payload["ids"] = [int(jobid) for jobid in jobids]
+    return JobEventsWatchFuture(flux_handle, payload)
+
+
 class JobException(Exception):
     """Represents an 'exception' event occurring to a job.
 
@@ -23,7 +23,12 @@ import os
 
 import flux
 from flux.job.submit import submit_async, submit_get_id
-from flux.job.event import event_watch_async, JobException, MAIN_EVENTS
+from flux.job.event import (
+    event_watch_async,
+    events_watch_async,
+    JobException,
+    MAIN_EVENTS,
+)
 
 
 _SubmitPackage = collections.namedtuple(
@@ -47,6 +52,13 @@ class _FluxExecutorThread(threading.Thread):
 
     Completes FluxExecutorFutures as events indicate that they finish.
 
+    Events of submitted jobs are received on a single job-manager
+    events-watch stream for all of the user's jobs, rather than one
+    eventlog watch per job.  Events of jobs whose submission has not yet
+    returned a jobid are held until the jobid is known.  Attached jobs
+    may have events that predate the executor, so they are still watched
+    individually.
+
     :param exit_event: ``threading.Event`` indicating when the associated
         Executor has shut down.
     :param packages_to_handle: a queue filled with Packages by the Executor
@@ -71,6 +83,10 @@ class _FluxExecutorThread(threading.Thread):
         self.__poll_interval = poll_interval
         self.__flux_handle = flux.Flux(*handle_args, **handle_kwargs)
         self.__running_user_futures = set()  # unfulfilled futures
+        self.__events_watch = None  # stream of events for submitted jobs
+        self.__watched_futures = {}  # jobid -> future, for submitted jobs
+        self.__pending_submits = 0  # submissions without a jobid
+        self.__unclaimed_events = collections.defaultdict(list)
 
     def run(self):
         try:
@@ -98,6 +114,8 @@ class _FluxExecutorThread(threading.Thread):
             self.__submit_new_jobs(reactor_run=False)
             if self.__flux_handle.reactor_run() < 0:
                 raise RuntimeError("reactor start failed")
+        if self.__events_watch is not None:
+            self.__events_watch.cancel()
 
     def __work_remains(self):
         """Return True if and only if there is still work to be done.
@@ -134,6 +152,10 @@ class _FluxExecutorThread(threading.Thread):
     def __handle_submit(self, package):
         """Submit a _SubmitPackage and set a jobid callback."""
         try:
+            # watch before submitting, so no events of the job are missed
+            if self.__events_watch is None:
+                self.__events_watch = events_watch_async(self.__flux_handle)
+                self.__events_watch.then(self.__events_watch_update)
             submit_async(
                 self.__flux_handle, *package.submit_args, **package.submit_kwargs
             ).then(self.__submission_callback, package.future)
@@ -141,6 +163,7 @@ class _FluxExecutorThread(threading.Thread):
             package.future.set_exception(submit_exc)
         else:
             self.__running_user_futures.add(package.future)
+            self.__pending_submits += 1
 
     def __handle_attach(self, package):
         """Submit an _AttachPackage and set an event callback."""
@@ -155,11 +178,50 @@ class _FluxExecutorThread(threading.Thread):
 
     def __submission_callback(self, submission_future, user_future):
         """Callback invoked when a jobid is ready for a submitted jobspec."""
+        self.__pending_submits -= 1
+        unclaimed = self.__unclaimed_events
+        if self.__pending_submits == 0:
+            self.__unclaimed_events = collections.defaultdict(list)
         jobid = submit_get_id(submission_future)
         user_future._set_jobid(jobid)  # pylint: disable=protected-access
-        event_watch_async(self.__flux_handle, jobid).then(
-            self.__event_update, user_future
-        )
+        if self.__events_watch is None:  # stream terminated, watch job alone
+            event_watch_async(self.__flux_handle, jobid).then(
+                self.__event_update, user_future
+            )
+            return
+        self.__watched_futures[jobid] = user_future
+        for event in unclaimed.pop(jobid, []):
+            self.__watched_event(jobid, event)
+
+    def __events_watch_update(self, watch_future):
+        """Callback invoked when submitted jobs have event updates."""
+        try:
+            events = watch_future.get_events()
+        except OSError as exc:
+            events = None
+            for user_future in self.__watched_futures.values():
+                if not user_future.done():
+                    user_future.set_exception(exc)
+        if events is None:  # no more events
+            for user_future in self.__watched_futures.values():
+                self.__running_user_futures.discard(user_future)
+            self.__watched_futures.clear()
+            self.__events_watch = None
+            return
+        for jobid, event in events:
+            if jobid in self.__watched_futures:
+                self.__watched_event(jobid, event)
+            elif self.__pending_submits > 0:
+                # may belong to a submission whose jobid is not yet known
+                self.__unclaimed_events[jobid].append(event)
+
+    def __watched_event(self, jobid, event):
+        """Handle an event of a job watched on the events-watch stream."""
+        user_future = self.__watched_futures[jobid]
+        self.__process_event(event, user_future)
+        if event.name == "clean":  # last event of a job
+            del self.__watched_futures[jobid]
+            self.__running_user_futures.discard(user_future)
 
     def __event_update(self, event_future, user_future):
         """Callback invoked when a job has an event update."""
@@ -169,23 +231,28 @@ class _FluxExecutorThread(threading.Thread):
         except FileNotFoundError:  # job ID was not accepted
             user_future.set_exception(ValueError("job ID does not match any job"))
         if event is not None:
-            if event.name in user_future.EVENTS:
-                user_future._set_event(event)  # pylint: disable=protected-access
-            # check if the event tells us that the job is done
-            if not user_future.done():
-                if event.name == "finish":
-                    exit_status = event.context["status"]
-                    if os.WIFEXITED(exit_status):
-                        user_future.set_result(os.WEXITSTATUS(exit_status))
-                    elif os.WIFSIGNALED(exit_status):
-                        user_future.set_result(-os.WTERMSIG(exit_status))
-                    else:
-                        user_future.set_exception(ValueError(exit_status))
-                elif event.name == "exception" and event.context["severity"] == 0:
-                    user_future.set_exception(JobException(event))
+            self.__process_event(event, user_future)
         else:  # no more events
             self.__running_user_futures.discard(user_future)
 
+    @staticmethod
+    def __process_event(event, user_future):
+        """Update a future with a job event, completing it if the job is done."""
+        if event.name in user_future.EVENTS:
+            user_future._set_event(event)  # pylint: disable=protected-access
+        # check if the event tells us that the job is done
+        if not user_future.done():
+            if event.name == "finish":
+                exit_status = event.context["status"]
+                if os.WIFEXITED(exit_status):
+                    user_future.set_result(os.WEXITSTATUS(exit_status))
+                elif os.WIFSIGNALED(exit_status):
+                    user_future.set_result(-os.WTERMSIG(exit_status))
+                else:
+                    user_future.set_exception(ValueError(exit_status))
+            elif event.name == "exception" and event.context["severity"] == 0:
+                user_future.set_exception(JobException(event))
+
 
 # pylint: disable=too-many-instance-attributes
 class FluxExecutorFuture(concurrent.futures.Future):
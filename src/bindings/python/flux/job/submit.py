@@ -96,6 +96,91 @@ def submit_get_id(future):
     return int(jobid[0])
 
 
+class SubmitBulkFuture(Future):
+    """Future returned by :func:`submit_bulk_async`"""
+
+    def __init__(self, future_handle, count):
+        super().__init__(future_handle)
+        self.count = count
+
+    @check_future_error
+    def get_id(self, index):
+        """Get job ID of job ``index`` of the bulk submission
+
+        Raises OSError if that job was not accepted.
+        """
+        self.wait_for()
+        jobid = ffi.new("flux_jobid_t[1]")
+        errmsg = ffi.new("char *[1]")
+        try:
+            RAW.submit_bulk_get_id(self, index, jobid, errmsg)
+        except OSError as exc:
+            if errmsg[0] != ffi.NULL:
+                raise OSError(
+                    exc.errno, ffi.string(errmsg[0]).decode("utf-8")
+                ) from None
+            raise
+        return int(jobid[0])
+
+    def get_ids(self):
+        """Get list of job IDs in submission order
+
+        Raises OSError for the first job that was not accepted.
+        """
+        return [self.get_id(i) for i in range(self.count)]
+
+
+def submit_bulk_async(
+    flux_handle,
+    jobspecs,
+    urgency=lib.FLUX_JOB_URGENCY_DEFAULT,
+    waitable=False,
+    debug=False,
+    pre_signed=False,
+    novalidate=False,
+    shared_signature=False,
+):
+    """Ask Flux to run many jobs with one request, without waiting
+
+    Submit a list of jobs to Flux.  This method returns immediately with
+    a Flux Future, which can be used to obtain the job IDs later.
+    Arguments are as for :func:`submit_async` and apply to all jobs.
+
+    :param jobspecs: jobspecs defining the job requests
+    :type jobspecs: list of Jobspec or their string encoding
+    :param shared_signature: sign all jobs with one signature
+        (default is False).  shared_signature=True is restricted to the
+        instance owner.
+    :type shared_signature: bool
+    :returns: a Flux Future object for obtaining the assigned jobids
+    :rtype: SubmitBulkFuture
+    """
+    jobspecs = [_convert_jobspec_arg_to_string(x) for x in jobspecs]
+    jobspecs = [
+        ffi.new("char[]", x.encode("utf-8") if isinstance(x, str) else x)
+        for x in jobspecs
+    ]
+    flags = 0
+    if waitable:
+        flags |= constants.FLUX_JOB_WAITABLE
+    if debug:
+        flags |= constants.FLUX_JOB_DEBUG
+    if pre_signed:
+        flags |= constants.FLUX_JOB_PRE_SIGNED
+    if novalidate:
+        flags |= constants.FLUX_JOB_NOVALIDATE
+    if shared_signature:
+        flags |= constants.FLUX_JOB_SHARED_SIGNATURE
+    future_handle = RAW.submit_bulk(
+        flux_handle,
+        len(jobspecs),
+        ffi.new("const char *[]", jobspecs),
+        urgency,
+        flags,
+    )
+    return SubmitBulkFuture(future_handle, len(jobspecs))
+
+
 def submit(
     flux_handle,
     jobspec,
@@ -21,6 +21,7 @@
 #include "src/common/libutil/cleanup.h"
 #include "src/common/libutil/ipaddr.h"
 #include "src/common/libutil/kary.h"
+#include "src/common/libutil/monotime.h"
 #include "src/common/libpmi/pmi.h"
 #include "src/common/libpmi/pmi_strerror.h"
 #include "src/common/libpmi/clique.h"
@@ -30,6 +31,15 @@
 #include "boot_pmi.h"
 #include "pmiutil.h"
 
+/* Values are kept well under the PMI-1 minimum value length
+ * so that the hostlist may be split across keys if necessary.
+ */
+#define HOSTLIST_CHUNK_SIZE 512
+
+enum exchange_method {
+    EXCHANGE_RANK0,     // rank 0 gathers hostlist and publishes it
+    EXCHANGE_ALLGATHER, // all ranks fetch every business card
+};
 
 /*  If the broker is launched via flux-shell, then the shell may opt
  *  to set a "flux.instance-level" parameter in the PMI kvs to tell
@@ -153,6 +163,180 @@ overflow:
     return -1;
 }
 
+/* Set broker.boot-exchange to select how the hostlist is assembled.
+ */
+static int get_exchange_method (attr_t *attrs, enum exchange_method *method)
+{
+    const char *val;
+
+    if (attr_get (attrs, "broker.boot-exchange", &val, NULL) < 0 || !val)
+        *method = EXCHANGE_RANK0;
+    else if (!strcmp (val, "rank0"))
+        *method = EXCHANGE_RANK0;
+    else if (!strcmp (val, "allgather"))
+        *method = EXCHANGE_ALLGATHER;
+    else {
+        log_msg ("unknown broker.boot-exchange method: %s", val);
+        return -1;
+    }
+    return 0;
+}
+
+static int set_time_attr (attr_t *attrs, const char *name, struct timespec t0)
+{
+    char buf[32];
+
+    snprintf (buf, sizeof (buf), "%.3f", monotime_since (t0) / 1000.);
+    if (attr_add (attrs, name, buf, FLUX_ATTRFLAG_IMMUTABLE) < 0) {
+        log_err ("setattr %s", name);
+        return -1;
+    }
+    return 0;
+}
+
+/* Fetch the business card of all ranks and append hostnames to 'hl'.
+ */
+static int gather_hostlist (struct pmi_handle *pmi,
+                            struct pmi_params *pmi_params,
+                            struct hostlist *hl)
+{
+    char key[64];
+    char val[1024];
+    json_t *o;
+    int result;
+    int i;
+
+    for (i = 0; i < pmi_params->size; i++) {
+        const char *peer_hostname;
+
+        if (snprintf (key, sizeof (key), "%d", i) >= sizeof (key)) {
+            log_msg ("pmi key string overflow");
+            return -1;
+        }
+        result = broker_pmi_kvs_get (pmi, pmi_params->kvsname,
+                                     key, val, sizeof (val), i);
+
+        if (result != PMI_SUCCESS) {
+            log_msg ("broker_pmi_kvs_get %s: %s", key, pmi_strerror (result));
+            return -1;
+        }
+        if (!(o = json_loads (val, 0, NULL))
+            || json_unpack (o, "{s:s}", "hostname", &peer_hostname) < 0) {
+            log_msg ("error decoding rank %d pmi business card", i);
+            json_decref (o);
+            return -1;
+        }
+        if (hostlist_append (hl, peer_hostname) < 0) {
+            log_err ("hostlist_append");
+            json_decref (o);
+            return -1;
+        }
+        json_decref (o);
+    }
+    return 0;
+}
+
+/* Publish the compressed hostlist under "flux.hostlist.<n>" keys,
+ * with the number of keys in "flux.hostlist".
+ */
+static int put_hostlist (struct pmi_handle *pmi,
+                         struct pmi_params *pmi_params,
+                         struct hostlist *hl)
+{
+    char key[64];
+    char val[HOSTLIST_CHUNK_SIZE + 1];
+    char *s;
+    size_t len;
+    int count;
+    int result;
+    int i;
+
+    if (!(s = hostlist_encode (hl))) {
+        log_err ("hostlist_encode");
+        return -1;
+    }
+    len = strlen (s);
+    count = (len + HOSTLIST_CHUNK_SIZE - 1) / HOSTLIST_CHUNK_SIZE;
+    if (count == 0)
+        count = 1;
+    for (i = 0; i < count; i++) {
+        snprintf (key, sizeof (key), "flux.hostlist.%d", i);
+        snprintf (val, sizeof (val), "%s", s + i * HOSTLIST_CHUNK_SIZE);
+        result = broker_pmi_kvs_put (pmi, pmi_params->kvsname, key, val);
+        if (result != PMI_SUCCESS)
+            goto error;
+    }
+    snprintf (val, sizeof (val), "%d", count);
+    result = broker_pmi_kvs_put (pmi, pmi_params->kvsname, "flux.hostlist", val);
+    if (result != PMI_SUCCESS)
+        goto error;
+    result = broker_pmi_kvs_commit (pmi, pmi_params->kvsname);
+    if (result != PMI_SUCCESS) {
+        log_msg ("broker_pmi_kvs_commit: %s", pmi_strerror (result));
+        free (s);
+        return -1;
+    }
+    free (s);
+    return 0;
+error:
+    log_msg ("broker_pmi_kvs_put %s: %s", key, pmi_strerror (result));
+    free (s);
+    return -1;
+}
+
+/* Fetch the hostlist published by rank 0.
+ */
+static struct hostlist *get_hostlist (struct pmi_handle *pmi,
+                                      struct pmi_params *pmi_params)
+{
+    char key[64];
+    char val[1024];
+    char *s = NULL;
+    size_t len = 0;
+    struct hostlist *hl;
+    int count;
+    int result;
+    int i;
+
+    result = broker_pmi_kvs_get (pmi, pmi_params->kvsname,
+                                 "flux.hostlist", val, sizeof (val), 0);
+    if (result != PMI_SUCCESS) {
+        log_msg ("broker_pmi_kvs_get flux.hostlist: %s",
+                 pmi_strerror (result));
+        return NULL;
+    }
+    if ((count = strtol (val, NULL, 10)) < 1) {
+        log_msg ("error decoding flux.hostlist key count");
+        return NULL;
+    }
+    for (i = 0; i < count; i++) {
+        size_t n;
+        char *new;
+
+        snprintf (key, sizeof (key), "flux.hostlist.%d", i);
+        result = broker_pmi_kvs_get (pmi, pmi_params->kvsname,
+                                     key, val, sizeof (val), 0);
+        if (result != PMI_SUCCESS) {
+            log_msg ("broker_pmi_kvs_get %s: %s", key, pmi_strerror (result));
+            free (s);
+            return NULL;
+        }
+        n = strlen (val);
+        if (!(new = realloc (s, len + n + 1))) {
+            log_err ("out of memory");
+            free (s);
+            return NULL;
+        }
+        s = new;
+        memcpy (s + len, val, n + 1);
+        len += n;
+    }
+    if (!(hl = hostlist_decode (s)))
+        log_err ("error decoding hostlist published by rank 0");
+    free (s);
+    return hl;
+}
+
 int boot_pmi (struct overlay *overlay, attr_t *attrs)
 {
     int fanout = overlay_get_fanout (overlay);
@@ -160,6 +344,7 @@ int boot_pmi (struct overlay *overlay, attr_t *attrs)
     char key[64];
     char val[1024];
     char hostname[MAXHOSTNAMELEN + 1];
+    const char *fakehost;
     char *bizcard = NULL;
     struct hostlist *hl = NULL;
     json_t *o;
@@ -168,8 +353,14 @@ int boot_pmi (struct overlay *overlay, attr_t *attrs)
     struct pmi_params pmi_params;
     int result;
     const char *uri;
+    enum exchange_method method;
+    struct timespec t_start;
+    struct timespec t_exchange;
     int i;
 
+    monotime (&t_start);
+    if (get_exchange_method (attrs, &method) < 0)
+        return -1;
     memset (&pmi_params, 0, sizeof (pmi_params));
     if (!(pmi = broker_pmi_create ())) {
         log_err ("broker_pmi_create");
@@ -201,11 +392,17 @@ int boot_pmi (struct overlay *overlay, attr_t *attrs)
         log_err ("gethostname");
         goto error;
     }
+    if ((fakehost = getenv ("FLUX_FAKE_HOSTNAME"))) // for testing
+        snprintf (hostname, sizeof (hostname), "%s", fakehost);
     if (!(hl = hostlist_create ())) {
         log_err ("hostlist_create");
         goto error;
     }
 
+    if (set_time_attr (attrs, "broker.boot-pmi-init", t_start) < 0)
+        goto error;
+    monotime (&t_exchange);
+
     /* A size=1 instance has no peers, so skip the PMI exchange.
      */
     if (pmi_params.size == 1) {
@@ -352,35 +549,18 @@ int boot_pmi (struct overlay *overlay, attr_t *attrs)
         json_decref (o);
     }
 
-    /* Fetch the business card of all ranks and build hostlist.
-     * The hostlist is built indepenedently (and in parallel) on all ranks.
+    /* Build the hostlist.  By default, rank 0 fetches every business card
+     * and publishes the compressed hostlist before the final barrier, so
+     * other ranks make O(1) gets instead of O(size).  With allgather,
+     * every rank fetches every business card, as before.
      */
-    for (i = 0; i < pmi_params.size; i++) {
-        const char *peer_hostname;
-
-        if (snprintf (key, sizeof (key), "%d", i) >= sizeof (key)) {
-            log_msg ("pmi key string overflow");
-            goto error;
-        }
-        result = broker_pmi_kvs_get (pmi, pmi_params.kvsname,
-                                     key, val, sizeof (val), i);
-
-        if (result != PMI_SUCCESS) {
-            log_msg ("broker_pmi_kvs_get %s: %s", key, pmi_strerror (result));
-            goto error;
-        }
-        if (!(o = json_loads (val, 0, NULL))
-            || json_unpack (o, "{s:s}", "hostname", &peer_hostname) < 0) {
-            log_msg ("error decoding rank %d pmi business card", i);
-            json_decref (o);
+    if (method == EXCHANGE_ALLGATHER || pmi_params.rank == 0) {
+        if (gather_hostlist (pmi, &pmi_params, hl) < 0)
             goto error;
-        }
-        if (hostlist_append (hl, peer_hostname) < 0) {
-            log_err ("hostlist_append");
-            json_decref (o);
+    }
+    if (method == EXCHANGE_RANK0 && pmi_params.rank == 0) {
+        if (put_hostlist (pmi, &pmi_params, hl) < 0)
             goto error;
-        }
-        json_decref (o);
     }
 
     /* One more barrier before allowing connects to commence.
@@ -392,6 +572,16 @@ int boot_pmi (struct overlay *overlay, attr_t *attrs)
         goto error;
     }
 
+    if (method == EXCHANGE_RANK0 && pmi_params.rank > 0) {
+        hostlist_destroy (hl);
+        if (!(hl = get_hostlist (pmi, &pmi_params)))
+            goto error;
+        if (hostlist_count (hl) != pmi_params.size) {
+            log_msg ("hostlist published by rank 0 has wrong size");
+            goto error;
+        }
+    }
+
 done:
     result = broker_pmi_finalize (pmi);
     if (result != PMI_SUCCESS) {
@@ -406,6 +596,9 @@ done:
         goto error;
     }
     free (s);
+    if (set_time_attr (attrs, "broker.boot-pmi-exchange", t_exchange) < 0
+        || set_time_attr (attrs, "broker.boot-time", t_start) < 0)
+        goto error;
     free (bizcard);
     broker_pmi_destroy (pmi);
     hostlist_destroy (hl);
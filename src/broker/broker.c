@@ -97,6 +97,8 @@ static int create_runat_phases (broker_ctx_t *ctx);
 
 static int handle_event (broker_ctx_t *ctx, const flux_msg_t *msg);
 
+static int stats_init (broker_ctx_t *ctx);
+
 static void init_attrs (attr_t *attrs, pid_t pid, struct flux_msg_cred *cred);
 
 static int init_local_uri_attr (struct overlay *ov, attr_t *attrs);
@@ -365,6 +367,11 @@ int main (int argc, char *argv[])
         goto cleanup;
     }
 
+    if (stats_init (&ctx) < 0) {
+        log_err ("error setting up stats");
+        goto cleanup;
+    }
+
     if (ctx.verbose) {
         const char *parent = overlay_get_parent_uri (ctx.overlay);
         const char *child = overlay_get_bind_uri (ctx.overlay);
@@ -490,6 +497,7 @@ cleanup:
     /* Unregister builtin services
      */
     attr_destroy (ctx.attrs);
+    flux_future_destroy (ctx.f_stats);
     content_cache_destroy (ctx.cache);
 
     modhash_destroy (ctx.modhash);
@@ -1474,6 +1482,8 @@ static void overlay_recv_cb (const flux_msg_t *msg,
     /* Suppress logging if a response could not be sent due to ENOSYS,
      * which happens if sending module unloads before finishing all RPCs.
      */
+    if (dropped)
+        ctx->msgstats.dropped++;
     if (dropped && (type != FLUX_MSGTYPE_RESPONSE || errno != ENOSYS)) {
         const char *topic = "unknown";
         (void)flux_msg_get_topic (msg, &topic);
@@ -1510,6 +1520,7 @@ static int handle_event (broker_ctx_t *ctx, const flux_msg_t *msg)
             flux_log (ctx->h, LOG_ERR, "lost event %d", first);
     }
     ctx->event_recv_seq = seq;
+    ctx->msgstats.event++;
 
     /* Forward to this rank's children.
      */
@@ -1555,7 +1566,8 @@ static void module_cb (module_t *p, void *arg)
         goto done;
     switch (type) {
         case FLUX_MSGTYPE_RESPONSE:
-            (void)broker_response_sendmsg (ctx, msg);
+            if (broker_response_sendmsg (ctx, msg) < 0)
+                ctx->msgstats.dropped++;
             break;
         case FLUX_MSGTYPE_REQUEST:
             count = flux_msg_route_count (msg);
@@ -1757,6 +1769,7 @@ static int broker_request_sendmsg_internal (broker_ctx_t *ctx,
  */
 static void broker_request_sendmsg (broker_ctx_t *ctx, const flux_msg_t *msg)
 {
+    ctx->msgstats.request++;
     if (broker_request_sendmsg_internal (ctx, msg) < 0) {
         const char *topic;
         char errbuf[64];
@@ -1768,6 +1781,7 @@ static void broker_request_sendmsg (broker_ctx_t *ctx, const flux_msg_t *msg)
                       "No service matching %s is registered", topic);
             errstr = errbuf;
         }
+        ctx->msgstats.request_error++;
         if (flux_respond_error (ctx->h, msg, errno, errstr) < 0)
             flux_log_error (ctx->h, "flux_respond");
     }
@@ -1783,6 +1797,7 @@ static int broker_response_sendmsg (broker_ctx_t *ctx, const flux_msg_t *msg)
     int rc;
     const char *uuid;
 
+    ctx->msgstats.response++;
     if (!(uuid = flux_msg_route_last (msg)))
         rc = flux_requeue (ctx->h, msg, FLUX_RQ_TAIL);
     else if (overlay_uuid_is_parent (ctx->overlay, uuid))
@@ -1794,6 +1809,33 @@ static int broker_response_sendmsg (broker_ctx_t *ctx, const flux_msg_t *msg)
     return rc;
 }
 
+static void stats_sync_cb (flux_future_t *f, void *arg)
+{
+    broker_ctx_t *ctx = arg;
+    struct broker_msgstats *ms = &ctx->msgstats;
+
+    flux_stats_count (ctx->h, "broker.msg.request", ms->request);
+    flux_stats_count (ctx->h, "broker.msg.request-error", ms->request_error);
+    flux_stats_count (ctx->h, "broker.msg.response", ms->response);
+    flux_stats_count (ctx->h, "broker.msg.event", ms->event);
+    flux_stats_count (ctx->h, "broker.msg.dropped", ms->dropped);
+
+    flux_future_reset (f);
+}
+
+/* If a stats endpoint is configured, send message routing counts
+ * on each heartbeat.  Counting is cheap enough to do unconditionally.
+ */
+static int stats_init (broker_ctx_t *ctx)
+{
+    if (!flux_stats_enabled (ctx->h, NULL))
+        return 0;
+    if (!(ctx->f_stats = flux_sync_create (ctx->h, 0))
+        || flux_future_then (ctx->f_stats, 5., stats_sync_cb, ctx) < 0)
+        return -1;
+    return 0;
+}
+
 /* Events are forwarded up the TBON to rank 0, then published per RFC 3.
  * An alternate publishing mechanism that allows the event sequence number
  * to be obtained is to send an RPC to event.pub.
@@ -15,6 +15,17 @@
 
 #include "src/common/libczmqcontainers/czmq_containers.h"
 
+/* Counts of messages routed by this broker, sent to the stats
+ * endpoint (if any) on each heartbeat.
+ */
+struct broker_msgstats {
+    ssize_t request;
+    ssize_t request_error;
+    ssize_t response;
+    ssize_t event;
+    ssize_t dropped;
+};
+
 struct broker {
     flux_t *h;
     flux_reactor_t *reactor;
@@ -49,6 +60,9 @@ struct broker {
     size_t init_shell_cmd_len;
 
     int exit_rc;
+
+    struct broker_msgstats msgstats;
+    flux_future_t *f_stats;
 };
 
 typedef struct broker broker_ctx_t;
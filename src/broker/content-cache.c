@@ -21,6 +21,7 @@
 #include "src/common/libccan/ccan/list/list.h"
 #include "src/common/libutil/errno_safe.h"
 #include "src/common/libutil/blobref.h"
+#include "src/common/libutil/blobvec.h"
 #include "src/common/libutil/iterators.h"
 #include "src/common/libutil/log.h"
 
@@ -38,6 +39,16 @@ static const char *default_hash = "sha1";
 static const uint32_t default_cache_purge_target_size = 1024*1024*16;
 static const uint32_t default_cache_purge_old_entry = 10; // seconds
 
+/* Clean entries are kept on a segmented LRU (SLRU).  Entries enter the
+ * probation segment and are promoted to the protected segment when they
+ * are looked up again.  The protected segment is limited to a fraction of
+ * the cache size target, with overflow demoted back to probation.  Entries
+ * are evicted from probation first, so a one-time scan of many blobs
+ * (e.g. a recursive KVS directory walk) cannot flush frequently used
+ * entries such as the KVS root and its directories.
+ */
+static const double protected_ratio = 0.8;
+
 /* Raise the max blob size value to 1GB so that large KVS values
  * (including KVS directories) can be supported while the KVS transitions
  * to the RFC 11 treeobj data representation.
@@ -61,6 +72,8 @@ struct cache_entry {
                                     /*   or to backing store (rank 0) */
     uint8_t load_pending:1;
     uint8_t store_pending:1;
+    uint8_t probation:1;            /* entry is on the probation segment */
+    uint8_t protected:1;            /* entry is on the protected segment */
     struct msgstack *load_requests;
     struct msgstack *store_requests;
     double lastused;
@@ -68,6 +81,14 @@ struct cache_entry {
     struct list_node list;
 };
 
+struct lru_segment {
+    struct list_head list;          /* most recently used at head */
+    uint32_t count;
+    uint32_t size;
+    uint32_t hits;
+    uint32_t evictions;
+};
+
 struct content_cache {
     flux_t *h;
     flux_reactor_t *reactor;
@@ -80,7 +101,8 @@ struct content_cache {
     const char *hash_name;
     struct msgstack *flush_requests;
 
-    struct list_head lru;           /* LRU is for valid, clean entries only */
+    struct lru_segment probation;   /* LRU is for valid, clean entries only */
+    struct lru_segment protected;
     struct list_head flush;         /* dirties queued due to batch limit */
 
     uint32_t blob_size_limit;
@@ -89,10 +111,12 @@ struct content_cache {
 
     uint32_t purge_target_size;
     uint32_t purge_old_entry;
+    uint32_t size_limit;            /* hard limit on acct_size (0=none) */
 
     uint32_t acct_size;             /* total size of all cache entries */
     uint32_t acct_valid;            /* count of valid cache entries */
     uint32_t acct_dirty;            /* count of dirty cache entries */
+    uint32_t acct_misses;           /* count of loads not found in cache */
 };
 
 static void flush_respond (struct content_cache *cache);
@@ -209,6 +233,83 @@ static struct cache_entry *cache_entry_create (const char *blobref)
     return e;
 }
 
+/* Segmented LRU.
+ * lru_add() places a valid, clean entry on the probation segment.
+ * lru_touch() moves an entry to the front of the protected segment,
+ * demoting the least recently used protected entries to probation if
+ * the protected segment is over its size budget.
+ * lru_del() removes an entry from whichever segment it is on, if any.
+ */
+static uint32_t lru_protected_limit (struct content_cache *cache)
+{
+    uint32_t target = cache->purge_target_size;
+
+    if (cache->size_limit > 0 && cache->size_limit < target)
+        target = cache->size_limit;
+    return target * protected_ratio;
+}
+
+static void lru_segment_add (struct lru_segment *seg, struct cache_entry *e)
+{
+    list_add (&seg->list, &e->list);
+    seg->count++;
+    seg->size += e->len;
+}
+
+static void lru_segment_del (struct lru_segment *seg, struct cache_entry *e)
+{
+    list_del_from (&seg->list, &e->list);
+    seg->count--;
+    seg->size -= e->len;
+}
+
+static void lru_del (struct content_cache *cache, struct cache_entry *e)
+{
+    if (e->probation) {
+        lru_segment_del (&cache->probation, e);
+        e->probation = 0;
+    }
+    else if (e->protected) {
+        lru_segment_del (&cache->protected, e);
+        e->protected = 0;
+    }
+}
+
+static void lru_add (struct content_cache *cache, struct cache_entry *e)
+{
+    assert (e->valid);
+    assert (!e->dirty);
+    assert (!e->probation && !e->protected);
+    lru_segment_add (&cache->probation, e);
+    e->probation = 1;
+    e->lastused = flux_reactor_now (cache->reactor);
+}
+
+static void lru_touch (struct content_cache *cache, struct cache_entry *e)
+{
+    uint32_t limit = lru_protected_limit (cache);
+    struct cache_entry *victim;
+
+    if (e->probation)
+        cache->probation.hits++;
+    else if (e->protected)
+        cache->protected.hits++;
+    else
+        return;
+    lru_del (cache, e);
+    lru_segment_add (&cache->protected, e);
+    e->protected = 1;
+    e->lastused = flux_reactor_now (cache->reactor);
+
+    while (cache->protected.size > limit && cache->protected.count > 1) {
+        victim = list_tail (&cache->protected.list, struct cache_entry, list);
+        lru_segment_del (&cache->protected, victim);
+        victim->protected = 0;
+        lru_segment_add (&cache->probation, victim);
+        victim->probation = 1;
+    }
+}
+
 /* Make an invalid cache entry valid, filling in its data.
  * Set dirty flag if 'dirty' is true.
  * Perform accounting.
@@ -239,10 +340,8 @@ static int cache_entry_fill (struct content_cache *cache,
             e->dirty = 1;
             cache->acct_dirty++;
         }
-        else {
-            list_add (&cache->lru, &e->list);
-            e->lastused = flux_reactor_now (cache->reactor);
-        }
+        else
+            lru_add (cache, e);
         request_list_respond_raw (&e->load_requests,
                                   cache->h,
                                   e->data,
@@ -259,9 +358,7 @@ static void cache_entry_dirty_clear (struct content_cache *cache,
         cache->acct_dirty--;
         e->dirty = 0;
 
-        assert (e->valid);
-        list_add (&cache->lru, &e->list);
-        e->lastused = flux_reactor_now (cache->reactor);
+        lru_add (cache, e);
 
         request_list_respond_raw (&e->store_requests,
                                   cache->h,
@@ -290,7 +387,7 @@ static struct cache_entry *cache_entry_insert (struct content_cache *cache,
 }
 
 /* Look up a cache entry, by blobref.
- * Move to front of LRU because it was looked up.
+ * Promote to front of protected LRU segment because it was looked up.
  * Returns entry on success, NULL on failure.
  * N.B. errno is not set
  */
@@ -301,11 +398,8 @@ static struct cache_entry *cache_entry_lookup (struct content_cache *cache,
     if (!(e = zhashx_lookup (cache->entries, blobref)))
         return NULL;
 
-    if (e->valid && !e->dirty) {
-        list_del_from (&cache->lru, &e->list);
-        list_add (&cache->lru, &e->list);
-        e->lastused = flux_reactor_now (cache->reactor);
-    }
+    if (e->valid && !e->dirty)
+        lru_touch (cache, e);
 
     return e;
 }
@@ -317,7 +411,10 @@ static void cache_entry_remove (struct content_cache *cache,
 {
     assert (e->load_requests == NULL);
     assert (e->store_requests == NULL);
-    list_del (&e->list);
+    if (e->probation || e->protected)
+        lru_del (cache, e);
+    else
+        list_del (&e->list);
     if (e->valid) {
         cache->acct_size -= e->len;
         cache->acct_valid--;
@@ -327,6 +424,28 @@ static void cache_entry_remove (struct content_cache *cache,
     zhashx_delete (cache->entries, e->blobref);
 }
 
+/* Evict the least recently used clean entries, probation segment first,
+ * until the cache is within its hard size limit.  Dirty entries cannot
+ * be evicted, so the limit may be exceeded temporarily until they are
+ * written upstream or to the backing store.
+ */
+static void cache_shrink (struct content_cache *cache)
+{
+    struct lru_segment *seg[] = { &cache->probation, &cache->protected };
+    struct cache_entry *e;
+    int i;
+
+    if (cache->size_limit == 0)
+        return;
+    for (i = 0; i < 2 && cache->acct_size > cache->size_limit; i++) {
+        while (cache->acct_size > cache->size_limit
+               && (e = list_tail (&seg[i]->list, struct cache_entry, list))) {
+            seg[i]->evictions++;
+            cache_entry_remove (cache, e);
+        }
+    }
+}
+
 /* Load operation
  *
  * If a cache entry is already present and valid, response is immediate.
@@ -358,6 +477,7 @@ static void cache_load_continuation (flux_future_t *f, void *arg)
         goto error;
     }
     flux_future_destroy (f);
+    cache_shrink (cache); // N.B. 'e' may be evicted
     return;
 error:
     request_list_respond_error (&e->load_requests,
@@ -417,6 +537,7 @@ void content_load_request (flux_t *h, flux_msg_handler_t *mh,
         }
     }
     if (!e->valid) {
+        cache->acct_misses++;
         if (cache_load (cache, e) < 0)
             goto error;
         if (msgstack_push (&e->load_requests, msg) < 0) {
@@ -490,6 +611,7 @@ static void cache_store_continuation (flux_future_t *f, void *arg)
     }
     cache_entry_dirty_clear (cache, e);
     flux_future_destroy (f);
+    cache_shrink (cache);
     cache_resume_flush (cache);
     return;
 error:
@@ -556,6 +678,7 @@ static void content_store_request (flux_t *h, flux_msg_handler_t *mh,
     if (cache_entry_fill (cache, e, data, len, true) < 0)
         goto error;
     if (e->dirty) {
+        cache_shrink (cache); // make room by evicting clean entries
         if (cache->rank > 0 || cache->backing) {
             if (cache_store (cache, e) < 0)
                 goto error;
@@ -574,6 +697,488 @@ error:
         flux_log_error (h, "content store: flux_respond_error");
 }
 
+/* Batch load and store operations
+ *
+ * The content.load-batch and content.store-batch requests carry a vector
+ * of blobrefs or blobs in a single message (see blobvec.h), and the
+ * response carries a vector of results in the same order, each with its
+ * own errno.  They follow the same semantics as their single-blob
+ * counterparts above, except that all the blobs that cannot be satisfied
+ * locally are requested from the next level of the TBON (or on rank 0,
+ * the content.backing service) with one batch request.
+ *
+ * To keep the interactions with single-blob requests simple, a batch load
+ * only fills entries that are not in the cache at all when the response
+ * arrives, and a batch store only takes ownership of entries that do not
+ * already have a store pending.
+ */
+
+struct load_batch {
+    struct content_cache *cache;
+    const flux_msg_t *msg;
+    struct blobvec *request;
+    int count;
+    struct load_batch_slot {
+        int errnum;
+        void *data;             /* copy of cached data, if any */
+        int len;
+        int upstream_index;     /* index in upstream request, or -1 */
+    } *slots;
+};
+
+struct store_batch {
+    struct content_cache *cache;
+    const flux_msg_t *msg;
+    int count;
+    struct store_batch_slot {
+        int errnum;
+        char blobref[BLOBREF_MAX_STRING_SIZE];
+        struct cache_entry *owner; /* entry whose store_pending we set */
+        int upstream_index;     /* index in upstream request, or -1 */
+    } *slots;
+};
+
+static void load_batch_destroy (struct load_batch *lb)
+{
+    if (lb) {
+        int saved_errno = errno;
+        int i;
+        for (i = 0; i < lb->count; i++)
+            free (lb->slots[i].data);
+        free (lb->slots);
+        blobvec_destroy (lb->request);
+        flux_msg_decref (lb->msg);
+        free (lb);
+        errno = saved_errno;
+    }
+}
+
+static struct load_batch *load_batch_create (struct content_cache *cache,
+                                             const flux_msg_t *msg,
+                                             struct blobvec *request)
+{
+    struct load_batch *lb;
+    int i;
+
+    if (!(lb = calloc (1, sizeof (*lb))))
+        return NULL;
+    lb->count = blobvec_count (request);
+    if (!(lb->slots = calloc (lb->count ? lb->count : 1,
+                              sizeof (lb->slots[0])))) {
+        free (lb);
+        return NULL;
+    }
+    for (i = 0; i < lb->count; i++)
+        lb->slots[i].upstream_index = -1;
+    lb->cache = cache;
+    lb->msg = flux_msg_incref (msg);
+    lb->request = request;
+    return lb;
+}
+
+/* Send the load batch response.  Data for slots that were loaded
+ * upstream is taken from the upstream response 'f', if any.
+ */
+static void load_batch_respond (struct load_batch *lb, flux_future_t *f)
+{
+    flux_t *h = lb->cache->h;
+    struct blobvec *bv;
+    const void *buf;
+    int len;
+    int i;
+
+    if (!(bv = blobvec_create ()))
+        goto error;
+    for (i = 0; i < lb->count; i++) {
+        struct load_batch_slot *slot = &lb->slots[i];
+        const void *data = slot->data;
+        int errnum = slot->errnum;
+        int size = slot->len;
+
+        if (slot->upstream_index >= 0 && errnum == 0) {
+            if (flux_content_load_batch_get (f,
+                                             slot->upstream_index,
+                                             &data,
+                                             &size) < 0)
+                errnum = errno;
+        }
+        if (blobvec_append (bv, errnum, data, errnum ? 0 : size) < 0)
+            goto error;
+    }
+    if (blobvec_encode (bv, &buf, &len) < 0)
+        goto error;
+    if (flux_respond_raw (h, lb->msg, buf, len) < 0)
+        flux_log_error (h, "content load-batch: flux_respond_raw");
+    blobvec_destroy (bv);
+    return;
+error:
+    if (flux_respond_error (h, lb->msg, errno, NULL) < 0)
+        flux_log_error (h, "content load-batch: flux_respond_error");
+    blobvec_destroy (bv);
+}
+
+static void cache_load_batch_continuation (flux_future_t *f, void *arg)
+{
+    struct load_batch *lb = arg;
+    struct content_cache *cache = lb->cache;
+    int i;
+
+    for (i = 0; i < lb->count; i++) {
+        struct load_batch_slot *slot = &lb->slots[i];
+        struct cache_entry *e;
+        const char *blobref;
+        const void *data;
+        int len;
+
+        if (slot->upstream_index < 0)
+            continue;
+        if (flux_content_load_batch_get (f,
+                                         slot->upstream_index,
+                                         &data,
+                                         &len) < 0) {
+            if (errno == ENOSYS && cache->rank == 0)
+                errno = ENOENT;
+            if (errno != ENOENT)
+                flux_log_error (cache->h, "content load-batch");
+            slot->errnum = errno;
+            continue;
+        }
+        if (blobvec_get (lb->request,
+                         i,
+                         NULL,
+                         (const void **)&blobref,
+                         NULL) < 0
+            || zhashx_lookup (cache->entries, blobref))
+            continue; // already cached, or load pending
+        if (!(e = cache_entry_insert (cache, blobref))
+            || cache_entry_fill (cache, e, data, len, false) < 0) {
+            flux_log_error (cache->h, "content load-batch");
+            if (e)
+                cache_entry_remove (cache, e);
+        }
+    }
+    load_batch_respond (lb, f);
+    load_batch_destroy (lb);
+    flux_future_destroy (f);
+    cache_shrink (cache);
+}
+
+static int cache_load_batch (struct content_cache *cache,
+                             struct load_batch *lb,
+                             const char **blobrefs,
+                             int count)
+{
+    flux_future_t *f;
+    int flags = CONTENT_FLAG_UPSTREAM;
+
+    if (cache->rank == 0)
+        flags = CONTENT_FLAG_CACHE_BYPASS;
+    if (!(f = flux_content_load_batch (cache->h, blobrefs, count, flags))
+        || flux_future_then (f, -1., cache_load_batch_continuation, lb) < 0) {
+        flux_log_error (cache->h, "content load-batch");
+        flux_future_destroy (f);
+        return -1;
+    }
+    return 0;
+}
+
+static void content_load_batch_request (flux_t *h,
+                                        flux_msg_handler_t *mh,
+                                        const flux_msg_t *msg,
+                                        void *arg)
+{
+    struct content_cache *cache = arg;
+    const void *buf;
+    int len;
+    struct blobvec *request = NULL;
+    struct load_batch *lb = NULL;
+    const char **upstream = NULL;
+    int nupstream = 0;
+    int i;
+
+    if (flux_request_decode_raw (msg, NULL, &buf, &len) < 0)
+        goto error;
+    if (!(request = blobvec_decode (buf, len)))
+        goto error;
+    if (!(lb = load_batch_create (cache, msg, request)))
+        goto error;
+    request = NULL; // now owned by lb
+    if (!(upstream = calloc (lb->count ? lb->count : 1, sizeof (char *))))
+        goto error;
+    for (i = 0; i < lb->count; i++) {
+        struct load_batch_slot *slot = &lb->slots[i];
+        const char *blobref;
+        int size;
+        struct cache_entry *e;
+
+        if (blobvec_get (lb->request,
+                         i,
+                         NULL,
+                         (const void **)&blobref,
+                         &size) < 0)
+            goto error;
+        if (!blobref || blobref[size - 1] != '\0') {
+            errno = EPROTO;
+            goto error;
+        }
+        if ((e = cache_entry_lookup (cache, blobref)) && e->valid) {
+            if (e->len > 0) {
+                if (!(slot->data = malloc (e->len)))
+                    goto error;
+                memcpy (slot->data, e->data, e->len);
+            }
+            slot->len = e->len;
+            continue;
+        }
+        cache->acct_misses++;
+        if (cache->rank == 0 && !cache->backing) {
+            slot->errnum = ENOENT;
+            continue;
+        }
+        slot->upstream_index = nupstream;
+        upstream[nupstream++] = blobref;
+    }
+    if (nupstream > 0) {
+        if (cache_load_batch (cache, lb, upstream, nupstream) < 0)
+            goto error;
+        free (upstream);
+        return; /* RPC continuation will respond to msg */
+    }
+    load_batch_respond (lb, NULL);
+    load_batch_destroy (lb);
+    free (upstream);
+    return;
+error:
+    if (flux_respond_error (h, msg, errno, NULL) < 0)
+        flux_log_error (h, "content load-batch: flux_respond_error");
+    blobvec_destroy (request);
+    load_batch_destroy (lb);
+    free (upstream);
+}
+
+static void store_batch_destroy (struct store_batch *sb)
+{
+    if (sb) {
+        int saved_errno = errno;
+        free (sb->slots);
+        flux_msg_decref (sb->msg);
+        free (sb);
+        errno = saved_errno;
+    }
+}
+
+static struct store_batch *store_batch_create (struct content_cache *cache,
+                                               const flux_msg_t *msg,
+                                               int count)
+{
+    struct store_batch *sb;
+    int i;
+
+    if (!(sb = calloc (1, sizeof (*sb))))
+        return NULL;
+    if (!(sb->slots = calloc (count ? count : 1, sizeof (sb->slots[0])))) {
+        free (sb);
+        return NULL;
+    }
+    for (i = 0; i < count; i++)
+        sb->slots[i].upstream_index = -1;
+    sb->count = count;
+    sb->cache = cache;
+    sb->msg = flux_msg_incref (msg);
+    return sb;
+}
+
+static void store_batch_respond (struct store_batch *sb)
+{
+    flux_t *h = sb->cache->h;
+    struct blobvec *bv;
+    const void *buf;
+    int len;
+    int i;
+
+    if (!(bv = blobvec_create ()))
+        goto error;
+    for (i = 0; i < sb->count; i++) {
+        struct store_batch_slot *slot = &sb->slots[i];
+
+        if (slot->errnum) {
+            if (blobvec_append (bv, slot->errnum, NULL, 0) < 0)
+                goto error;
+        }
+        else {
+            if (blobvec_append (bv,
+                                0,
+                                slot->blobref,
+                                strlen (slot->blobref) + 1) < 0)
+                goto error;
+        }
+    }
+    if (blobvec_encode (bv, &buf, &len) < 0)
+        goto error;
+    if (flux_respond_raw (h, sb->msg, buf, len) < 0)
+        flux_log_error (h, "content store-batch: flux_respond_raw");
+    blobvec_destroy (bv);
+    return;
+error:
+    if (flux_respond_error (h, sb->msg, errno, NULL) < 0)
+        flux_log_error (h, "content store-batch: flux_respond_error");
+    blobvec_destroy (bv);
+}
+
+static void cache_store_batch_continuation (flux_future_t *f, void *arg)
+{
+    struct store_batch *sb = arg;
+    struct content_cache *cache = sb->cache;
+    int i;
+
+    for (i = 0; i < sb->count; i++) {
+        struct store_batch_slot *slot = &sb->slots[i];
+        struct cache_entry *e = slot->owner;
+        const char *blobref;
+
+        if (slot->upstream_index < 0)
+            continue;
+        if (flux_content_store_batch_get (f,
+                                          slot->upstream_index,
+                                          &blobref) < 0) {
+            flux_log_error (cache->h, "content store-batch");
+            slot->errnum = errno;
+        }
+        else if (strcmp (blobref, slot->blobref) != 0) {
+            flux_log (cache->h, LOG_ERR, "content store-batch: wrong blobref");
+            slot->errnum = EIO;
+        }
+        if (e) {
+            e->store_pending = 0;
+            if (slot->errnum == 0)
+                cache_entry_dirty_clear (cache, e);
+            else {
+                request_list_respond_error (&e->store_requests,
+                                            cache->h,
+                                            slot->errnum,
+                                            NULL,
+                                            "store");
+            }
+        }
+    }
+    store_batch_respond (sb);
+    store_batch_destroy (sb);
+    flux_future_destroy (f);
+    cache_shrink (cache);
+    cache_resume_flush (cache);
+}
+
+static void content_store_batch_request (flux_t *h,
+                                         flux_msg_handler_t *mh,
+                                         const flux_msg_t *msg,
+                                         void *arg)
+{
+    struct content_cache *cache = arg;
+    const void *buf;
+    int len;
+    struct blobvec *request = NULL;
+    struct store_batch *sb = NULL;
+    const void **upstream_data = NULL;
+    int *upstream_len = NULL;
+    int nupstream = 0;
+    flux_future_t *f = NULL;
+    int count;
+    int i;
+
+    if (flux_request_decode_raw (msg, NULL, &buf, &len) < 0)
+        goto error;
+    if (!(request = blobvec_decode (buf, len)))
+        goto error;
+    count = blobvec_count (request);
+    if (!(sb = store_batch_create (cache, msg, count))
+        || !(upstream_data = calloc (count ? count : 1, sizeof (void *)))
+        || !(upstream_len = calloc (count ? count : 1, sizeof (int))))
+        goto error;
+    for (i = 0; i < count; i++) {
+        struct store_batch_slot *slot = &sb->slots[i];
+        struct cache_entry *e;
+        const void *data;
+        int size;
+
+        if (blobvec_get (request, i, NULL, &data, &size) < 0)
+            goto error;
+        if (size > cache->blob_size_limit) {
+            slot->errnum = EFBIG;
+            continue;
+        }
+        if (blobref_hash (cache->hash_name,
+                          (uint8_t *)data,
+                          size,
+                          slot->blobref,
+                          sizeof (slot->blobref)) < 0) {
+            slot->errnum = errno;
+            continue;
+        }
+        if (!(e = cache_entry_lookup (cache, slot->blobref))) {
+            if (!(e = cache_entry_insert (cache, slot->blobref))) {
+                slot->errnum = errno;
+                continue;
+            }
+        }
+        if (cache_entry_fill (cache, e, data, size, true) < 0) {
+            slot->errnum = errno;
+            continue;
+        }
+        if (!e->dirty)
+            continue;
+        if (cache->rank == 0) { // write-back
+            if (cache->backing && cache_store (cache, e) < 0)
+                slot->errnum = errno;
+            continue;
+        }
+        if (!e->store_pending) { // write-through
+            e->store_pending = 1;
+            slot->owner = e;
+        }
+        slot->upstream_index = nupstream;
+        upstream_data[nupstream] = e->data;
+        upstream_len[nupstream] = e->len;
+        nupstream++;
+    }
+    if (nupstream > 0) {
+        if (!(f = flux_content_store_batch (h,
+                                            upstream_data,
+                                            upstream_len,
+                                            nupstream,
+                                            CONTENT_FLAG_UPSTREAM))
+            || flux_future_then (f,
+                                 -1.,
+                                 cache_store_batch_continuation,
+                                 sb) < 0) {
+            flux_log_error (h, "content store-batch");
+            goto error;
+        }
+        goto done; /* RPC continuation will respond to msg */
+    }
+    store_batch_respond (sb);
+    store_batch_destroy (sb);
+    cache_shrink (cache);
+done:
+    blobvec_destroy (request);
+    free (upstream_data);
+    free (upstream_len);
+    return;
+error:
+    if (flux_respond_error (h, msg, errno, NULL) < 0)
+        flux_log_error (h, "content store-batch: flux_respond_error");
+    if (sb) {
+        for (i = 0; i < sb->count; i++) {
+            if (sb->slots[i].owner)
+                sb->slots[i].owner->store_pending = 0;
+        }
+    }
+    flux_future_destroy (f);
+    store_batch_destroy (sb);
+    blobvec_destroy (request);
+    free (upstream_data);
+    free (upstream_len);
+}
+
 /* Backing store is enabled/disabled by modules that provide the
  * 'content.backing' service.  At module load time, the backing module
  * informs the content service of its availability, and entries are
@@ -674,7 +1279,7 @@ error:
 }
 
 /* Forcibly drop all entries from the cache that can be dropped
- * without data loss.  Use the LRU for this since all entires are
+ * without data loss.  Use the LRU segments for this since all entires are
  * valid and clean.
  */
 
@@ -688,7 +1293,10 @@ static void content_dropcache_request (flux_t *h, flux_msg_handler_t *mh,
 
     orig_size = zhashx_size (cache->entries);
 
-    list_for_each_safe (&cache->lru, e, next, list) {
+    list_for_each_safe (&cache->probation.list, e, next, list) {
+        cache_entry_remove (cache, e);
+    }
+    list_for_each_safe (&cache->protected.list, e, next, list) {
         cache_entry_remove (cache, e);
     }
 
@@ -706,12 +1314,26 @@ static void content_stats_request (flux_t *h, flux_msg_handler_t *mh,
 {
     struct content_cache *cache = arg;
 
-    if (flux_respond_pack (h, msg, "{s:i s:i s:i s:i s:i}",
+    if (flux_respond_pack (h, msg,
+                           "{s:i s:i s:i s:i s:i s:i"
+                           " s:{s:i s:i s:i s:i}"
+                           " s:{s:i s:i s:i s:i}}",
                            "count", zhashx_size (cache->entries),
                            "valid", cache->acct_valid,
                            "dirty", cache->acct_dirty,
                            "size", cache->acct_size,
-                           "flush-batch-count", cache->flush_batch_count) < 0)
+                           "misses", cache->acct_misses,
+                           "flush-batch-count", cache->flush_batch_count,
+                           "probation",
+                             "count", cache->probation.count,
+                             "size", cache->probation.size,
+                             "hits", cache->probation.hits,
+                             "evictions", cache->probation.evictions,
+                           "protected",
+                             "count", cache->protected.count,
+                             "size", cache->protected.size,
+                             "hits", cache->protected.hits,
+                             "evictions", cache->protected.evictions) < 0)
         flux_log_error (h, "content stats");
 }
 
@@ -765,22 +1387,33 @@ error:
 /* Heartbeat drives periodic cache purge
  */
 
-static void cache_purge (struct content_cache *cache)
+static void cache_purge_segment (struct content_cache *cache,
+                                 struct lru_segment *seg,
+                                 double now)
 {
-    double now = flux_reactor_now (cache->reactor);
     struct cache_entry *e = NULL;
     struct cache_entry *next;
 
-    list_for_each_rev_safe (&cache->lru, e, next, list) {
+    list_for_each_rev_safe (&seg->list, e, next, list) {
         if (cache->acct_size <= cache->purge_target_size
             || now - e->lastused < cache->purge_old_entry)
             break;
         assert (e->valid);
         assert (!e->dirty);
+        seg->evictions++;
         cache_entry_remove (cache, e);
     }
 }
 
+static void cache_purge (struct content_cache *cache)
+{
+    double now = flux_reactor_now (cache->reactor);
+
+    cache_purge_segment (cache, &cache->probation, now);
+    cache_purge_segment (cache, &cache->protected, now);
+    cache_shrink (cache);
+}
+
 static void update_stats (struct content_cache *cache)
 {
     flux_stats_gauge_set (cache->h, "content-cache.count",
@@ -793,6 +1426,20 @@ static void update_stats (struct content_cache *cache)
         cache->acct_size);
     flux_stats_gauge_set (cache->h, "content-cache.flush-batch-count",
         cache->flush_batch_count);
+    flux_stats_gauge_set (cache->h, "content-cache.misses",
+        cache->acct_misses);
+    flux_stats_gauge_set (cache->h, "content-cache.probation.size",
+        cache->probation.size);
+    flux_stats_gauge_set (cache->h, "content-cache.probation.hits",
+        cache->probation.hits);
+    flux_stats_gauge_set (cache->h, "content-cache.probation.evictions",
+        cache->probation.evictions);
+    flux_stats_gauge_set (cache->h, "content-cache.protected.size",
+        cache->protected.size);
+    flux_stats_gauge_set (cache->h, "content-cache.protected.hits",
+        cache->protected.hits);
+    flux_stats_gauge_set (cache->h, "content-cache.protected.evictions",
+        cache->protected.evictions);
 }
 
 static void sync_cb (flux_future_t *f, void *arg)
@@ -823,6 +1470,18 @@ static const struct flux_msg_handler_spec htab[] = {
         content_store_request,
         FLUX_ROLE_USER
     },
+    {
+        FLUX_MSGTYPE_REQUEST,
+        "content.load-batch",
+        content_load_batch_request,
+        FLUX_ROLE_USER
+    },
+    {
+        FLUX_MSGTYPE_REQUEST,
+        "content.store-batch",
+        content_store_batch_request,
+        FLUX_ROLE_USER
+    },
     {
         FLUX_MSGTYPE_REQUEST,
         "content.unregister-backing",
@@ -908,6 +1567,9 @@ static int register_attrs (struct content_cache *cache, attr_t *attr)
     if (attr_add_active_uint32 (attr, "content.purge-old-entry",
                 &cache->purge_old_entry, 0) < 0)
         return -1;
+    if (attr_add_active_uint32 (attr, "content.size-limit",
+                &cache->size_limit, 0) < 0)
+        return -1;
     /* Misc
      */
     if (attr_add_active_uint32 (attr, "content.flush-batch-limit",
@@ -957,7 +1619,8 @@ struct content_cache *content_cache_create (flux_t *h, attr_t *attrs)
     cache->hash_name = default_hash;
     cache->h = h;
     cache->reactor = flux_get_reactor (h);
-    list_head_init (&cache->lru);
+    list_head_init (&cache->probation.list);
+    list_head_init (&cache->protected.list);
     list_head_init (&cache->flush);
 
     if (register_attrs (cache, attrs) < 0)
@@ -102,6 +102,8 @@ struct parent {
     bool offline;           // set upon receipt of KEEPALIVE_DISCONNECT
     struct rpc_track *tracker;
     struct zmqutil_monitor *monitor;
+    ssize_t tx;             // messages sent/received, for stats
+    ssize_t rx;
 };
 
 /* Wake up periodically (between 'sync_min' and 'sync_max' seconds) and:
@@ -143,6 +145,8 @@ struct overlay {
     enum subtree_status status;
     struct timespec status_timestamp;
     struct zmqutil_monitor *bind_monitor;
+    ssize_t child_tx;           // messages sent/received, for stats
+    ssize_t child_rx;
 
     overlay_monitor_f child_monitor_cb;
     void *child_monitor_arg;
@@ -489,8 +493,10 @@ static int overlay_sendmsg_parent (struct overlay *ov, const flux_msg_t *msg)
         goto done;
     }
     rc = zmqutil_msg_send (ov->parent.zsock, msg);
-    if (rc == 0)
+    if (rc == 0) {
         ov->parent.lastsent = flux_reactor_now (ov->reactor);
+        ov->parent.tx++;
+    }
 done:
     return rc;
 }
@@ -650,6 +656,22 @@ error:
     return -1;
 }
 
+static int child_rpc_track_count (struct overlay *ov);
+
+static void update_stats (struct overlay *ov)
+{
+    flux_stats_count (ov->h, "overlay.parent.tx", ov->parent.tx);
+    flux_stats_count (ov->h, "overlay.parent.rx", ov->parent.rx);
+    flux_stats_count (ov->h, "overlay.child.tx", ov->child_tx);
+    flux_stats_count (ov->h, "overlay.child.rx", ov->child_rx);
+    flux_stats_gauge_set (ov->h, "overlay.child.connected",
+                          overlay_get_child_peer_count (ov));
+    flux_stats_gauge_set (ov->h, "overlay.parent.rpc",
+                          rpc_track_count (ov->parent.tracker));
+    flux_stats_gauge_set (ov->h, "overlay.child.rpc",
+                          child_rpc_track_count (ov));
+}
+
 static void sync_cb (flux_future_t *f, void *arg)
 {
     struct overlay *ov = arg;
@@ -659,6 +681,9 @@ static void sync_cb (flux_future_t *f, void *arg)
         overlay_keepalive_parent (ov, KEEPALIVE_HEARTBEAT, 0);
     overlay_log_idle_children (ov);
 
+    if (flux_stats_enabled (ov->h, NULL))
+        update_stats (ov);
+
     flux_future_reset (f);
 }
 
@@ -732,6 +757,8 @@ static int overlay_sendmsg_child (struct overlay *ov, const flux_msg_t *msg)
         goto done;
     }
     rc = zmqutil_msg_send_ex (ov->bind_zsock, msg, true);
+    if (rc == 0)
+        ov->child_tx++;
     /* Since ROUTER socket has ZMQ_ROUTER_MANDATORY set, EHOSTUNREACH on a
      * connected peer signifies a disconnect.  See zmq_setsockopt(3).
      */
@@ -832,6 +859,7 @@ static void child_cb (flux_reactor_t *r, flux_watcher_t *w,
 
     if (!(msg = zmqutil_msg_recv (ov->bind_zsock)))
         return;
+    ov->child_rx++;
     if (flux_msg_get_type (msg, &type) < 0
         || !(uuid = flux_msg_route_last (msg))) {
         logdrop (ov, OVERLAY_DOWNSTREAM, msg, "malformed message");
@@ -928,6 +956,7 @@ static void parent_cb (flux_reactor_t *r, flux_watcher_t *w,
 
     if (!(msg = zmqutil_msg_recv (ov->parent.zsock)))
         return;
+    ov->parent.rx++;
     if (flux_msg_get_type (msg, &type) < 0) {
         logdrop (ov, OVERLAY_UPSTREAM, msg, "malformed message");
         goto done;
@@ -11,10 +11,32 @@
 #include "builtin.h"
 
 #include <unistd.h>
+#include <jansson.h>
 
 #include "src/common/libutil/blobref.h"
 #include "src/common/libutil/read_all.h"
 
+static void load_batch (flux_t *h, int count, const char **refs, int flags)
+{
+    flux_future_t *f;
+    const uint8_t *data;
+    int size;
+    int i;
+
+    if (!(f = flux_content_load_batch (h, refs, count, flags)))
+        log_err_exit ("flux_content_load_batch");
+    for (i = 0; i < count; i++) {
+        if (flux_content_load_batch_get (f,
+                                         i,
+                                         (const void **)&data,
+                                         &size) < 0)
+            log_err_exit ("%s", refs[i]);
+        if (write_all (STDOUT_FILENO, data, size) < 0)
+            log_err_exit ("write");
+    }
+    flux_future_destroy (f);
+}
+
 static int internal_content_load (optparse_t *p, int ac, char *av[])
 {
     int n;
@@ -26,7 +48,7 @@ static int internal_content_load (optparse_t *p, int ac, char *av[])
     int flags = 0;
 
     n = optparse_option_index (p);
-    if (n != ac - 1) {
+    if (n == ac) {
         optparse_print_usage (p);
         exit (1);
     }
@@ -35,13 +57,17 @@ static int internal_content_load (optparse_t *p, int ac, char *av[])
         log_err_exit ("flux_open");
     if (optparse_hasopt (p, "bypass-cache"))
         flags |= CONTENT_FLAG_CACHE_BYPASS;
-    if (!(f = flux_content_load (h, ref, flags)))
-        log_err_exit ("flux_content_load");
-    if (flux_content_load_get (f, (const void **)&data, &size) < 0)
-        log_err_exit ("flux_content_load_get");
-    if (write_all (STDOUT_FILENO, data, size) < 0)
-        log_err_exit ("write");
-    flux_future_destroy (f);
+    if (n < ac - 1)
+        load_batch (h, ac - n, (const char **)&av[n], flags);
+    else {
+        if (!(f = flux_content_load (h, ref, flags)))
+            log_err_exit ("flux_content_load");
+        if (flux_content_load_get (f, (const void **)&data, &size) < 0)
+            log_err_exit ("flux_content_load_get");
+        if (write_all (STDOUT_FILENO, data, size) < 0)
+            log_err_exit ("write");
+        flux_future_destroy (f);
+    }
     flux_close (h);
     return (0);
 }
@@ -116,22 +142,184 @@ static int internal_content_dropcache (optparse_t *p, int ac, char *av[])
     return (0);
 }
 
+static void print_codec_stats (json_t *o)
+{
+    const char *size;
+    int stores, loads;
+    json_int_t raw_bytes, stored_bytes;
+    double encode_ms, decode_ms;
+
+    if (json_unpack (o,
+                     "{s:s s:i s:I s:I s:f s:i s:f}",
+                     "size", &size,
+                     "stores", &stores,
+                     "raw-bytes", &raw_bytes,
+                     "stored-bytes", &stored_bytes,
+                     "encode-ms", &encode_ms,
+                     "loads", &loads,
+                     "decode-ms", &decode_ms) < 0)
+        log_msg_exit ("error decoding compression stats");
+    printf ("%-6s %8d %12lld %12lld %6.2f %10.2f %8d %10.2f\n",
+            size,
+            stores,
+            (long long)raw_bytes,
+            (long long)stored_bytes,
+            stored_bytes > 0 ? (double)raw_bytes / stored_bytes : 0.,
+            stores > 0 ? encode_ms * 1000. / stores : 0.,
+            loads,
+            loads > 0 ? decode_ms * 1000. / loads : 0.);
+}
+
+static int internal_content_stats (optparse_t *p, int ac, char *av[])
+{
+    flux_t *h;
+    flux_future_t *f = NULL;
+    const char *module;
+    char topic[256];
+    const char *codec;
+    int dict_count;
+    int dict_size;
+    json_t *compression;
+    size_t index;
+    json_t *o;
+
+    if (optparse_option_index (p) != ac) {
+        optparse_print_usage (p);
+        exit (1);
+    }
+    if (!(h = builtin_get_flux_handle (p)))
+        log_err_exit ("flux_open");
+    if (!(module = flux_attr_get (h, "content.backing-module")))
+        log_err_exit ("content.backing-module");
+    snprintf (topic, sizeof (topic), "%s.stats.get", module);
+    if (!(f = flux_rpc (h, topic, NULL, 0, 0)))
+        log_err_exit ("%s", topic);
+    if (flux_rpc_get_unpack (f,
+                             "{s:s s:i s:i s:o}",
+                             "codec", &codec,
+                             "dictionaries", &dict_count,
+                             "dictionary-size", &dict_size,
+                             "compression", &compression) < 0)
+        log_msg_exit ("%s: %s", module, future_strerror (f, errno));
+    printf ("codec: %s\n", codec);
+    printf ("dictionaries: %d (current %d bytes)\n", dict_count, dict_size);
+    printf ("%-6s %8s %12s %12s %6s %10s %8s %10s\n",
+            "SIZE",
+            "STORES",
+            "RAW",
+            "STORED",
+            "RATIO",
+            "ENCODE-us",
+            "LOADS",
+            "DECODE-us");
+    json_array_foreach (compression, index, o)
+        print_codec_stats (o);
+    flux_future_destroy (f);
+    flux_close (h);
+    return (0);
+}
+
+static int internal_content_gc (optparse_t *p, int ac, char *av[])
+{
+    flux_t *h;
+    flux_future_t *f = NULL;
+    const char *module;
+    char topic[256];
+    int marked, scanned, removed;
+    json_int_t reclaimed;
+    double duration;
+
+    if (optparse_option_index (p) != ac) {
+        optparse_print_usage (p);
+        exit (1);
+    }
+    if (!(h = builtin_get_flux_handle (p)))
+        log_err_exit ("flux_open");
+    if (!(module = flux_attr_get (h, "content.backing-module")))
+        log_err_exit ("content.backing-module");
+    snprintf (topic, sizeof (topic), "%s.gc", module);
+    if (!(f = flux_rpc_pack (h,
+                             topic,
+                             0,
+                             0,
+                             "{s:i s:b}",
+                             "rate", optparse_get_int (p, "rate", 0),
+                             "compact", optparse_hasopt (p, "compact"))))
+        log_err_exit ("%s", topic);
+    if (flux_rpc_get_unpack (f,
+                             "{s:i s:i s:i s:I s:f}",
+                             "marked", &marked,
+                             "scanned", &scanned,
+                             "removed", &removed,
+                             "reclaimed-bytes", &reclaimed,
+                             "duration", &duration) < 0)
+        log_msg_exit ("%s: %s", module, future_strerror (f, errno));
+    printf ("removed %d of %d blobs (%lld bytes), %d reachable, in %.3fs\n",
+            removed,
+            scanned,
+            (long long)reclaimed,
+            marked,
+            duration);
+    flux_future_destroy (f);
+    flux_close (h);
+    return (0);
+}
+
 static int spam_max_inflight;
 static int spam_cur_inflight;
+static int spam_batch;
 
 static void store_completion (flux_future_t *f, void *arg)
 {
     flux_t *h = arg;
     const char *blobref;
+    int i;
 
-    if (flux_content_store_get (f, &blobref) < 0)
-        log_err_exit ("store");
-    printf ("%s\n", blobref);
+    if (spam_batch > 0) {
+        for (i = 0; i < spam_batch; i++) {
+            if (flux_content_store_batch_get (f, i, &blobref) < 0)
+                log_err_exit ("store");
+            printf ("%s\n", blobref);
+        }
+    }
+    else {
+        if (flux_content_store_get (f, &blobref) < 0)
+            log_err_exit ("store");
+        printf ("%s\n", blobref);
+    }
     flux_future_destroy (f);
     if (--spam_cur_inflight < spam_max_inflight/2)
         flux_reactor_stop (flux_get_reactor (h));
 }
 
+static flux_future_t *spam_store_batch (flux_t *h, int seq)
+{
+    int size = 256;
+    char *data;
+    const void **bufs;
+    int *lens;
+    flux_future_t *f;
+    int i;
+
+    data = xzmalloc (spam_batch * size);
+    bufs = xzmalloc (spam_batch * sizeof (bufs[0]));
+    lens = xzmalloc (spam_batch * sizeof (lens[0]));
+    for (i = 0; i < spam_batch; i++) {
+        bufs[i] = data + i * size;
+        lens[i] = size;
+        snprintf (data + i * size,
+                  size,
+                  "spam-o-matic pid=%d seq=%d",
+                  getpid(),
+                  seq + i);
+    }
+    f = flux_content_store_batch (h, bufs, lens, spam_batch, 0);
+    free (data);
+    free (bufs);
+    free (lens);
+    return f;
+}
+
 static int internal_content_spam (optparse_t *p, int ac, char *av[])
 {
     int i, count;
@@ -139,16 +327,21 @@ static int internal_content_spam (optparse_t *p, int ac, char *av[])
     flux_t *h;
     char data[256];
     int size = 256;
+    int n;
 
-    if (ac != 2 && ac != 3) {
+    n = optparse_option_index (p);
+    if (n != ac - 1 && n != ac - 2) {
         optparse_print_usage (p);
         exit (1);
     }
-    count = strtoul (av[1], NULL, 10);
-    if (ac == 3)
-        spam_max_inflight = strtoul (av[2], NULL, 10);
+    count = strtoul (av[n], NULL, 10);
+    if (n == ac - 2)
+        spam_max_inflight = strtoul (av[n + 1], NULL, 10);
     else
         spam_max_inflight = 1;
+    spam_batch = optparse_get_int (p, "batch", 0);
+    if (spam_batch < 0 || (spam_batch > 0 && count % spam_batch != 0))
+        log_msg_exit ("N must be a multiple of the batch size");
 
     if (!(h = builtin_get_flux_handle (p)))
         log_err_exit ("flux_open");
@@ -157,13 +350,20 @@ static int internal_content_spam (optparse_t *p, int ac, char *av[])
     i = 0;
     while (i < count || spam_cur_inflight > 0) {
         while (i < count && spam_cur_inflight < spam_max_inflight) {
-            snprintf (data, size, "spam-o-matic pid=%d seq=%d", getpid(), i);
-            if (!(f = flux_content_store (h, data, size, 0)))
-                log_err_exit ("flux_content_store(%d)", i);
+            if (spam_batch > 0) {
+                if (!(f = spam_store_batch (h, i)))
+                    log_err_exit ("flux_content_store_batch(%d)", i);
+                i += spam_batch;
+            }
+            else {
+                snprintf (data, size, "spam-o-matic pid=%d seq=%d", getpid(), i);
+                if (!(f = flux_content_store (h, data, size, 0)))
+                    log_err_exit ("flux_content_store(%d)", i);
+                i++;
+            }
             if (flux_future_then (f, -1., store_completion, h) < 0)
                 log_err_exit ("flux_future_then(%d)", i);
             spam_cur_inflight++;
-            i++;
         }
         if (flux_reactor_run (flux_get_reactor (h), 0) < 0)
             log_err ("flux_reactor_run");
@@ -192,10 +392,24 @@ static struct optparse_option store_opts[] = {
       OPTPARSE_TABLE_END,
 };
 
+static struct optparse_option spam_opts[] = {
+    { .name = "batch",  .key = 'B',  .has_arg = 1, .arginfo = "M",
+      .usage = "Store blobs in batches of M per request", },
+      OPTPARSE_TABLE_END,
+};
+
+static struct optparse_option gc_opts[] = {
+    { .name = "rate",  .key = 'r',  .has_arg = 1, .arginfo = "N",
+      .usage = "Limit collection to about N blobs per second", },
+    { .name = "compact",  .key = 'c',  .has_arg = 0,
+      .usage = "Reclaim free space in the backing store afterwards", },
+      OPTPARSE_TABLE_END,
+};
+
 static struct optparse_subcommand content_subcmds[] = {
     { "load",
-      "[OPTIONS] BLOBREF",
-      "Load blob for digest BLOBREF to stdout",
+      "[OPTIONS] BLOBREF...",
+      "Load blob(s) for digest BLOBREF(s) to stdout",
       internal_content_load,
       0,
       load_opts,
@@ -221,12 +435,26 @@ static struct optparse_subcommand content_subcmds[] = {
       0,
       NULL,
     },
+    { "gc",
+      "[OPTIONS]",
+      "Remove blobs unreachable from the KVS from the backing store",
+      internal_content_gc,
+      0,
+      gc_opts,
+    },
+    { "stats",
+      NULL,
+      "Show backing store compression statistics",
+      internal_content_stats,
+      0,
+      NULL,
+    },
     { "spam",
       "N [M]",
       "Store N random entries, keeping M requests in flight (default 1)",
       internal_content_spam,
       0,
-      NULL,
+      spam_opts,
     },
     OPTPARSE_SUBCMD_END
 };
@@ -2717,6 +2717,47 @@ void wait_event_continuation (flux_future_t *f, void *arg)
     flux_future_reset (f);
 }
 
+/* If the event has already been posted to the main job eventlog,
+ * fetch it with job-info.eventlog-seek rather than streaming the
+ * eventlog from the beginning.  Only simple waits qualify: verbose
+ * output, context matching, counts, and offset timestamps all need
+ * the events before the match.  Return true if the event was found.
+ */
+static bool wait_event_seek (flux_t *h, struct wait_event_ctx *ctx)
+{
+    flux_future_t *f;
+    json_t *events;
+    json_t *o;
+    bool found = false;
+
+    if (strcmp (ctx->path, "eventlog") != 0
+        || optparse_hasopt (ctx->p, "verbose")
+        || ctx->context_key
+        || ctx->count != 1
+        || !strcasecmp (ctx->e.time_format, "offset"))
+        return false;
+    if (!(f = flux_rpc_pack (h,
+                             "job-info.eventlog-seek",
+                             FLUX_NODEID_ANY,
+                             0,
+                             "{s:I s:s}",
+                             "id", ctx->id,
+                             "name", ctx->wait_event)))
+        log_err_exit ("flux_rpc_pack");
+    /* On any error (e.g. the event has not been posted yet),
+     * fall back to watching the eventlog.
+     */
+    if (flux_rpc_get_unpack (f, "{s:o}", "events", &events) == 0
+        && (o = json_array_get (events, 0))
+        && wait_event_test (ctx, o)) {
+        if (!optparse_hasopt (ctx->p, "quiet"))
+            output_event (&ctx->e, o);
+        found = true;
+    }
+    flux_future_destroy (f);
+    return found;
+}
+
 int cmd_wait_event (optparse_t *p, int argc, char **argv)
 {
     flux_t *h;
@@ -2751,13 +2792,16 @@ int cmd_wait_event (optparse_t *p, int argc, char **argv)
     if (ctx.count <= 0)
         log_msg_exit ("count must be > 0");
 
+    if (wait_event_seek (h, &ctx))
+        goto done;
+
     if (!(f = flux_job_event_watch (h, ctx.id, ctx.path, 0)))
         log_err_exit ("flux_job_event_watch");
     if (flux_future_then (f, timeout, wait_event_continuation, &ctx) < 0)
         log_err_exit ("flux_future_then");
     if (flux_reactor_run (flux_get_reactor (h), 0) < 0)
         log_err_exit ("flux_reactor_run");
-
+done:
     free (ctx.context_key);
     flux_close (h);
     return (0);
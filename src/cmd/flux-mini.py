@@ -625,18 +625,11 @@ class MiniCmd:
 
         return jobspec
 
-    def submit_async(self, args, jobspec=None):
+    @staticmethod
+    def submit_options(args):
         """
-        Submit job, constructing jobspec from args unless jobspec is not None.
-        Returns a SubmitFuture.
+        Return keyword arguments for job.submit_async() from args.
         """
-        if jobspec is None:
-            jobspec = self.jobspec_create(args)
-
-        if args.dry_run:
-            print(jobspec.dumps(), file=sys.stdout)
-            sys.exit(0)
-
         arg_debug = False
         arg_waitable = False
         arg_novalidate = False
@@ -652,9 +645,6 @@ class MiniCmd:
                     else:
                         raise ValueError("--flags: Unknown flag " + flag)
 
-        if not self.flux_handle:
-            self.flux_handle = flux.Flux()
-
         if args.urgency == "default":
             urgency = flux.constants.FLUX_JOB_URGENCY_DEFAULT
         elif args.urgency == "hold":
@@ -664,15 +654,32 @@ class MiniCmd:
         else:
             urgency = int(args.urgency)
 
-        return job.submit_async(
-            self.flux_handle,
-            jobspec.dumps(),
+        return dict(
             urgency=urgency,
             waitable=arg_waitable,
             debug=arg_debug,
             novalidate=arg_novalidate,
         )
 
+    def submit_async(self, args, jobspec=None):
+        """
+        Submit job, constructing jobspec from args unless jobspec is not None.
+        Returns a SubmitFuture.
+        """
+        if jobspec is None:
+            jobspec = self.jobspec_create(args)
+
+        if args.dry_run:
+            print(jobspec.dumps(), file=sys.stdout)
+            sys.exit(0)
+
+        options = self.submit_options(args)
+
+        if not self.flux_handle:
+            self.flux_handle = flux.Flux()
+
+        return job.submit_async(self.flux_handle, jobspec.dumps(), **options)
+
     def submit(self, args, jobspec=None):
         return JobID(self.submit_async(args, jobspec).get_id())
 
@@ -755,11 +762,17 @@ class SubmitBulkCmd(SubmitBaseCmd):
     to the SubmitBaseCmd class
     """
 
+    #  Maximum number of jobs sent in one job-ingest.submit-bulk request
+    submit_chunk_size = 1024
+
     def __init__(self):
 
         #  dictionary of open logfiles for --log, --log-stderr:
         self._logfiles = {}
 
+        #  jobs waiting to be sent by submit_flush():
+        self._submit_queue = []
+
         super().__init__()
         self.parser.add_argument(
             "-q",
@@ -897,16 +910,14 @@ class SubmitBulkCmd(SubmitBaseCmd):
             if status > self.exitcode:
                 self.exitcode = status
 
-    def submit_cb(self, future, args, label=""):
-        try:
-            jobid = JobID(future.get_id())
-            if not args.quiet:
-                print(jobid, file=args.stdout)
-        except OSError as exc:
-            print(f"{label}{exc}", file=args.stderr)
-            self.exitcode = 1
-            self.progress_update(submit_failed=True)
-            return
+    def submit_failed(self, args, label, exc):
+        print(f"{label}{exc}", file=args.stderr)
+        self.exitcode = 1
+        self.progress_update(submit_failed=True)
+
+    def submitted(self, args, label, jobid):
+        if not args.quiet:
+            print(jobid, file=args.stdout)
 
         if args.wait or args.watch:
             #
@@ -924,6 +935,55 @@ class SubmitBulkCmd(SubmitBaseCmd):
             #  Update progress of submission only
             self.progress.update(jps=self.jobs_per_sec())
 
+    def submit_bulk_cb(self, future, entries):
+        """Handle response to one chunk of jobs sent by submit_flush()"""
+        for index, (_, args, label) in enumerate(entries):
+            try:
+                jobid = JobID(future.get_id(index))
+            except OSError as exc:
+                self.submit_failed(args, label, exc)
+            else:
+                self.submitted(args, label, jobid)
+
+    def submit_queue(self, args, jobspec, label=""):
+        """
+        Queue jobspec for submission by submit_flush().
+        """
+        if args.dry_run:
+            print(jobspec.dumps(), file=sys.stdout)
+            sys.exit(0)
+        self._submit_queue.append((jobspec, args, label))
+
+    def submit_flush(self):
+        """
+        Submit all queued jobs, sending jobs with the same submit options
+        in chunks of up to submit_chunk_size jobs per request.
+        """
+        if not self._submit_queue:
+            return
+        if not self.flux_handle:
+            self.flux_handle = flux.Flux()
+
+        #  The instance owner may sign each chunk once, instead of each job:
+        owner = int(self.flux_handle.attr_get("security.owner"))
+        shared_signature = owner == os.getuid()
+
+        groups = {}
+        for entry in self._submit_queue:
+            options = self.submit_options(entry[1])
+            groups.setdefault(tuple(sorted(options.items())), []).append(entry)
+        self._submit_queue = []
+
+        for options, entries in groups.items():
+            for i in range(0, len(entries), self.submit_chunk_size):
+                chunk = entries[i : i + self.submit_chunk_size]
+                job.submit_bulk_async(
+                    self.flux_handle,
+                    [jobspec.dumps() for jobspec, _, _ in chunk],
+                    shared_signature=shared_signature,
+                    **dict(options),
+                ).then(self.submit_bulk_cb, chunk)
+
     def jobs_per_sec(self):
         return (self.progress.count + 1) / self.progress.elapsed
 
@@ -1092,10 +1152,11 @@ class SubmitBulkCmd(SubmitBaseCmd):
             if xargs.log_stderr:
                 xargs.stderr = self.openlog(xargs.log_stderr)
 
-            self.submit_async(xargs, jobspec).then(self.submit_cb, xargs, label)
+            self.submit_queue(xargs, jobspec, label)
 
     def main(self, args):
         self.submit_async_with_cc(args)
+        self.submit_flush()
         self.run_and_exit()
 
 
@@ -1303,6 +1364,7 @@ class BulkSubmitCmd(SubmitBulkCmd):
                 self.submit_async_with_cc(xargs)
 
         if not args.dry_run:
+            self.submit_flush()
             self.run_and_exit()
 
 
@@ -0,0 +1,269 @@
+#!/bin/false
+##############################################################
+# Copyright 2021 Lawrence Livermore National Security, LLC
+# (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+#
+# This file is part of the Flux resource manager framework.
+# For details, see https://github.com/flux-framework.
+#
+# SPDX-License-Identifier: LGPL-3.0
+##############################################################
+
+import os
+import re
+import sys
+import time
+import signal
+import socket
+import logging
+import argparse
+import selectors
+import subprocess
+
+import flux.util
+
+LOGGER = logging.getLogger("flux-stats")
+
+
+class StatsAggregator:
+    """Accumulate statsd lines as sent by Flux and render them in the
+    Prometheus text exposition format.
+
+    Counters ("C") carry the absolute value of a counter, gauges ("g")
+    are set, or adjusted when the value carries an explicit sign, and
+    timings ("ms") are summarized as a sum and count in seconds.
+    A sample rate ("@rate") on a timing or delta counter means the value
+    stands for 1/rate samples, as Flux sends timings aggregated over its
+    period as their mean.  A leading "flux.<rank>." prefix is turned into
+    a rank label.
+    """
+
+    line_re = re.compile(
+        r"^([^:]+):([+\-]?[0-9.]+(?:e[+\-]?\d+)?)\|(C|c|g|ms)"
+        r"(?:\|@([0-9.]+(?:e[+\-]?\d+)?))?$"
+    )
+    rank_re = re.compile(r"^flux\.(\d+)\.(.+)$")
+
+    def __init__(self):
+        self.counters = {}
+        self.gauges = {}
+        self.timings = {}
+        self.errors = 0
+
+    @staticmethod
+    def metric_key(name):
+        labels = ""
+        match = StatsAggregator.rank_re.match(name)
+        if match:
+            labels = f'{{rank="{match.group(1)}"}}'
+            name = "flux." + match.group(2)
+        name = re.sub(r"[^a-zA-Z0-9_:]", "_", name)
+        if name[0].isdigit():
+            name = "_" + name
+        return name, labels
+
+    def add_line(self, line):
+        match = self.line_re.match(line)
+        if not match:
+            self.errors += 1
+            return
+        name, value, mtype, rate = match.groups()
+        samples = 1
+        if rate is not None:
+            if float(rate) <= 0:
+                self.errors += 1
+                return
+            samples = round(1.0 / float(rate))
+        key = self.metric_key(name)
+        if mtype == "C":
+            self.counters[key] = float(value)
+        elif mtype == "c":
+            self.counters[key] = self.counters.get(key, 0.0) + float(value) * samples
+        elif mtype == "g":
+            if value[0] in "+-":
+                self.gauges[key] = self.gauges.get(key, 0.0) + float(value)
+            else:
+                self.gauges[key] = float(value)
+        else:
+            total, count = self.timings.get(key, (0.0, 0))
+            self.timings[key] = (
+                total + float(value) * samples / 1000.0,
+                count + samples,
+            )
+
+    def add_packet(self, data):
+        for line in data.decode("utf-8", errors="replace").splitlines():
+            if line:
+                self.add_line(line)
+
+    @staticmethod
+    def format_value(value):
+        if float(value).is_integer():
+            return str(int(value))
+        return repr(float(value))
+
+    def _emit(self, fp, metrics, mtype, suffix=""):
+        last = None
+        for (name, labels), value in sorted(metrics.items()):
+            if name != last:
+                fp.write(f"# TYPE {name}{suffix} {mtype}\n")
+                last = name
+            fp.write(f"{name}{suffix}{labels} {self.format_value(value)}\n")
+
+    def write(self, fp):
+        self._emit(fp, self.counters, "counter", "_total")
+        self._emit(fp, self.gauges, "gauge")
+        last = None
+        for (name, labels), (total, count) in sorted(self.timings.items()):
+            if name != last:
+                fp.write(f"# TYPE {name}_seconds summary\n")
+                last = name
+            fp.write(f"{name}_seconds_sum{labels} {self.format_value(total)}\n")
+            fp.write(f"{name}_seconds_count{labels} {count}\n")
+
+    def dump(self, path=None):
+        """Write metrics to stdout, or atomically replace 'path'"""
+        if path is None or path == "-":
+            self.write(sys.stdout)
+            sys.stdout.flush()
+            return
+        tmp = f"{path}.tmp"
+        with open(tmp, "w") as fp:
+            self.write(fp)
+        os.replace(tmp, path)
+
+
+def parse_address(address):
+    host, sep, port = address.rpartition(":")
+    if not sep or not host:
+        raise ValueError(f"{address}: expected HOST:PORT")
+    return host, int(port)
+
+
+def receive(sock, stats, timeout):
+    """Receive packets until 'timeout' seconds have elapsed"""
+    deadline = time.time() + timeout
+    with selectors.DefaultSelector() as sel:
+        sel.register(sock, selectors.EVENT_READ)
+        while True:
+            remaining = deadline - time.time()
+            if remaining <= 0:
+                break
+            for _ in sel.select(remaining):
+                stats.add_packet(sock.recv(65536))
+
+
+def run_command(args, sock, stats):
+    host, port = sock.getsockname()[:2]
+    env = dict(os.environ, FLUX_FRIPP_STATSD=f"{host}:{port}")
+    proc = subprocess.Popen(args.command, env=env)
+    while proc.poll() is None:
+        receive(sock, stats, 0.1)
+    receive(sock, stats, args.linger)
+    stats.dump(args.output)
+    return proc.returncode
+
+
+def run_listener(args, sock, stats):
+    host, port = sock.getsockname()[:2]
+    LOGGER.info("listening on %s:%d", host, port)
+
+    done = []
+    signal.signal(signal.SIGTERM, lambda signum, frame: done.append(signum))
+    start = time.time()
+    try:
+        while not done:
+            interval = args.interval
+            if args.timeout is not None:
+                remaining = args.timeout - (time.time() - start)
+                if remaining <= 0:
+                    break
+                interval = min(interval, remaining)
+            receive(sock, stats, interval)
+            if args.output:
+                stats.dump(args.output)
+    except KeyboardInterrupt:
+        pass
+    stats.dump(args.output)
+    return 0
+
+
+@flux.util.CLIMain(LOGGER)
+def main():
+    sys.stdout = open(sys.stdout.fileno(), "w", encoding="utf8")
+
+    parser = argparse.ArgumentParser(
+        prog="flux-stats", formatter_class=flux.util.help_formatter()
+    )
+    parser.add_argument(
+        "-a",
+        "--address",
+        metavar="HOST:PORT",
+        default="127.0.0.1:0",
+        help="UDP address to receive metrics on (default: %(default)s, "
+        + "port 0 picks an unused port)",
+    )
+    parser.add_argument(
+        "-o",
+        "--output",
+        metavar="FILE",
+        help="Write metrics in Prometheus text format to FILE "
+        + "instead of stdout",
+    )
+    parser.add_argument(
+        "-i",
+        "--interval",
+        metavar="SECONDS",
+        type=float,
+        default=10.0,
+        help="Without COMMAND, rewrite FILE every SECONDS "
+        + "(default: %(default)s)",
+    )
+    parser.add_argument(
+        "-t",
+        "--timeout",
+        metavar="SECONDS",
+        type=float,
+        help="Without COMMAND, exit after SECONDS",
+    )
+    parser.add_argument(
+        "-l",
+        "--linger",
+        metavar="SECONDS",
+        type=float,
+        default=1.0,
+        help="With COMMAND, keep receiving for SECONDS after it exits "
+        + "(default: %(default)s)",
+    )
+    parser.add_argument(
+        "command",
+        nargs=argparse.REMAINDER,
+        help="Run COMMAND with FLUX_FRIPP_STATSD set and report its metrics",
+    )
+    args = parser.parse_args()
+
+    try:
+        address = parse_address(args.address)
+    except ValueError as exc:
+        LOGGER.error("%s", exc)
+        sys.exit(1)
+
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.bind(address)
+    stats = StatsAggregator()
+    try:
+        if args.command:
+            rc = run_command(args, sock, stats)
+        else:
+            rc = run_listener(args, sock, stats)
+    finally:
+        sock.close()
+    if stats.errors:
+        LOGGER.warning("ignored %d malformed metric lines", stats.errors)
+    sys.exit(rc)
+
+
+if __name__ == "__main__":
+    main()
+
+# vi: ts=4 sw=4 expandtab
@@ -0,0 +1,603 @@
+/************************************************************\
+ * Copyright 2021 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+/* content-gc.c - online mark and sweep garbage collection for
+ * content backing stores
+ *
+ * Collection proceeds through these phases:
+ *
+ * PREPARE
+ * Start noting blobs loaded/stored by clients, then drop clean entries
+ * from the rank 0 KVS cache and all content caches, so that any blob that
+ * is reused from now on must pass through the backing store and be noted.
+ * Then flush the rank 0 content cache so all dirty blobs are in the backing
+ * store, and fetch the KVS checkpoint and the current root of each
+ * KVS namespace.
+ *
+ * MARK
+ * Walk the tree from each root, loading directory objects from the backing
+ * store and marking each dirref and valref blobref that is encountered.
+ *
+ * SWEEP
+ * Iterate over the backing store and remove blobs that are neither marked
+ * nor noted.
+ *
+ * If any step before the sweep fails, including a reachable blob that
+ * cannot be loaded, the collection is aborted before anything is removed.
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <flux/core.h>
+#include <jansson.h>
+
+#include "src/common/libczmqcontainers/czmq_containers.h"
+#include "src/common/libkvs/treeobj.h"
+#include "src/common/libutil/blobref.h"
+#include "src/common/libutil/monotime.h"
+
+#include "content-gc.h"
+
+/* Without a rate limit, process this many blobs per reactor iteration
+ * so that the module remains responsive to other requests.
+ */
+static const int unlimited_chunk = 1024;
+
+/* With a rate limit, process rate * work_period blobs per timer tick.
+ */
+static const double work_period = 0.1;
+
+enum gc_state {
+    GC_IDLE,
+    GC_PREPARE,
+    GC_MARK,
+    GC_SWEEP,
+};
+
+struct content_gc {
+    flux_t *h;
+    const struct content_gc_ops *ops;
+    void *arg;
+
+    enum gc_state state;
+    const flux_msg_t *request;
+    int rate;
+    bool compact;
+    flux_watcher_t *timer;
+    struct timespec t0;
+
+    zhashx_t *marked;           /* set of reachable blobrefs */
+    zhashx_t *noted;            /* set of blobrefs used during collection */
+    zlistx_t *queue;            /* directory blobrefs pending visit */
+    int pending;                /* outstanding RPCs in current step */
+    int errnum;                 /* first RPC error in current step */
+
+    /* Statistics for the current or most recent collection.
+     */
+    int runs;
+    int scanned;
+    int removed;
+    int64_t reclaimed;
+    double duration;
+};
+
+static const char *state_name (enum gc_state state)
+{
+    switch (state) {
+        case GC_IDLE:
+            return "idle";
+        case GC_PREPARE:
+            return "prepare";
+        case GC_MARK:
+            return "mark";
+        case GC_SWEEP:
+            return "sweep";
+    }
+    return "unknown";
+}
+
+static void gc_reset (struct content_gc *gc)
+{
+    char *ref;
+
+    flux_watcher_stop (gc->timer);
+    zhashx_purge (gc->marked);
+    zhashx_purge (gc->noted);
+    while ((ref = zlistx_detach (gc->queue, NULL)))
+        free (ref);
+    flux_msg_decref (gc->request);
+    gc->request = NULL;
+    gc->state = GC_IDLE;
+}
+
+static void gc_finish (struct content_gc *gc)
+{
+    gc->duration = monotime_since (gc->t0) * 1E-3;
+    flux_log (gc->h,
+              LOG_INFO,
+              "gc: removed %d of %d blobs (%lld bytes) in %.3fs",
+              gc->removed,
+              gc->scanned,
+              (long long)gc->reclaimed,
+              gc->duration);
+    if (flux_respond_pack (gc->h,
+                           gc->request,
+                           "{s:i s:i s:i s:I s:f}",
+                           "marked", (int)zhashx_size (gc->marked),
+                           "scanned", gc->scanned,
+                           "removed", gc->removed,
+                           "reclaimed-bytes", (json_int_t)gc->reclaimed,
+                           "duration", gc->duration) < 0)
+        flux_log_error (gc->h, "gc: error responding to gc request");
+    gc_reset (gc);
+}
+
+static void gc_abort (struct content_gc *gc, int errnum, const char *what)
+{
+    flux_log (gc->h,
+              LOG_ERR,
+              "gc: aborted during %s: %s: %s",
+              state_name (gc->state),
+              what,
+              strerror (errnum));
+    if (gc->state == GC_SWEEP)
+        gc->ops->sweep_end (gc->arg);
+    if (flux_respond_error (gc->h, gc->request, errnum, NULL) < 0)
+        flux_log_error (gc->h, "gc: error responding to gc request");
+    gc_reset (gc);
+}
+
+/* Mark 'blobref' reachable.  If it refers to a directory object,
+ * queue it to be visited.  Returns 0 on success, -1 on failure.
+ */
+static int mark_blobref (struct content_gc *gc, const char *blobref, bool dir)
+{
+    char *cpy;
+
+    if (zhashx_insert (gc->marked, blobref, (void *)1) < 0)
+        return 0; // already marked
+    if (dir) {
+        if (!(cpy = strdup (blobref)))
+            return -1;
+        if (!zlistx_add_end (gc->queue, cpy)) {
+            free (cpy);
+            errno = ENOMEM;
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static int mark_treeobj (struct content_gc *gc, json_t *obj)
+{
+    bool dir = treeobj_is_dirref (obj);
+
+    if (dir || treeobj_is_valref (obj)) {
+        int count = treeobj_get_count (obj);
+        int i;
+
+        for (i = 0; i < count; i++) {
+            const char *blobref = treeobj_get_blobref (obj, i);
+            if (!blobref || mark_blobref (gc, blobref, dir) < 0)
+                return -1;
+        }
+    }
+    else if (treeobj_is_dir (obj)) {
+        json_t *data = treeobj_get_data (obj);
+        const char *name;
+        json_t *entry;
+
+        json_object_foreach (data, name, entry) {
+            if (mark_treeobj (gc, entry) < 0)
+                return -1;
+        }
+    }
+    return 0;
+}
+
+/* Visit the next queued directory object.
+ * Returns 1 if one was visited, 0 if the queue is empty, -1 on error.
+ */
+static int mark_next (struct content_gc *gc)
+{
+    char *blobref;
+    void *data;
+    int size;
+    json_t *obj = NULL;
+
+    if (!(blobref = zlistx_detach (gc->queue, NULL)))
+        return 0;
+    if (gc->ops->load (gc->arg, blobref, &data, &size) < 0) {
+        flux_log_error (gc->h, "gc: error loading %s", blobref);
+        goto error;
+    }
+    obj = treeobj_decodeb (data, size);
+    free (data);
+    if (!obj || !treeobj_is_dir (obj)) {
+        flux_log (gc->h, LOG_ERR, "gc: %s is not a directory", blobref);
+        errno = EINVAL;
+        goto error;
+    }
+    if (mark_treeobj (gc, obj) < 0)
+        goto error;
+    json_decref (obj);
+    free (blobref);
+    return 1;
+error:
+    json_decref (obj);
+    free (blobref);
+    return -1;
+}
+
+/* Examine the next stored blob and remove it if it is garbage.
+ * Returns 1 if a blob was examined, 0 when done, -1 on error.
+ */
+static int sweep_next (struct content_gc *gc)
+{
+    char blobref[BLOBREF_MAX_STRING_SIZE];
+    int size;
+    int rc;
+
+    if ((rc = gc->ops->sweep_next (gc->arg,
+                                   blobref,
+                                   sizeof (blobref),
+                                   &size)) <= 0)
+        return rc;
+    gc->scanned++;
+    if (!zhashx_lookup (gc->marked, blobref)
+        && !zhashx_lookup (gc->noted, blobref)) {
+        if (gc->ops->remove (gc->arg, blobref) < 0)
+            return -1;
+        gc->removed++;
+        gc->reclaimed += size;
+    }
+    return 1;
+}
+
+static void work_cb (flux_reactor_t *r,
+                     flux_watcher_t *w,
+                     int revents,
+                     void *arg)
+{
+    struct content_gc *gc = arg;
+    int budget;
+    int rc = 1;
+
+    if (gc->rate > 0) {
+        budget = gc->rate * work_period;
+        if (budget < 1)
+            budget = 1;
+    }
+    else
+        budget = unlimited_chunk;
+    while (budget-- > 0) {
+        if (gc->state == GC_MARK) {
+            if ((rc = mark_next (gc)) < 0) {
+                gc_abort (gc, errno, "mark");
+                return;
+            }
+            if (rc == 0) {
+                if (gc->ops->sweep_begin (gc->arg) < 0) {
+                    gc_abort (gc, errno, "sweep begin");
+                    return;
+                }
+                gc->state = GC_SWEEP;
+            }
+        }
+        else if (gc->state == GC_SWEEP) {
+            if ((rc = sweep_next (gc)) < 0) {
+                gc_abort (gc, errno, "sweep");
+                return;
+            }
+            if (rc == 0) {
+                gc->ops->sweep_end (gc->arg);
+                if (gc->compact && gc->ops->compact) {
+                    if (gc->ops->compact (gc->arg) < 0)
+                        flux_log_error (gc->h, "gc: compact");
+                }
+                gc_finish (gc);
+                return;
+            }
+        }
+    }
+    flux_timer_watcher_reset (w, gc->rate > 0 ? work_period : 0., 0.);
+    flux_watcher_start (w);
+}
+
+static void start_mark (struct content_gc *gc)
+{
+    gc->state = GC_MARK;
+    flux_timer_watcher_reset (gc->timer, 0., 0.);
+    flux_watcher_start (gc->timer);
+}
+
+static void checkpoint_continuation (flux_future_t *f, void *arg)
+{
+    struct content_gc *gc = arg;
+    const char *rootref;
+
+    if (flux_rpc_get_unpack (f, "{s:s}", "value", &rootref) < 0) {
+        if (errno != ENOENT) {
+            gc_abort (gc, errno, "kvs-checkpoint.get");
+            goto done;
+        }
+    }
+    else if (mark_blobref (gc, rootref, true) < 0) {
+        gc_abort (gc, errno, "kvs-checkpoint.get");
+        goto done;
+    }
+    start_mark (gc);
+done:
+    flux_future_destroy (f);
+}
+
+static void prepare_checkpoint (struct content_gc *gc)
+{
+    flux_future_t *f;
+
+    if (!(f = flux_rpc_pack (gc->h,
+                             "kvs-checkpoint.get",
+                             0,
+                             0,
+                             "{s:s}",
+                             "key", "kvs-primary"))
+        || flux_future_then (f, -1, checkpoint_continuation, gc) < 0) {
+        gc_abort (gc, errno, "kvs-checkpoint.get");
+        flux_future_destroy (f);
+    }
+}
+
+/* Mark the current root of each KVS namespace.
+ * If the KVS is not loaded, only the checkpoint is used.
+ */
+static void namespace_list_continuation (flux_future_t *f, void *arg)
+{
+    struct content_gc *gc = arg;
+    json_t *namespaces;
+    size_t index;
+    json_t *entry;
+
+    if (flux_rpc_get_unpack (f, "{s:o}", "namespaces", &namespaces) < 0) {
+        if (errno != ENOSYS) {
+            gc_abort (gc, errno, "kvs.namespace-list");
+            goto done;
+        }
+    }
+    else {
+        json_array_foreach (namespaces, index, entry) {
+            const char *rootref;
+
+            if (json_unpack (entry, "{s:s}", "rootref", &rootref) < 0) {
+                gc_abort (gc, EPROTO, "kvs.namespace-list");
+                goto done;
+            }
+            if (mark_blobref (gc, rootref, true) < 0) {
+                gc_abort (gc, errno, "kvs.namespace-list");
+                goto done;
+            }
+        }
+    }
+    prepare_checkpoint (gc);
+done:
+    flux_future_destroy (f);
+}
+
+static void prepare_roots (struct content_gc *gc)
+{
+    flux_future_t *f;
+
+    if (!(f = flux_rpc (gc->h, "kvs.namespace-list", NULL, 0, 0))
+        || flux_future_then (f, -1, namespace_list_continuation, gc) < 0) {
+        gc_abort (gc, errno, "kvs.namespace-list");
+        flux_future_destroy (f);
+    }
+}
+
+static void flush_continuation (flux_future_t *f, void *arg)
+{
+    struct content_gc *gc = arg;
+
+    if (flux_rpc_get (f, NULL) < 0)
+        gc_abort (gc, errno, "content.flush");
+    else
+        prepare_roots (gc);
+    flux_future_destroy (f);
+}
+
+static void prepare_flush (struct content_gc *gc)
+{
+    flux_future_t *f;
+
+    if (!(f = flux_rpc (gc->h, "content.flush", NULL, 0, 0))
+        || flux_future_then (f, -1, flush_continuation, gc) < 0) {
+        gc_abort (gc, errno, "content.flush");
+        flux_future_destroy (f);
+    }
+}
+
+static void content_dropcache_continuation (flux_future_t *f, void *arg)
+{
+    struct content_gc *gc = arg;
+
+    if (flux_rpc_get (f, NULL) < 0 && gc->errnum == 0)
+        gc->errnum = errno;
+    flux_future_destroy (f);
+    if (--gc->pending > 0)
+        return;
+    if (gc->errnum != 0)
+        gc_abort (gc, gc->errnum, "content.dropcache");
+    else
+        prepare_flush (gc);
+}
+
+/* Drop clean entries from the content cache on every rank.
+ */
+static void prepare_content_dropcache (struct content_gc *gc)
+{
+    uint32_t size;
+    uint32_t rank;
+    flux_future_t *f;
+
+    if (flux_get_size (gc->h, &size) < 0) {
+        gc_abort (gc, errno, "flux_get_size");
+        return;
+    }
+    gc->pending = 0;
+    gc->errnum = 0;
+    for (rank = 0; rank < size; rank++) {
+        if (!(f = flux_rpc (gc->h, "content.dropcache", NULL, rank, 0))
+            || flux_future_then (f,
+                                 -1,
+                                 content_dropcache_continuation,
+                                 gc) < 0) {
+            flux_future_destroy (f);
+            gc->errnum = errno;
+            break;
+        }
+        gc->pending++;
+    }
+    if (gc->pending == 0)
+        gc_abort (gc, gc->errnum, "content.dropcache");
+}
+
+/* The rank 0 KVS module does not store objects it finds in its own cache,
+ * so drop clean entries there first.
+ */
+static void kvs_dropcache_continuation (flux_future_t *f, void *arg)
+{
+    struct content_gc *gc = arg;
+
+    if (flux_rpc_get (f, NULL) < 0 && errno != ENOSYS)
+        gc_abort (gc, errno, "kvs.dropcache");
+    else
+        prepare_content_dropcache (gc);
+    flux_future_destroy (f);
+}
+
+static void prepare_kvs_dropcache (struct content_gc *gc)
+{
+    flux_future_t *f;
+
+    if (!(f = flux_rpc (gc->h, "kvs.dropcache", NULL, 0, 0))
+        || flux_future_then (f, -1, kvs_dropcache_continuation, gc) < 0) {
+        gc_abort (gc, errno, "kvs.dropcache");
+        flux_future_destroy (f);
+    }
+}
+
+void content_gc_request (struct content_gc *gc, const flux_msg_t *msg)
+{
+    int rate = 0;
+    int compact = 0;
+
+    if (flux_request_unpack (msg,
+                             NULL,
+                             "{s?i s?b}",
+                             "rate", &rate,
+                             "compact", &compact) < 0)
+        goto error;
+    if (rate < 0) {
+        errno = EINVAL;
+        goto error;
+    }
+    if (gc->state != GC_IDLE) {
+        errno = EBUSY;
+        goto error;
+    }
+    gc->request = flux_msg_incref (msg);
+    gc->rate = rate;
+    gc->compact = compact ? true : false;
+    gc->state = GC_PREPARE;
+    gc->runs++;
+    gc->scanned = 0;
+    gc->removed = 0;
+    gc->reclaimed = 0;
+    gc->duration = 0.;
+    monotime (&gc->t0);
+    flux_log (gc->h, LOG_INFO, "gc: starting");
+    prepare_kvs_dropcache (gc);
+    return;
+error:
+    if (flux_respond_error (gc->h, msg, errno, NULL) < 0)
+        flux_log_error (gc->h, "gc: error responding to gc request");
+}
+
+void content_gc_note (struct content_gc *gc, const char *blobref)
+{
+    if (gc && gc->state != GC_IDLE)
+        (void)zhashx_insert (gc->noted, blobref, (void *)1);
+}
+
+json_t *content_gc_stats (struct content_gc *gc)
+{
+    json_t *o;
+
+    if (!(o = json_pack ("{s:s s:i s:i s:i s:i s:I s:f}",
+                         "state", state_name (gc->state),
+                         "runs", gc->runs,
+                         "marked", (int)zhashx_size (gc->marked),
+                         "scanned", gc->scanned,
+                         "removed", gc->removed,
+                         "reclaimed-bytes", (json_int_t)gc->reclaimed,
+                         "duration",
+                         gc->state == GC_IDLE ? gc->duration
+                                              : monotime_since (gc->t0) * 1E-3)))
+        errno = ENOMEM;
+    return o;
+}
+
+void content_gc_destroy (struct content_gc *gc)
+{
+    if (gc) {
+        int saved_errno = errno;
+        if (gc->state != GC_IDLE)
+            gc_abort (gc, ECANCELED, "module unload");
+        flux_watcher_destroy (gc->timer);
+        zhashx_destroy (&gc->marked);
+        zhashx_destroy (&gc->noted);
+        zlistx_destroy (&gc->queue);
+        free (gc);
+        errno = saved_errno;
+    }
+}
+
+struct content_gc *content_gc_create (flux_t *h,
+                                      const struct content_gc_ops *ops,
+                                      void *arg)
+{
+    struct content_gc *gc;
+
+    if (!(gc = calloc (1, sizeof (*gc))))
+        return NULL;
+    gc->h = h;
+    gc->ops = ops;
+    gc->arg = arg;
+    if (!(gc->marked = zhashx_new ())
+        || !(gc->noted = zhashx_new ())
+        || !(gc->queue = zlistx_new ())) {
+        errno = ENOMEM;
+        goto error;
+    }
+    if (!(gc->timer = flux_timer_watcher_create (flux_get_reactor (h),
+                                                 0.,
+                                                 0.,
+                                                 work_cb,
+                                                 gc)))
+        goto error;
+    return gc;
+error:
+    content_gc_destroy (gc);
+    return NULL;
+}
+
+/*
+ * vi:ts=4 sw=4 expandtab
+ */
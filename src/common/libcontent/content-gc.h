@@ -0,0 +1,78 @@
+/************************************************************\
+ * Copyright 2021 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+/* content-gc.h - online mark and sweep garbage collection for
+ * content backing stores
+ *
+ * A collection is started by a <module>.gc request.  It first makes
+ * the content and KVS caches consistent with the backing store, then marks
+ * all blobs reachable from the KVS checkpoint and current namespace roots,
+ * then sweeps the backing store, removing unmarked blobs.  Work is performed
+ * incrementally from the reactor, at an optional rate limit (blobs/sec).
+ *
+ * While a collection is active, the backing module must call
+ * content_gc_note() for each blob loaded or stored on behalf of clients,
+ * so that blobs which become reachable again during the collection
+ * are not removed.
+ */
+
+#ifndef _FLUX_CONTENT_GC_H
+#define _FLUX_CONTENT_GC_H
+
+#include <flux/core.h>
+#include <jansson.h>
+
+struct content_gc_ops {
+    /* Load blob by blobref.  On success, 'data' is assigned a copy
+     * that the caller must free.
+     */
+    int (*load) (void *arg, const char *blobref, void **data, int *size);
+
+    /* Iterate over all stored blobs.  sweep_next() returns 1 and assigns
+     * 'blobref' and the stored 'size' in bytes, or returns 0 when there
+     * are no more blobs.  Functions return -1 on error with errno set.
+     * remove() may be called on the last blob returned by sweep_next().
+     */
+    int (*sweep_begin) (void *arg);
+    int (*sweep_next) (void *arg, char *blobref, int blobrefsz, int *size);
+    void (*sweep_end) (void *arg);
+    int (*remove) (void *arg, const char *blobref);
+
+    /* Reclaim free space after a sweep, if requested (optional).
+     */
+    int (*compact) (void *arg);
+};
+
+struct content_gc *content_gc_create (flux_t *h,
+                                      const struct content_gc_ops *ops,
+                                      void *arg);
+void content_gc_destroy (struct content_gc *gc);
+
+/* Start a collection in response to a <module>.gc request.
+ * Optional request keys are "rate" (int, blobs/sec, 0 = unlimited)
+ * and "compact" (bool).  The response is sent when collection is complete.
+ */
+void content_gc_request (struct content_gc *gc, const flux_msg_t *msg);
+
+/* Note that 'blobref' has been loaded or stored by a client.
+ * This is a no-op if collection is not active.
+ */
+void content_gc_note (struct content_gc *gc, const char *blobref);
+
+/* Get progress and summary statistics.
+ * Caller must json_decref() the returned object.
+ */
+json_t *content_gc_stats (struct content_gc *gc);
+
+#endif /* !_FLUX_CONTENT_GC_H */
+
+/*
+ * vi:ts=4 sw=4 expandtab
+ */
@@ -0,0 +1,287 @@
+/************************************************************\
+ * Copyright 2021 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+/* eventlog_index.c - incrementally decoded eventlog with name index
+ *
+ * Entries are kept in a json array in eventlog order, along with the
+ * byte offset of each entry.  For each event name, a sorted array of
+ * sequence numbers is kept, so the first occurrence of a name after a
+ * given sequence number is found with a binary search.
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <jansson.h>
+
+#include "src/common/libczmqcontainers/czmq_containers.h"
+
+#include "eventlog.h"
+#include "eventlog_index.h"
+
+struct seqlist {
+    int *seq;
+    int count;
+    int size;
+};
+
+struct eventlog_index {
+    json_t *entries;
+    size_t *offset;     // byte offset of each entry
+    int offset_size;    // allocated length of offset array
+    size_t size;        // bytes of eventlog indexed
+    zhashx_t *names;    // name => struct seqlist
+};
+
+static void seqlist_destroy (struct seqlist *sl)
+{
+    if (sl) {
+        int saved_errno = errno;
+        free (sl->seq);
+        free (sl);
+        errno = saved_errno;
+    }
+}
+
+static void seqlist_destructor (void **item)
+{
+    if (item) {
+        seqlist_destroy (*item);
+        *item = NULL;
+    }
+}
+
+static int seqlist_append (struct seqlist *sl, int seq)
+{
+    if (sl->count == sl->size) {
+        int newsize = sl->size ? sl->size * 2 : 4;
+        int *new;
+
+        if (!(new = realloc (sl->seq, newsize * sizeof (sl->seq[0])))) {
+            errno = ENOMEM;
+            return -1;
+        }
+        sl->seq = new;
+        sl->size = newsize;
+    }
+    sl->seq[sl->count++] = seq;
+    return 0;
+}
+
+/* Return the first sequence number in 'sl' greater than 'after', or -1.
+ */
+static int seqlist_find (struct seqlist *sl, int after)
+{
+    int lo = 0;
+    int hi = sl->count;
+
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (sl->seq[mid] <= after)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo < sl->count ? sl->seq[lo] : -1;
+}
+
+void eventlog_index_destroy (struct eventlog_index *idx)
+{
+    if (idx) {
+        int saved_errno = errno;
+        json_decref (idx->entries);
+        free (idx->offset);
+        zhashx_destroy (&idx->names);
+        free (idx);
+        errno = saved_errno;
+    }
+}
+
+struct eventlog_index *eventlog_index_create (void)
+{
+    struct eventlog_index *idx;
+
+    if (!(idx = calloc (1, sizeof (*idx))))
+        return NULL;
+    if (!(idx->entries = json_array ())
+        || !(idx->names = zhashx_new ()))
+        goto nomem;
+    zhashx_set_destructor (idx->names, seqlist_destructor);
+    return idx;
+nomem:
+    eventlog_index_destroy (idx);
+    errno = ENOMEM;
+    return NULL;
+}
+
+/* Decode 'entry' of length 'len' (including trailing newline) and add it
+ * to the index.
+ */
+static int index_entry (struct eventlog_index *idx,
+                        const char *entry,
+                        size_t len)
+{
+    char *s;
+    json_t *o;
+    const char *name;
+    struct seqlist *sl;
+    int seq = json_array_size (idx->entries);
+
+    if (seq == idx->offset_size) {
+        int newsize = idx->offset_size ? idx->offset_size * 2 : 16;
+        size_t *new;
+
+        if (!(new = realloc (idx->offset, newsize * sizeof (*new)))) {
+            errno = ENOMEM;
+            return -1;
+        }
+        idx->offset = new;
+        idx->offset_size = newsize;
+    }
+    if (!(s = strndup (entry, len)))
+        return -1;
+    o = eventlog_entry_decode (s);
+    free (s);
+    if (!o)
+        return -1;
+    if (eventlog_entry_parse (o, NULL, &name, NULL) < 0)
+        goto error;
+    if (!(sl = zhashx_lookup (idx->names, name))) {
+        if (!(sl = calloc (1, sizeof (*sl))))
+            goto error;
+        (void)zhashx_insert (idx->names, name, sl);
+    }
+    if (seqlist_append (sl, seq) < 0)
+        goto error;
+    if (json_array_append_new (idx->entries, o) < 0) {
+        sl->count--;
+        errno = ENOMEM;
+        return -1;
+    }
+    idx->offset[seq] = idx->size;
+    idx->size += len;
+    return seq;
+error:
+    json_decref (o);
+    return -1;
+}
+
+int eventlog_index_update (struct eventlog_index *idx, const char *s)
+{
+    const char *p;
+    const char *term;
+    size_t len;
+    int count = 0;
+
+    if (!idx || !s) {
+        errno = EINVAL;
+        return -1;
+    }
+    len = strlen (s);
+    if (len < idx->size) {
+        errno = EINVAL;
+        return -1;
+    }
+    p = s + idx->size;
+    while ((term = strchr (p, '\n'))) {
+        if (index_entry (idx, p, term - p + 1) < 0)
+            return -1;
+        p = term + 1;
+        count++;
+    }
+    return count;
+}
+
+int eventlog_index_append (struct eventlog_index *idx,
+                           size_t offset,
+                           const char *entry,
+                           size_t len)
+{
+    if (!idx || !entry || len == 0 || offset > idx->size) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (offset < idx->size) {
+        /* Already indexed, look up its sequence number by offset.
+         */
+        int lo = 0;
+        int hi = json_array_size (idx->entries);
+
+        while (lo < hi) {
+            int mid = lo + (hi - lo) / 2;
+            if (idx->offset[mid] < offset)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        if (lo == json_array_size (idx->entries)
+            || idx->offset[lo] != offset) {
+            errno = EINVAL;
+            return -1;
+        }
+        return lo;
+    }
+    return index_entry (idx, entry, len);
+}
+
+int eventlog_index_count (struct eventlog_index *idx)
+{
+    return idx ? json_array_size (idx->entries) : 0;
+}
+
+size_t eventlog_index_size (struct eventlog_index *idx)
+{
+    return idx ? idx->size : 0;
+}
+
+json_t *eventlog_index_get (struct eventlog_index *idx, int seq)
+{
+    json_t *o;
+
+    if (!idx || seq < 0 || !(o = json_array_get (idx->entries, seq))) {
+        errno = ENOENT;
+        return NULL;
+    }
+    return o;
+}
+
+int eventlog_index_find (struct eventlog_index *idx,
+                         const char *name,
+                         int after)
+{
+    struct seqlist *sl;
+    int seq;
+
+    if (!idx) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (after < -1)
+        after = -1;
+    if (!name) {
+        if (after + 1 < json_array_size (idx->entries))
+            return after + 1;
+        errno = ENOENT;
+        return -1;
+    }
+    if (!(sl = zhashx_lookup (idx->names, name))
+        || (seq = seqlist_find (sl, after)) < 0) {
+        errno = ENOENT;
+        return -1;
+    }
+    return seq;
+}
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
@@ -0,0 +1,80 @@
+/************************************************************\
+ * Copyright 2021 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#ifndef _EVENTLOG_INDEX_H
+#define _EVENTLOG_INDEX_H
+
+#include <jansson.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* An eventlog_index holds the decoded entries of an append-only eventlog,
+ * along with an index of event name to entry sequence numbers.  Entries
+ * are numbered from zero in the order they appear in the eventlog.
+ * As the eventlog grows, only newly appended entries are decoded.
+ */
+struct eventlog_index;
+
+struct eventlog_index *eventlog_index_create (void);
+void eventlog_index_destroy (struct eventlog_index *idx);
+
+/* Index any entries of eventlog 's' beyond those already indexed.
+ * 's' must be the previously indexed eventlog with zero or more entries
+ * appended (only its length is checked).  Returns the number of new
+ * entries, or -1 on error with errno set (EINVAL if 's' is shorter than
+ * what was indexed or an entry could not be decoded).
+ */
+int eventlog_index_update (struct eventlog_index *idx, const char *s);
+
+/* Index one eventlog entry 'entry' of length 'len' including its trailing
+ * newline, found at byte 'offset' of the eventlog.  If the entry is
+ * already indexed, it is not decoded again.  Returns its sequence number,
+ * or -1 on error with errno set (EINVAL if 'offset' is beyond the end of
+ * what was indexed, or the entry could not be decoded).
+ */
+int eventlog_index_append (struct eventlog_index *idx,
+                           size_t offset,
+                           const char *entry,
+                           size_t len);
+
+/* Return the number of indexed entries.
+ */
+int eventlog_index_count (struct eventlog_index *idx);
+
+/* Return the length in bytes of the indexed portion of the eventlog.
+ */
+size_t eventlog_index_size (struct eventlog_index *idx);
+
+/* Return the entry with sequence number 'seq' (borrowed reference),
+ * or NULL with errno = ENOENT if there is no such entry.
+ */
+json_t *eventlog_index_get (struct eventlog_index *idx, int seq);
+
+/* Return the sequence number of the first entry named 'name' with
+ * sequence number greater than 'after' (-1 to search from the beginning),
+ * or -1 with errno = ENOENT if no such entry has been indexed.
+ * If 'name' is NULL, return the first entry after 'after' regardless
+ * of name.
+ */
+int eventlog_index_find (struct eventlog_index *idx,
+                         const char *name,
+                         int after);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* !_EVENTLOG_INDEX_H */
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
@@ -0,0 +1,151 @@
+/************************************************************\
+ * Copyright 2021 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#include <errno.h>
+#include <string.h>
+
+#include "src/common/libtap/tap.h"
+#include "src/common/libeventlog/eventlog.h"
+#include "src/common/libeventlog/eventlog_index.h"
+
+#define E_SUBMIT "{\"timestamp\":1.0,\"name\":\"submit\"}\n"
+#define E_START "{\"timestamp\":2.0,\"name\":\"start\"}\n"
+#define E_FOO "{\"timestamp\":3.0,\"name\":\"foo\",\"context\":{\"n\":1}}\n"
+#define E_FOO2 "{\"timestamp\":4.0,\"name\":\"foo\",\"context\":{\"n\":2}}\n"
+#define E_CLEAN "{\"timestamp\":5.0,\"name\":\"clean\"}\n"
+
+static const char *entry_name (struct eventlog_index *idx, int seq)
+{
+    const char *name = NULL;
+    (void)eventlog_entry_parse (eventlog_index_get (idx, seq),
+                                NULL,
+                                &name,
+                                NULL);
+    return name;
+}
+
+void index_update (void)
+{
+    struct eventlog_index *idx;
+
+    if (!(idx = eventlog_index_create ()))
+        BAIL_OUT ("eventlog_index_create failed");
+    ok (eventlog_index_count (idx) == 0 && eventlog_index_size (idx) == 0,
+        "new index is empty");
+    ok (eventlog_index_update (idx, "") == 0,
+        "eventlog_index_update of empty eventlog works");
+    ok (eventlog_index_update (idx, E_SUBMIT E_START) == 2,
+        "eventlog_index_update indexes 2 entries");
+    ok (eventlog_index_size (idx) == strlen (E_SUBMIT E_START),
+        "eventlog_index_size is length of eventlog");
+    ok (eventlog_index_update (idx, E_SUBMIT E_START) == 0,
+        "eventlog_index_update of same eventlog indexes nothing new");
+    ok (eventlog_index_update (idx, E_SUBMIT E_START E_FOO E_FOO2) == 2,
+        "eventlog_index_update of appended eventlog indexes only new entries");
+    ok (eventlog_index_count (idx) == 4,
+        "eventlog_index_count is 4");
+    ok (entry_name (idx, 0) && !strcmp (entry_name (idx, 0), "submit")
+        && entry_name (idx, 3) && !strcmp (entry_name (idx, 3), "foo"),
+        "eventlog_index_get returns entries in order");
+    errno = 0;
+    ok (eventlog_index_get (idx, 4) == NULL && errno == ENOENT,
+        "eventlog_index_get seq=count fails with ENOENT");
+    errno = 0;
+    ok (eventlog_index_update (idx, E_SUBMIT) < 0 && errno == EINVAL,
+        "eventlog_index_update of truncated eventlog fails with EINVAL");
+    eventlog_index_destroy (idx);
+}
+
+void index_find (void)
+{
+    struct eventlog_index *idx;
+
+    if (!(idx = eventlog_index_create ()))
+        BAIL_OUT ("eventlog_index_create failed");
+    if (eventlog_index_update (idx, E_SUBMIT E_FOO E_START E_FOO2) != 4)
+        BAIL_OUT ("eventlog_index_update failed");
+
+    ok (eventlog_index_find (idx, "start", -1) == 2,
+        "eventlog_index_find start returns seq 2");
+    ok (eventlog_index_find (idx, "foo", -1) == 1,
+        "eventlog_index_find foo returns first foo");
+    ok (eventlog_index_find (idx, "foo", 1) == 3,
+        "eventlog_index_find foo after 1 returns second foo");
+    errno = 0;
+    ok (eventlog_index_find (idx, "foo", 3) < 0 && errno == ENOENT,
+        "eventlog_index_find foo after last foo fails with ENOENT");
+    errno = 0;
+    ok (eventlog_index_find (idx, "clean", -1) < 0 && errno == ENOENT,
+        "eventlog_index_find of missing name fails with ENOENT");
+    ok (eventlog_index_find (idx, NULL, 1) == 2,
+        "eventlog_index_find name=NULL returns next entry");
+    errno = 0;
+    ok (eventlog_index_find (idx, NULL, 3) < 0 && errno == ENOENT,
+        "eventlog_index_find name=NULL after last entry fails with ENOENT");
+
+    if (eventlog_index_update (idx, E_SUBMIT E_FOO E_START E_FOO2 E_CLEAN) != 1)
+        BAIL_OUT ("eventlog_index_update failed");
+    ok (eventlog_index_find (idx, "clean", -1) == 4,
+        "eventlog_index_find finds appended entry");
+    eventlog_index_destroy (idx);
+}
+
+void index_append (void)
+{
+    struct eventlog_index *idx;
+    size_t off;
+
+    if (!(idx = eventlog_index_create ()))
+        BAIL_OUT ("eventlog_index_create failed");
+
+    ok (eventlog_index_append (idx, 0, E_SUBMIT, strlen (E_SUBMIT)) == 0,
+        "eventlog_index_append at offset 0 returns seq 0");
+    off = strlen (E_SUBMIT);
+    ok (eventlog_index_append (idx, off, E_START, strlen (E_START)) == 1,
+        "eventlog_index_append at end returns seq 1");
+    ok (eventlog_index_append (idx, 0, E_SUBMIT, strlen (E_SUBMIT)) == 0,
+        "eventlog_index_append of indexed entry returns its seq");
+    ok (eventlog_index_append (idx, off, E_START, strlen (E_START)) == 1
+        && eventlog_index_count (idx) == 2,
+        "eventlog_index_append of indexed entry does not add it again");
+    errno = 0;
+    ok (eventlog_index_append (idx, 1, E_START, strlen (E_START)) < 0
+        && errno == EINVAL,
+        "eventlog_index_append at offset within an entry fails with EINVAL");
+    errno = 0;
+    ok (eventlog_index_append (idx, 1000, E_FOO, strlen (E_FOO)) < 0
+        && errno == EINVAL,
+        "eventlog_index_append past end fails with EINVAL");
+    errno = 0;
+    off = eventlog_index_size (idx);
+    ok (eventlog_index_append (idx, off, "foo\n", 4) < 0 && errno == EINVAL,
+        "eventlog_index_append of invalid entry fails with EINVAL");
+    ok (eventlog_index_count (idx) == 2 && eventlog_index_size (idx) == off,
+        "failed eventlog_index_append leaves index unchanged");
+    ok (eventlog_index_update (idx, E_SUBMIT E_START E_FOO) == 1
+        && eventlog_index_find (idx, "foo", -1) == 2,
+        "eventlog_index_update continues after eventlog_index_append");
+    eventlog_index_destroy (idx);
+}
+
+int main (int argc, char *argv[])
+{
+    plan (NO_PLAN);
+
+    index_update ();
+    index_find ();
+    index_append ();
+
+    done_testing ();
+}
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
@@ -19,6 +19,7 @@
 #include "content.h"
 
 #include "src/common/libutil/blobref.h"
+#include "src/common/libutil/blobvec.h"
 
 flux_future_t *flux_content_load (flux_t *h, const char *blobref, int flags)
 {
@@ -73,6 +74,186 @@ int flux_content_store_get (flux_future_t *f, const char **blobref)
     return 0;
 }
 
+static void batch_topic (int flags,
+                         const char *method,
+                         char *topic,
+                         size_t topicsz,
+                         uint32_t *rank)
+{
+    const char *service = "content";
+
+    *rank = FLUX_NODEID_ANY;
+    if ((flags & CONTENT_FLAG_UPSTREAM))
+        *rank = FLUX_NODEID_UPSTREAM;
+    if ((flags & CONTENT_FLAG_CACHE_BYPASS)) {
+        service = "content-backing";
+        *rank = 0;
+    }
+    (void)snprintf (topic, topicsz, "%s.%s", service, method);
+}
+
+static flux_future_t *batch_rpc (flux_t *h,
+                                 const char *method,
+                                 struct blobvec *bv,
+                                 int flags)
+{
+    char topic[64];
+    uint32_t rank;
+    const void *buf;
+    int len;
+
+    batch_topic (flags, method, topic, sizeof (topic), &rank);
+    if (blobvec_encode (bv, &buf, &len) < 0)
+        return NULL;
+    return flux_rpc_raw (h, topic, buf, len, rank, 0);
+}
+
+/* Decode the batch response on first access and cache it in the future.
+ */
+static struct blobvec *batch_response (flux_future_t *f)
+{
+    const char *auxkey = "flux::content_batch";
+    struct blobvec *bv;
+    const void *buf;
+    int len;
+
+    if (!(bv = flux_future_aux_get (f, auxkey))) {
+        if (flux_rpc_get_raw (f, &buf, &len) < 0)
+            return NULL;
+        if (!(bv = blobvec_decode (buf, len)))
+            return NULL;
+        if (flux_future_aux_set (f,
+                                 auxkey,
+                                 bv,
+                                 (flux_free_f)blobvec_destroy) < 0) {
+            blobvec_destroy (bv);
+            return NULL;
+        }
+    }
+    return bv;
+}
+
+flux_future_t *flux_content_load_batch (flux_t *h,
+                                        const char **blobrefs,
+                                        int count,
+                                        int flags)
+{
+    struct blobvec *bv;
+    flux_future_t *f;
+    int i;
+
+    if (!h || !blobrefs || count < 0) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if (!(bv = blobvec_create ()))
+        return NULL;
+    for (i = 0; i < count; i++) {
+        if (!blobrefs[i] || blobref_validate (blobrefs[i]) < 0) {
+            errno = EINVAL;
+            goto error;
+        }
+        if (blobvec_append (bv,
+                            0,
+                            blobrefs[i],
+                            strlen (blobrefs[i]) + 1) < 0)
+            goto error;
+    }
+    if (!(f = batch_rpc (h, "load-batch", bv, flags)))
+        goto error;
+    blobvec_destroy (bv);
+    return f;
+error:
+    blobvec_destroy (bv);
+    return NULL;
+}
+
+int flux_content_load_batch_get (flux_future_t *f,
+                                 int index,
+                                 const void **buf,
+                                 int *len)
+{
+    struct blobvec *bv;
+    int errnum;
+
+    if (!(bv = batch_response (f)))
+        return -1;
+    if (index < 0 || index >= blobvec_count (bv)) {
+        errno = EPROTO;
+        return -1;
+    }
+    if (blobvec_get (bv, index, &errnum, buf, len) < 0)
+        return -1;
+    if (errnum != 0) {
+        errno = errnum;
+        return -1;
+    }
+    return 0;
+}
+
+flux_future_t *flux_content_store_batch (flux_t *h,
+                                         const void **bufs,
+                                         const int *lens,
+                                         int count,
+                                         int flags)
+{
+    struct blobvec *bv;
+    flux_future_t *f;
+    int i;
+
+    if (!h || !bufs || !lens || count < 0) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if (!(bv = blobvec_create ()))
+        return NULL;
+    for (i = 0; i < count; i++) {
+        if (blobvec_append (bv, 0, bufs[i], lens[i]) < 0)
+            goto error;
+    }
+    if (!(f = batch_rpc (h, "store-batch", bv, flags)))
+        goto error;
+    blobvec_destroy (bv);
+    return f;
+error:
+    blobvec_destroy (bv);
+    return NULL;
+}
+
+int flux_content_store_batch_get (flux_future_t *f,
+                                  int index,
+                                  const char **blobref)
+{
+    struct blobvec *bv;
+    int errnum;
+    const char *ref;
+    int ref_size;
+
+    if (!(bv = batch_response (f)))
+        return -1;
+    if (index < 0 || index >= blobvec_count (bv)) {
+        errno = EPROTO;
+        return -1;
+    }
+    if (blobvec_get (bv,
+                     index,
+                     &errnum,
+                     (const void **)&ref,
+                     &ref_size) < 0)
+        return -1;
+    if (errnum != 0) {
+        errno = errnum;
+        return -1;
+    }
+    if (!ref || ref[ref_size - 1] != '\0' || blobref_validate (ref) < 0) {
+        errno = EPROTO;
+        return -1;
+    }
+    if (blobref)
+        *blobref = ref;
+    return 0;
+}
+
 /*
  * vi:tabstop=4 shiftwidth=4 expandtab
  */
@@ -50,6 +50,12 @@ struct metric {
     union val prev;
     bool inc;
     metric_type type;
+
+    /* Timer samples recorded in the current period.
+     */
+    int count;
+    double sum;
+    double max;
 };
 
 struct fripp_ctx {
@@ -267,22 +273,59 @@ int fripp_timing (struct fripp_ctx *ctx,
     struct metric *m;
 
     if (!(m = zhashx_lookup (ctx->metrics, name))) {
-        if (!(m = malloc (sizeof (*m))))
+        if (!(m = calloc (1, sizeof (*m))))
             return -1;
 
         zhashx_insert (ctx->metrics, name, (void *) m);
-        m->prev.d = -1.0;
     }
 
     m->type = BRUBECK_TIMER;
     m->inc = false;
-    m->cur.d = ms;
+    if (m->count == 0 || ms > m->max)
+        m->max = ms;
+    m->sum += ms;
+    m->count++;
 
     flux_watcher_start (ctx->w);
 
     return 0;
 }
 
+/* Send the timer samples recorded in this period as their mean, with a
+ * statsd sample rate of 1/count so that the receiver accounts for every
+ * sample in its count and sum, followed by their maximum as a gauge.
+ */
+static int timer_append (struct fripp_ctx *ctx,
+                         const char *name,
+                         struct metric *m)
+{
+    int rc;
+
+    if (m->count == 1)
+        rc = fripp_packet_appendf (ctx,
+                                   "%s.%s:%lf|ms\n",
+                                   ctx->prefix,
+                                   name,
+                                   m->sum);
+    else
+        rc = fripp_packet_appendf (ctx,
+                                   "%s.%s:%lf|ms|@%.9g\n",
+                                   ctx->prefix,
+                                   name,
+                                   m->sum / m->count,
+                                   1. / m->count);
+    if (rc == 0)
+        rc = fripp_packet_appendf (ctx,
+                                   "%s.%s.max:%lf|g\n",
+                                   ctx->prefix,
+                                   name,
+                                   m->max);
+    m->count = 0;
+    m->sum = 0.;
+    m->max = 0.;
+    return rc;
+}
+
 static void metric_destroy (void **item)
 {
     if (item) {
@@ -318,7 +361,7 @@ static void timer_cb (flux_reactor_t *r,
             zlist_append (ctx->done, (void *) name);
             continue;
         }
-        if (m->type == BRUBECK_TIMER && m->cur.d == m->prev.d) {
+        if (m->type == BRUBECK_TIMER && m->count == 0) {
             zlist_append (ctx->done, (void *) name);
             continue;
         }
@@ -341,11 +384,7 @@ static void timer_cb (flux_reactor_t *r,
                                            m->cur.l);
                 break;
             case BRUBECK_TIMER:
-                rc = fripp_packet_appendf (ctx,
-                                           "%s.%s:%lf|ms\n",
-                                           ctx->prefix,
-                                           name,
-                                           m->cur.d);
+                rc = timer_append (ctx, name, m);
                 break;
             default:
                 break;
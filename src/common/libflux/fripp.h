@@ -43,8 +43,10 @@ int fripp_count (struct fripp_ctx *ctx, const char *name, ssize_t count);
  */
 int fripp_gauge (struct fripp_ctx *ctx, const char *name, ssize_t value, bool inc);
 
-/* Update (or create) and store 'ms' for 'name' to be sent on the
- * next flush.
+/* Record a sample of 'ms' for 'name'.  Samples are aggregated until the
+ * next flush, which sends their mean with a sample rate of 1/count, so the
+ * statsd receiver sees the true count and sum, and their maximum as the
+ * gauge 'name'.max.
  */
 int fripp_timing (struct fripp_ctx *ctx, const char *name, double ms);
 
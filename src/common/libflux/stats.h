@@ -29,7 +29,9 @@
  *           size of the broker's content-cache. At each point, the cache's
  *           sizes are independent of each other.
  * Timing  - A double value which represents the time taken for a given
- *           task in ms.
+ *           task in ms.  Every sample is accounted for:  samples taken
+ *           within an aggregation period are sent as their mean with a
+ *           sample rate of 1/count, plus their maximum as a '.max' gauge.
  *           An example of where to use a timer is timing the length of
  *           asynchronous loads in the broker's content-cache. The cache
  *           entry can keep track of when the load was started and then
@@ -53,8 +55,7 @@ void flux_stats_gauge_set (flux_t *h, const char *name, ssize_t value);
 void flux_stats_gauge_inc (flux_t *h, const char *name, ssize_t inc);
 
 
-/* Update (or create) and store 'ms' for 'name' to be sent on the
- * next flush.
+/* Record a sample of 'ms' for 'name' to be sent on the next flush.
  */
 void flux_stats_timing (flux_t *h, const char *name, double ms);
 
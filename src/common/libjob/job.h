@@ -24,6 +24,8 @@ enum job_submit_flags {
     FLUX_JOB_DEBUG = 2,
     FLUX_JOB_WAITABLE = 4,      // flux_job_wait() will be used on this job
     FLUX_JOB_NOVALIDATE = 8,    // don't validate jobspec (instance owner only)
+    FLUX_JOB_SHARED_SIGNATURE = 16, // sign jobs of bulk submit once
+                                    //   (instance owner only)
 };
 
 enum job_urgency {
@@ -115,6 +117,28 @@ flux_future_t *flux_job_submit (flux_t *h, const char *jobspec,
  */
 int flux_job_submit_get_id (flux_future_t *f, flux_jobid_t *id);
 
+/* Submit 'count' jobs to the system in one request.
+ * 'urgency' and 'flags' apply to all jobs, as for flux_job_submit().
+ * With FLUX_JOB_SHARED_SIGNATURE, one signature covers all jobs,
+ * which is only permitted for the instance owner.
+ */
+flux_future_t *flux_job_submit_bulk (flux_t *h,
+                                     int count,
+                                     const char **jobspecs,
+                                     int urgency,
+                                     int flags);
+
+/* Parse jobid of job 'index' from response to flux_job_submit_bulk().
+ * Returns 0 on success, -1 on failure with errno set.  If the job
+ * failed, 'errmsg' (if non-NULL) is set to a description of the error.
+ * If the request as a whole failed, an extended error message may be
+ * available with flux_future_error_string().
+ */
+int flux_job_submit_bulk_get_id (flux_future_t *f,
+                                 int index,
+                                 flux_jobid_t *id,
+                                 const char **errmsg);
+
 /* Wait for jobid to enter INACTIVE state.
  * If jobid=FLUX_JOBID_ANY, wait for the next waitable job.
  * Fails with ECHILD if there is nothing to wait for.
@@ -13,12 +13,13 @@
 #endif
 #include <unistd.h>
 #include <sys/types.h>
+#include <string.h>
 //#include <ctype.h>
 #include <flux/core.h>
 #if HAVE_FLUX_SECURITY
 #include <flux/security/sign.h>
 #endif
-//#include <jansson.h>
+#include <jansson.h>
 
 #include "job.h"
 #include "sign_none.h"
@@ -70,6 +71,52 @@ error:
 }
 #endif
 
+/* Sign 'payload' of length 'len' and return the result in 'J',
+ * which the caller must free.  On failure, return -1 and set the value
+ * of 'f_error' to NULL, or to a future containing a textual error.
+ */
+static int sign_wrap (flux_t *h,
+                      const char *payload,
+                      int len,
+                      char **J,
+                      flux_future_t **f_error)
+{
+    char *s;
+
+    *f_error = NULL;
+#if HAVE_FLUX_SECURITY
+    flux_security_t *sec;
+    const char *mech = NULL;
+    const char *signed_J;
+    uint32_t owner;
+
+    /* Security note:
+     * Instance owner jobs do not need a cryptographic signature since
+     * they do not require the IMP to be executed.  Force the signing
+     * mechanism to 'none' if the connector can provide owner userid and
+     * owner == getuid().  This side-steps the requirement that the
+     * munge daemon is running for single user instances compiled
+     * --with-flux-security, as described in flux-framework/flux-core#3305.
+     */
+    if (flux_opt_get (h, "flux::owner", &owner, sizeof (owner)) == 0
+            && getuid () == owner)
+        mech = "none";
+    if (!(sec = get_security_ctx (h, f_error)))
+        return -1;
+    if (!(signed_J = flux_sign_wrap (sec, payload, len, mech, 0))) {
+        *f_error = get_security_error (sec);
+        return -1;
+    }
+    if (!(s = strdup (signed_J)))
+        return -1;
+#else
+    if (!(s = sign_none_wrap (payload, len, getuid ())))
+        return -1;
+#endif
+    *J = s;
+    return 0;
+}
+
 flux_future_t *flux_job_submit (flux_t *h, const char *jobspec, int urgency,
                                 int flags)
 {
@@ -83,31 +130,9 @@ flux_future_t *flux_job_submit (flux_t *h, const char *jobspec, int urgency,
         return NULL;
     }
     if (!(flags & FLUX_JOB_PRE_SIGNED)) {
-#if HAVE_FLUX_SECURITY
-        flux_security_t *sec;
-        const char *mech = NULL;
-        uint32_t owner;
-
-        /* Security note:
-         * Instance owner jobs do not need a cryptographic signature since
-         * they do not require the IMP to be executed.  Force the signing
-         * mechanism to 'none' if the connector can provide owner userid and
-         * owner == getuid().  This side-steps the requirement that the
-         * munge daemon is running for single user instances compiled
-         * --with-flux-security, as described in flux-framework/flux-core#3305.
-         */
-        if (flux_opt_get (h, "flux::owner", &owner, sizeof (owner)) == 0
-                && getuid () == owner)
-            mech = "none";
-        if (!(sec = get_security_ctx (h, &f)))
+        if (sign_wrap (h, jobspec, strlen (jobspec), &s, &f) < 0)
             return f;
-        if (!(J = flux_sign_wrap (sec, jobspec, strlen (jobspec), mech, 0)))
-            return get_security_error (sec);
-#else
-        if (!(s = sign_none_wrap (jobspec, strlen (jobspec), getuid ())))
-            goto error;
         J = s;
-#endif
     }
     else {
         J = jobspec;
@@ -119,6 +144,7 @@ flux_future_t *flux_job_submit (flux_t *h, const char *jobspec, int urgency,
                              "urgency", urgency,
                              "flags", flags)))
         goto error;
+    free (s);
     return f;
 error:
     saved_errno = errno;
@@ -127,6 +153,140 @@ error:
     return NULL;
 }
 
+/* Append 'jobspec' to 'jobs', signing it first if 'sign' is true.
+ */
+static int append_job (flux_t *h,
+                       json_t *jobs,
+                       const char *jobspec,
+                       bool sign,
+                       flux_future_t **f_error)
+{
+    char *s = NULL;
+    json_t *o;
+
+    if (sign && sign_wrap (h, jobspec, strlen (jobspec), &s, f_error) < 0)
+        return -1;
+    if (!(o = json_string (s ? s : jobspec))
+        || json_array_append_new (jobs, o) < 0) {
+        free (s);
+        errno = ENOMEM;
+        return -1;
+    }
+    free (s);
+    return 0;
+}
+
+flux_future_t *flux_job_submit_bulk (flux_t *h,
+                                     int count,
+                                     const char **jobspecs,
+                                     int urgency,
+                                     int flags)
+{
+    flux_future_t *f = NULL;
+    json_t *jobs;
+    char *payload = NULL;
+    char *J = NULL;
+    bool sign;
+    int i;
+    int saved_errno;
+
+    if (!h || count < 0 || (count > 0 && !jobspecs)
+        || ((flags & FLUX_JOB_SHARED_SIGNATURE)
+            && (flags & FLUX_JOB_PRE_SIGNED))) {
+        errno = EINVAL;
+        return NULL;
+    }
+    /* With a shared signature, jobspecs are collected unsigned
+     * and the array as a whole is signed below.
+     */
+    sign = !(flags & (FLUX_JOB_PRE_SIGNED | FLUX_JOB_SHARED_SIGNATURE));
+    if (!(jobs = json_array ())) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    for (i = 0; i < count; i++) {
+        if (!jobspecs[i]) {
+            errno = EINVAL;
+            goto error;
+        }
+        if (append_job (h, jobs, jobspecs[i], sign, &f) < 0)
+            goto error;
+    }
+    if ((flags & FLUX_JOB_SHARED_SIGNATURE)) {
+        if (!(payload = json_dumps (jobs, JSON_COMPACT))) {
+            errno = ENOMEM;
+            goto error;
+        }
+        if (sign_wrap (h, payload, strlen (payload), &J, &f) < 0)
+            goto error;
+        flags &= ~FLUX_JOB_SHARED_SIGNATURE; // client only flag
+        f = flux_rpc_pack (h, "job-ingest.submit-bulk", FLUX_NODEID_ANY, 0,
+                           "{s:s s:i s:i}",
+                           "J", J,
+                           "urgency", urgency,
+                           "flags", flags);
+    }
+    else {
+        flags &= ~FLUX_JOB_PRE_SIGNED; // client only flag
+        f = flux_rpc_pack (h, "job-ingest.submit-bulk", FLUX_NODEID_ANY, 0,
+                           "{s:O s:i s:i}",
+                           "jobs", jobs,
+                           "urgency", urgency,
+                           "flags", flags);
+    }
+    if (!f)
+        goto error;
+    free (J);
+    free (payload);
+    json_decref (jobs);
+    return f;
+error:
+    saved_errno = errno;
+    free (J);
+    free (payload);
+    json_decref (jobs);
+    errno = saved_errno;
+    return f;
+}
+
+int flux_job_submit_bulk_get_id (flux_future_t *f,
+                                 int index,
+                                 flux_jobid_t *jobid,
+                                 const char **errmsg)
+{
+    json_t *results;
+    json_t *result;
+    flux_jobid_t id;
+    const char *s = NULL;
+    int errnum;
+
+    if (!f || index < 0) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (flux_rpc_get_unpack (f, "{s:o}", "results", &results) < 0)
+        return -1;
+    if (!(result = json_array_get (results, index))) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (json_unpack (result, "{s:i s?s}",
+                     "errnum", &errnum,
+                     "errmsg", &s) == 0) {
+        if (errmsg)
+            *errmsg = s;
+        errno = errnum;
+        return -1;
+    }
+    if (json_unpack (result, "{s:I}", "id", &id) < 0) {
+        errno = EPROTO;
+        return -1;
+    }
+    if (jobid)
+        *jobid = id;
+    return 0;
+}
+
 int flux_job_submit_get_id (flux_future_t *f, flux_jobid_t *jobid)
 {
     flux_jobid_t id;
@@ -114,6 +114,32 @@ void check_corner_case (void)
     ok (flux_job_submit_get_id (NULL, NULL) < 0 && errno == EINVAL,
         "flux_job_submit_get_id with NULL args fails with EINVAL");
 
+    /* flux_job_submit_bulk */
+
+    errno = 0;
+    ok (flux_job_submit_bulk (NULL, 0, NULL, 0, 0) == NULL && errno == EINVAL,
+        "flux_job_submit_bulk h=NULL fails with EINVAL");
+
+    errno = 0;
+    ok (flux_job_submit_bulk (h, -1, NULL, 0, 0) == NULL && errno == EINVAL,
+        "flux_job_submit_bulk count=-1 fails with EINVAL");
+
+    errno = 0;
+    ok (flux_job_submit_bulk (h, 1, NULL, 0, 0) == NULL && errno == EINVAL,
+        "flux_job_submit_bulk count=1 jobspecs=NULL fails with EINVAL");
+
+    errno = 0;
+    ok (flux_job_submit_bulk (h, 0, NULL, 0,
+                              FLUX_JOB_PRE_SIGNED
+                              | FLUX_JOB_SHARED_SIGNATURE) == NULL
+        && errno == EINVAL,
+        "flux_job_submit_bulk PRE_SIGNED|SHARED_SIGNATURE fails with EINVAL");
+
+    errno = 0;
+    ok (flux_job_submit_bulk_get_id (NULL, 0, NULL, NULL) < 0
+        && errno == EINVAL,
+        "flux_job_submit_bulk_get_id f=NULL fails with EINVAL");
+
     /* flux_job_list */
 
     errno = 0;
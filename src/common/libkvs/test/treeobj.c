@@ -283,6 +283,51 @@ void test_dirref (void)
     json_decref (dirref);
 }
 
+void test_dirref_index (void)
+{
+    char name[32];
+    int count[5] = { 0 };
+    int i, n;
+    bool inrange = true;
+    bool stable = true;
+
+    errno = 0;
+    ok (treeobj_dirref_index (NULL, 1) < 0 && errno == EINVAL,
+        "treeobj_dirref_index name=NULL fails with EINVAL");
+    errno = 0;
+    ok (treeobj_dirref_index ("foo", 0) < 0 && errno == EINVAL,
+        "treeobj_dirref_index count=0 fails with EINVAL");
+    ok (treeobj_dirref_index ("foo", 1) == 0,
+        "treeobj_dirref_index count=1 returns 0");
+
+    /* Splitting bucket 1 of 5 buckets (level 4) adds bucket 5.
+     * Names in other buckets must not move.
+     */
+    for (i = 0; i < 1000; i++) {
+        int a, b;
+        snprintf (name, sizeof (name), "key%d", i);
+        a = treeobj_dirref_index (name, 5);
+        b = treeobj_dirref_index (name, 6);
+        if (a < 0 || a >= 5 || b < 0 || b >= 6)
+            inrange = false;
+        else {
+            count[a]++;
+            if (a != b && !(a == 1 && b == 5))
+                stable = false;
+        }
+    }
+    ok (inrange,
+        "treeobj_dirref_index returns index in range");
+    ok (stable,
+        "treeobj_dirref_index only moves names from the split bucket");
+    for (i = 0, n = 0; i < 5; i++) {
+        if (count[i] > 0)
+            n++;
+    }
+    ok (n == 5,
+        "treeobj_dirref_index uses all buckets");
+}
+
 void test_dir (void)
 {
     json_t *dir;
@@ -809,6 +854,7 @@ int main(int argc, char** argv)
     test_val ();
     test_dirref ();
     test_dir ();
+    test_dirref_index ();
     test_dir_peek ();
     test_copy ();
     test_deep_copy ();
@@ -17,6 +17,7 @@
 #include <string.h>
 #include <assert.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <jansson.h>
 
 #include "src/common/libccan/ccan/base64/base64.h"
@@ -471,6 +472,34 @@ json_t *treeobj_create_dir (void)
     return obj;
 }
 
+/* Buckets are addressed by linear hashing of the entry name (FNV-1a).
+ * With 'count' buckets, let 'level' be the largest power of two <= count.
+ * Buckets [0, count - level) have been split, so names that hash below
+ * that use one more bit of the hash.
+ */
+int treeobj_dirref_index (const char *name, int count)
+{
+    const unsigned char *p = (const unsigned char *)name;
+    uint32_t hash = 2166136261u;
+    uint32_t level = 1;
+    uint32_t index;
+
+    if (!name || count < 1) {
+        errno = EINVAL;
+        return -1;
+    }
+    while (*p) {
+        hash ^= *p++;
+        hash *= 16777619u;
+    }
+    while (level * 2 <= (uint32_t)count)
+        level *= 2;
+    index = hash & (level - 1);
+    if (index < (uint32_t)count - level)
+        index = hash & (level * 2 - 1);
+    return index;
+}
+
 json_t *treeobj_create_symlink (const char *ns, const char *target)
 {
     json_t *data, *obj;
@@ -29,6 +29,19 @@ json_t *treeobj_create_valref (const char *blobref);
 json_t *treeobj_create_dir (void);
 json_t *treeobj_create_dirref (const char *blobref);
 
+/* Get the index of the blobref in a dirref with 'count' blobrefs that
+ * refers to the dir object holding 'name'.
+ * A large directory may be stored as a dirref with more than one blobref,
+ * each referring to a dir object ("bucket") holding the entries whose
+ * names hash to it, so that changing one entry rewrites one bucket.
+ * Buckets are addressed by linear hashing, so the directory grows by
+ * splitting bucket (count - L), where L is the largest power of two
+ * <= count, into itself and a new bucket appended at index count.
+ * A dirref with one blobref is an ordinary directory (index is always 0).
+ * Return index on success, -1 on error with errno = EINVAL.
+ */
+int treeobj_dirref_index (const char *name, int count);
+
 /* Validate treeobj, recursively.
  * Return 0 if valid, -1 with errno = EINVAL if invalid.
  */
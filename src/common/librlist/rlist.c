@@ -29,6 +29,144 @@
 
 static int by_rank (const void *item1, const void *item2);
 
+/*  Index of free resources, used to choose nodes for allocation without
+ *   sorting the node list.  Nodes are identified by their position in
+ *   rank order.  Up nodes are kept in buckets by available core count,
+ *   and a set of up nodes with any available cores is kept for first-fit.
+ *
+ *  The index is built on demand by rlist_alloc(), and updated
+ *   incrementally as cores are allocated and freed, and nodes marked
+ *   up or down.  Any other change to rl->nodes invalidates it.
+ */
+struct rlist_index {
+    int size;
+    struct rnode **nodes;       // sorted by rank
+    int *avail;                 // available cores by position, -1 if down
+    int maxavail;
+    struct idset **buckets;     // positions of up nodes by avail count
+    struct idset *free;         // positions of up nodes with avail > 0
+};
+
+static void rlist_index_destroy (struct rlist_index *idx)
+{
+    if (idx) {
+        int saved_errno = errno;
+        if (idx->buckets) {
+            for (int i = 0; i <= idx->maxavail; i++)
+                idset_destroy (idx->buckets[i]);
+            free (idx->buckets);
+        }
+        idset_destroy (idx->free);
+        free (idx->avail);
+        free (idx->nodes);
+        free (idx);
+        errno = saved_errno;
+    }
+}
+
+static void rlist_index_invalidate (struct rlist *rl)
+{
+    rlist_index_destroy (rl->index);
+    rl->index = NULL;
+}
+
+static int rnode_cmp_rank (const void *a, const void *b)
+{
+    const struct rnode *x = *(const struct rnode **)a;
+    const struct rnode *y = *(const struct rnode **)b;
+    return (x->rank > y->rank) - (x->rank < y->rank);
+}
+
+static void rlist_index_set (struct rlist_index *idx, int pos, int avail)
+{
+    int old = idx->avail[pos];
+
+    if (old >= 0) {
+        idset_clear (idx->buckets[old], pos);
+        if (old > 0)
+            idset_clear (idx->free, pos);
+    }
+    if (avail >= 0) {
+        idset_set (idx->buckets[avail], pos);
+        if (avail > 0)
+            idset_set (idx->free, pos);
+    }
+    idx->avail[pos] = avail;
+}
+
+static struct rlist_index *rlist_index_create (struct rlist *rl)
+{
+    struct rlist_index *idx;
+    struct rnode *n;
+    int i;
+
+    if (!(idx = calloc (1, sizeof (*idx))))
+        return NULL;
+    idx->size = zlistx_size (rl->nodes);
+    if (!(idx->nodes = calloc (idx->size + 1, sizeof (idx->nodes[0])))
+        || !(idx->avail = calloc (idx->size + 1, sizeof (idx->avail[0]))))
+        goto error;
+    i = 0;
+    n = zlistx_first (rl->nodes);
+    while (n) {
+        idx->nodes[i++] = n;
+        if (rnode_count (n) > idx->maxavail)
+            idx->maxavail = rnode_count (n);
+        n = zlistx_next (rl->nodes);
+    }
+    qsort (idx->nodes, idx->size, sizeof (idx->nodes[0]), rnode_cmp_rank);
+
+    if (!(idx->buckets = calloc (idx->maxavail + 1, sizeof (struct idset *)))
+        || !(idx->free = idset_create (idx->size, 0)))
+        goto error;
+    for (i = 0; i <= idx->maxavail; i++) {
+        if (!(idx->buckets[i] = idset_create (idx->size, 0)))
+            goto error;
+    }
+    for (i = 0; i < idx->size; i++) {
+        n = idx->nodes[i];
+        idx->avail[i] = -1;
+        rlist_index_set (idx, i, n->up ? rnode_avail (n) : -1);
+    }
+    return idx;
+error:
+    rlist_index_destroy (idx);
+    return NULL;
+}
+
+static int rlist_index_position (struct rlist_index *idx, uint32_t rank)
+{
+    int lo = 0;
+    int hi = idx->size - 1;
+
+    while (lo <= hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (idx->nodes[mid]->rank == rank)
+            return mid;
+        if (idx->nodes[mid]->rank < rank)
+            lo = mid + 1;
+        else
+            hi = mid - 1;
+    }
+    return -1;
+}
+
+/*  Update the index after the availability of node 'n' has changed.
+ */
+static void rlist_index_update (struct rlist *rl, struct rnode *n)
+{
+    int avail = n->up ? rnode_avail (n) : -1;
+    int pos;
+
+    if (rl->index) {
+        if (avail > rl->index->maxavail
+            || (pos = rlist_index_position (rl->index, n->rank)) < 0)
+            rlist_index_invalidate (rl);
+        else
+            rlist_index_set (rl->index, pos, avail);
+    }
+}
+
 static int
 sprintfcat (char **s, size_t *sz, size_t *lenp, const char *fmt, ...)
 {
@@ -58,6 +196,7 @@ void rlist_destroy (struct rlist *rl)
 {
     if (rl) {
         int saved_errno = errno;
+        rlist_index_destroy (rl->index);
         zlistx_destroy (&rl->nodes);
         zhashx_destroy (&rl->noremap);
         json_decref (rl->scheduling);
@@ -128,6 +267,20 @@ static struct rnode *rlist_find_rank (const struct rlist *rl, uint32_t rank)
     return NULL;
 }
 
+/*  Find rank, using the index if available.
+ */
+static struct rnode *rlist_lookup_rank (const struct rlist *rl, uint32_t rank)
+{
+    int pos;
+
+    if (rl->index) {
+        if ((pos = rlist_index_position (rl->index, rank)) < 0)
+            return NULL;
+        return rl->index->nodes[pos];
+    }
+    return rlist_find_rank (rl, rank);
+}
+
 static void rlist_update_totals (struct rlist *rl, struct rnode *n)
 {
     rl->total += rnode_count (n);
@@ -139,6 +292,7 @@ static int rlist_add_rnode_new (struct rlist *rl, struct rnode *n)
 {
     if (!zlistx_add_end (rl->nodes, n))
         return -1;
+    rlist_index_invalidate (rl);
     rlist_update_totals (rl, n);
     return 0;
 }
@@ -151,6 +305,7 @@ static int rlist_add_rnode (struct rlist *rl, struct rnode *n)
 {
     struct rnode *found = rlist_find_rank (rl, n->rank);
     if (found) {
+        rlist_index_invalidate (rl);
         if (rnode_add (found, n) < 0)
             return -1;
         rlist_update_totals (rl, n);
@@ -290,6 +445,7 @@ int rlist_remove_ranks (struct rlist *rl, struct idset *ranks)
     i = idset_first (ranks);
     while (i != IDSET_INVALID_ID) {
         if ((n = rlist_find_rank (rl, i))) {
+            rlist_index_invalidate (rl);
             zlistx_delete (rl->nodes, zlistx_cursor (rl->nodes));
             count++;
         }
@@ -303,6 +459,8 @@ int rlist_remap (struct rlist *rl)
     uint32_t rank = 0;
     struct rnode *n;
 
+    rlist_index_invalidate (rl);
+
     /*   Sort list by ascending rank, then rerank starting at 0
      */
     zlistx_set_comparator (rl->nodes, by_rank);
@@ -334,6 +492,8 @@ static int rlist_rerank_hostlist (struct rlist *rl, struct hostlist *hl)
 {
     uint32_t rank = 0;
     const char *host = hostlist_first (hl);
+
+    rlist_index_invalidate (rl);
     while (host) {
         struct rnode *n = rlist_find_host (rl, host);
         if (!n)
@@ -384,8 +544,10 @@ done:
 static struct rnode *rlist_detach_rank (struct rlist *rl, uint32_t rank)
 {
     struct rnode *n = rlist_find_rank (rl, rank);
-    if (n)
+    if (n) {
+        rlist_index_invalidate (rl);
         zlistx_detach_cur (rl->nodes);
+    }
     return n;
 }
 
@@ -748,6 +910,7 @@ int rlist_rank_add_child (struct rlist *rl,
         errno = ENOENT;
         return -1;
     }
+    rlist_index_invalidate (rl);
     if (rnode_add_child (n, name, ids) == NULL)
         return -1;
     return 0;
@@ -1322,16 +1485,10 @@ static int by_rank (const void *item1, const void *item2)
     return (x->rank - y->rank);
 }
 
-static int by_avail (const void *item1, const void *item2)
-{
-    int n;
-    const struct rnode *x = item1;
-    const struct rnode *y = item2;
-    if ((n = rnode_avail (x) - rnode_avail (y)) == 0)
-        n = by_rank (x, y);
-    return n;
-}
-
+/*  "Least used" is measured as most available cores, so on nodes of
+ *   different sizes a larger, partially used node sorts first.  The
+ *   worst-fit cursor (ORDER_AVAIL_DESC) visits nodes in this same order.
+ */
 static int by_used (const void *item1, const void *item2)
 {
     int n;
@@ -1348,6 +1505,7 @@ static int rlist_rnode_alloc (struct rlist *rl, struct rnode *n,
     if (!n || rnode_alloc (n, count, idsetp) < 0)
         return -1;
     rl->avail -= idset_count (*idsetp);
+    rlist_index_update (rl, n);
     return 0;
 }
 
@@ -1362,33 +1520,104 @@ static uint32_t rlist_rnode_rank (struct rlist *rl)
 }
 #endif
 
-static struct rnode *rlist_first (struct rlist *rl)
+/*  Order in which to visit nodes for allocation:
+ */
+enum {
+    ORDER_RANK,         // first-fit: by rank
+    ORDER_AVAIL_ASC,    // best-fit: by available cores, then rank
+    ORDER_AVAIL_DESC,   // worst-fit: as by_used(), available cores
+                        //  descending, then rank
+};
+
+/*  Cursor over nodes in the index with at least 'min' available cores.
+ */
+struct rlist_cursor {
+    int order;
+    int min;
+    int bucket;
+    unsigned int pos;
+};
+
+static struct rnode *rlist_cursor_next (struct rlist *rl,
+                                        struct rlist_cursor *cur)
 {
-    return zlistx_first (rl->nodes);
+    struct rlist_index *idx = rl->index;
+
+    for (;;) {
+        struct idset *set;
+
+        if (cur->order == ORDER_RANK)
+            set = idx->free;
+        else if (cur->bucket < cur->min || cur->bucket > idx->maxavail)
+            return NULL;
+        else
+            set = idx->buckets[cur->bucket];
+
+        if (cur->pos == IDSET_INVALID_ID)
+            cur->pos = idset_first (set);
+        else
+            cur->pos = idset_next (set, cur->pos);
+        if (cur->pos != IDSET_INVALID_ID) {
+            struct rnode *n = idx->nodes[cur->pos];
+            if (cur->order != ORDER_RANK || rnode_avail (n) >= cur->min)
+                return n;
+            continue;
+        }
+        if (cur->order == ORDER_RANK)
+            return NULL;
+        else if (cur->order == ORDER_AVAIL_ASC)
+            cur->bucket++;
+        else
+            cur->bucket--;
+    }
 }
 
-static struct rnode *rlist_next (struct rlist *rl)
+static struct rnode *rlist_cursor_first (struct rlist *rl,
+                                         struct rlist_cursor *cur,
+                                         int order,
+                                         int min)
 {
-    return zlistx_next (rl->nodes);
+    cur->order = order;
+    cur->min = min;
+    cur->pos = IDSET_INVALID_ID;
+    if (order == ORDER_AVAIL_ASC)
+        cur->bucket = min;
+    else
+        cur->bucket = rl->index->maxavail;
+    return rlist_cursor_next (rl, cur);
+}
+
+static int rlist_index_require (struct rlist *rl)
+{
+    if (!rl->index && !(rl->index = rlist_index_create (rl)))
+        return -1;
+    return 0;
 }
 
 /*
  *  Allocate the first available N slots of size cores_per_slot from
- *   resource list rl after sorting the nodes with the current sort strategy.
+ *   resource list rl, visiting nodes in 'order'.  Since a node is only
+ *   left when it cannot fit another slot, a node moved to another bucket
+ *   by allocation is not visited again.
  */
-static struct rlist * rlist_alloc_first_fit (struct rlist *rl,
-                                             int cores_per_slot,
-                                             int slots)
+static struct rlist * rlist_alloc_first_fit_order (struct rlist *rl,
+                                                   int order,
+                                                   int cores_per_slot,
+                                                   int slots)
 {
     int rc;
     struct idset *ids = NULL;
     struct rnode *n = NULL;
     struct rlist *result = NULL;
+    struct rlist_cursor cur;
 
-    zlistx_sort (rl->nodes);
+    if (rlist_index_require (rl) < 0)
+        return NULL;
 
-    if (!(n = rlist_first (rl)))
+    if (!(n = rlist_cursor_first (rl, &cur, order, cores_per_slot))) {
+        errno = ENOSPC;
         return NULL;
+    }
 
     if (!(result = rlist_create ()))
         return NULL;
@@ -1402,7 +1631,7 @@ static struct rlist * rlist_alloc_first_fit (struct rlist *rl,
         if ((rc = rlist_rnode_alloc (rl, n, cores_per_slot, &ids)) < 0) {
             if (errno != ENOSPC)
                 goto unwind;
-            n = rlist_next (rl);
+            n = rlist_cursor_next (rl, &cur);
             continue;
         }
         /*  Append the allocated cores to the result set and continue
@@ -1424,51 +1653,71 @@ unwind:
     return result;
 }
 
+/*
+ *  Allocate the first available N slots of size cores_per_slot from
+ *   resource list rl in rank order.
+ */
+static struct rlist * rlist_alloc_first_fit (struct rlist *rl,
+                                             int cores_per_slot,
+                                             int slots)
+{
+    return rlist_alloc_first_fit_order (rl,
+                                        ORDER_RANK,
+                                        cores_per_slot,
+                                        slots);
+}
+
 /*
  *  Allocate `slots` of size cores_per_slot from rlist `rl` and return
- *   the result. Sorts the node list by smallest available first, so that
+ *   the result. Visits nodes by smallest available first, so that
  *   we get something like "best fit". (minimize nodes used)
  */
 static struct rlist * rlist_alloc_best_fit (struct rlist *rl,
                                             int cores_per_slot,
                                             int slots)
 {
-    zlistx_set_comparator (rl->nodes, by_avail);
-    return rlist_alloc_first_fit (rl, cores_per_slot, slots);
+    return rlist_alloc_first_fit_order (rl,
+                                        ORDER_AVAIL_ASC,
+                                        cores_per_slot,
+                                        slots);
 }
 
 /*
  *  Allocate `slots` of size cores_per_slot from rlist `rl` and return
- *   the result. Sorts the node list by least utilized first, so that
+ *   the result. Visits nodes by least utilized first, so that
  *   we get something like "worst fit". (Spread jobs across nodes)
  */
 static struct rlist * rlist_alloc_worst_fit (struct rlist *rl,
                                              int cores_per_slot,
                                              int slots)
 {
-    zlistx_set_comparator (rl->nodes, by_used);
-    return rlist_alloc_first_fit (rl, cores_per_slot, slots);
+    return rlist_alloc_first_fit_order (rl,
+                                        ORDER_AVAIL_DESC,
+                                        cores_per_slot,
+                                        slots);
 }
 
-
+/*  Get the first 'nnodes' up nodes, least utilized first, in by_used()
+ *   order.
+ */
 static zlistx_t *rlist_get_nnodes (struct rlist *rl, int nnodes)
 {
     struct rnode *n;
-    zlistx_t *l = zlistx_new ();
-    if (!l)
+    struct rlist_cursor cur;
+    zlistx_t *l;
+
+    if (rlist_index_require (rl) < 0 || !(l = zlistx_new ()))
         return NULL;
-    n = zlistx_first (rl->nodes);
+    n = rlist_cursor_first (rl, &cur, ORDER_AVAIL_DESC, 0);
     while (nnodes > 0) {
         if (n == NULL) {
             errno = ENOSPC;
             goto err;
         }
-        if (n->up) {
-            if (!zlistx_add_end (l, n))
-                goto err;
-            nnodes--;
-        }
-        n = zlistx_next (rl->nodes);
+        if (!zlistx_add_end (l, n))
+            goto err;
+        nnodes--;
+        n = rlist_cursor_next (rl, &cur);
     }
     return (l);
 err:
@@ -1498,12 +1747,7 @@ static struct rlist *rlist_alloc_nnodes (struct rlist *rl, int nnodes,
     if (!(result = rlist_create ()))
         return NULL;
 
-    /* 1. sort rank list by used cores ascending:
-     */
-    zlistx_set_comparator (rl->nodes, by_used);
-    zlistx_sort (rl->nodes);
-
-    /* 2. get a list of the first up n nodes
+    /* 1. get a list of the first n up nodes, by used cores ascending
      */
     if (!(cl = rlist_get_nnodes (rl, nnodes)))
         goto unwind;
@@ -1514,7 +1758,7 @@ static struct rlist *rlist_alloc_nnodes (struct rlist *rl, int nnodes,
     zlistx_set_comparator (cl, by_used);
 
     /*
-     * 3. divide slots across all nodes, placing each slot
+     * 2. divide slots across all nodes, placing each slot
      *    on most empty node first
      */
     while (slots > 0) {
@@ -1564,9 +1808,6 @@ static struct rlist *rlist_try_alloc (struct rlist *rl, const char *mode,
         return NULL;
     }
 
-    /*  Reset default sort to order nodes by "rank" */
-    zlistx_set_comparator (rl->nodes, by_rank);
-
     if (nnodes > 0)
         result = rlist_alloc_nnodes (rl, nnodes, cores_per_slot, slots);
     else if (mode == NULL || strcmp (mode, "worst-fit") == 0)
@@ -1634,7 +1875,7 @@ struct rlist *rlist_alloc (struct rlist *rl, const char *mode,
 
 static int rlist_free_rnode (struct rlist *rl, struct rnode *n)
 {
-    struct rnode *rnode = rlist_find_rank (rl, n->rank);
+    struct rnode *rnode = rlist_lookup_rank (rl, n->rank);
     if (!rnode) {
         errno = ENOENT;
         return -1;
@@ -1643,12 +1884,13 @@ static int rlist_free_rnode (struct rlist *rl, struct rnode *n)
         return -1;
     if (rnode->up)
         rl->avail += idset_count (n->cores->ids);
+    rlist_index_update (rl, rnode);
     return 0;
 }
 
 static int rlist_alloc_rnode (struct rlist *rl, struct rnode *n)
 {
-    struct rnode *rnode = rlist_find_rank (rl, n->rank);
+    struct rnode *rnode = rlist_lookup_rank (rl, n->rank);
     if (!rnode) {
         errno = ENOENT;
         return -1;
@@ -1656,6 +1898,7 @@ static int rlist_alloc_rnode (struct rlist *rl, struct rnode *n)
     if (rnode_alloc_idset (rnode, n->cores->avail) < 0)
         return -1;
     rl->avail -= idset_count (n->cores->avail);
+    rlist_index_update (rl, rnode);
     return 0;
 }
 
@@ -1740,6 +1983,7 @@ static int rlist_mark_all (struct rlist *rl, bool up)
         if (n->up != up)
             count += idset_count (n->cores->avail);
         n->up = up;
+        rlist_index_update (rl, n);
         n = zlistx_next (rl->nodes);
     }
     return count;
@@ -1754,10 +1998,11 @@ static int rlist_mark_state (struct rlist *rl, bool up, const char *ids)
         return -1;
     i = idset_first (idset);
     while (i != IDSET_INVALID_ID) {
-        struct rnode *n = rlist_find_rank (rl, i);
+        struct rnode *n = rlist_lookup_rank (rl, i);
         if (n->up != up)
             count += idset_count (n->cores->avail);
         n->up = up;
+        rlist_index_update (rl, n);
         i = idset_next (idset, i);
     }
     idset_destroy (idset);
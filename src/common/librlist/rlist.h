@@ -41,6 +41,9 @@ struct rlist {
 
     /*  Opaque Rv1.scheduling key */
     json_t *scheduling;
+
+    /*  Index of free resources for allocation (internal) */
+    struct rlist_index *index;
 };
 
 /*  Create an empty rlist object */
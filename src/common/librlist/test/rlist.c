@@ -163,6 +163,18 @@ struct rlist_test_entry test_6n_4c[] = {
       "rank[0-2]/core[0-3] rank3/core[0-1]",
       "rank3/core[2-3] rank[4-5]/core[0-3]",
       0, false },
+    { "best-fit: down rank is skipped",              "best-fit", "3",
+      { 0, 1, 1 },
+      "rank4/core0",
+      NULL,
+      NULL,
+      0, false },
+    { "first-fit: down rank is skipped",             "first-fit", "3",
+      { 0, 1, 1 },
+      "rank4/core1",
+      NULL,
+      NULL,
+      0, false },
     RLIST_TEST_END,
 };
 
@@ -635,6 +647,87 @@ static void test_issue2473 (void)
     rlist_destroy (rl);
 }
 
+const char R_hetero[] = "{\
+  \"version\": 1,\n\
+  \"execution\": {\n\
+    \"R_lite\": [\n\
+      {\n\
+        \"rank\": \"0\",\n\
+        \"children\": {\n\
+          \"core\": \"0-3\"\n\
+        }\n\
+      },\n\
+      {\n\
+        \"rank\": \"1\",\n\
+        \"children\": {\n\
+          \"core\": \"0-7\"\n\
+        }\n\
+      }\n\
+    ]\n\
+  }\n\
+}";
+
+/*  worst-fit visits nodes by most available cores first (see by_used()),
+ *   not by fewest used cores.  On heterogeneous nodes those differ:
+ *   a partially used 8 core node is preferred over an idle 4 core node.
+ */
+static void test_worst_fit_hetero (void)
+{
+    char *result;
+    struct rlist *rl;
+    struct rlist *a, *b, *c;
+
+    if (!(rl = rlist_from_R (R_hetero)))
+        BAIL_OUT ("unable to create rlist from R_hetero");
+
+    a = rlist_alloc (rl, "worst-fit", 0, 2, 1);
+    ok (a != NULL,
+        "hetero: worst-fit slots=2 slotsz=1 worked");
+    if (!a)
+        BAIL_OUT ("rlist_alloc failed");
+    result = rlist_dumps (a);
+    is (result,
+        "rank1/core[0-1]",
+        "hetero: cores allocated from largest node");
+    free (result);
+
+    b = rlist_alloc (rl, "worst-fit", 0, 1, 1);
+    ok (b != NULL,
+        "hetero: worst-fit slots=1 slotsz=1 worked");
+    if (!b)
+        BAIL_OUT ("rlist_alloc failed");
+    result = rlist_dumps (b);
+    is (result,
+        "rank1/core2",
+        "hetero: 8 cores with 2 used is chosen before 4 cores with 0 used");
+    free (result);
+
+    c = rlist_alloc (rl, "worst-fit", 2, 2, 1);
+    ok (c != NULL,
+        "hetero: worst-fit nnodes=2 slots=2 slotsz=1 worked");
+    if (!c)
+        BAIL_OUT ("rlist_alloc failed");
+    result = rlist_dumps (c);
+    is (result,
+        "rank0/core0 rank1/core3",
+        "hetero: one core allocated from each node");
+    free (result);
+
+    result = rlist_dumps (rl);
+    is (result,
+        "rank0/core[1-3] rank1/core[4-7]",
+        "hetero: remaining cores are correct");
+    free (result);
+
+    rlist_free (rl, c);
+    rlist_destroy (c);
+    rlist_free (rl, b);
+    rlist_destroy (b);
+    rlist_free (rl, a);
+    rlist_destroy (a);
+    rlist_destroy (rl);
+}
+
 static void test_dumps (void)
 {
     char *result = NULL;
@@ -1549,6 +1642,7 @@ int main (int ac, char *av[])
     run_test_entries (test_1024n_4c, 1024, 4);
     test_issue2202 ();
     test_issue2473 ();
+    test_worst_fit_hetero ();
     test_updown ();
     test_append ();
     test_diff ();
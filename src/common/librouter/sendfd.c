@@ -39,6 +39,17 @@
  *   is assembled, then it is freed.  The static buffer is sized somewhat
  *   arbitrarily at 4K.
  *
+ * - sendfd_batch/recvfd_batch use the same encoding, but move as much
+ *   data as possible in each system call using an iobatch, which holds
+ *   many messages.  Messages are appended to an iobatch with
+ *   iobatch_append() before sending, and are extracted with iobatch_next()
+ *   after receiving.  The iobatch buffer grows as needed to hold one large
+ *   message, and shrinks back to its default size when empty.
+ *
+ * - sendfd_rights/recvfd_batch_rights pass file descriptors with a message
+ *   over a unix domain socket (SCM_RIGHTS).  They are used to hand off
+ *   shared memory rings when a usock connection is set up.
+ *
  * - sendfd/recvfd do not encrypt messages, therefore this transport
  *   is only appropriate for use on AF_LOCAL sockets or on file descriptors
  *   tunneled through a secure channel.
@@ -47,14 +58,20 @@
 #if HAVE_CONFIG_H
 #include "config.h"
 #endif
+#include <sys/socket.h>
 #include <arpa/inet.h>
 #include <unistd.h>
 #include <flux/core.h>
 
+#include "src/common/libutil/errno_safe.h"
+
 #include "sendfd.h"
 
 #define IOBUF_MAGIC 0xffee0012
 
+#define IOBATCH_SIZE    65536   // default iobatch buffer size
+#define IOBATCH_READMIN 4096    // minimum space for recvfd_batch() read
+
 void iobuf_init (struct iobuf *iobuf)
 {
     memset (iobuf, 0, sizeof (*iobuf));
@@ -178,6 +195,277 @@ done:
     return msg;
 }
 
+void iobatch_init (struct iobatch *b)
+{
+    memset (b, 0, sizeof (*b));
+}
+
+void iobatch_clean (struct iobatch *b)
+{
+    free (b->buf);
+    memset (b, 0, sizeof (*b));
+}
+
+size_t iobatch_pending (struct iobatch *b)
+{
+    return b->end - b->start;
+}
+
+/* Messages are not aligned within an iobatch buffer,
+ * so header words are accessed with memcpy().
+ */
+static uint32_t get_word (const uint8_t *p)
+{
+    uint32_t w;
+    memcpy (&w, p, sizeof (w));
+    return w;
+}
+
+static void put_word (uint8_t *p, uint32_t w)
+{
+    memcpy (p, &w, sizeof (w));
+}
+
+/* Ensure there is room for 'need' more bytes at the end of the buffer.
+ * Move pending data to the front if that helps, otherwise grow buffer.
+ * An empty buffer that grew for a large message is shrunk back to default.
+ */
+static int iobatch_reserve (struct iobatch *b, size_t need)
+{
+    size_t size;
+    uint8_t *buf;
+
+    if (b->start == b->end) {
+        b->start = b->end = 0;
+        if (b->size > IOBATCH_SIZE && need <= IOBATCH_SIZE) {
+            free (b->buf);
+            b->buf = NULL;
+            b->size = 0;
+        }
+    }
+    if (b->size - b->end >= need)
+        return 0;
+    if (b->start > 0) {
+        memmove (b->buf, b->buf + b->start, b->end - b->start);
+        b->end -= b->start;
+        b->start = 0;
+        if (b->size - b->end >= need)
+            return 0;
+    }
+    size = IOBATCH_SIZE;
+    while (size < b->end + need)
+        size *= 2;
+    if (!(buf = realloc (b->buf, size)))
+        return -1;
+    b->buf = buf;
+    b->size = size;
+    return 0;
+}
+
+int iobatch_append (struct iobatch *b, const flux_msg_t *msg)
+{
+    ssize_t s;
+    uint8_t *p;
+
+    if (!b || !msg) {
+        errno = EINVAL;
+        return -1;
+    }
+    if ((s = flux_msg_encode_size (msg)) < 0)
+        return -1;
+    if (iobatch_reserve (b, s + 8) < 0)
+        return -1;
+    p = b->buf + b->end;
+    put_word (&p[0], IOBUF_MAGIC);
+    put_word (&p[4], htonl (s));
+    if (flux_msg_encode (msg, &p[8], s) < 0)
+        return -1;
+    b->end += s + 8;
+    return 0;
+}
+
+ssize_t sendfd_batch (int fd, struct iobatch *b)
+{
+    ssize_t n;
+
+    if (fd < 0 || !b) {
+        errno = EINVAL;
+        return -1;
+    }
+    if ((n = write (fd, b->buf + b->start, b->end - b->start)) < 0)
+        return -1;
+    b->start += n;
+    return n;
+}
+
+/* Make room in iobatch for the next read.
+ */
+static int iobatch_prepare_read (struct iobatch *b)
+{
+    size_t pending;
+    size_t need = IOBATCH_READMIN;
+
+    /* If the header of a message larger than the free space has been
+     * received, make room for the rest of it.
+     */
+    pending = b->end - b->start;
+    if (pending >= 8) {
+        size_t size = ntohl (get_word (&b->buf[b->start + 4])) + 8;
+        if (size > pending && size - pending > need)
+            need = size - pending;
+    }
+    return iobatch_reserve (b, need);
+}
+
+ssize_t recvfd_batch (int fd, struct iobatch *b)
+{
+    ssize_t n;
+
+    if (fd < 0 || !b) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (iobatch_prepare_read (b) < 0)
+        return -1;
+    if ((n = read (fd, b->buf + b->end, b->size - b->end)) < 0)
+        return -1;
+    if (n == 0) {
+        errno = ECONNRESET;
+        return -1;
+    }
+    b->end += n;
+    return n;
+}
+
+ssize_t recvfd_batch_rights (int fd, struct iobatch *b, int *fds, int *nfds)
+{
+    union {
+        char buf[CMSG_SPACE (sizeof (int) * SENDFD_MAX_RIGHTS)];
+        struct cmsghdr align;
+    } u;
+    struct msghdr mh;
+    struct iovec iov;
+    struct cmsghdr *cmsg;
+    ssize_t n;
+    int count = 0;
+
+    if (fd < 0 || !b || !fds || !nfds || *nfds < 0) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (iobatch_prepare_read (b) < 0)
+        return -1;
+    iov.iov_base = b->buf + b->end;
+    iov.iov_len = b->size - b->end;
+    memset (&mh, 0, sizeof (mh));
+    mh.msg_iov = &iov;
+    mh.msg_iovlen = 1;
+    mh.msg_control = u.buf;
+    mh.msg_controllen = sizeof (u.buf);
+    if ((n = recvmsg (fd, &mh, MSG_CMSG_CLOEXEC)) < 0) {
+        *nfds = 0;
+        return -1;
+    }
+    /* Keep up to *nfds descriptors and close any others.
+     */
+    for (cmsg = CMSG_FIRSTHDR (&mh); cmsg; cmsg = CMSG_NXTHDR (&mh, cmsg)) {
+        if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS) {
+            int rights = (cmsg->cmsg_len - CMSG_LEN (0)) / sizeof (int);
+            for (int i = 0; i < rights; i++) {
+                int rfd;
+                memcpy (&rfd, CMSG_DATA (cmsg) + i * sizeof (int), sizeof (rfd));
+                if (count < *nfds)
+                    fds[count++] = rfd;
+                else
+                    (void)close (rfd);
+            }
+        }
+    }
+    *nfds = count;
+    if (n == 0) {
+        errno = ECONNRESET;
+        return -1;
+    }
+    b->end += n;
+    return n;
+}
+
+int sendfd_rights (int fd, const flux_msg_t *msg, const int *fds, int nfds)
+{
+    union {
+        char buf[CMSG_SPACE (sizeof (int) * SENDFD_MAX_RIGHTS)];
+        struct cmsghdr align;
+    } u;
+    struct iobatch b;
+    struct msghdr mh;
+    struct iovec iov;
+    struct cmsghdr *cmsg;
+    ssize_t n;
+
+    if (fd < 0 || !msg || !fds || nfds < 1 || nfds > SENDFD_MAX_RIGHTS) {
+        errno = EINVAL;
+        return -1;
+    }
+    iobatch_init (&b);
+    if (iobatch_append (&b, msg) < 0)
+        goto error;
+    iov.iov_base = b.buf + b.start;
+    iov.iov_len = b.end - b.start;
+    memset (&u, 0, sizeof (u));
+    memset (&mh, 0, sizeof (mh));
+    mh.msg_iov = &iov;
+    mh.msg_iovlen = 1;
+    mh.msg_control = u.buf;
+    mh.msg_controllen = CMSG_SPACE (sizeof (int) * nfds);
+    cmsg = CMSG_FIRSTHDR (&mh);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN (sizeof (int) * nfds);
+    memcpy (CMSG_DATA (cmsg), fds, sizeof (int) * nfds);
+    if ((n = sendmsg (fd, &mh, 0)) < 0)
+        goto error;
+    b.start += n;
+    while (iobatch_pending (&b) > 0) {
+        if (sendfd_batch (fd, &b) < 0)
+            goto error;
+    }
+    iobatch_clean (&b);
+    return 0;
+error:
+    ERRNO_SAFE_WRAP (iobatch_clean, &b);
+    return -1;
+}
+
+flux_msg_t *iobatch_next (struct iobatch *b)
+{
+    size_t pending;
+    size_t size;
+    flux_msg_t *msg;
+
+    if (!b) {
+        errno = EINVAL;
+        return NULL;
+    }
+    pending = b->end - b->start;
+    if (pending < 8) {
+        errno = EAGAIN;
+        return NULL;
+    }
+    if (get_word (&b->buf[b->start]) != IOBUF_MAGIC) {
+        errno = EPROTO;
+        return NULL;
+    }
+    size = ntohl (get_word (&b->buf[b->start + 4])) + 8;
+    if (size > pending) {
+        errno = EAGAIN;
+        return NULL;
+    }
+    if (!(msg = flux_msg_decode (b->buf + b->start + 8, size - 8)))
+        return NULL;
+    b->start += size;
+    return msg;
+}
+
 /*
  * vi:tabstop=4 shiftwidth=4 expandtab
  */
@@ -13,6 +13,8 @@
 
 #include <flux/core.h>
 
+#define SENDFD_MAX_RIGHTS 8
+
 struct iobuf {
     uint8_t *buf;
     size_t size;
@@ -20,6 +22,16 @@ struct iobuf {
     uint8_t buf_fixed[4096];
 };
 
+/* Buffer for sending or receiving a stream of messages in batches.
+ * Data in buf[start:end] is pending.
+ */
+struct iobatch {
+    uint8_t *buf;
+    size_t size;
+    size_t start;
+    size_t end;
+};
+
 /* Send message to file descriptor.
  * iobuf captures intermediate state to make EAGAIN/EWOULDBLOCK restartable.
  * Returns 0 on success, -1 on failure with errno set.
@@ -41,6 +53,52 @@ void iobuf_init (struct iobuf *iobuf);
  */
 void iobuf_clean (struct iobuf *iobuf);
 
+/* Initialize iobatch members.
+ */
+void iobatch_init (struct iobatch *b);
+
+/* Free any internal memory allocated to iobatch.
+ */
+void iobatch_clean (struct iobatch *b);
+
+/* Return the number of bytes pending in iobatch.
+ */
+size_t iobatch_pending (struct iobatch *b);
+
+/* Encode message and append it to iobatch, for sending with sendfd_batch().
+ * Returns 0 on success, -1 on failure with errno set.
+ */
+int iobatch_append (struct iobatch *b, const flux_msg_t *msg);
+
+/* Write pending data in iobatch to file descriptor with one write(2).
+ * Returns bytes written on success, -1 on failure with errno set.
+ */
+ssize_t sendfd_batch (int fd, struct iobatch *b);
+
+/* Read available data from file descriptor into iobatch with one read(2).
+ * Returns bytes read on success, -1 on failure with errno set
+ * (ECONNRESET on EOF).
+ */
+ssize_t recvfd_batch (int fd, struct iobatch *b);
+
+/* Like recvfd_batch(), but also receive up to *nfds file descriptors
+ * passed with SCM_RIGHTS into 'fds', and set *nfds to the number received.
+ * Descriptors in excess of *nfds are closed.
+ */
+ssize_t recvfd_batch_rights (int fd, struct iobatch *b, int *fds, int *nfds);
+
+/* Send message with 'nfds' file descriptors attached (SCM_RIGHTS).
+ * The file descriptor 'fd' must be a unix domain socket in blocking mode.
+ * Returns 0 on success, -1 on failure with errno set.
+ */
+int sendfd_rights (int fd, const flux_msg_t *msg, const int *fds, int nfds);
+
+/* Decode the next complete message from data received by recvfd_batch().
+ * Returns message on success, NULL on failure with errno set
+ * (EAGAIN if no complete message is pending, EPROTO if data is corrupt).
+ */
+flux_msg_t *iobatch_next (struct iobatch *b);
+
 #endif /* !_ROUTER_SENDFD_H */
 
 /*
@@ -0,0 +1,535 @@
+/************************************************************\
+ * Copyright 2021 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+/* shmring.c - single producer, single consumer message ring in a memfd
+ *
+ * The memfd contains a one page header followed by the data area.
+ * The data area is mapped twice, back to back, so that any span of up
+ * to 'size' bytes starting within the first mapping is contiguous in
+ * memory.  Thus a message may be encoded or decoded in place even if it
+ * wraps around the end of the ring.
+ *
+ * Messages are framed as in sendfd.c:
+ *
+ *   4 bytes - IOBUF_MAGIC
+ *   4 bytes - size of encoded message in network byte order
+ *   N bytes - message encoded with flux_msg_encode()
+ *
+ * 'head' and 'tail' are free running byte counts, written only by the
+ * consumer and producer respectively.  The wakeup flags use sequentially
+ * consistent atomics so that a waiter either sees the peer's update when
+ * it re-checks the ring after setting its flag, or the peer sees the flag.
+ *
+ * If the peer is not trusted (e.g. the broker side of a guest connection),
+ * its header updates are validated, the memfd must be sealed against
+ * shrinking, and messages are copied out of the ring before decoding, since
+ * the peer could modify them during decoding.
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <flux/core.h>
+
+#include "src/common/libutil/errno_safe.h"
+
+#include "shmring.h"
+
+#define IOBUF_MAGIC 0xffee0012      // same as sendfd.c
+#define SHMRING_MAGIC 0x73687231    // "shr1"
+#define SHMRING_MAX_SIZE (1UL << 30)
+
+#ifndef MFD_CLOEXEC
+#define MFD_CLOEXEC 0x0001U
+#endif
+#ifndef MFD_ALLOW_SEALING
+#define MFD_ALLOW_SEALING 0x0002U
+#endif
+
+struct shmring_header {
+    uint32_t magic;
+    uint32_t size;
+    uint64_t head __attribute__ ((aligned (64)));
+    uint32_t reader_waiting;
+    uint64_t tail __attribute__ ((aligned (64)));
+    uint32_t writer_waiting;
+};
+
+/* A message larger than the ring, being streamed through it.
+ */
+struct partial {
+    uint8_t *buf;
+    size_t size;
+    size_t done;
+};
+
+struct shmring {
+    int fd;
+    int flags;
+    size_t pagesize;
+    size_t size;
+    size_t mask;
+    struct shmring_header *hdr;
+    uint8_t *data;
+
+    struct partial tx;
+    bool tx_blocked;
+    uint64_t tx_blocked_head;
+
+    struct partial rx;
+    bool rx_blocked;
+    uint64_t rx_blocked_tail;
+};
+
+static int shm_memfd_create (const char *name, unsigned int flags)
+{
+#if HAVE_MEMFD_CREATE
+    return memfd_create (name, flags);
+#elif defined (SYS_memfd_create)
+    return syscall (SYS_memfd_create, name, flags);
+#else
+    errno = ENOSYS;
+    return -1;
+#endif
+}
+
+static uint32_t get_word (const uint8_t *p)
+{
+    uint32_t w;
+    memcpy (&w, p, sizeof (w));
+    return w;
+}
+
+static void put_word (uint8_t *p, uint32_t w)
+{
+    memcpy (p, &w, sizeof (w));
+}
+
+static void partial_clean (struct partial *p)
+{
+    free (p->buf);
+    memset (p, 0, sizeof (*p));
+}
+
+/* Map header, then map data area twice into a reserved region.
+ */
+static int shmring_map (struct shmring *ring)
+{
+    uint8_t *base;
+
+    ring->hdr = mmap (NULL,
+                      ring->pagesize,
+                      PROT_READ | PROT_WRITE,
+                      MAP_SHARED,
+                      ring->fd,
+                      0);
+    if (ring->hdr == MAP_FAILED) {
+        ring->hdr = NULL;
+        return -1;
+    }
+    base = mmap (NULL,
+                 2 * ring->size,
+                 PROT_NONE,
+                 MAP_PRIVATE | MAP_ANONYMOUS,
+                 -1,
+                 0);
+    if (base == MAP_FAILED)
+        return -1;
+    ring->data = base;
+    if (mmap (base,
+              ring->size,
+              PROT_READ | PROT_WRITE,
+              MAP_SHARED | MAP_FIXED,
+              ring->fd,
+              ring->pagesize) == MAP_FAILED
+        || mmap (base + ring->size,
+                 ring->size,
+                 PROT_READ | PROT_WRITE,
+                 MAP_SHARED | MAP_FIXED,
+                 ring->fd,
+                 ring->pagesize) == MAP_FAILED)
+        return -1;
+    return 0;
+}
+
+void shmring_destroy (struct shmring *ring)
+{
+    if (ring) {
+        int saved_errno = errno;
+        if (ring->data)
+            (void)munmap (ring->data, 2 * ring->size);
+        if (ring->hdr)
+            (void)munmap (ring->hdr, ring->pagesize);
+        if (ring->fd >= 0)
+            (void)close (ring->fd);
+        partial_clean (&ring->tx);
+        partial_clean (&ring->rx);
+        free (ring);
+        errno = saved_errno;
+    }
+}
+
+static struct shmring *shmring_alloc (int fd, int flags)
+{
+    struct shmring *ring;
+    long pagesize;
+
+    if ((pagesize = sysconf (_SC_PAGESIZE)) < 0)
+        return NULL;
+    if (!(ring = calloc (1, sizeof (*ring))))
+        return NULL;
+    ring->fd = fd;
+    ring->flags = flags;
+    ring->pagesize = pagesize;
+    return ring;
+}
+
+struct shmring *shmring_create (size_t size)
+{
+    struct shmring *ring;
+    size_t n;
+    int fd;
+
+    if (size == 0 || size > SHMRING_MAX_SIZE) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if ((fd = shm_memfd_create ("flux-shmring",
+                                MFD_CLOEXEC | MFD_ALLOW_SEALING)) < 0)
+        return NULL;
+    if (!(ring = shmring_alloc (fd, 0))) {
+        ERRNO_SAFE_WRAP (close, fd);
+        return NULL;
+    }
+    n = ring->pagesize;
+    while (n < size)
+        n <<= 1;
+    ring->size = n;
+    ring->mask = n - 1;
+    if (ftruncate (fd, ring->pagesize + ring->size) < 0)
+        goto error;
+#ifdef F_SEAL_SHRINK
+    if (fcntl (fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) < 0)
+        goto error;
+#endif
+    if (shmring_map (ring) < 0)
+        goto error;
+    ring->hdr->magic = SHMRING_MAGIC;
+    ring->hdr->size = ring->size;
+    return ring;
+error:
+    shmring_destroy (ring);
+    return NULL;
+}
+
+struct shmring *shmring_attach (int fd, int flags)
+{
+    struct shmring *ring;
+    struct stat sb;
+    uint32_t size;
+
+    if (fd < 0) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if (!(ring = shmring_alloc (fd, flags)))
+        return NULL;
+    if (fstat (fd, &sb) < 0)
+        goto error;
+    if (sb.st_size < ring->pagesize)
+        goto error_proto;
+    /* An untrusted peer could shrink the file out from under the
+     * mapping and crash us with SIGBUS, unless it is sealed.
+     */
+    if ((flags & SHMRING_UNTRUSTED)) {
+#ifdef F_SEAL_SHRINK
+        int seals = fcntl (fd, F_GET_SEALS);
+        if (seals < 0 || !(seals & F_SEAL_SHRINK))
+            goto error_proto;
+#else
+        errno = ENOSYS;
+        goto error;
+#endif
+    }
+    /* Map header only, to get the size.
+     */
+    ring->hdr = mmap (NULL,
+                      ring->pagesize,
+                      PROT_READ | PROT_WRITE,
+                      MAP_SHARED,
+                      fd,
+                      0);
+    if (ring->hdr == MAP_FAILED) {
+        ring->hdr = NULL;
+        goto error;
+    }
+    size = ring->hdr->size;
+    if (ring->hdr->magic != SHMRING_MAGIC
+        || size < ring->pagesize
+        || size > SHMRING_MAX_SIZE
+        || (size & (size - 1)) != 0
+        || sb.st_size != ring->pagesize + size)
+        goto error_proto;
+    (void)munmap (ring->hdr, ring->pagesize);
+    ring->hdr = NULL;
+    ring->size = size;
+    ring->mask = size - 1;
+    if (shmring_map (ring) < 0)
+        goto error;
+    return ring;
+error_proto:
+    errno = EPROTO;
+error:
+    shmring_destroy (ring);
+    return NULL;
+}
+
+int shmring_fd (struct shmring *ring)
+{
+    return ring ? ring->fd : -1;
+}
+
+/* Get the number of bytes in the ring, from the producer or consumer
+ * side.  The peer's counter is validated, since it may not be trusted.
+ */
+static int ring_used (struct shmring *ring, uint64_t head, uint64_t tail,
+                      size_t *used)
+{
+    if (tail - head > ring->size) {
+        errno = EPROTO;
+        return -1;
+    }
+    *used = tail - head;
+    return 0;
+}
+
+/* Stream as much of an oversized message into the ring as will fit.
+ */
+static int send_partial (struct shmring *ring)
+{
+    uint64_t tail = ring->hdr->tail;
+    uint64_t head = __atomic_load_n (&ring->hdr->head, __ATOMIC_ACQUIRE);
+    size_t used;
+    size_t n;
+
+    if (ring_used (ring, head, tail, &used) < 0)
+        return -1;
+    n = ring->size - used;
+    if (n > ring->tx.size - ring->tx.done)
+        n = ring->tx.size - ring->tx.done;
+    memcpy (ring->data + (tail & ring->mask), ring->tx.buf + ring->tx.done, n);
+    __atomic_store_n (&ring->hdr->tail, tail + n, __ATOMIC_SEQ_CST);
+    ring->tx.done += n;
+    if (ring->tx.done < ring->tx.size) {
+        ring->tx_blocked = true;
+        ring->tx_blocked_head = head;
+        errno = EAGAIN;
+        return -1;
+    }
+    partial_clean (&ring->tx);
+    return 0;
+}
+
+int shmring_send (struct shmring *ring, const flux_msg_t *msg)
+{
+    uint64_t head;
+    uint64_t tail;
+    size_t used;
+    ssize_t s;
+    uint8_t *p;
+
+    if (!ring || !msg) {
+        errno = EINVAL;
+        return -1;
+    }
+    ring->tx_blocked = false;
+    if (ring->tx.buf)
+        return send_partial (ring);
+    if ((s = flux_msg_encode_size (msg)) < 0)
+        return -1;
+    if (s + 8 > ring->size) {
+        if (!(ring->tx.buf = malloc (s + 8)))
+            return -1;
+        ring->tx.size = s + 8;
+        put_word (&ring->tx.buf[0], IOBUF_MAGIC);
+        put_word (&ring->tx.buf[4], htonl (s));
+        if (flux_msg_encode (msg, &ring->tx.buf[8], s) < 0) {
+            ERRNO_SAFE_WRAP (partial_clean, &ring->tx);
+            return -1;
+        }
+        return send_partial (ring);
+    }
+    tail = ring->hdr->tail;
+    head = __atomic_load_n (&ring->hdr->head, __ATOMIC_ACQUIRE);
+    if (ring_used (ring, head, tail, &used) < 0)
+        return -1;
+    if (ring->size - used < s + 8) {
+        ring->tx_blocked = true;
+        ring->tx_blocked_head = head;
+        errno = EAGAIN;
+        return -1;
+    }
+    p = ring->data + (tail & ring->mask);
+    put_word (&p[0], IOBUF_MAGIC);
+    put_word (&p[4], htonl (s));
+    if (flux_msg_encode (msg, &p[8], s) < 0)
+        return -1;
+    __atomic_store_n (&ring->hdr->tail, tail + s + 8, __ATOMIC_SEQ_CST);
+    return 0;
+}
+
+/* Copy as much of an oversized message out of the ring as is available.
+ */
+static flux_msg_t *recv_partial (struct shmring *ring,
+                                 uint64_t head,
+                                 size_t used)
+{
+    flux_msg_t *msg;
+    size_t n = used;
+
+    if (n > ring->rx.size - ring->rx.done)
+        n = ring->rx.size - ring->rx.done;
+    memcpy (ring->rx.buf + ring->rx.done, ring->data + (head & ring->mask), n);
+    __atomic_store_n (&ring->hdr->head, head + n, __ATOMIC_SEQ_CST);
+    ring->rx.done += n;
+    if (ring->rx.done < ring->rx.size) {
+        ring->rx_blocked = true;
+        ring->rx_blocked_tail = head + n;
+        errno = EAGAIN;
+        return NULL;
+    }
+    msg = flux_msg_decode (ring->rx.buf + 8, ring->rx.size - 8);
+    ERRNO_SAFE_WRAP (partial_clean, &ring->rx);
+    return msg;
+}
+
+flux_msg_t *shmring_recv (struct shmring *ring)
+{
+    uint64_t head;
+    uint64_t tail;
+    size_t used;
+    size_t size;
+    uint8_t *p;
+    flux_msg_t *msg;
+
+    if (!ring) {
+        errno = EINVAL;
+        return NULL;
+    }
+    ring->rx_blocked = false;
+    head = ring->hdr->head;
+    tail = __atomic_load_n (&ring->hdr->tail, __ATOMIC_ACQUIRE);
+    if (ring_used (ring, head, tail, &used) < 0)
+        return NULL;
+    if (ring->rx.buf)
+        return recv_partial (ring, head, used);
+    if (used < 8)
+        goto again;
+    p = ring->data + (head & ring->mask);
+    if (get_word (&p[0]) != IOBUF_MAGIC) {
+        errno = EPROTO;
+        return NULL;
+    }
+    size = (size_t)ntohl (get_word (&p[4])) + 8;
+    if (size > ring->size) {
+        if (!(ring->rx.buf = malloc (size)))
+            return NULL;
+        ring->rx.size = size;
+        return recv_partial (ring, head, used);
+    }
+    if (used < size)
+        goto again;
+    if ((ring->flags & SHMRING_UNTRUSTED)) {
+        uint8_t *cpy;
+
+        if (!(cpy = malloc (size - 8)))
+            return NULL;
+        memcpy (cpy, &p[8], size - 8);
+        msg = flux_msg_decode (cpy, size - 8);
+        ERRNO_SAFE_WRAP (free, cpy);
+    }
+    else
+        msg = flux_msg_decode (&p[8], size - 8);
+    if (!msg)
+        return NULL;
+    __atomic_store_n (&ring->hdr->head, head + size, __ATOMIC_SEQ_CST);
+    return msg;
+again:
+    ring->rx_blocked = true;
+    ring->rx_blocked_tail = tail;
+    errno = EAGAIN;
+    return NULL;
+}
+
+bool shmring_readable (struct shmring *ring)
+{
+    uint64_t tail = __atomic_load_n (&ring->hdr->tail, __ATOMIC_SEQ_CST);
+
+    if (ring->rx_blocked)
+        return tail != ring->rx_blocked_tail;
+    return tail != ring->hdr->head;
+}
+
+bool shmring_writable (struct shmring *ring)
+{
+    uint64_t head = __atomic_load_n (&ring->hdr->head, __ATOMIC_SEQ_CST);
+
+    if (ring->tx_blocked)
+        return head != ring->tx_blocked_head;
+    return true;
+}
+
+bool shmring_wait_readable (struct shmring *ring)
+{
+    __atomic_store_n (&ring->hdr->reader_waiting, 1, __ATOMIC_SEQ_CST);
+    if (shmring_readable (ring)) {
+        __atomic_store_n (&ring->hdr->reader_waiting, 0, __ATOMIC_SEQ_CST);
+        return false;
+    }
+    return true;
+}
+
+bool shmring_wait_writable (struct shmring *ring)
+{
+    __atomic_store_n (&ring->hdr->writer_waiting, 1, __ATOMIC_SEQ_CST);
+    if (shmring_writable (ring)) {
+        __atomic_store_n (&ring->hdr->writer_waiting, 0, __ATOMIC_SEQ_CST);
+        return false;
+    }
+    return true;
+}
+
+bool shmring_wake_reader (struct shmring *ring)
+{
+    return __atomic_exchange_n (&ring->hdr->reader_waiting,
+                                0,
+                                __ATOMIC_SEQ_CST) != 0;
+}
+
+bool shmring_wake_writer (struct shmring *ring)
+{
+    return __atomic_exchange_n (&ring->hdr->writer_waiting,
+                                0,
+                                __ATOMIC_SEQ_CST) != 0;
+}
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
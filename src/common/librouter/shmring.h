@@ -0,0 +1,94 @@
+/************************************************************\
+ * Copyright 2021 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#ifndef _ROUTER_SHMRING_H
+#define _ROUTER_SHMRING_H
+
+#include <stdbool.h>
+#include <flux/core.h>
+
+/* Single producer, single consumer message ring in shared memory.
+ *
+ * A ring is backed by a memfd, which may be passed to another process
+ * over a unix domain socket and attached there.  Messages are encoded
+ * directly into the ring by the producer, and decoded from the ring by
+ * the consumer.  Messages larger than the ring are streamed through it.
+ *
+ * The ring does not perform wakeups.  Instead, a consumer that finds the
+ * ring empty (or a producer that finds it full) may arm a wakeup flag in
+ * the ring header.  The peer checks the flag after each operation and
+ * signals the waiter by other means, e.g. an eventfd.
+ */
+
+enum {
+    SHMRING_UNTRUSTED = 1,  // copy data out of ring before decoding
+};
+
+/* Create a ring with a data area of at least 'size' bytes.
+ */
+struct shmring *shmring_create (size_t size);
+
+/* Attach to ring backed by 'fd', which was obtained from shmring_fd()
+ * in another process.  The ring takes ownership of 'fd'.  If the peer is
+ * not trusted, set SHMRING_UNTRUSTED in 'flags'.
+ */
+struct shmring *shmring_attach (int fd, int flags);
+
+void shmring_destroy (struct shmring *ring);
+
+int shmring_fd (struct shmring *ring);
+
+/* Producer: encode message into ring.
+ * Returns 0 on success, -1 on failure with errno set.  If there is not
+ * enough space, fail with EAGAIN.  As with sendfd(), call again with the
+ * same message when space becomes available.
+ */
+int shmring_send (struct shmring *ring, const flux_msg_t *msg);
+
+/* Consumer: decode the next message from ring.
+ * Returns message on success, NULL on failure with errno set.  If no
+ * complete message is available, fail with EAGAIN.
+ */
+flux_msg_t *shmring_recv (struct shmring *ring);
+
+/* Consumer: return true if data was added to the ring since
+ * shmring_recv() last failed with EAGAIN.
+ */
+bool shmring_readable (struct shmring *ring);
+
+/* Producer: return true if data was consumed from the ring since
+ * shmring_send() last failed with EAGAIN.
+ */
+bool shmring_writable (struct shmring *ring);
+
+/* Consumer: request a wakeup when data is added to the ring.
+ * Returns true if the consumer should wait, or false if data arrived
+ * in the mean time (the request is canceled).
+ */
+bool shmring_wait_readable (struct shmring *ring);
+
+/* Producer: request a wakeup when data is consumed from the ring.
+ * Returns true if the producer should wait, or false if space became
+ * available in the mean time (the request is canceled).
+ */
+bool shmring_wait_writable (struct shmring *ring);
+
+/* Producer: return true if the consumer requested a wakeup.
+ * Consumer: return true if the producer requested a wakeup.
+ * The request is cleared, so the caller must deliver the wakeup.
+ */
+bool shmring_wake_reader (struct shmring *ring);
+bool shmring_wake_writer (struct shmring *ring);
+
+#endif /* !_ROUTER_SHMRING_H */
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
@@ -13,6 +13,7 @@
 #endif
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/socket.h>
 #include <fcntl.h>
 #include <unistd.h>
 
@@ -292,6 +293,115 @@ next:
     free (buf);
 }
 
+/* Append 'count' messages with payload 'size' to an iobatch.
+ * Send them over a nonblocking socketpair with sendfd_batch() and
+ * receive them with recvfd_batch(), alternating until all are received.
+ * Verify that messages are all received intact, in fewer system calls
+ * than messages if they are small.
+ */
+void test_batch (int size, int count)
+{
+    int sfd[2];
+    struct iobatch out, in;
+    char *buf;
+    int i;
+    int received = 0;
+    int errors = 0;
+    int calls = 0;
+    flux_msg_t *msg;
+
+    if (!(buf = malloc (size)))
+        BAIL_OUT ("malloc failed");
+    memset (buf, 0xf0, size);
+    if (socketpair (PF_LOCAL, SOCK_STREAM | SOCK_CLOEXEC, 0, sfd) < 0)
+        BAIL_OUT ("socketpair failed");
+    if (fd_set_nonblocking (sfd[0]) < 0 || fd_set_nonblocking (sfd[1]) < 0)
+        BAIL_OUT ("fd_set_nonblocking failed");
+    iobatch_init (&out);
+    iobatch_init (&in);
+
+    for (i = 0; i < count; i++) {
+        if (!(msg = flux_request_encode_raw ("foo.bar", buf, size)))
+            BAIL_OUT ("flux_request_encode failed");
+        if (iobatch_append (&out, msg) < 0)
+            BAIL_OUT ("iobatch_append failed");
+        flux_msg_destroy (msg);
+    }
+    ok (iobatch_pending (&out) > (size_t)size * count,
+        "batch %d,%d: iobatch_append encoded all messages", count, size);
+
+    while (received < count) {
+        if (iobatch_pending (&out) > 0) {
+            if (sendfd_batch (sfd[1], &out) < 0
+                && errno != EAGAIN && errno != EWOULDBLOCK)
+                BAIL_OUT ("sendfd_batch failed: %s", strerror (errno));
+        }
+        if (recvfd_batch (sfd[0], &in) < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+                BAIL_OUT ("recvfd_batch failed: %s", strerror (errno));
+            continue;
+        }
+        calls++;
+        while ((msg = iobatch_next (&in))) {
+            const char *topic;
+            const void *buf2;
+            int buf2len;
+
+            if (flux_request_decode_raw (msg, &topic, &buf2, &buf2len) < 0
+                || strcmp (topic, "foo.bar") != 0
+                || buf2len != size
+                || memcmp (buf, buf2, buf2len) != 0)
+                errors++;
+            flux_msg_destroy (msg);
+            received++;
+        }
+        if (errno != EAGAIN)
+            BAIL_OUT ("iobatch_next failed: %s", strerror (errno));
+    }
+    ok (received == count && errors == 0,
+        "batch %d,%d: received messages are intact", count, size);
+    ok (iobatch_pending (&out) == 0 && iobatch_pending (&in) == 0,
+        "batch %d,%d: no data is left pending", count, size);
+    if (size < 1024) {
+        ok (calls < count,
+            "batch %d,%d: %d messages were received in %d reads",
+            count, size, count, calls);
+    }
+
+    iobatch_clean (&out);
+    iobatch_clean (&in);
+    close (sfd[1]);
+    close (sfd[0]);
+    free (buf);
+}
+
+void test_batch_eof (void)
+{
+    int pfd[2];
+    struct iobatch in;
+    uint8_t junk[8] = { 0 };
+
+    if (pipe2 (pfd, O_CLOEXEC) < 0)
+        BAIL_OUT ("pipe2 failed");
+    iobatch_init (&in);
+    errno = 0;
+    ok (iobatch_next (&in) == NULL && errno == EAGAIN,
+        "iobatch_next on empty iobatch fails with EAGAIN");
+    if (write (pfd[1], junk, sizeof (junk)) != sizeof (junk))
+        BAIL_OUT ("write failed");
+    ok (recvfd_batch (pfd[0], &in) == sizeof (junk),
+        "recvfd_batch reads data");
+    errno = 0;
+    ok (iobatch_next (&in) == NULL && errno == EPROTO,
+        "iobatch_next fails with EPROTO on bad magic");
+    close (pfd[1]);
+    errno = 0;
+    ok (recvfd_batch (pfd[0], &in) < 0 && errno == ECONNRESET,
+        "recvfd_batch fails with ECONNRESET when sender closes pipe");
+    iobatch_clean (&in);
+    close (pfd[0]);
+}
+
 void test_inval (void)
 {
     flux_msg_t *msg;
@@ -310,6 +420,16 @@ void test_inval (void)
     ok (sendfd (0, NULL, NULL) < 0 && errno == EINVAL,
         "senfd msg=NULL fails with EINVAL");
 
+    errno = 0;
+    ok (sendfd_batch (-1, NULL) < 0 && errno == EINVAL,
+        "sendfd_batch fd=-1 fails with EINVAL");
+    errno = 0;
+    ok (recvfd_batch (-1, NULL) < 0 && errno == EINVAL,
+        "recvfd_batch fd=-1 fails with EINVAL");
+    errno = 0;
+    ok (iobatch_append (NULL, msg) < 0 && errno == EINVAL,
+        "iobatch_append b=NULL fails with EINVAL");
+
     flux_msg_destroy (msg);
 }
 
@@ -324,6 +444,10 @@ int main (int argc, char *argv[])
     test_nonblock (4096, 256);
     test_nonblock (16384, 64);
     test_nonblock (1048586, 1);
+    test_batch (64, 1024);
+    test_batch (16384, 64);
+    test_batch (1048586, 2);
+    test_batch_eof ();
     test_inval ();
 
     done_testing();
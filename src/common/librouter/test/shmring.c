@@ -0,0 +1,268 @@
+/************************************************************\
+ * Copyright 2021 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <unistd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <flux/core.h>
+
+#include "src/common/libtap/tap.h"
+#include "src/common/librouter/shmring.h"
+
+static flux_msg_t *create_msg (int size, int seq)
+{
+    flux_msg_t *msg;
+    char *buf;
+
+    if (!(buf = malloc (size)))
+        BAIL_OUT ("out of memory");
+    for (int i = 0; i < size; i++)
+        buf[i] = (char)(seq + i);
+    if (!(msg = flux_request_encode_raw ("a.b", buf, size)))
+        BAIL_OUT ("flux_request_encode_raw failed");
+    free (buf);
+    return msg;
+}
+
+static bool check_msg (const flux_msg_t *msg, int size, int seq)
+{
+    const char *buf;
+    int len;
+
+    if (!msg
+        || flux_request_decode_raw (msg, NULL, (const void **)&buf, &len) < 0)
+        return false;
+    if (len != size)
+        return false;
+    for (int i = 0; i < size; i++) {
+        if (buf[i] != (char)(seq + i))
+            return false;
+    }
+    return true;
+}
+
+/* Create a ring and attach to it through a dup of its fd,
+ * as a peer process would.
+ */
+static void ring_pair (size_t size, struct shmring **tx, struct shmring **rx)
+{
+    int fd;
+
+    if (!(*tx = shmring_create (size)))
+        BAIL_OUT ("shmring_create failed: %s", strerror (errno));
+    if ((fd = dup (shmring_fd (*tx))) < 0)
+        BAIL_OUT ("dup failed");
+    if (!(*rx = shmring_attach (fd, SHMRING_UNTRUSTED)))
+        BAIL_OUT ("shmring_attach failed: %s", strerror (errno));
+}
+
+void test_basic (void)
+{
+    struct shmring *tx, *rx;
+    flux_msg_t *msg, *rmsg;
+
+    ring_pair (4096, &tx, &rx);
+
+    ok (shmring_readable (rx) == false,
+        "shmring_readable is false on empty ring");
+    errno = 0;
+    ok (shmring_recv (rx) == NULL && errno == EAGAIN,
+        "shmring_recv on empty ring fails with EAGAIN");
+    ok (shmring_wait_readable (rx) == true,
+        "shmring_wait_readable says to wait");
+
+    msg = create_msg (100, 1);
+    ok (shmring_send (tx, msg) == 0,
+        "shmring_send works");
+    ok (shmring_wake_reader (tx) == true,
+        "shmring_wake_reader reports waiting reader");
+    ok (shmring_wake_reader (tx) == false,
+        "shmring_wake_reader clears request");
+    ok (shmring_readable (rx) == true,
+        "shmring_readable is true");
+    rmsg = shmring_recv (rx);
+    ok (check_msg (rmsg, 100, 1),
+        "shmring_recv returned sent message");
+    flux_msg_destroy (rmsg);
+    flux_msg_destroy (msg);
+
+    shmring_destroy (tx);
+    shmring_destroy (rx);
+}
+
+/* Fill a ring until send fails, then drain it, several times over
+ * so that messages wrap around the end of the ring.
+ */
+void test_full (void)
+{
+    struct shmring *tx, *rx;
+    flux_msg_t *msg, *rmsg;
+    int sent = 0;
+    int received = 0;
+    int errors = 0;
+
+    ring_pair (4096, &tx, &rx);
+
+    for (int round = 0; round < 8; round++) {
+        for (;;) {
+            msg = create_msg (300, sent);
+            if (shmring_send (tx, msg) < 0) {
+                if (errno != EAGAIN)
+                    errors++;
+                flux_msg_destroy (msg);
+                break;
+            }
+            flux_msg_destroy (msg);
+            sent++;
+        }
+        if (round == 0) {
+            ok (shmring_writable (tx) == false,
+                "shmring_writable is false on full ring");
+            ok (shmring_wait_writable (tx) == true,
+                "shmring_wait_writable says to wait");
+        }
+        while ((rmsg = shmring_recv (rx))) {
+            if (!check_msg (rmsg, 300, received))
+                errors++;
+            flux_msg_destroy (rmsg);
+            received++;
+        }
+        if (errno != EAGAIN)
+            errors++;
+        if (round == 0) {
+            ok (shmring_wake_writer (rx) == true,
+                "shmring_wake_writer reports waiting writer");
+            ok (shmring_writable (tx) == true,
+                "shmring_writable is true after ring is drained");
+        }
+    }
+    ok (errors == 0 && sent == received && sent > 8,
+        "sent and received %d messages through wrapping ring", sent);
+
+    shmring_destroy (tx);
+    shmring_destroy (rx);
+}
+
+/* Send messages larger than the ring, alternating send and recv.
+ */
+void test_oversize (void)
+{
+    struct shmring *tx, *rx;
+    flux_msg_t *msg, *rmsg = NULL;
+    int size = 100000;
+    int calls = 0;
+
+    ring_pair (4096, &tx, &rx);
+
+    for (int seq = 0; seq < 3; seq++) {
+        msg = create_msg (size, seq);
+        while (shmring_send (tx, msg) < 0) {
+            if (errno != EAGAIN)
+                BAIL_OUT ("shmring_send failed: %s", strerror (errno));
+            if (!(rmsg = shmring_recv (rx)) && errno != EAGAIN)
+                BAIL_OUT ("shmring_recv failed: %s", strerror (errno));
+            calls++;
+        }
+        while (!rmsg) {
+            if (!(rmsg = shmring_recv (rx)) && errno != EAGAIN)
+                BAIL_OUT ("shmring_recv failed: %s", strerror (errno));
+        }
+        ok (check_msg (rmsg, size, seq),
+            "message %d of size %d was streamed through ring", seq, size);
+        flux_msg_destroy (rmsg);
+        rmsg = NULL;
+        flux_msg_destroy (msg);
+    }
+    ok (calls > 3,
+        "it took multiple calls per message");
+
+    shmring_destroy (tx);
+    shmring_destroy (rx);
+}
+
+void test_corrupt (void)
+{
+    struct shmring *tx, *rx;
+    flux_msg_t *msg;
+    char buf[8] = { 0 };
+
+    ring_pair (4096, &tx, &rx);
+
+    msg = create_msg (10, 0);
+    if (shmring_send (tx, msg) < 0)
+        BAIL_OUT ("shmring_send failed");
+    flux_msg_destroy (msg);
+    /* Overwrite frame header with zeroes via fd (data starts at 1 page).
+     */
+    if (pwrite (shmring_fd (tx), buf, sizeof (buf), sysconf (_SC_PAGESIZE))
+        != sizeof (buf))
+        BAIL_OUT ("pwrite failed");
+    errno = 0;
+    ok (shmring_recv (rx) == NULL && errno == EPROTO,
+        "shmring_recv fails with EPROTO on corrupt frame");
+
+    shmring_destroy (tx);
+    shmring_destroy (rx);
+}
+
+void test_inval (void)
+{
+    int fd;
+    char path[] = "/tmp/shmring.XXXXXX";
+
+    errno = 0;
+    ok (shmring_create (0) == NULL && errno == EINVAL,
+        "shmring_create size=0 fails with EINVAL");
+    errno = 0;
+    ok (shmring_attach (-1, 0) == NULL && errno == EINVAL,
+        "shmring_attach fd=-1 fails with EINVAL");
+
+    if ((fd = mkstemp (path)) < 0)
+        BAIL_OUT ("mkstemp failed");
+    (void)unlink (path);
+    if (ftruncate (fd, 65536) < 0)
+        BAIL_OUT ("ftruncate failed");
+    errno = 0;
+    ok (shmring_attach (fd, SHMRING_UNTRUSTED) == NULL && errno == EPROTO,
+        "shmring_attach of unsealed regular file fails with EPROTO");
+
+    errno = 0;
+    ok (shmring_send (NULL, NULL) < 0 && errno == EINVAL,
+        "shmring_send ring=NULL fails with EINVAL");
+    errno = 0;
+    ok (shmring_recv (NULL) == NULL && errno == EINVAL,
+        "shmring_recv ring=NULL fails with EINVAL");
+    ok (shmring_fd (NULL) == -1,
+        "shmring_fd ring=NULL returns -1");
+    shmring_destroy (NULL);
+}
+
+int main (int argc, char *argv[])
+{
+    plan (NO_PLAN);
+
+    test_basic ();
+    test_full ();
+    test_oversize ();
+    test_corrupt ();
+    test_inval ();
+
+    done_testing ();
+    return 0;
+}
+
+/*
+ * vi:ts=4 sw=4 expandtab
+ */
@@ -12,12 +12,18 @@
 #include "config.h"
 #endif
 #include <sys/param.h>
+#include <sys/eventfd.h>
+#include <fcntl.h>
+#include <unistd.h>
 #include <flux/core.h>
 
 #include "src/common/libtap/tap.h"
 #include "src/common/libutil/unlink_recursive.h"
+#include "src/common/libutil/fdutils.h"
 #include "src/common/libtestutil/util.h"
 #include "src/common/librouter/usock.h"
+#include "src/common/librouter/sendfd.h"
+#include "src/common/librouter/shmring.h"
 
 #include "usock_util.h"
 
@@ -213,6 +219,123 @@ static void test_one_echo (flux_t *h)
     flux_msg_destroy (msg);
 }
 
+/* Switch to shared memory with a small ring, then echo messages smaller
+ * and larger than the ring.
+ */
+static void test_shmem_echo (flux_t *h)
+{
+    char sockpath[PATH_MAX + 1];
+    int sizes[] = { 0, 100, 4000, 100000 };
+    struct usock_client *client;
+    int fd;
+
+    if (snprintf (sockpath,
+                  sizeof (sockpath),
+                  "%s/server",
+                  tmpdir) >= sizeof (sockpath))
+        BAIL_OUT ("buffer overflow");
+    if ((fd = usock_client_connect (sockpath, USOCK_RETRY_DEFAULT)) < 0)
+        BAIL_OUT ("usock_client_connect failed");
+    if (!(client = usock_client_create (fd)))
+        BAIL_OUT ("usock_client_create failed");
+    ok (usock_client_enable_shmem (client, 4096) == 0,
+        "usock_client_enable_shmem works");
+    errno = 0;
+    ok (usock_client_enable_shmem (client, 4096) < 0 && errno == EINVAL,
+        "usock_client_enable_shmem fails with EINVAL if already enabled");
+    ok (usock_client_pollfd (client) != fd,
+        "usock_client_pollfd returns a different fd");
+    ok ((usock_client_pollevents (client) & FLUX_POLLOUT),
+        "usock_client_pollevents says POLLOUT");
+
+    for (int i = 0; i < sizeof (sizes) / sizeof (sizes[0]); i++) {
+        flux_msg_t *msg;
+        flux_msg_t *rmsg;
+        char *buf;
+
+        if (!(buf = calloc (1, sizes[i] + 1)))
+            BAIL_OUT ("calloc failed");
+        memset (buf, 'x', sizes[i]);
+        if (!(msg = flux_request_encode_raw ("a", buf, sizes[i])))
+            BAIL_OUT ("flux_request_encode_raw failed");
+        ok (usock_client_send (client, msg, 0) == 0,
+            "usock_client_send size=%d works", sizes[i]);
+        rmsg = usock_client_recv (client, 0);
+        ok (rmsg != NULL && equal_message (msg, rmsg),
+            "usock_client_recv returned matching message");
+        flux_msg_destroy (rmsg);
+        flux_msg_destroy (msg);
+        free (buf);
+    }
+    errno = 0;
+    ok (usock_client_recv (client, FLUX_O_NONBLOCK) == NULL
+        && errno == EAGAIN,
+        "usock_client_recv FLUX_O_NONBLOCK fails with EAGAIN");
+
+    diag ("disconnecting");
+
+    usock_client_destroy (client);
+    (void)close (fd);
+}
+
+/* Pass a regular file where the server expects its eventfd.
+ * The server should reject the shared memory request with EPROTO.
+ */
+static void test_shmem_bad_eventfd (flux_t *h)
+{
+    char sockpath[PATH_MAX + 1];
+    char path[PATH_MAX + 1];
+    struct shmring *c2s;
+    struct shmring *s2c;
+    struct usock_client *client;
+    flux_msg_t *msg;
+    int fds[4];
+    int fd;
+    int errnum;
+
+    if (snprintf (sockpath,
+                  sizeof (sockpath),
+                  "%s/server",
+                  tmpdir) >= sizeof (sockpath)
+        || snprintf (path,
+                     sizeof (path),
+                     "%s/notanevent",
+                     tmpdir) >= sizeof (path))
+        BAIL_OUT ("buffer overflow");
+    if ((fd = usock_client_connect (sockpath, USOCK_RETRY_DEFAULT)) < 0)
+        BAIL_OUT ("usock_client_connect failed");
+    if (!(client = usock_client_create (fd)))
+        BAIL_OUT ("usock_client_create failed");
+    if (!(c2s = shmring_create (4096)) || !(s2c = shmring_create (4096)))
+        BAIL_OUT ("shmring_create failed");
+    fds[0] = shmring_fd (c2s);
+    fds[1] = shmring_fd (s2c);
+    if ((fds[2] = open (path, O_RDWR | O_CREAT, 0600)) < 0
+        || (fds[3] = eventfd (0, EFD_CLOEXEC)) < 0)
+        BAIL_OUT ("could not create file descriptors");
+    if (!(msg = flux_request_encode ("usock.shmem", NULL)))
+        BAIL_OUT ("flux_request_encode failed");
+    ok (fd_set_blocking (fd) == 0
+        && sendfd_rights (fd, msg, fds, 4) == 0
+        && fd_set_nonblocking (fd) == 0,
+        "sent shmem request with a regular file as server eventfd");
+    flux_msg_destroy (msg);
+    msg = usock_client_recv (client, 0);
+    ok (msg != NULL
+        && flux_msg_get_errnum (msg, &errnum) == 0
+        && errnum == EPROTO,
+        "server rejected shmem request with EPROTO");
+    flux_msg_destroy (msg);
+
+    usock_client_destroy (client);
+    (void)close (fd);
+    (void)close (fds[2]);
+    (void)close (fds[3]);
+    (void)unlink (path);
+    shmring_destroy (c2s);
+    shmring_destroy (s2c);
+}
+
 struct async_ctx {
     flux_reactor_t *r;
     flux_msg_t *msg;
@@ -305,6 +428,8 @@ int main (int argc, char *argv[])
 
     test_early_disconnect (h);
     test_one_echo (h);
+    test_shmem_echo (h);
+    test_shmem_bad_eventfd (h);
     test_async_stream (h, 1024, 1024);
     test_async_stream (h, 4096, 256);
     test_async_stream (h, 16384, 64);
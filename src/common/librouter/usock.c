@@ -31,6 +31,27 @@
  * - usock_conn_send() adds a message to a queue, starts fd (write) watcher.
  * - Register a receive callback to receive complete messages from client.
  * - Register an error callback to be notified when I/O errors occur.
+ *
+ * Batched I/O:
+ * - Each read wakeup reads as much as is available into a buffer, then
+ *   all complete messages in the buffer are passed to the receive callback.
+ * - Each write wakeup encodes queued messages into a buffer, up to
+ *   USOCK_WRITE_BUDGET bytes, and writes them with one system call.
+ * - usock_conn_get_stats() returns system call and message counts.
+ *
+ * Shared memory:
+ * - A client may call usock_client_enable_shmem() after connecting to
+ *   switch message traffic to a pair of shared memory rings (see shmring.h).
+ * - The client creates the rings and two eventfds, and passes them to the
+ *   server with a "usock.shmem" request (SCM_RIGHTS).  This must be the
+ *   first message on the connection.  The server responds on the socket,
+ *   then both sides move to the rings.  The socket remains open so that
+ *   each side can detect when the other goes away.
+ * - A peer that finds a ring empty (or full) arms a wakeup flag in the ring
+ *   and waits on its eventfd.  The eventfd is only signaled when the flag
+ *   is set, so a busy connection exchanges messages without system calls.
+ * - Servers that predate this feature route the request to the broker,
+ *   which fails it with ENOSYS, and the client continues with the socket.
  */
 
 #if HAVE_CONFIG_H
@@ -39,6 +60,8 @@
 #include <sys/un.h>
 #include <sys/socket.h>
 #include <sys/stat.h>
+#include <sys/eventfd.h>
+#include <sys/epoll.h>
 #include <poll.h>
 #include <unistd.h>
 #include <errno.h>
@@ -54,9 +77,26 @@
 
 #include "usock.h"
 #include "sendfd.h"
+#include "shmring.h"
 
 #define LISTEN_BACKLOG 5
 
+#define USOCK_WRITE_BUDGET 262144
+
+#define USOCK_SHM_TOPIC "usock.shmem"
+#define USOCK_SHM_SIZE_DEFAULT (1024*1024)
+#define USOCK_SHM_RECV_BUDGET 1024
+
+/* Order of file descriptors passed with the USOCK_SHM_TOPIC request.
+ */
+enum {
+    SHM_FD_C2S,             // client to server ring
+    SHM_FD_S2C,             // server to client ring
+    SHM_FD_SERVER_EFD,      // eventfd to wake server
+    SHM_FD_CLIENT_EFD,      // eventfd to wake client
+    SHM_FD_COUNT,
+};
+
 #ifndef UUID_STR_LEN
 #define UUID_STR_LEN 37     // defined in later libuuid headers
 #endif
@@ -74,7 +114,18 @@ struct usock_server {
 struct usock_io {
     int fd;
     flux_watcher_t *w;
-    struct iobuf iobuf;
+    struct iobatch batch;
+};
+
+/* Shared memory transport, from the point of view of one side.
+ */
+struct usock_shm {
+    struct shmring *rx;
+    struct shmring *tx;
+    int efd;                // signaled by peer
+    int peer_efd;           // signal peer
+    flux_watcher_t *w;      // efd watcher (server)
+    zlist_t *outqueue;      // messages waiting for space in tx (server)
 };
 
 struct usock_conn {
@@ -82,6 +133,12 @@ struct usock_conn {
     struct usock_io in;
     struct usock_io out;
     zlist_t *outqueue;
+    struct usock_conn_stats stats;
+    flux_reactor_t *r;
+
+    struct usock_shm *shm;
+    int rights[SHM_FD_COUNT];
+    int nrights;
 
     usock_conn_close_f close_cb;
     void *close_arg;
@@ -100,14 +157,66 @@ struct usock_conn {
     int refcount;
 
     unsigned char enable_close_on_destroy:1;
+    unsigned char enable_shm:1;
 };
 
 struct usock_client {
     int fd;
     struct iobuf in_iobuf;
     struct iobuf out_iobuf;
+    struct usock_shm *shm;
+    int epfd;
 };
 
+static int shm_signal (int efd)
+{
+    uint64_t val = 1;
+
+    if (write (efd, &val, sizeof (val)) < 0 && errno != EAGAIN)
+        return -1;
+    return 0;
+}
+
+static void shm_drain (int efd)
+{
+    uint64_t val;
+
+    (void)read (efd, &val, sizeof (val));
+}
+
+static void shm_destroy (struct usock_shm *shm)
+{
+    if (shm) {
+        int saved_errno = errno;
+        flux_watcher_destroy (shm->w);
+        if (shm->outqueue) {
+            flux_msg_t *msg;
+            while ((msg = zlist_pop (shm->outqueue)))
+                flux_msg_decref (msg);
+            zlist_destroy (&shm->outqueue);
+        }
+        shmring_destroy (shm->rx);
+        shmring_destroy (shm->tx);
+        if (shm->efd >= 0)
+            (void)close (shm->efd);
+        if (shm->peer_efd >= 0)
+            (void)close (shm->peer_efd);
+        free (shm);
+        errno = saved_errno;
+    }
+}
+
+static struct usock_shm *shm_alloc (void)
+{
+    struct usock_shm *shm;
+
+    if (!(shm = calloc (1, sizeof (*shm))))
+        return NULL;
+    shm->efd = -1;
+    shm->peer_efd = -1;
+    return shm;
+}
+
 const struct flux_msg_cred *usock_conn_get_cred (struct usock_conn *conn)
 {
     return conn ? &conn->cred : NULL;
@@ -118,6 +227,16 @@ const char *usock_conn_get_uuid (struct usock_conn *conn)
     return conn ? conn->uuid_str : NULL;
 }
 
+const struct usock_conn_stats *usock_conn_get_stats (struct usock_conn *conn)
+{
+    return conn ? &conn->stats : NULL;
+}
+
+bool usock_conn_is_shmem (struct usock_conn *conn)
+{
+    return conn && conn->shm ? true : false;
+}
+
 void usock_conn_set_error_cb (struct usock_conn *conn,
                               usock_conn_error_f cb,
                               void *arg)
@@ -180,12 +299,69 @@ static void conn_io_error (struct usock_conn *conn, int errnum)
     }
 }
 
+static int conn_shm_wake_peer (struct usock_conn *conn)
+{
+    conn->stats.wakeups++;
+    return shm_signal (conn->shm->peer_efd);
+}
+
+/* Move queued messages into the ring until it is full.
+ * If it fills, arm a wakeup for when the client has made space.
+ */
+static int conn_shm_flush (struct usock_conn *conn)
+{
+    struct usock_shm *shm = conn->shm;
+    flux_msg_t *msg;
+
+    while ((msg = zlist_head (shm->outqueue))) {
+        if (shmring_send (shm->tx, msg) < 0) {
+            if (errno != EAGAIN)
+                return -1;
+            if (shmring_wait_writable (shm->tx))
+                break;
+            continue;
+        }
+        msg = zlist_pop (shm->outqueue);
+        flux_msg_decref (msg);
+        conn->stats.send_count++;
+    }
+    if (shmring_wake_reader (shm->tx))
+        return conn_shm_wake_peer (conn);
+    return 0;
+}
+
+static int conn_shm_send (struct usock_conn *conn, const flux_msg_t *msg)
+{
+    struct usock_shm *shm = conn->shm;
+
+    if (zlist_size (shm->outqueue) == 0) {
+        if (shmring_send (shm->tx, msg) == 0) {
+            conn->stats.send_count++;
+            if (shmring_wake_reader (shm->tx))
+                return conn_shm_wake_peer (conn);
+            return 0;
+        }
+        if (errno != EAGAIN)
+            return -1;
+    }
+    if (zlist_append (shm->outqueue, (void *)flux_msg_incref (msg)) < 0) {
+        flux_msg_decref (msg);
+        errno = ENOMEM;
+        return -1;
+    }
+    if (zlist_size (shm->outqueue) == 1)
+        return conn_shm_flush (conn);
+    return 0;
+}
+
 int usock_conn_send (struct usock_conn *conn, const flux_msg_t *msg)
 {
     if (!conn || !msg) {
         errno = EINVAL;
         return -1;
     }
+    if (conn->shm)
+        return conn_shm_send (conn, msg);
     if (zlist_append (conn->outqueue, (void *)flux_msg_incref (msg)) < 0) {
         flux_msg_decref (msg);
         errno = ENOMEM;
@@ -195,6 +371,183 @@ int usock_conn_send (struct usock_conn *conn, const flux_msg_t *msg)
     return 0;
 }
 
+static void conn_close_rights (struct usock_conn *conn)
+{
+    for (int i = 0; i < conn->nrights; i++) {
+        if (conn->rights[i] >= 0)
+            (void)close (conn->rights[i]);
+    }
+    conn->nrights = 0;
+}
+
+/* Read from the socket.  Until the first message has been received,
+ * accept file descriptors, which may accompany a USOCK_SHM_TOPIC request.
+ */
+static ssize_t conn_recv (struct usock_conn *conn)
+{
+    int nfds;
+    ssize_t n;
+
+    if (!conn->enable_shm)
+        return recvfd_batch (conn->in.fd, &conn->in.batch);
+    nfds = SHM_FD_COUNT - conn->nrights;
+    n = recvfd_batch_rights (conn->in.fd,
+                             &conn->in.batch,
+                             conn->rights + conn->nrights,
+                             &nfds);
+    conn->nrights += nfds;
+    return n;
+}
+
+static void conn_shm_cb (flux_reactor_t *r,
+                         flux_watcher_t *w,
+                         int revents,
+                         void *arg)
+{
+    struct usock_conn *conn = arg;
+    struct usock_shm *shm = conn->shm;
+    flux_msg_t *msg;
+    int count = 0;
+
+    shm_drain (shm->efd);
+    while (count < USOCK_SHM_RECV_BUDGET) {
+        if (!(msg = shmring_recv (shm->rx))) {
+            if (errno != EAGAIN)
+                goto error;
+            if (shmring_wait_readable (shm->rx))
+                break;
+            continue;
+        }
+        count++;
+        conn->stats.recv_count++;
+        if (auth_init_message (msg, &conn->cred) < 0) {
+            ERRNO_SAFE_WRAP (flux_msg_destroy, msg);
+            goto error;
+        }
+        if (conn->recv_cb)
+            conn->recv_cb (conn, msg, conn->recv_arg);
+        flux_msg_destroy (msg);
+    }
+    /* If the budget was exhausted, come back after other watchers have run.
+     */
+    if (count == USOCK_SHM_RECV_BUDGET && shm_signal (shm->efd) < 0)
+        goto error;
+    if (shmring_wake_writer (shm->rx) && conn_shm_wake_peer (conn) < 0)
+        goto error;
+    if (conn_shm_flush (conn) < 0)
+        goto error;
+    return;
+error:
+    conn_io_error (conn, errno);
+}
+
+/* Return true if 'fd' is an eventfd.  A peer could pass some other
+ * always-readable fd, which would make the server watcher spin.
+ */
+static bool fd_is_eventfd (int fd)
+{
+    char path[64];
+    char target[64];
+    ssize_t n;
+
+    if (snprintf (path, sizeof (path), "/proc/self/fd/%d", fd)
+            >= sizeof (path)
+        || (n = readlink (path, target, sizeof (target) - 1)) < 0)
+        return false;
+    target[n] = '\0';
+    return !strcmp (target, "anon_inode:[eventfd]");
+}
+
+/* Attach to rings and eventfds passed by the client.
+ * Both rings were created by the client, so neither is trusted.
+ */
+static struct usock_shm *conn_shm_create (struct usock_conn *conn)
+{
+    struct usock_shm *shm;
+    int fds[SHM_FD_COUNT];
+
+    if (!(shm = shm_alloc ()))
+        return NULL;
+    /* The rings and shm take ownership of the file descriptors.
+     */
+    for (int i = 0; i < SHM_FD_COUNT; i++)
+        fds[i] = conn->rights[i];
+    conn->nrights = 0;
+    shm->efd = fds[SHM_FD_SERVER_EFD];
+    shm->peer_efd = fds[SHM_FD_CLIENT_EFD];
+    if (!fd_is_eventfd (shm->efd) || !fd_is_eventfd (shm->peer_efd)) {
+        ERRNO_SAFE_WRAP (close, fds[SHM_FD_C2S]);
+        ERRNO_SAFE_WRAP (close, fds[SHM_FD_S2C]);
+        errno = EPROTO;
+        goto error;
+    }
+    if (!(shm->rx = shmring_attach (fds[SHM_FD_C2S], SHMRING_UNTRUSTED))) {
+        ERRNO_SAFE_WRAP (close, fds[SHM_FD_S2C]);
+        goto error;
+    }
+    if (!(shm->tx = shmring_attach (fds[SHM_FD_S2C], SHMRING_UNTRUSTED)))
+        goto error;
+    if (fd_set_nonblocking (shm->efd) < 0
+        || fd_set_nonblocking (shm->peer_efd) < 0)
+        goto error;
+    if (!(shm->outqueue = zlist_new ())) {
+        errno = ENOMEM;
+        goto error;
+    }
+    if (!(shm->w = flux_fd_watcher_create (conn->r,
+                                           shm->efd,
+                                           FLUX_POLLIN,
+                                           conn_shm_cb,
+                                           conn)))
+        goto error;
+    return shm;
+error:
+    shm_destroy (shm);
+    return NULL;
+}
+
+/* Handle USOCK_SHM_TOPIC request.
+ * Return 1 if 'msg' was the request, 0 if not, or -1 on fatal error.
+ */
+static int conn_shm_request (struct usock_conn *conn, const flux_msg_t *msg)
+{
+    struct usock_shm *shm = NULL;
+    const char *topic;
+    flux_msg_t *rep;
+    int type;
+    int errnum = 0;
+
+    if (flux_msg_get_type (msg, &type) < 0
+        || type != FLUX_MSGTYPE_REQUEST
+        || flux_msg_get_topic (msg, &topic) < 0
+        || strcmp (topic, USOCK_SHM_TOPIC) != 0)
+        return 0;
+    if (conn->nrights != SHM_FD_COUNT)
+        errnum = EPROTO;
+    else if (zlist_size (conn->outqueue) > 0
+             || iobatch_pending (&conn->out.batch) > 0)
+        errnum = EBUSY;
+    else if (!(shm = conn_shm_create (conn)))
+        errnum = errno;
+    if (!(rep = flux_response_derive (msg, errnum))
+        || usock_conn_send (conn, rep) < 0) {
+        flux_msg_destroy (rep);
+        shm_destroy (shm);
+        return -1;
+    }
+    flux_msg_destroy (rep);
+    /* The response goes out on the socket; everything after it
+     * goes through the ring.  Catch up on anything already in the ring.
+     */
+    if (shm) {
+        conn->shm = shm;
+        flux_watcher_start (shm->w);
+        if (shm_signal (shm->efd) < 0)
+            return -1;
+    }
+    return 1;
+}
+
 static void conn_read_cb (flux_reactor_t *r,
                           flux_watcher_t *w,
                           int revents,
@@ -209,20 +562,43 @@ static void conn_read_cb (flux_reactor_t *r,
     if ((revents & FLUX_POLLIN)) {
         flux_msg_t *msg;
 
-        if (!(msg = recvfd (conn->in.fd, &conn->in.iobuf))) {
+        conn->stats.recv_calls++;
+        if (conn_recv (conn) < 0) {
             if (errno != EWOULDBLOCK && errno != EAGAIN)
                 goto error;
+            return;
         }
-        else {
+        /* N.B. the receive callback must not destroy the connection.
+         */
+        while ((msg = iobatch_next (&conn->in.batch))) {
+            conn->stats.recv_count++;
+
+            /* The shared memory request may only be the first message.
+             */
+            if (conn->enable_shm) {
+                int rc = conn_shm_request (conn, msg);
+                conn->enable_shm = 0;
+                conn_close_rights (conn);
+                if (rc != 0) {
+                    flux_msg_destroy (msg);
+                    if (rc < 0)
+                        goto error;
+                    continue;
+                }
+            }
+
             /* Update message credentials based on connected creds.
              */
-            if (auth_init_message (msg, &conn->cred) < 0)
+            if (auth_init_message (msg, &conn->cred) < 0) {
+                ERRNO_SAFE_WRAP (flux_msg_destroy, msg);
                 goto error;
-
+            }
             if (conn->recv_cb)
                 conn->recv_cb (conn, msg, conn->recv_arg);
             flux_msg_destroy (msg);
         }
+        if (errno != EAGAIN)
+            goto error;
     }
     return;
 error:
@@ -251,9 +627,18 @@ static void conn_write_cb (flux_reactor_t *r,
     }
 
     if ((revents & FLUX_POLLOUT)) {
-        const flux_msg_t *msg = zlist_head (conn->outqueue);
-        if (msg) {
-            if (sendfd (conn->out.fd, msg, &conn->out.iobuf) < 0) {
+        const flux_msg_t *msg;
+
+        while (iobatch_pending (&conn->out.batch) < USOCK_WRITE_BUDGET
+               && (msg = zlist_head (conn->outqueue))) {
+            if (iobatch_append (&conn->out.batch, msg) < 0)
+                goto error;
+            (void) conn_outqueue_drop (conn);
+            conn->stats.send_count++;
+        }
+        if (iobatch_pending (&conn->out.batch) > 0) {
+            conn->stats.send_calls++;
+            if (sendfd_batch (conn->out.fd, &conn->out.batch) < 0) {
                 if (errno == EPIPE) {
                     /* Remote peer has closed connection.
                      * However, there may still be pending messages sent
@@ -264,17 +649,17 @@ static void conn_write_cb (flux_reactor_t *r,
                      */
                     while (conn_outqueue_drop (conn))
                         ;
+                    iobatch_clean (&conn->out.batch);
                     flux_watcher_stop (conn->out.w);
                 }
                 else if (errno != EWOULDBLOCK && errno != EAGAIN)
                     goto error;
-            }
-            else {
-                (void) conn_outqueue_drop (conn);
-                if (zlist_size (conn->outqueue) == 0)
-                    flux_watcher_stop (conn->out.w);
+                return;
             }
         }
+        if (iobatch_pending (&conn->out.batch) == 0
+            && zlist_size (conn->outqueue) == 0)
+            flux_watcher_stop (conn->out.w);
     }
     return;
 error:
@@ -330,7 +715,7 @@ void usock_conn_destroy (struct usock_conn *conn)
             (*conn->close_cb) (conn, conn->close_arg);
         aux_destroy (&conn->aux);
         flux_watcher_destroy (conn->in.w);
-        iobuf_clean (&conn->in.iobuf);
+        iobatch_clean (&conn->in.batch);
         if (conn->outqueue) {
             const flux_msg_t *msg;
             while ((msg = zlist_pop (conn->outqueue)))
@@ -338,7 +723,9 @@ void usock_conn_destroy (struct usock_conn *conn)
             zlist_destroy (&conn->outqueue);
         }
         flux_watcher_destroy (conn->out.w);
-        iobuf_clean (&conn->out.iobuf);
+        iobatch_clean (&conn->out.batch);
+        shm_destroy (conn->shm);
+        conn_close_rights (conn);
         if (conn->server)
             zlist_remove (conn->server->connections, conn);
         if (conn->enable_close_on_destroy) {
@@ -362,6 +749,16 @@ void usock_server_set_acceptor (struct usock_server *server,
     }
 }
 
+struct usock_conn *usock_server_first_conn (struct usock_server *server)
+{
+    return server ? zlist_first (server->connections) : NULL;
+}
+
+struct usock_conn *usock_server_next_conn (struct usock_server *server)
+{
+    return server ? zlist_next (server->connections) : NULL;
+}
+
 void usock_server_destroy (struct usock_server *server)
 {
     if (server) {
@@ -421,6 +818,7 @@ struct usock_conn *usock_conn_create (flux_reactor_t *r, int infd, int outfd)
     if (!(conn = calloc (1, sizeof (*conn))))
         return NULL;
 
+    conn->r = r;
     conn->in.fd = infd;
     conn->out.fd = outfd;
     conn->cred.userid = FLUX_USERID_UNKNOWN;
@@ -432,7 +830,7 @@ struct usock_conn *usock_conn_create (flux_reactor_t *r, int infd, int outfd)
                                                conn_read_cb,
                                                conn)))
         goto error;
-    iobuf_init (&conn->in.iobuf);
+    iobatch_init (&conn->in.batch);
 
     if (!(conn->out.w = flux_fd_watcher_create (r,
                                                 conn->out.fd,
@@ -440,7 +838,7 @@ struct usock_conn *usock_conn_create (flux_reactor_t *r, int infd, int outfd)
                                                 conn_write_cb,
                                                 conn)))
         goto error;
-    iobuf_init (&conn->out.iobuf);
+    iobatch_init (&conn->out.batch);
     uuid_generate (conn->uuid);
     uuid_unparse (conn->uuid, conn->uuid_str);
 
@@ -468,6 +866,7 @@ static struct usock_conn *server_accept (struct usock_server *server,
         return NULL;
     }
     conn->enable_close_on_destroy = 1;
+    conn->enable_shm = 1;
     return conn;
 }
 
@@ -581,11 +980,36 @@ static bool is_poll_error (int revents)
  * If none are pending, return 0.  If an error occurred, return FLUX_POLLERR.
  * N.B. see op->pollevents in libflux/connector.h
  */
+static int client_shm_pollevents (struct usock_client *client)
+{
+    struct usock_shm *shm = client->shm;
+    struct epoll_event ev[2];
+    int flux_revents = 0;
+    int n;
+
+    if ((n = epoll_wait (client->epfd, ev, 2, 0)) < 0)
+        return FLUX_POLLERR;
+    for (int i = 0; i < n; i++) {
+        if (ev[i].data.fd == shm->efd)
+            shm_drain (shm->efd);
+        else
+            flux_revents |= FLUX_POLLERR; // socket EOF or error
+    }
+    if (!shmring_wait_readable (shm->rx))
+        flux_revents |= FLUX_POLLIN;
+    if (!shmring_wait_writable (shm->tx))
+        flux_revents |= FLUX_POLLOUT;
+    return flux_revents;
+}
+
 int usock_client_pollevents (struct usock_client *client)
 {
     struct pollfd pfd;
     int flux_revents = 0;
 
+    if (client->shm)
+        return client_shm_pollevents (client);
+
     pfd.fd = client->fd;
     pfd.events = POLLIN | POLLOUT;
     pfd.revents = 0;
@@ -608,6 +1032,8 @@ int usock_client_pollevents (struct usock_client *client)
  */
 int usock_client_pollfd (struct usock_client *client)
 {
+    if (client->shm)
+        return client->epfd;
     return client->fd;
 }
 
@@ -631,6 +1057,72 @@ static int usock_client_poll (int fd, int events)
     return 0;
 }
 
+/* Block until the server signals the client eventfd.
+ * If the socket becomes readable, the server has gone away.
+ */
+static int client_shm_wait (struct usock_client *client)
+{
+    struct epoll_event ev[2];
+    int n;
+
+    if ((n = epoll_wait (client->epfd, ev, 2, -1)) < 0)
+        return -1;
+    for (int i = 0; i < n; i++) {
+        if (ev[i].data.fd != client->shm->efd) {
+            errno = EIO;
+            return -1;
+        }
+    }
+    shm_drain (client->shm->efd);
+    return 0;
+}
+
+static int client_shm_send (struct usock_client *client,
+                            const flux_msg_t *msg,
+                            int flags)
+{
+    struct usock_shm *shm = client->shm;
+    int rc;
+
+    while ((rc = shmring_send (shm->tx, msg)) < 0) {
+        if (errno != EAGAIN)
+            break;
+        /* A message larger than the ring may have been partially sent.
+         */
+        if (shmring_wake_reader (shm->tx) && shm_signal (shm->peer_efd) < 0)
+            return -1;
+        if ((flags & FLUX_O_NONBLOCK))
+            return -1;
+        if (shmring_wait_writable (shm->tx) && client_shm_wait (client) < 0)
+            return -1;
+    }
+    if (shmring_wake_reader (shm->tx) && shm_signal (shm->peer_efd) < 0)
+        return -1;
+    return rc;
+}
+
+static flux_msg_t *client_shm_recv (struct usock_client *client, int flags)
+{
+    struct usock_shm *shm = client->shm;
+    flux_msg_t *msg;
+
+    while (!(msg = shmring_recv (shm->rx))) {
+        if (errno != EAGAIN)
+            break;
+        if (shmring_wake_writer (shm->rx) && shm_signal (shm->peer_efd) < 0)
+            return NULL;
+        if ((flags & FLUX_O_NONBLOCK))
+            return NULL;
+        if (shmring_wait_readable (shm->rx) && client_shm_wait (client) < 0)
+            return NULL;
+    }
+    if (shmring_wake_writer (shm->rx) && shm_signal (shm->peer_efd) < 0) {
+        ERRNO_SAFE_WRAP (flux_msg_destroy, msg);
+        return NULL;
+    }
+    return msg;
+}
+
 /* Try to send message.  If flags does not include FLUX_O_NONBLOCK,
  * and sendfd fails with EWOULDBLOCK/EAGAIN, then poll(POLLOUT) and
  * keep trying until the full message is sent.
@@ -639,6 +1131,8 @@ int usock_client_send (struct usock_client *client,
                        const flux_msg_t *msg,
                        int flags)
 {
+    if (client->shm)
+        return client_shm_send (client, msg, flags);
     while (sendfd (client->fd, msg, &client->out_iobuf) < 0) {
         if (errno != EWOULDBLOCK && errno != EAGAIN)
             return -1;
@@ -658,6 +1152,8 @@ flux_msg_t *usock_client_recv (struct usock_client *client, int flags)
 {
     flux_msg_t *msg;
 
+    if (client->shm)
+        return client_shm_recv (client, flags);
     while (!(msg = recvfd (client->fd, &client->in_iobuf))) {
         if (errno != EWOULDBLOCK && errno != EAGAIN)
             return NULL;
@@ -745,6 +1241,7 @@ struct usock_client *usock_client_create (int fd)
         return NULL;
 
     client->fd = fd;
+    client->epfd = -1;
     iobuf_init (&client->in_iobuf);
     iobuf_init (&client->out_iobuf);
 
@@ -758,9 +1255,86 @@ error:
     return NULL;
 }
 
+/* Create rings and eventfds for the client side of a connection.
+ * The client transmits on the c2s ring and receives on the s2c ring.
+ */
+static struct usock_shm *client_shm_create (size_t size)
+{
+    struct usock_shm *shm;
+
+    if (!(shm = shm_alloc ()))
+        return NULL;
+    if (!(shm->tx = shmring_create (size))
+        || !(shm->rx = shmring_create (size)))
+        goto error;
+    if ((shm->efd = eventfd (0, EFD_NONBLOCK | EFD_CLOEXEC)) < 0
+        || (shm->peer_efd = eventfd (0, EFD_NONBLOCK | EFD_CLOEXEC)) < 0)
+        goto error;
+    return shm;
+error:
+    shm_destroy (shm);
+    return NULL;
+}
+
+static int epoll_add (int epfd, int fd)
+{
+    struct epoll_event ev;
+
+    memset (&ev, 0, sizeof (ev));
+    ev.events = EPOLLIN;
+    ev.data.fd = fd;
+    return epoll_ctl (epfd, EPOLL_CTL_ADD, fd, &ev);
+}
+
+int usock_client_enable_shmem (struct usock_client *client, size_t size)
+{
+    struct usock_shm *shm;
+    int fds[SHM_FD_COUNT];
+    flux_msg_t *msg = NULL;
+    int epfd = -1;
+
+    if (!client || client->shm) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (!(shm = client_shm_create (size > 0 ? size : USOCK_SHM_SIZE_DEFAULT)))
+        return -1;
+    if ((epfd = epoll_create1 (EPOLL_CLOEXEC)) < 0
+        || epoll_add (epfd, shm->efd) < 0
+        || epoll_add (epfd, client->fd) < 0)
+        goto error;
+    fds[SHM_FD_C2S] = shmring_fd (shm->tx);
+    fds[SHM_FD_S2C] = shmring_fd (shm->rx);
+    fds[SHM_FD_SERVER_EFD] = shm->peer_efd;
+    fds[SHM_FD_CLIENT_EFD] = shm->efd;
+    if (!(msg = flux_request_encode (USOCK_SHM_TOPIC, NULL)))
+        goto error;
+    if (fd_set_blocking (client->fd) < 0
+        || sendfd_rights (client->fd, msg, fds, SHM_FD_COUNT) < 0
+        || fd_set_nonblocking (client->fd) < 0)
+        goto error;
+    flux_msg_destroy (msg);
+    if (!(msg = usock_client_recv (client, 0))
+        || flux_response_decode (msg, NULL, NULL) < 0)
+        goto error;
+    flux_msg_destroy (msg);
+    client->shm = shm;
+    client->epfd = epfd;
+    return 0;
+error:
+    ERRNO_SAFE_WRAP (flux_msg_destroy, msg);
+    if (epfd >= 0)
+        ERRNO_SAFE_WRAP (close, epfd);
+    shm_destroy (shm);
+    return -1;
+}
+
 void usock_client_destroy (struct usock_client *client)
 {
     if (client) {
+        shm_destroy (client->shm);
+        if (client->epfd >= 0)
+            ERRNO_SAFE_WRAP (close, client->epfd);
         iobuf_clean (&client->in_iobuf);
         iobuf_clean (&client->out_iobuf);
         ERRNO_SAFE_WRAP (free, client);
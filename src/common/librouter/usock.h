@@ -12,6 +12,7 @@
 #define _ROUTER_USOCK_H
 
 #include <sys/types.h>
+#include <stdbool.h>
 #include <flux/core.h>
 
 #include "auth.h"
@@ -36,6 +37,16 @@ struct usock_retry_params {
     .max_delay = 0, \
 }
 
+/* Per-connection I/O counts.
+ */
+struct usock_conn_stats {
+    uint64_t recv_calls;    // read(2) calls
+    uint64_t recv_count;    // messages received
+    uint64_t send_calls;    // write(2) calls
+    uint64_t send_count;    // messages sent
+    uint64_t wakeups;       // eventfd wakeups sent to peer (shmem only)
+};
+
 typedef void (*usock_acceptor_f)(struct usock_conn *conn, void *arg);
 
 typedef void (*usock_conn_close_f)(struct usock_conn *conn,
@@ -61,6 +72,11 @@ void usock_server_set_acceptor (struct usock_server *server,
                                 usock_acceptor_f cb,
                                 void *arg);
 
+/* Iterate over server connections.
+ */
+struct usock_conn *usock_server_first_conn (struct usock_server *server);
+struct usock_conn *usock_server_next_conn (struct usock_server *server);
+
 /* Server connection for one client
  */
 
@@ -70,6 +86,12 @@ const struct flux_msg_cred *usock_conn_get_cred (struct usock_conn *conn);
 
 const char *usock_conn_get_uuid (struct usock_conn *conn);
 
+const struct usock_conn_stats *usock_conn_get_stats (struct usock_conn *conn);
+
+/* Return true if the client has switched the connection to shared memory.
+ */
+bool usock_conn_is_shmem (struct usock_conn *conn);
+
 void usock_conn_set_close_cb (struct usock_conn *conn,
                               usock_conn_close_f cb,
                               void *arg);
@@ -114,6 +136,13 @@ int usock_client_connect (const char *sockpath,
 struct usock_client *usock_client_create (int fd);
 void usock_client_destroy (struct usock_client *client);
 
+/* Move message traffic to shared memory rings of 'size' bytes (0=default).
+ * Call after usock_client_create(), before any messages are sent.
+ * On failure, e.g. ENOSYS if the server does not support it, the client
+ * continues to use the socket.
+ */
+int usock_client_enable_shmem (struct usock_client *client, size_t size);
+
 #endif /* !_ROUTER_USOCK_H */
 
 /*
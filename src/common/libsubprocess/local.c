@@ -14,8 +14,12 @@
 
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/stat.h>
 #include <wait.h>
 #include <unistd.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
 #include <errno.h>
 
 #include <flux/core.h>
@@ -24,6 +28,7 @@
 #include "src/common/libutil/log.h"
 #include "src/common/libutil/fdwalk.h"
 #include "src/common/libutil/fdutils.h"
+#include "src/common/libutil/errno_safe.h"
 
 #include "subprocess.h"
 #include "subprocess_private.h"
@@ -654,25 +659,332 @@ static int local_release_child (flux_subprocess_t *p)
     return 0;
 }
 
+/*  Reap child immediately after a failed exec(2). Expectation from
+ *   caller is that failure to exec will not require subsequent reaping
+ *   of child.
+ */
+static int local_exec_failed (flux_subprocess_t *p, int errnum)
+{
+    int status;
+    pid_t pid;
+
+    p->exec_failed_errno = errnum;
+    if ((pid = waitpid (p->pid, &status, 0)) <= 0)
+        return -1;
+    p->status = status;
+
+    /* spiritually FLUX_SUBPROCESS_EXEC_FAILED state at this
+     * point */
+    errno = p->exec_failed_errno;
+    return -1;
+}
+
 static int local_exec (flux_subprocess_t *p)
 {
-    if ((p->exec_failed_errno = local_release_child (p)) != 0) {
-        /*
-         *  Reap child immediately. Expectation from caller is that
-         *   failure to exec will not require subsequent reaping of
-         *   child.
-         */
-        int status;
-        pid_t pid;
-        if ((pid = waitpid (p->pid, &status, 0)) <= 0)
+    int errnum;
+
+    if ((errnum = local_release_child (p)) != 0)
+        return local_exec_failed (p, errnum);
+    p->state = FLUX_SUBPROCESS_RUNNING;
+
+    return 0;
+}
+
+/*  vfork(2) fast path.
+ *
+ *  When no pre_exec or post_fork hook needs to run between fork and
+ *   exec, the child is created with vfork(2), which shares the parent
+ *   address space and so avoids copying page tables of a large parent
+ *   (e.g. the broker).  The parent is suspended until the child calls
+ *   exec(2) or _exit(2), so the sync_fds handshake is not needed, and
+ *   an exec failure is reported back in shared memory.
+ *
+ *  Everything the child needs is prepared in the parent beforehand.
+ *   The child must not allocate memory, call stdio, or modify any
+ *   parent data structure.
+ */
+struct local_spawn {
+    char **argv;
+    char **env;
+    char *path;             // resolved argv[0], NULL if not found
+    int path_errnum;        // execvp(3) style errno if path is NULL
+    const char *cwd;
+    int stdio_fd[3];        // fd to dup2(2) onto 0-2, -1 to close, -2 to skip
+    int *keep_fds;          // channel fds to leave open across exec
+    int keep_count;
+    bool setpgrp;
+    volatile int errnum;    // set by child on failure
+};
+
+static bool local_spawn_supported (flux_subprocess_t *p)
+{
+    const char *cwd = flux_cmd_getcwd (p->cmd);
+
+    if (p->hooks.pre_exec || p->hooks.post_fork)
+        return false;
+    /* Let the fork path handle the /tmp fallback and its message
+     * if cwd is inaccessible.
+     */
+    if (cwd && access (cwd, X_OK) < 0)
+        return false;
+    return true;
+}
+
+static void local_spawn_cleanup (struct local_spawn *sp)
+{
+    free (sp->path);
+    free (sp->argv);
+    free (sp->env);
+    free (sp->keep_fds);
+}
+
+/*  Return true if 'path' is an executable regular file.  A relative
+ *   path is checked against 'cwd', which the child changes to before
+ *   exec.  On false, errno is EACCES if the file exists but may not be
+ *   executed.
+ */
+static bool local_spawn_executable (const char *cwd, const char *path)
+{
+    char *cpy = NULL;
+    struct stat st;
+    bool rc = false;
+
+    if (cwd && path[0] != '/') {
+        if (asprintf (&cpy, "%s/%s", cwd, path) < 0)
+            return false;
+        path = cpy;
+    }
+    if (stat (path, &st) < 0)
+        goto done;
+    if (!S_ISREG (st.st_mode) || access (path, X_OK) < 0) {
+        errno = EACCES;
+        goto done;
+    }
+    rc = true;
+done:
+    ERRNO_SAFE_WRAP (free, cpy);
+    return rc;
+}
+
+/*  Resolve argv[0] in the parent, searching PATH from the command
+ *   environment as execvp(3) would, so that the child can call
+ *   execve(2) without touching the environ it shares with the parent
+ *   (and any other threads).  If no executable is found, sp->path is
+ *   left NULL and sp->path_errnum is set for the child to report.
+ */
+static int local_spawn_resolve (flux_subprocess_t *p, struct local_spawn *sp)
+{
+    const char *name = sp->argv[0];
+    const char *path;
+
+    sp->path_errnum = ENOENT;
+    if (!name || *name == '\0')
+        return 0;
+    if (strchr (name, '/')) {
+        if (!(sp->path = strdup (name)))
             return -1;
-        p->status = status;
+        return 0;
+    }
+    if (!(path = flux_cmd_getenv (p->cmd, "PATH")))
+        path = "/bin:/usr/bin";
+    while (path) {
+        const char *end = strchr (path, ':');
+        int len = end ? end - path : strlen (path);
+        char *candidate;
+
+        /* an empty PATH element means the current directory */
+        if (asprintf (&candidate,
+                      "%.*s%s%s",
+                      len,
+                      path,
+                      len > 0 ? "/" : "",
+                      name) < 0)
+            return -1;
+        if (local_spawn_executable (sp->cwd, candidate)) {
+            sp->path = candidate;
+            return 0;
+        }
+        if (errno == EACCES)
+            sp->path_errnum = EACCES;
+        free (candidate);
+        path = end ? end + 1 : NULL;
+    }
+    return 0;
+}
+
+static int local_spawn_prepare (flux_subprocess_t *p, struct local_spawn *sp)
+{
+    struct subprocess_channel *c;
+    int i;
 
-        /* spiritually FLUX_SUBPROCESS_EXEC_FAILED state at this
-         * point */
-        errno = p->exec_failed_errno;
+    memset (sp, 0, sizeof (*sp));
+    for (i = 0; i < 3; i++)
+        sp->stdio_fd[i] = -2;
+    if (!(p->flags & FLUX_SUBPROCESS_FLAGS_STDIO_FALLTHROUGH)) {
+        if ((c = zhash_lookup (p->channels, "stdin")))
+            sp->stdio_fd[STDIN_FILENO] = c->child_fd;
+        c = zhash_lookup (p->channels, "stdout");
+        sp->stdio_fd[STDOUT_FILENO] = c ? c->child_fd : -1;
+        c = zhash_lookup (p->channels, "stderr");
+        sp->stdio_fd[STDERR_FILENO] = c ? c->child_fd : -1;
+    }
+    if (!(sp->keep_fds = calloc (zhash_size (p->channels) + 1,
+                                 sizeof (sp->keep_fds[0]))))
+        return -1;
+    c = zhash_first (p->channels);
+    while (c) {
+        if (c->child_fd != -1)
+            sp->keep_fds[sp->keep_count++] = c->child_fd;
+        c = zhash_next (p->channels);
+    }
+    sp->cwd = flux_cmd_getcwd (p->cmd);
+    sp->setpgrp = (p->flags & FLUX_SUBPROCESS_FLAGS_SETPGRP) ? true : false;
+    if (!(sp->argv = flux_cmd_argv_expand (p->cmd))
+        || !(sp->env = flux_cmd_env_expand (p->cmd))
+        || local_spawn_resolve (p, sp) < 0) {
+        local_spawn_cleanup (sp);
+        errno = ENOMEM;
         return -1;
     }
+    return 0;
+}
+
+static bool local_spawn_keep (struct local_spawn *sp, int fd)
+{
+    for (int i = 0; i < sp->keep_count; i++) {
+        if (sp->keep_fds[i] == fd)
+            return true;
+    }
+    return false;
+}
+
+static void closefd_spawn (void *arg, int fd)
+{
+    struct local_spawn *sp = arg;
+
+    if (fd < 3)
+        return;
+    if (local_spawn_keep (sp, fd))
+        (void) fd_unset_cloexec (fd);
+    else
+        close (fd);
+}
+
+/*  Close all fds >= 3 except channel fds in the child.  With
+ *   close_range(2), all fds are marked close-on-exec in one call and
+ *   the channel fds are then unmarked, instead of walking the fd table.
+ */
+static int local_spawn_close_fds (struct local_spawn *sp)
+{
+#if HAVE_CLOSE_RANGE
+#ifndef CLOSE_RANGE_CLOEXEC
+#define CLOSE_RANGE_CLOEXEC (1U << 2)
+#endif
+    if (close_range (3, ~0U, CLOSE_RANGE_CLOEXEC) == 0) {
+        for (int i = 0; i < sp->keep_count; i++) {
+            if (fd_unset_cloexec (sp->keep_fds[i]) < 0)
+                return -1;
+        }
+        return 0;
+    }
+    /* else kernel too old for CLOSE_RANGE_CLOEXEC, fall back to fdwalk */
+#endif
+    return fdwalk (closefd_spawn, sp);
+}
+
+static void local_spawn_child (struct local_spawn *sp)
+{
+    struct sigaction sa;
+    sigset_t mask;
+    int sig;
+
+    /* Parent signal handlers must not run in the child, since they
+     * would operate on the parent's memory.  Reset them before
+     * unblocking signals, which were blocked by the parent around
+     * vfork(2).
+     */
+    memset (&sa, 0, sizeof (sa));
+    sa.sa_handler = SIG_DFL;
+    sigemptyset (&sa.sa_mask);
+    for (sig = 1; sig < _NSIG; sig++) {
+        struct sigaction old;
+        if (sigaction (sig, NULL, &old) == 0
+            && old.sa_handler != SIG_DFL
+            && old.sa_handler != SIG_IGN)
+            (void) sigaction (sig, &sa, NULL);
+    }
+    sigemptyset (&mask);
+    if (sigprocmask (SIG_SETMASK, &mask, NULL) < 0)
+        goto error;
+
+    for (int fd = 0; fd < 3; fd++) {
+        if (sp->stdio_fd[fd] >= 0) {
+            if (dup2 (sp->stdio_fd[fd], fd) < 0)
+                goto error;
+        }
+        else if (sp->stdio_fd[fd] == -1)
+            close (fd);
+    }
+    if (sp->cwd && chdir (sp->cwd) < 0)
+        goto error;
+    if (local_spawn_close_fds (sp) < 0)
+        goto error;
+    if (sp->setpgrp && setpgrp () < 0)
+        goto error;
+    if (!sp->path) {
+        errno = sp->path_errnum;
+        goto error;
+    }
+    execve (sp->path, sp->argv, sp->env);
+error:
+    sp->errnum = errno ? errno : EINVAL;
+    _exit (1);
+}
+
+static int local_spawn (flux_subprocess_t *p)
+{
+    struct local_spawn sp;
+    sigset_t all, old;
+    int saved_errno;
+
+    if (local_spawn_prepare (p, &sp) < 0)
+        return -1;
+
+    sigfillset (&all);
+    if (sigprocmask (SIG_SETMASK, &all, &old) < 0) {
+        local_spawn_cleanup (&sp);
+        return -1;
+    }
+    if ((p->pid = vfork ()) == 0)
+        local_spawn_child (&sp); /* No return */
+    saved_errno = errno;
+    (void) sigprocmask (SIG_SETMASK, &old, NULL);
+    local_spawn_cleanup (&sp);
+    if (p->pid < 0) {
+        errno = saved_errno;
+        return -1;
+    }
+
+    p->pid_set = true;
+
+    close_child_fds (p);
+    close (p->sync_fds[0]);
+    p->sync_fds[0] = -1;
+
+    /* no-op if reactor is !FLUX_REACTOR_SIGCHLD */
+    if (!(p->child_w = flux_child_watcher_create (p->reactor,
+                                                  p->pid,
+                                                  true,
+                                                  child_watch_cb,
+                                                  p))) {
+        flux_log_error (p->h, "flux_child_watcher_create");
+        return -1;
+    }
+
+    flux_watcher_start (p->child_w);
+
+    if (sp.errnum != 0)
+        return local_exec_failed (p, sp.errnum);
     p->state = FLUX_SUBPROCESS_RUNNING;
 
     return 0;
@@ -706,10 +1018,16 @@ int subprocess_local_setup (flux_subprocess_t *p)
         return -1;
     if (local_setup_channels (p) < 0)
         return -1;
-    if (local_fork (p) < 0)
-        return -1;
-    if (local_exec (p) < 0)
-        return -1;
+    if (local_spawn_supported (p)) {
+        if (local_spawn (p) < 0)
+            return -1;
+    }
+    else {
+        if (local_fork (p) < 0)
+            return -1;
+        if (local_exec (p) < 0)
+            return -1;
+    }
     if (start_local_watchers (p) < 0)
         return -1;
     return 0;
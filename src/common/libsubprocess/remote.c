@@ -19,6 +19,7 @@
 #include <assert.h>
 
 #include <flux/core.h>
+#include <flux/idset.h>
 
 #include "src/common/libczmqcontainers/czmq_containers.h"
 #include "src/common/libutil/log.h"
@@ -532,50 +533,42 @@ int subprocess_remote_setup (flux_subprocess_t *p)
     return 0;
 }
 
-static int remote_state (flux_subprocess_t *p, flux_future_t *f,
-                         int rank)
+static int remote_state (flux_subprocess_t *p, json_t *o, int rank)
 {
     flux_subprocess_state_t state;
     pid_t pid = -1;
     int errnum = 0;
     int status = 0;
 
-    if (flux_rpc_get_unpack (f, "{ s:i }", "state", &state) < 0) {
-        flux_log_error (p->h,
-                        "%s: flux_rpc_get_unpack: rank %u",
-                        __FUNCTION__,
-                        flux_rpc_get_nodeid (f));
-        return -1;
-    }
+    if (json_unpack (o, "{ s:i }", "state", &state) < 0)
+        goto eproto;
 
     if (state == FLUX_SUBPROCESS_RUNNING) {
-        if (flux_rpc_get_unpack (f, "{ s:i }", "pid", &pid) < 0) {
-            flux_log_error (p->h, "%s: flux_rpc_get_unpack", __FUNCTION__);
-            return -1;
-        }
+        if (json_unpack (o, "{ s:i }", "pid", &pid) < 0)
+            goto eproto;
     }
 
     if (state == FLUX_SUBPROCESS_EXEC_FAILED
         || state == FLUX_SUBPROCESS_FAILED) {
-        if (flux_rpc_get_unpack (f, "{ s:i }", "errno", &errnum) < 0) {
-            flux_log_error (p->h, "%s: flux_rpc_get_unpack", __FUNCTION__);
-            return -1;
-        }
+        if (json_unpack (o, "{ s:i }", "errno", &errnum) < 0)
+            goto eproto;
     }
 
     if (state == FLUX_SUBPROCESS_EXITED) {
-        if (flux_rpc_get_unpack (f, "{ s:i }", "status", &status) < 0) {
-            flux_log_error (p->h, "%s: flux_rpc_get_unpack", __FUNCTION__);
-            return -1;
-        }
+        if (json_unpack (o, "{ s:i }", "status", &status) < 0)
+            goto eproto;
     }
 
     process_new_state (p, state, rank, pid, errnum, status);
 
     return 0;
+eproto:
+    errno = EPROTO;
+    flux_log_error (p->h, "%s: json_unpack: rank %d", __FUNCTION__, rank);
+    return -1;
 }
 
-static int remote_output (flux_subprocess_t *p, flux_future_t *f,
+static int remote_output (flux_subprocess_t *p, json_t *o,
                           int rank, pid_t pid)
 {
     struct subprocess_channel *c;
@@ -586,8 +579,9 @@ static int remote_output (flux_subprocess_t *p, flux_future_t *f,
     json_t *io = NULL;
     int rv = -1;
 
-    if (flux_rpc_get_unpack (f, "{ s:o }", "io", &io)) {
-        flux_log_error (p->h, "flux_rpc_get_unpack EPROTO io");
+    if (json_unpack (o, "{ s:o }", "io", &io) < 0) {
+        errno = EPROTO;
+        flux_log_error (p->h, "json_unpack EPROTO io");
         goto cleanup;
     }
 
@@ -641,25 +635,51 @@ static void remote_completion (flux_subprocess_t *p)
     subprocess_check_completed (p);
 }
 
+/* Fail 'p' after a protocol or messaging error, killing it if running.
+ */
+static void remote_fatal (flux_subprocess_t *p)
+{
+    int saved_errno = errno;
+
+    if (p->state == FLUX_SUBPROCESS_RUNNING) {
+        flux_future_t *fkill;
+        if (!(fkill = remote_kill (p, SIGKILL)))
+            flux_log_error (p->h,
+                            "%s: remote_kill: rank %u",
+                            __FUNCTION__,
+                            p->rank);
+        else
+            flux_future_destroy (fkill);
+    }
+    process_new_state (p, FLUX_SUBPROCESS_FAILED,
+                       p->rank, -1, saved_errno, 0);
+}
+
 static void remote_exec_cb (flux_future_t *f, void *arg)
 {
     flux_subprocess_t *p = arg;
+    json_t *o;
     const char *type;
     int rank;
     pid_t pid;
 
-    if (flux_rpc_get_unpack (f, "{ s:s s:i }",
-                             "type", &type,
-                             "rank", &rank) < 0) {
+    if (flux_rpc_get_unpack (f, "o", &o) < 0) {
         flux_log_error (p->h,
                         "%s: flux_rpc_get_unpack: rank %u",
                         __FUNCTION__,
                         flux_rpc_get_nodeid (f));
         goto error;
     }
+    if (json_unpack (o, "{ s:s s:i }",
+                     "type", &type,
+                     "rank", &rank) < 0) {
+        errno = EPROTO;
+        flux_log_error (p->h, "%s: json_unpack", __FUNCTION__);
+        goto error;
+    }
 
     if (!strcmp (type, "state")) {
-        if (remote_state (p, f, rank) < 0)
+        if (remote_state (p, o, rank) < 0)
             goto error;
         if (p->state == FLUX_SUBPROCESS_EXEC_FAILED
             || p->state == FLUX_SUBPROCESS_FAILED) {
@@ -670,11 +690,12 @@ static void remote_exec_cb (flux_future_t *f, void *arg)
             flux_future_reset (f);
     }
     else if (!strcmp (type, "output")) {
-        if (flux_rpc_get_unpack (f, "{ s:i }", "pid", &pid) < 0) {
-            flux_log_error (p->h, "%s: flux_rpc_get_unpack", __FUNCTION__);
+        if (json_unpack (o, "{ s:i }", "pid", &pid) < 0) {
+            errno = EPROTO;
+            flux_log_error (p->h, "%s: json_unpack", __FUNCTION__);
             goto error;
         }
-        if (remote_output (p, f, rank, pid) < 0)
+        if (remote_output (p, o, rank, pid) < 0)
             goto error;
         flux_future_reset (f);
     }
@@ -692,18 +713,7 @@ static void remote_exec_cb (flux_future_t *f, void *arg)
     return;
 
 error:
-    if (p->state == FLUX_SUBPROCESS_RUNNING) {
-        flux_future_t *fkill;
-        if (!(fkill = remote_kill (p, SIGKILL)))
-            flux_log_error (p->h,
-                            "%s: remote_kill: rank %u",
-                            __FUNCTION__,
-                            flux_rpc_get_nodeid (fkill));
-        else
-            flux_future_destroy (fkill);
-    }
-    process_new_state (p, FLUX_SUBPROCESS_FAILED,
-                       p->rank, -1, errno, 0);
+    remote_fatal (p);
     flux_future_destroy (f);
     p->f = NULL;
 }
@@ -795,6 +805,248 @@ int remote_exec (flux_subprocess_t *p)
     return -1;
 }
 
+/*
+ * rexec.tree client: one streaming request starts the command on a set
+ * of ranks.  Responses arrive in batches and are dispatched by rank to
+ * per-rank subprocess objects, which otherwise behave as if they had
+ * been started with remote_exec().
+ */
+
+struct remote_tree {
+    int refcount;
+    flux_t *h;
+    flux_future_t *f;
+    int size;
+    int count;
+    uint32_t *ranks;            /* ranks in ascending order */
+    flux_subprocess_t **procs;  /* procs[i] runs on ranks[i], NULL if freed */
+};
+
+/* aux item on each subprocess, releases its slot in the tree when freed */
+struct remote_tree_ref {
+    struct remote_tree *t;
+    int index;
+};
+
+static const char *tree_auxkey = "sp::remote_tree";
+
+void remote_tree_decref (struct remote_tree *t)
+{
+    if (t && --t->refcount == 0) {
+        int saved_errno = errno;
+        flux_future_destroy (t->f);
+        free (t->ranks);
+        free (t->procs);
+        free (t);
+        errno = saved_errno;
+    }
+}
+
+struct remote_tree *remote_tree_create (flux_t *h, int count)
+{
+    struct remote_tree *t;
+
+    if (!(t = calloc (1, sizeof (*t))))
+        return NULL;
+    t->refcount = 1;
+    t->h = h;
+    t->size = count;
+    if (!(t->ranks = calloc (count, sizeof (t->ranks[0])))
+        || !(t->procs = calloc (count, sizeof (t->procs[0])))) {
+        remote_tree_decref (t);
+        return NULL;
+    }
+    return t;
+}
+
+static void remote_tree_ref_destroy (struct remote_tree_ref *ref)
+{
+    if (ref) {
+        ref->t->procs[ref->index] = NULL;
+        remote_tree_decref (ref->t);
+        free (ref);
+    }
+}
+
+/* Add 'p' to the tree.  Subprocesses must be added in rank order.
+ */
+int remote_tree_add (struct remote_tree *t, flux_subprocess_t *p)
+{
+    struct remote_tree_ref *ref;
+
+    if (t->count == t->size
+        || (t->count > 0 && t->ranks[t->count - 1] >= p->rank)) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (!(ref = calloc (1, sizeof (*ref))))
+        return -1;
+    ref->t = t;
+    ref->index = t->count;
+    t->refcount++;
+    if (flux_subprocess_aux_set (p,
+                                 tree_auxkey,
+                                 ref,
+                                 (flux_free_f)remote_tree_ref_destroy) < 0) {
+        remote_tree_ref_destroy (ref);
+        return -1;
+    }
+    t->ranks[t->count] = p->rank;
+    t->procs[t->count++] = p;
+    return 0;
+}
+
+static flux_subprocess_t *remote_tree_lookup (struct remote_tree *t,
+                                              uint32_t rank)
+{
+    int lo = 0;
+    int hi = t->count - 1;
+
+    while (lo <= hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (t->ranks[mid] == rank)
+            return t->procs[mid];
+        if (t->ranks[mid] < rank)
+            lo = mid + 1;
+        else
+            hi = mid - 1;
+    }
+    return NULL;
+}
+
+static void remote_tree_response (struct remote_tree *t, json_t *o)
+{
+    flux_subprocess_t *p;
+    const char *type;
+    int rank;
+    pid_t pid;
+
+    if (json_unpack (o, "{ s:s s:i }",
+                     "type", &type,
+                     "rank", &rank) < 0) {
+        flux_log (t->h, LOG_ERR, "%s: malformed response", __FUNCTION__);
+        return;
+    }
+    /* Subprocess was destroyed by the caller or has already failed.
+     */
+    if (!(p = remote_tree_lookup (t, rank))
+        || p->state == FLUX_SUBPROCESS_EXEC_FAILED
+        || p->state == FLUX_SUBPROCESS_FAILED)
+        return;
+
+    if (!strcmp (type, "state")) {
+        if (remote_state (p, o, rank) < 0)
+            goto error;
+    }
+    else if (!strcmp (type, "output")) {
+        if (json_unpack (o, "{ s:i }", "pid", &pid) < 0) {
+            errno = EPROTO;
+            flux_log_error (p->h, "%s: json_unpack", __FUNCTION__);
+            goto error;
+        }
+        if (remote_output (p, o, rank, pid) < 0)
+            goto error;
+    }
+    else if (!strcmp (type, "complete"))
+        remote_completion (p);
+    else {
+        flux_log_error (p->h, "%s: EPROTO", __FUNCTION__);
+        errno = EPROTO;
+        goto error;
+    }
+    return;
+error:
+    remote_fatal (p);
+}
+
+static void remote_tree_cb (flux_future_t *f, void *arg)
+{
+    struct remote_tree *t = arg;
+    json_t *responses;
+    size_t index;
+    json_t *o;
+
+    if (flux_rpc_get_unpack (f, "{ s:o }", "responses", &responses) < 0) {
+        int errnum = errno == ENODATA ? EPROTO : errno;
+
+        if (errno != ENODATA && errno != EHOSTUNREACH)
+            flux_log_error (t->h, "%s: flux_rpc_get_unpack", __FUNCTION__);
+
+        /* The stream is over: anything not yet complete never will be.
+         */
+        for (int i = 0; i < t->count; i++) {
+            flux_subprocess_t *p = t->procs[i];
+            if (p
+                && !p->remote_completed
+                && p->state != FLUX_SUBPROCESS_EXEC_FAILED
+                && p->state != FLUX_SUBPROCESS_FAILED)
+                process_new_state (p, FLUX_SUBPROCESS_FAILED,
+                                   p->rank, -1, errnum, 0);
+        }
+        return;
+    }
+    json_array_foreach (responses, index, o)
+        remote_tree_response (t, o);
+    flux_future_reset (f);
+}
+
+int remote_exec_tree (struct remote_tree *t, const char *service)
+{
+    flux_subprocess_t *p;
+    char *cmd_str = NULL;
+    struct idset *ids = NULL;
+    char *ranks = NULL;
+    int save_errno;
+
+    if (t->count == 0 || !(p = t->procs[0])) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (!(ids = idset_create (0, IDSET_FLAG_AUTOGROW)))
+        goto error;
+    for (int i = 0; i < t->count; i++) {
+        if (idset_set (ids, t->ranks[i]) < 0)
+            goto error;
+    }
+    if (!(ranks = idset_encode (ids, IDSET_FLAG_RANGE)))
+        goto error;
+    if (!(cmd_str = flux_cmd_tojson (p->cmd))) {
+        flux_log_error (p->h, "flux_cmd_tojson");
+        goto error;
+    }
+    /* Enter the tree at its root so every target rank is a descendant.
+     */
+    if (!(t->f = flux_rpc_pack (t->h, service, 0,
+                                FLUX_RPC_STREAMING,
+                                "{s:s s:s s:i s:i s:i}",
+                                "ranks", ranks,
+                                "cmd", cmd_str,
+                                "on_channel_out",
+                                p->ops.on_channel_out ? 1 : 0,
+                                "on_stdout", p->ops.on_stdout ? 1 : 0,
+                                "on_stderr", p->ops.on_stderr ? 1 : 0))) {
+        flux_log_error (p->h, "flux_rpc");
+        goto error;
+    }
+    if (flux_future_then (t->f, -1., remote_tree_cb, t) < 0) {
+        flux_log_error (p->h, "flux_future_then");
+        goto error;
+    }
+    free (cmd_str);
+    free (ranks);
+    idset_destroy (ids);
+    return 0;
+error:
+    save_errno = errno;
+    flux_future_destroy (t->f);
+    t->f = NULL;
+    free (cmd_str);
+    free (ranks);
+    idset_destroy (ids);
+    errno = save_errno;
+    return -1;
+}
+
 flux_future_t *remote_kill (flux_subprocess_t *p, int signum)
 {
     flux_future_t *f;
@@ -19,4 +19,19 @@ int remote_exec (flux_subprocess_t *p);
 
 flux_future_t *remote_kill (flux_subprocess_t *p, int signum);
 
+/* Start subprocesses on many ranks with one rexec.tree request.
+ * Subprocesses are added to the tree in rank order, then the request
+ * is sent with remote_exec_tree().  Each subprocess holds a reference
+ * on the tree.
+ */
+struct remote_tree;
+
+struct remote_tree *remote_tree_create (flux_t *h, int count);
+
+void remote_tree_decref (struct remote_tree *t);
+
+int remote_tree_add (struct remote_tree *t, flux_subprocess_t *p);
+
+int remote_exec_tree (struct remote_tree *t, const char *service);
+
 #endif /* !_SUBPROCESS_REMOTE_H */
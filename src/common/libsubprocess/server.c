@@ -16,15 +16,18 @@
 #include <wait.h>
 #include <unistd.h>
 #include <errno.h>
+#include <stdarg.h>
 #include <assert.h>
 
 #include <flux/core.h>
+#include <flux/idset.h>
 
 #include "src/common/libczmqcontainers/czmq_containers.h"
 #include "src/common/libutil/errno_safe.h"
 #include "src/common/libutil/log.h"
 #include "src/common/libutil/fdwalk.h"
 #include "src/common/libutil/macros.h"
+#include "src/common/libutil/kary.h"
 #include "src/common/libioencode/ioencode.h"
 
 #include "subprocess.h"
@@ -36,31 +39,98 @@
 
 static const char *auxkey = "flux::rexec";
 
+/* A rexec.tree request fanned out from this rank.  Responses for the
+ * local process and for every forwarded child request are collected in
+ * 'batch' and sent upstream as one response per reactor loop.
+ */
+struct rexec_fanout {
+    int refcount;
+    const flux_msg_t *msg;          // rexec.tree request message
+    char *sender;                   // originating client of the request
+    flux_subprocess_server_t *s;    // server context
+    json_t *batch;                  // responses not yet sent upstream
+    zlist_t *children;              // forwarded requests
+    struct idset *child_ranks;      // ranks requests were forwarded to
+    int pending;                    // local process + children not done
+    bool finished;
+    flux_watcher_t *prep_w;
+    flux_watcher_t *idle_w;
+    flux_watcher_t *check_w;
+};
+
 struct rexec {
     const flux_msg_t *msg;          // rexec request message
     flux_subprocess_server_t *s;    // server context
+    struct rexec_fanout *fanout;    // set if started by rexec.tree
+    bool done;                      // local process reported to fanout
 };
 
+static void rexec_fanout_decref (struct rexec_fanout *fo);
+static void rexec_fanout_done (struct rexec_fanout *fo);
+static int rexec_fanout_append (struct rexec_fanout *fo, json_t *o);
+
 static void rexec_destroy (struct rexec *rex)
 {
     if (rex) {
+        int saved_errno = errno;
         flux_msg_decref (rex->msg);
-        ERRNO_SAFE_WRAP (free, rex);
+        rexec_fanout_decref (rex->fanout);
+        free (rex);
+        errno = saved_errno;
     }
 }
 
 static struct rexec *rexec_create (const flux_msg_t *msg,
-                                   flux_subprocess_server_t *s)
+                                   flux_subprocess_server_t *s,
+                                   struct rexec_fanout *fo)
 {
     struct rexec *rex;
 
     if ((rex = calloc (1, sizeof (*rex)))) {
         rex->msg = flux_msg_incref (msg);
         rex->s = s;
+        if (fo) {
+            rex->fanout = fo;
+            fo->refcount++;
+        }
     }
     return rex;
 }
 
+/* Respond to a rexec request, or queue the response for the next
+ * upstream batch if the process was started by rexec.tree.
+ */
+static int rexec_respond_pack (struct rexec *rex, const char *fmt, ...)
+{
+    va_list ap;
+    json_t *o;
+    int rc;
+
+    va_start (ap, fmt);
+    o = json_vpack_ex (NULL, 0, fmt, ap);
+    va_end (ap);
+    if (!o) {
+        errno = EPROTO;
+        return -1;
+    }
+    if (rex->fanout)
+        rc = rexec_fanout_append (rex->fanout, o);
+    else
+        rc = flux_respond_pack (rex->s->h, rex->msg, "O", o);
+    json_decref (o);
+    return rc;
+}
+
+/* The local process of a rexec.tree request has reported its final state.
+ */
+static void rexec_done (struct rexec *rex)
+{
+    if (rex->fanout && !rex->done) {
+        rex->done = true;
+        rexec_fanout_done (rex->fanout);
+    }
+}
+
 static void subprocesses_free_fn (void *arg)
 {
     flux_subprocess_t *p = arg;
@@ -153,11 +223,12 @@ static void rexec_completion_cb (flux_subprocess_t *p)
 
     if (p->state != FLUX_SUBPROCESS_FAILED) {
         /* no fallback if this fails */
-        if (flux_respond_pack (rex->s->h, rex->msg, "{s:s s:i}",
-                               "type", "complete",
-                               "rank", rex->s->rank) < 0)
+        if (rexec_respond_pack (rex, "{s:s s:i}",
+                                "type", "complete",
+                                "rank", rex->s->rank) < 0)
             flux_log_error (rex->s->h, "%s: flux_respond_pack", __FUNCTION__);
     }
+    rexec_done (rex);
 
     subprocess_cleanup (p);
 }
@@ -192,29 +263,30 @@ static void rexec_state_change_cb (flux_subprocess_t *p,
     if (state == FLUX_SUBPROCESS_RUNNING) {
         if (store_pid (rex->s, p) < 0)
             goto error;
-        if (flux_respond_pack (rex->s->h, rex->msg, "{s:s s:i s:i s:i}",
-                               "type", "state",
-                               "rank", rex->s->rank,
-                               "pid", flux_subprocess_pid (p),
-                               "state", state) < 0) {
+        if (rexec_respond_pack (rex, "{s:s s:i s:i s:i}",
+                                "type", "state",
+                                "rank", rex->s->rank,
+                                "pid", flux_subprocess_pid (p),
+                                "state", state) < 0) {
             flux_log_error (rex->s->h, "%s: flux_respond_pack", __FUNCTION__);
         }
     } else if (state == FLUX_SUBPROCESS_EXITED) {
-        if (flux_respond_pack (rex->s->h, rex->msg, "{s:s s:i s:i s:i}",
-                               "type", "state",
-                               "rank", rex->s->rank,
-                               "state", state,
-                               "status", flux_subprocess_status (p)) < 0) {
+        if (rexec_respond_pack (rex, "{s:s s:i s:i s:i}",
+                                "type", "state",
+                                "rank", rex->s->rank,
+                                "state", state,
+                                "status", flux_subprocess_status (p)) < 0) {
             flux_log_error (rex->s->h, "%s: flux_respond_pack", __FUNCTION__);
         }
     } else if (state == FLUX_SUBPROCESS_FAILED) {
-        if (flux_respond_pack (rex->s->h, rex->msg, "{s:s s:i s:i s:i}",
-                               "type", "state",
-                               "rank", rex->s->rank,
-                               "state", FLUX_SUBPROCESS_FAILED,
-                               "errno", p->failed_errno) < 0) {
+        if (rexec_respond_pack (rex, "{s:s s:i s:i s:i}",
+                                "type", "state",
+                                "rank", rex->s->rank,
+                                "state", FLUX_SUBPROCESS_FAILED,
+                                "errno", p->failed_errno) < 0) {
             flux_log_error (rex->s->h, "%s: flux_respond_pack", __FUNCTION__);
         }
+        rexec_done (rex);
         subprocess_cleanup (p);
     } else {
         errno = EPROTO;
@@ -230,12 +302,12 @@ error:
 
 static int rexec_output (flux_subprocess_t *p,
                          const char *stream,
-                         flux_subprocess_server_t *s,
-                         const flux_msg_t *msg,
+                         struct rexec *rex,
                          const char *data,
                          int len,
                          bool eof)
 {
+    flux_subprocess_server_t *s = rex->s;
     json_t *io = NULL;
     char rankstr[64];
     int rv = -1;
@@ -246,11 +318,11 @@ static int rexec_output (flux_subprocess_t *p,
         goto error;
     }
 
-    if (flux_respond_pack (s->h, msg, "{s:s s:i s:i s:O}",
-                           "type", "output",
-                           "rank", s->rank,
-                           "pid", flux_subprocess_pid (p),
-                           "io", io) < 0) {
+    if (rexec_respond_pack (rex, "{s:s s:i s:i s:O}",
+                            "type", "output",
+                            "rank", s->rank,
+                            "pid", flux_subprocess_pid (p),
+                            "io", io) < 0) {
         flux_log_error (s->h, "%s: flux_respond_pack", __FUNCTION__);
         goto error;
     }
@@ -275,11 +347,11 @@ static void rexec_output_cb (flux_subprocess_t *p, const char *stream)
     }
 
     if (lenp) {
-        if (rexec_output (p, stream, rex->s, rex->msg, ptr, lenp, false) < 0)
+        if (rexec_output (p, stream, rex, ptr, lenp, false) < 0)
             goto error;
     }
     else {
-        if (rexec_output (p, stream, rex->s, rex->msg, NULL, 0, true) < 0)
+        if (rexec_output (p, stream, rex, NULL, 0, true) < 0)
             goto error;
     }
 
@@ -289,13 +361,20 @@ error:
     internal_fatal (rex->s, p);
 }
 
-static void server_exec_cb (flux_t *h, flux_msg_handler_t *mh,
-                              const flux_msg_t *msg, void *arg)
+/* Start the process requested by 'msg'.  If 'fo' is set, the request
+ * is rexec.tree and responses are queued on the fanout.  Returns -1 with
+ * errno set if the request should fail before any process was started.
+ */
+static int server_exec (flux_subprocess_server_t *s,
+                        const flux_msg_t *msg,
+                        struct rexec_fanout *fo,
+                        const char *cmd_str,
+                        int on_channel_out,
+                        int on_stdout,
+                        int on_stderr)
 {
-    flux_subprocess_server_t *s = arg;
-    const char *cmd_str;
     flux_cmd_t *cmd = NULL;
-    struct rexec *rex;
+    struct rexec *rex = NULL;
     flux_subprocess_t *p = NULL;
     flux_subprocess_ops_t ops = {
         .on_completion = rexec_completion_cb,
@@ -304,15 +383,8 @@ static void server_exec_cb (flux_t *h, flux_msg_handler_t *mh,
         .on_stdout = rexec_output_cb,
         .on_stderr = rexec_output_cb,
     };
-    int on_channel_out, on_stdout, on_stderr;
     char **env = NULL;
-
-    if (flux_request_unpack (msg, NULL, "{s:s s:i s:i s:i}",
-                             "cmd", &cmd_str,
-                             "on_channel_out", &on_channel_out,
-                             "on_stdout", &on_stdout,
-                             "on_stderr", &on_stderr))
-        goto error;
+    int rv = -1;
 
     if (!on_channel_out)
         ops.on_channel_out = NULL;
@@ -348,9 +420,14 @@ static void server_exec_cb (flux_t *h, flux_msg_handler_t *mh,
     if (flux_cmd_setenvf (cmd, 1, "FLUX_URI", "%s", s->local_uri) < 0)
         goto error;
 
-    if (flux_respond_pack (s->h, msg, "{s:s s:i}",
-                           "type", "start",
-                           "rank", s->rank) < 0) {
+    if (!(rex = rexec_create (msg, s, fo)))
+        goto error;
+
+    /* rexec.tree callers do not wait for "start"
+     */
+    if (!fo && flux_respond_pack (s->h, msg, "{s:s s:i}",
+                                  "type", "start",
+                                  "rank", s->rank) < 0) {
         flux_log_error (s->h, "%s: flux_respond_pack", __FUNCTION__);
         goto error;
     }
@@ -361,38 +438,493 @@ static void server_exec_cb (flux_t *h, flux_msg_handler_t *mh,
                          &ops,
                          NULL))) {
         /* error here, generate FLUX_SUBPROCESS_EXEC_FAILED state */
-        if (flux_respond_pack (h, msg, "{s:s s:i s:i s:i}",
-                               "type", "state",
-                               "rank", s->rank,
-                               "state", FLUX_SUBPROCESS_EXEC_FAILED,
-                               "errno", errno) < 0) {
-            flux_log_error (h, "%s: flux_respond_pack", __FUNCTION__);
+        if (rexec_respond_pack (rex, "{s:s s:i s:i s:i}",
+                                "type", "state",
+                                "rank", s->rank,
+                                "state", FLUX_SUBPROCESS_EXEC_FAILED,
+                                "errno", errno) < 0) {
+            flux_log_error (s->h, "%s: flux_respond_pack", __FUNCTION__);
             goto error;
         }
+        rexec_done (rex);
         goto cleanup;
     }
 
-    if (!(rex = rexec_create (msg, s)))
-        goto error;
     if (flux_subprocess_aux_set (p,
                                 auxkey,
                                 rex,
-                                (flux_free_f)rexec_destroy) < 0) {
-        rexec_destroy (rex);
+                                (flux_free_f)rexec_destroy) < 0)
         goto error;
+    rex = NULL;
+
+cleanup:
+    rv = 0;
+error:
+    rexec_destroy (rex);
+    ERRNO_SAFE_WRAP (flux_cmd_destroy, cmd);
+    ERRNO_SAFE_WRAP (free, env);
+    if (rv < 0)
+        ERRNO_SAFE_WRAP (flux_subprocess_unref, p);
+    return rv;
+}
+
+static void server_exec_cb (flux_t *h, flux_msg_handler_t *mh,
+                            const flux_msg_t *msg, void *arg)
+{
+    flux_subprocess_server_t *s = arg;
+    const char *cmd_str;
+    int on_channel_out, on_stdout, on_stderr;
+
+    if (flux_request_unpack (msg, NULL, "{s:s s:i s:i s:i}",
+                             "cmd", &cmd_str,
+                             "on_channel_out", &on_channel_out,
+                             "on_stdout", &on_stdout,
+                             "on_stderr", &on_stderr) < 0
+        || server_exec (s,
+                        msg,
+                        NULL,
+                        cmd_str,
+                        on_channel_out,
+                        on_stdout,
+                        on_stderr) < 0) {
+        if (flux_respond_error (h, msg, errno, NULL) < 0)
+            flux_log_error (h, "%s: flux_respond_error", __FUNCTION__);
+    }
+}
+
+/*
+ * rexec.tree: start a command on a set of ranks with one request.
+ *
+ * The request is forwarded to each TBON child whose subtree contains
+ * target ranks, with 'ranks' narrowed to that subtree.  Every rank
+ * answers with batches of the same state, output, and completion objects
+ * that rexec sends, merged with those of its children:
+ *
+ *   {"type":"batch", "responses":[{"type":"state", "rank":N, ...}, ...]}
+ *
+ * The stream ends with ENODATA once the local process and all children
+ * are done.  If a child request fails, its unfinished ranks are reported
+ * in the FLUX_SUBPROCESS_FAILED state with the error.
+ *
+ * Forwarded requests carry the originating client in 'sender', since on
+ * other ranks the request appears to come from the parent broker.  When
+ * that client disconnects, the disconnect is forwarded to the children
+ * with rexec.disconnect, so processes on every rank are terminated.
+ */
+
+static void rexec_fanout_destroy (struct rexec_fanout *fo)
+{
+    if (fo) {
+        int saved_errno = errno;
+        flux_watcher_destroy (fo->prep_w);
+        flux_watcher_destroy (fo->idle_w);
+        flux_watcher_destroy (fo->check_w);
+        zlist_destroy (&fo->children);
+        idset_destroy (fo->child_ranks);
+        json_decref (fo->batch);
+        flux_msg_decref (fo->msg);
+        free (fo->sender);
+        free (fo);
+        errno = saved_errno;
+    }
+}
+
+static void rexec_fanout_decref (struct rexec_fanout *fo)
+{
+    if (fo && --fo->refcount == 0)
+        rexec_fanout_destroy (fo);
+}
+
+static void rexec_fanout_flush (struct rexec_fanout *fo)
+{
+    if (json_array_size (fo->batch) == 0)
+        return;
+    if (flux_respond_pack (fo->s->h, fo->msg, "{s:s s:O}",
+                           "type", "batch",
+                           "responses", fo->batch) < 0)
+        flux_log_error (fo->s->h, "%s: flux_respond_pack", __FUNCTION__);
+    json_array_clear (fo->batch);
+}
+
+static int rexec_fanout_append (struct rexec_fanout *fo, json_t *o)
+{
+    if (fo->finished)
+        return 0;
+    if (json_array_append (fo->batch, o) < 0) {
+        errno = ENOMEM;
+        return -1;
     }
+    return 0;
+}
+
+static void rexec_fanout_fail (struct rexec_fanout *fo,
+                               uint32_t rank,
+                               int errnum)
+{
+    json_t *o;
+
+    if (!(o = json_pack ("{s:s s:i s:i s:i}",
+                         "type", "state",
+                         "rank", rank,
+                         "state", FLUX_SUBPROCESS_FAILED,
+                         "errno", errnum))
+        || rexec_fanout_append (fo, o) < 0)
+        flux_log_error (fo->s->h, "%s: rank %u", __FUNCTION__, rank);
+    json_decref (o);
+}
+
+/* Called once for the local process and once for each child request.
+ * When all are done, send what is left of the batch and end the stream.
+ */
+static void rexec_fanout_done (struct rexec_fanout *fo)
+{
+    if (--fo->pending > 0 || fo->finished)
+        return;
+    rexec_fanout_flush (fo);
+    if (flux_respond_error (fo->s->h, fo->msg, ENODATA, NULL) < 0)
+        flux_log_error (fo->s->h, "%s: flux_respond_error", __FUNCTION__);
+    fo->finished = true;
+    flux_watcher_stop (fo->prep_w);
+    flux_watcher_stop (fo->idle_w);
+    flux_watcher_stop (fo->check_w);
+    zlist_remove (fo->s->fanouts, fo);
+}
+
+static void fanout_prep_cb (flux_reactor_t *r,
+                            flux_watcher_t *w,
+                            int revents,
+                            void *arg)
+{
+    struct rexec_fanout *fo = arg;
+
+    if (json_array_size (fo->batch) > 0)
+        flux_watcher_start (fo->idle_w);
+}
 
-    flux_cmd_destroy (cmd);
-    free (env);
+static void fanout_check_cb (flux_reactor_t *r,
+                             flux_watcher_t *w,
+                             int revents,
+                             void *arg)
+{
+    struct rexec_fanout *fo = arg;
+
+    flux_watcher_stop (fo->idle_w);
+    rexec_fanout_flush (fo);
+}
+
+static bool is_final_response (json_t *o, int *rank)
+{
+    const char *type;
+    int state = -1;
+
+    if (json_unpack (o, "{s:s s:i s?i}",
+                     "type", &type,
+                     "rank", rank,
+                     "state", &state) < 0)
+        return false;
+    return (!strcmp (type, "complete")
+            || state == FLUX_SUBPROCESS_FAILED
+            || state == FLUX_SUBPROCESS_EXEC_FAILED);
+}
+
+static void fanout_child_cb (flux_future_t *f, void *arg)
+{
+    struct rexec_fanout *fo = arg;
+    struct idset *ranks = flux_future_aux_get (f, "ranks");
+    json_t *responses;
+    size_t index;
+    json_t *o;
+    int rank;
+
+    if (flux_rpc_get_unpack (f, "{s:o}", "responses", &responses) < 0) {
+        unsigned int id;
+        int errnum = errno == ENODATA ? EPROTO : errno;
+
+        /* Ranks the child never finished are failed on its behalf.
+         */
+        if (errno != ENODATA || idset_count (ranks) > 0) {
+            id = idset_first (ranks);
+            while (id != IDSET_INVALID_ID) {
+                rexec_fanout_fail (fo, id, errnum);
+                id = idset_next (ranks, id);
+            }
+        }
+        rexec_fanout_done (fo);
+        return;
+    }
+    json_array_foreach (responses, index, o) {
+        if (rexec_fanout_append (fo, o) < 0)
+            flux_log_error (fo->s->h, "%s: append", __FUNCTION__);
+        if (is_final_response (o, &rank))
+            (void)idset_clear (ranks, rank);
+    }
+    flux_future_reset (f);
+}
+
+/* Split 'ranks' into one idset per TBON child of this rank.
+ * Fail with EINVAL if a rank is neither this rank nor a descendant.
+ */
+static struct idset **fanout_partition (flux_subprocess_server_t *s,
+                                        const struct idset *ranks,
+                                        int *kp)
+{
+    struct idset **sub;
+    uint32_t size;
+    const char *val;
+    int k = 2;
+    unsigned int id;
+
+    if (flux_get_size (s->h, &size) < 0)
+        return NULL;
+    if ((val = flux_attr_get (s->h, "tbon.fanout")))
+        k = strtol (val, NULL, 10);
+    if (k < 1) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if (!(sub = calloc (k, sizeof (sub[0]))))
+        return NULL;
+    id = idset_first (ranks);
+    while (id != IDSET_INVALID_ID) {
+        if (id != s->rank) {
+            uint32_t child;
+            int j;
+
+            child = kary_child_route (k, size, s->rank, id);
+            if (child == KARY_NONE) {
+                errno = EINVAL;
+                goto error;
+            }
+            j = child - (k * s->rank + 1);
+            if (!sub[j] && !(sub[j] = idset_create (0, IDSET_FLAG_AUTOGROW)))
+                goto error;
+            if (idset_set (sub[j], id) < 0)
+                goto error;
+        }
+        id = idset_next (ranks, id);
+    }
+    *kp = k;
+    return sub;
+error:
+    for (int j = 0; j < k; j++)
+        idset_destroy (sub[j]);
+    ERRNO_SAFE_WRAP (free, sub);
+    return NULL;
+}
+
+/* Forward the request to 'child' for 'ranks'.  On failure, the ranks
+ * are failed immediately, so this does not return an error.
+ */
+static void fanout_forward (struct rexec_fanout *fo,
+                            const char *topic,
+                            uint32_t child,
+                            struct idset *ranks,
+                            json_t *payload)
+{
+    struct idset *owned = ranks;
+    flux_future_t *f = NULL;
+    char *s = NULL;
+    json_t *o = NULL;
+    unsigned int id;
+    int errnum;
+
+    if (!(s = idset_encode (ranks, IDSET_FLAG_RANGE))
+        || !(o = json_copy (payload))
+        || json_object_set_new (o, "ranks", json_string (s)) < 0
+        || (fo->sender
+            && json_object_set_new (o,
+                                    "sender",
+                                    json_string (fo->sender)) < 0)) {
+        errno = ENOMEM;
+        goto error;
+    }
+    if (!(f = flux_rpc_pack (fo->s->h, topic, child, FLUX_RPC_STREAMING,
+                             "O", o))
+        || flux_future_aux_set (f,
+                                "ranks",
+                                ranks,
+                                (flux_free_f)idset_destroy) < 0)
+        goto error;
+    owned = NULL;
+    if (flux_future_then (f, -1., fanout_child_cb, fo) < 0
+        || zlist_append (fo->children, f) < 0)
+        goto error;
+    zlist_freefn (fo->children, f, (zlist_free_fn *)flux_future_destroy, true);
+    if (idset_set (fo->child_ranks, child) < 0)
+        flux_log_error (fo->s->h, "%s: idset_set", __FUNCTION__);
+    fo->pending++;
+    free (s);
+    json_decref (o);
     return;
+error:
+    errnum = errno;
+    flux_log_error (fo->s->h, "%s: rank %u", __FUNCTION__, child);
+    id = idset_first (ranks);
+    while (id != IDSET_INVALID_ID) {
+        rexec_fanout_fail (fo, id, errnum);
+        id = idset_next (ranks, id);
+    }
+    flux_future_destroy (f);
+    idset_destroy (owned);
+    free (s);
+    json_decref (o);
+}
+
+/* The origin client of this rexec.tree request has disconnected.
+ * Forward the disconnect to children, using the disconnect topic a
+ * connector would derive from the request topic.
+ */
+static void rexec_fanout_disconnect (struct rexec_fanout *fo)
+{
+    const char *topic;
+    const char *p;
+    char distopic[128];
+    unsigned int rank;
+
+    if (flux_msg_get_topic (fo->msg, &topic) < 0
+        || !(p = strrchr (topic, '.'))
+        || snprintf (distopic,
+                     sizeof (distopic),
+                     "%.*s.disconnect",
+                     (int)(p - topic),
+                     topic) >= sizeof (distopic))
+        return;
+    rank = idset_first (fo->child_ranks);
+    while (rank != IDSET_INVALID_ID) {
+        flux_future_t *f;
+
+        if (!(f = flux_rpc_pack (fo->s->h,
+                                 distopic,
+                                 rank,
+                                 FLUX_RPC_NORESPONSE,
+                                 "{s:s}",
+                                 "sender", fo->sender)))
+            flux_log_error (fo->s->h, "%s: rank %u", __FUNCTION__, rank);
+        flux_future_destroy (f);
+        rank = idset_next (fo->child_ranks, rank);
+    }
+}
+
+static struct rexec_fanout *rexec_fanout_create (flux_subprocess_server_t *s,
+                                                 const flux_msg_t *msg,
+                                                 const char *sender)
+{
+    struct rexec_fanout *fo;
 
+    if (!(fo = calloc (1, sizeof (*fo))))
+        return NULL;
+    fo->refcount = 1;
+    fo->s = s;
+    fo->msg = flux_msg_incref (msg);
+    if (!(fo->batch = json_array ())
+        || !(fo->children = zlist_new ())
+        || !(fo->child_ranks = idset_create (0, IDSET_FLAG_AUTOGROW))
+        || (sender && !(fo->sender = strdup (sender)))) {
+        errno = ENOMEM;
+        goto error;
+    }
+    if (!(fo->prep_w = flux_prepare_watcher_create (s->r,
+                                                    fanout_prep_cb,
+                                                    fo))
+        || !(fo->idle_w = flux_idle_watcher_create (s->r, NULL, fo))
+        || !(fo->check_w = flux_check_watcher_create (s->r,
+                                                      fanout_check_cb,
+                                                      fo)))
+        goto error;
+    flux_watcher_start (fo->prep_w);
+    flux_watcher_start (fo->check_w);
+    return fo;
+error:
+    rexec_fanout_destroy (fo);
+    return NULL;
+}
+
+static void server_exec_tree_cb (flux_t *h, flux_msg_handler_t *mh,
+                                 const flux_msg_t *msg, void *arg)
+{
+    flux_subprocess_server_t *s = arg;
+    const char *topic;
+    const char *ranks_str;
+    const char *cmd_str;
+    const char *sender = NULL;
+    int on_channel_out, on_stdout, on_stderr;
+    json_t *payload;
+    struct idset *ranks = NULL;
+    struct idset **sub = NULL;
+    struct rexec_fanout *fo = NULL;
+    int k = 0;
+
+    if (flux_request_unpack (msg, &topic, "o", &payload) < 0
+        || json_unpack (payload, "{s:s s:s s:i s:i s:i s?s}",
+                        "ranks", &ranks_str,
+                        "cmd", &cmd_str,
+                        "on_channel_out", &on_channel_out,
+                        "on_stdout", &on_stdout,
+                        "on_stderr", &on_stderr,
+                        "sender", &sender) < 0) {
+        errno = EPROTO;
+        goto error;
+    }
+    if (!sender)
+        sender = flux_msg_route_first (msg);
+    if (!(ranks = idset_decode (ranks_str)))
+        goto error;
+    if (idset_count (ranks) == 0) {
+        errno = EINVAL;
+        goto error;
+    }
+    if (!(sub = fanout_partition (s, ranks, &k)))
+        goto error;
+    if (!(fo = rexec_fanout_create (s, msg, sender)))
+        goto error;
+    if (zlist_append (s->fanouts, fo) < 0) {
+        rexec_fanout_destroy (fo);
+        errno = ENOMEM;
+        goto error;
+    }
+    zlist_freefn (s->fanouts,
+                  fo,
+                  (zlist_free_fn *)rexec_fanout_decref,
+                  true);
+
+    /* Hold the local process as pending while children are forwarded so
+     * a child that fails immediately cannot end the stream early.
+     */
+    fo->pending = 1;
+    for (int j = 0; j < k; j++) {
+        if (sub[j]) {
+            fanout_forward (fo,
+                            topic,
+                            k * s->rank + 1 + j,
+                            sub[j],
+                            payload);
+            sub[j] = NULL;
+        }
+    }
+    if (!idset_test (ranks, s->rank))
+        rexec_fanout_done (fo);
+    else if (server_exec (s,
+                          msg,
+                          fo,
+                          cmd_str,
+                          on_channel_out,
+                          on_stdout,
+                          on_stderr) < 0) {
+        rexec_fanout_fail (fo, s->rank, errno);
+        rexec_fanout_done (fo);
+    }
+    free (sub);
+    idset_destroy (ranks);
+    return;
 error:
     if (flux_respond_error (h, msg, errno, NULL) < 0)
         flux_log_error (h, "%s: flux_respond_error", __FUNCTION__);
-cleanup:
-    flux_cmd_destroy (cmd);
-    free (env);
-    flux_subprocess_unref (p);
+    if (sub) {
+        for (int j = 0; j < k; j++)
+            idset_destroy (sub[j]);
+        free (sub);
+    }
+    idset_destroy (ranks);
 }
 
 static int write_subprocess (flux_subprocess_server_t *s, flux_subprocess_t *p,
@@ -523,14 +1055,20 @@ error:
         flux_log_error (h, "%s: flux_respond_error", __FUNCTION__);
 }
 
+/* Return the client that requested 'p'.  For rexec.tree, this is the
+ * client that sent the request to the root of the tree.
+ */
 const char *subprocess_sender (flux_subprocess_t *p)
 {
     struct rexec *rex = flux_subprocess_aux_get (p, auxkey);
     const char *sender;
 
-    if (!rex || !(sender = flux_msg_route_first (rex->msg)))
+    if (!rex)
         return NULL;
-
+    if (rex->fanout)
+        sender = rex->fanout->sender;
+    else
+        sender = flux_msg_route_first (rex->msg);
     return sender;
 }
 
@@ -600,34 +1138,58 @@ error:
     json_decref (procs);
 }
 
+/* A client that sent rexec.tree (or rexec.write, rexec.signal) has
+ * disconnected.  A parent rank forwards the disconnect of a rexec.tree
+ * client with the client in 'sender'.  No response.
+ */
+static void server_disconnect_cb (flux_t *h, flux_msg_handler_t *mh,
+                                  const flux_msg_t *msg, void *arg)
+{
+    flux_subprocess_server_t *s = arg;
+    const char *sender = NULL;
+
+    if (flux_request_unpack (msg, NULL, "{s:s}", "sender", &sender) < 0)
+        sender = flux_msg_route_first (msg);
+    if (sender)
+        server_terminate_by_uuid (s, sender);
+}
+
 int server_start (flux_subprocess_server_t *s, const char *prefix)
 {
     /* rexec.processes is primarily for testing */
     struct flux_msg_handler_spec htab[] = {
         { FLUX_MSGTYPE_REQUEST, "rexec",        server_exec_cb, 0 },
+        { FLUX_MSGTYPE_REQUEST, "rexec.tree",   server_exec_tree_cb, 0 },
         { FLUX_MSGTYPE_REQUEST, "rexec.write",  server_write_cb, 0 },
         { FLUX_MSGTYPE_REQUEST, "rexec.signal", server_signal_cb, 0 },
         { FLUX_MSGTYPE_REQUEST, "rexec.processes", server_processes_cb, 0 },
+        { FLUX_MSGTYPE_REQUEST, "rexec.disconnect", server_disconnect_cb, 0 },
         FLUX_MSGHANDLER_TABLE_END,
     };
-    char *topic_globs[4] = {NULL, NULL, NULL, NULL};
+    char *topic_globs[6] = {NULL, NULL, NULL, NULL, NULL, NULL};
     int rv = -1;
 
     assert (prefix);
 
     if (asprintf (&topic_globs[0], "%s.rexec", prefix) < 0)
         goto cleanup;
-    if (asprintf (&topic_globs[1], "%s.rexec.write", prefix) < 0)
+    if (asprintf (&topic_globs[1], "%s.rexec.tree", prefix) < 0)
         goto cleanup;
-    if (asprintf (&topic_globs[2], "%s.rexec.signal", prefix) < 0)
+    if (asprintf (&topic_globs[2], "%s.rexec.write", prefix) < 0)
         goto cleanup;
-    if (asprintf (&topic_globs[3], "%s.rexec.processes", prefix) < 0)
+    if (asprintf (&topic_globs[3], "%s.rexec.signal", prefix) < 0)
+        goto cleanup;
+    if (asprintf (&topic_globs[4], "%s.rexec.processes", prefix) < 0)
+        goto cleanup;
+    if (asprintf (&topic_globs[5], "%s.rexec.disconnect", prefix) < 0)
         goto cleanup;
 
     htab[0].topic_glob = (const char *)topic_globs[0];
     htab[1].topic_glob = (const char *)topic_globs[1];
     htab[2].topic_glob = (const char *)topic_globs[2];
     htab[3].topic_glob = (const char *)topic_globs[3];
+    htab[4].topic_glob = (const char *)topic_globs[4];
+    htab[5].topic_glob = (const char *)topic_globs[5];
 
     if (flux_msg_handler_addvec (s->h, htab, s, &s->handlers) < 0)
         goto cleanup;
@@ -638,6 +1200,8 @@ cleanup:
     free (topic_globs[1]);
     free (topic_globs[2]);
     free (topic_globs[3]);
+    free (topic_globs[4]);
+    free (topic_globs[5]);
     return rv;
 }
 
@@ -692,6 +1256,7 @@ int server_terminate_by_uuid (flux_subprocess_server_t *s,
                               const char *id)
 {
     flux_subprocess_t *p;
+    struct rexec_fanout *fo;
 
     p = zhash_first (s->subprocesses);
     while (p) {
@@ -699,6 +1264,16 @@ int server_terminate_by_uuid (flux_subprocess_server_t *s,
         p = zhash_next (s->subprocesses);
     }
 
+    /* Processes started by rexec.tree on other ranks are terminated
+     * by forwarding the disconnect down the tree.
+     */
+    fo = zlist_first (s->fanouts);
+    while (fo) {
+        if (fo->sender && !strcmp (fo->sender, id))
+            rexec_fanout_disconnect (fo);
+        fo = zlist_next (s->fanouts);
+    }
+
     return 0;
 }
 
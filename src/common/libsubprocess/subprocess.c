@@ -20,6 +20,7 @@
 #include <assert.h>
 
 #include <flux/core.h>
+#include <flux/idset.h>
 
 #include "src/common/libczmqcontainers/czmq_containers.h"
 #include "src/common/libutil/log.h"
@@ -212,6 +213,7 @@ static void subprocess_server_destroy (void *arg)
          * things only
          */
         zhash_destroy (&s->subprocesses);
+        zlist_destroy (&s->fanouts);
         free (s->local_uri);
 
         flux_watcher_destroy (s->terminate_timer_w);
@@ -240,6 +242,8 @@ static flux_subprocess_server_t *subprocess_server_create (flux_t *h,
         goto error;
     if (!(s->subprocesses = zhash_new ()))
         goto error;
+    if (!(s->fanouts = zlist_new ()))
+        goto error;
     if (!(s->local_uri = strdup (local_uri)))
         goto error;
     s->rank = rank;
@@ -733,6 +737,75 @@ error:
     return NULL;
 }
 
+int flux_rexec_tree (flux_t *h, const struct idset *ranks, int flags,
+                     const flux_cmd_t *cmd,
+                     const flux_subprocess_ops_t *ops,
+                     flux_subprocess_t **procs)
+{
+    struct remote_tree *t = NULL;
+    flux_subprocess_t *p = NULL;
+    flux_reactor_t *r;
+    unsigned int rank;
+    int count = 0;
+    int save_errno;
+
+    if (!h || !ranks || idset_count (ranks) == 0 || !cmd || !procs) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    /* no flags supported yet */
+    if (flags) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    /* same requirements on cmd as flux_rexec() */
+    if (!flux_cmd_argc (cmd)
+        || !flux_cmd_getcwd (cmd)
+        || check_local_only_cmd_options (cmd)) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    if (!(r = flux_get_reactor (h)))
+        return -1;
+
+    if (!(t = remote_tree_create (h, idset_count (ranks))))
+        return -1;
+
+    rank = idset_first (ranks);
+    while (rank != IDSET_INVALID_ID) {
+        if (!(p = subprocess_create (h, r, flags, cmd, ops, NULL, rank, false))
+            || subprocess_remote_setup (p) < 0
+            || subprocess_setup_state_change (p) < 0
+            || subprocess_setup_completed (p) < 0
+            || remote_tree_add (t, p) < 0)
+            goto error;
+        procs[count++] = p;
+        p = NULL;
+        rank = idset_next (ranks, rank);
+    }
+
+    if (remote_exec_tree (t, "broker.rexec.tree") < 0)
+        goto error;
+
+    /* subprocesses now hold the only references to the tree */
+    remote_tree_decref (t);
+    return 0;
+
+error:
+    save_errno = errno;
+    flux_subprocess_unref (p);
+    for (int i = 0; i < count; i++) {
+        flux_subprocess_unref (procs[i]);
+        procs[i] = NULL;
+    }
+    remote_tree_decref (t);
+    errno = save_errno;
+    return -1;
+}
+
 int flux_subprocess_stream_start (flux_subprocess_t *p, const char *stream)
 {
     struct subprocess_channel *c;
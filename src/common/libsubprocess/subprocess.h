@@ -339,6 +339,23 @@ flux_subprocess_t *flux_rexec (flux_t *h, int rank, int flags,
                                const flux_cmd_t *cmd,
                                const flux_subprocess_ops_t *ops);
 
+/*
+ *  Create a subprocess for `cmd` on every rank in `ranks` with a single
+ *   request that is forwarded down the TBON and fanned out at each
+ *   level.  State, output, and completion responses are aggregated on
+ *   the way back up, then dispatched to per-rank subprocess objects
+ *   whose callbacks in `ops` are called as for flux_rexec().
+ *
+ *  On success, `procs` is filled with idset_count (ranks) subprocesses
+ *   in rank order.  The caller must release each with
+ *   flux_subprocess_unref(), or flux_subprocess_destroy().
+ */
+struct idset;
+int flux_rexec_tree (flux_t *h, const struct idset *ranks, int flags,
+                     const flux_cmd_t *cmd,
+                     const flux_subprocess_ops_t *ops,
+                     flux_subprocess_t **procs);
+
 /* Start / stop a read stream temporarily on local processes.  This
  * may be useful for flow control.  If you desire to have a stream not
  * call 'on_stdout' or 'on_stderr' when the local subprocess has
@@ -125,6 +125,7 @@ struct flux_subprocess_server {
     char *local_uri;
     uint32_t rank;
     zhash_t *subprocesses;
+    zlist_t *fanouts;               /* active rexec.tree requests */
     flux_msg_handler_t **handlers;
 
     /* for teardown / termination */
@@ -0,0 +1,105 @@
+/************************************************************\
+ * Copyright 2021 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+/* spawn_rate - measure local subprocess launch rate
+ *
+ * Usage: spawn_rate [HEAP-MB] [COUNT]
+ *
+ * Allocate and touch HEAP-MB megabytes of memory (default 1024) to
+ * simulate a broker with a large address space, then run COUNT
+ * (default 1000) instances of /bin/true, one at a time, through
+ * flux_local_exec(3).  This is done once with the default launch path
+ * (vfork(2) when no hooks are set), and once with a no-op post_fork hook,
+ * which forces the fork(2) path.  The launch rate for each is printed.
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <flux/core.h>
+
+#include "src/common/libutil/log.h"
+#include "src/common/libutil/monotime.h"
+
+extern char **environ;
+
+static void noop_hook_cb (flux_subprocess_t *p, void *arg)
+{
+}
+
+static double spawn_rate (flux_reactor_t *r,
+                          flux_cmd_t *cmd,
+                          int count,
+                          flux_subprocess_hooks_t *hooks)
+{
+    struct timespec t0;
+    double elapsed;
+
+    monotime (&t0);
+    for (int i = 0; i < count; i++) {
+        flux_subprocess_t *p;
+        if (!(p = flux_local_exec (r, 0, cmd, NULL, hooks)))
+            log_err_exit ("flux_local_exec");
+        if (flux_reactor_run (r, 0) < 0)
+            log_err_exit ("flux_reactor_run");
+        flux_subprocess_destroy (p);
+    }
+    elapsed = monotime_since (t0) / 1000.;
+    return count / elapsed;
+}
+
+int main (int argc, char *argv[])
+{
+    char *av[] = { "/bin/true", NULL };
+    long heap_mb = 1024;
+    int count = 1000;
+    char *heap;
+    flux_reactor_t *r;
+    flux_cmd_t *cmd;
+    flux_subprocess_hooks_t hooks = { .post_fork = noop_hook_cb };
+
+    log_init ("spawn_rate");
+    if (argc > 3) {
+        fprintf (stderr, "Usage: spawn_rate [HEAP-MB] [COUNT]\n");
+        exit (1);
+    }
+    if (argc > 1)
+        heap_mb = strtol (argv[1], NULL, 10);
+    if (argc > 2)
+        count = strtol (argv[2], NULL, 10);
+    if (heap_mb < 0 || count <= 0)
+        log_msg_exit ("invalid argument");
+
+    if (!(heap = malloc (heap_mb * 1024 * 1024 + 1)))
+        log_err_exit ("malloc");
+    memset (heap, 1, heap_mb * 1024 * 1024 + 1);
+
+    if (!(r = flux_reactor_create (FLUX_REACTOR_SIGCHLD)))
+        log_err_exit ("flux_reactor_create");
+    if (!(cmd = flux_cmd_create (1, av, environ)))
+        log_err_exit ("flux_cmd_create");
+
+    printf ("heap=%ldMB count=%d\n", heap_mb, count);
+    printf ("vfork: %.1f spawns/sec\n", spawn_rate (r, cmd, count, NULL));
+    printf ("fork:  %.1f spawns/sec\n", spawn_rate (r, cmd, count, &hooks));
+
+    flux_cmd_destroy (cmd);
+    flux_reactor_destroy (r);
+    free (heap);
+    log_fini ();
+    return 0;
+}
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
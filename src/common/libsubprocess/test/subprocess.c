@@ -1478,6 +1478,130 @@ void test_exec_fail (flux_reactor_t *r)
     flux_cmd_destroy (cmd);
 }
 
+void noop_hook_cb (flux_subprocess_t *p, void *arg)
+{
+}
+
+/* A post_fork hook forces the fork(2) launch path instead of vfork(2)
+ */
+void test_exec_fail_fork (flux_reactor_t *r)
+{
+    char *av_enoent[]  = { "/usr/bin/foobarbaz", NULL };
+    flux_cmd_t *cmd = NULL;
+    flux_subprocess_t *p = NULL;
+    flux_subprocess_hooks_t hooks = {
+        .post_fork = noop_hook_cb,
+    };
+
+    ok ((cmd = flux_cmd_create (1, av_enoent, NULL)) != NULL, "flux_cmd_create");
+
+    p = flux_local_exec (r, 0, cmd, NULL, &hooks);
+    ok (p == NULL
+        && errno == ENOENT,
+        "flux_local_exec with post_fork hook failed with ENOENT");
+
+    flux_cmd_destroy (cmd);
+}
+
+int fd_leak_exit_code;
+
+void fd_leak_completion_cb (flux_subprocess_t *p)
+{
+    fd_leak_exit_code = flux_subprocess_exit_code (p);
+}
+
+void test_fd_leak (flux_reactor_t *r, bool use_fork)
+{
+    char path[64];
+    char *av[] = { "/bin/sh", "-c", NULL, NULL };
+    flux_cmd_t *cmd;
+    flux_subprocess_t *p = NULL;
+    flux_subprocess_ops_t ops = {
+        .on_completion = fd_leak_completion_cb,
+    };
+    flux_subprocess_hooks_t hooks = {
+        .post_fork = noop_hook_cb,
+    };
+    int fd;
+
+    /* fd is opened without FD_CLOEXEC, so must be closed explicitly */
+    if ((fd = open ("/dev/null", O_RDONLY)) < 0)
+        BAIL_OUT ("open /dev/null failed");
+    snprintf (path, sizeof (path), "test -e /proc/self/fd/%d", fd);
+    av[2] = path;
+
+    ok ((cmd = flux_cmd_create (3, av, environ)) != NULL, "flux_cmd_create");
+    ok (flux_cmd_setcwd (cmd, "/") == 0, "flux_cmd_setcwd works");
+
+    fd_leak_exit_code = -1;
+    p = flux_local_exec (r, 0, cmd, &ops, use_fork ? &hooks : NULL);
+    ok (p != NULL, "flux_local_exec %s", use_fork ? "with hook" : "");
+
+    int rc = flux_reactor_run (r, 0);
+    ok (rc == 0, "flux_reactor_run returned zero status");
+    ok (fd_leak_exit_code == 1,
+        "parent fd %d was not inherited by child", fd);
+    flux_subprocess_destroy (p);
+    flux_cmd_destroy (cmd);
+    close (fd);
+}
+
+/* The vfork(2) path resolves argv[0] from the command's PATH in the
+ * parent, without modifying the parent environment.
+ */
+void test_exec_path (flux_reactor_t *r)
+{
+    char *av_true[] = { "true", NULL };
+    char *av_enoent[] = { "foobarbaz", NULL };
+    char *path = getenv ("PATH");
+    char *saved_path = path ? strdup (path) : NULL;
+    char **saved_environ = environ;
+    flux_cmd_t *cmd;
+    flux_subprocess_t *p = NULL;
+    flux_subprocess_ops_t ops = {
+        .on_completion = fd_leak_completion_cb,
+    };
+
+    ok ((cmd = flux_cmd_create (1, av_true, environ)) != NULL,
+        "flux_cmd_create");
+    ok (flux_cmd_setenvf (cmd, 1, "PATH", "/nonexistent::/bin:/usr/bin") == 0,
+        "flux_cmd_setenvf PATH works");
+
+    fd_leak_exit_code = -1;
+    p = flux_local_exec (r, 0, cmd, &ops, NULL);
+    ok (p != NULL,
+        "flux_local_exec finds true in command PATH");
+    ok (environ == saved_environ
+        && ((!saved_path && !getenv ("PATH"))
+            || (saved_path && getenv ("PATH")
+                && !strcmp (saved_path, getenv ("PATH")))),
+        "parent environment was not modified");
+    ok (flux_reactor_run (r, 0) == 0,
+        "flux_reactor_run returned zero status");
+    ok (fd_leak_exit_code == 0,
+        "true exited with 0");
+    flux_subprocess_destroy (p);
+
+    flux_cmd_unsetenv (cmd, "PATH");
+    fd_leak_exit_code = -1;
+    p = flux_local_exec (r, 0, cmd, &ops, NULL);
+    ok (p != NULL,
+        "flux_local_exec finds true in default PATH");
+    ok (flux_reactor_run (r, 0) == 0 && fd_leak_exit_code == 0,
+        "true exited with 0");
+    flux_subprocess_destroy (p);
+    flux_cmd_destroy (cmd);
+
+    ok ((cmd = flux_cmd_create (1, av_enoent, environ)) != NULL,
+        "flux_cmd_create");
+    p = flux_local_exec (r, 0, cmd, NULL, NULL);
+    ok (p == NULL
+        && errno == ENOENT,
+        "flux_local_exec of command not in PATH fails with ENOENT");
+    flux_cmd_destroy (cmd);
+    free (saved_path);
+}
+
 void test_context (flux_reactor_t *r)
 {
     char *av[] = { "/bin/true", NULL };
@@ -2664,6 +2788,14 @@ int main (int argc, char *argv[])
     test_state_strings ();
     diag ("exec_fail");
     test_exec_fail (r);
+    diag ("exec_fail_fork");
+    test_exec_fail_fork (r);
+    diag ("fd_leak");
+    test_fd_leak (r, false);
+    diag ("fd_leak_fork");
+    test_fd_leak (r, true);
+    diag ("exec_path");
+    test_exec_path (r);
     diag ("context");
     test_context (r);
     diag ("refcount");
@@ -0,0 +1,198 @@
+/************************************************************\
+ * Copyright 2021 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <arpa/inet.h>
+
+#include "blobvec.h"
+
+#define BLOBVEC_HDRSIZE (2 * sizeof (uint32_t))
+
+struct blobvec_entry {
+    int errnum;
+    size_t offset;      /* offset of data from start of buffer */
+    int len;
+};
+
+struct blobvec {
+    const char *buf;    /* points to 'data' when encoding */
+    char *data;
+    size_t size;        /* size of encoded data */
+    size_t alloc;       /* allocated size of 'data' */
+    struct blobvec_entry *entries;
+    int count;
+    int entries_alloc;
+};
+
+void blobvec_destroy (struct blobvec *bv)
+{
+    if (bv) {
+        int saved_errno = errno;
+        free (bv->data);
+        free (bv->entries);
+        free (bv);
+        errno = saved_errno;
+    }
+}
+
+struct blobvec *blobvec_create (void)
+{
+    struct blobvec *bv;
+
+    if (!(bv = calloc (1, sizeof (*bv))))
+        return NULL;
+    return bv;
+}
+
+static int grow_entries (struct blobvec *bv)
+{
+    if (bv->count == bv->entries_alloc) {
+        int n = bv->entries_alloc > 0 ? bv->entries_alloc * 2 : 16;
+        struct blobvec_entry *new;
+
+        if (!(new = realloc (bv->entries, n * sizeof (new[0]))))
+            return -1;
+        bv->entries = new;
+        bv->entries_alloc = n;
+    }
+    return 0;
+}
+
+static int grow_data (struct blobvec *bv, size_t size)
+{
+    if (bv->alloc < size) {
+        size_t n = bv->alloc > 0 ? bv->alloc : 4096;
+        char *new;
+
+        while (n < size)
+            n *= 2;
+        if (!(new = realloc (bv->data, n)))
+            return -1;
+        bv->data = new;
+        bv->buf = new;
+        bv->alloc = n;
+    }
+    return 0;
+}
+
+int blobvec_append (struct blobvec *bv, int errnum, const void *data, int len)
+{
+    uint32_t hdr[2];
+    size_t newsize;
+
+    if (!bv || errnum < 0 || len < 0 || (len > 0 && !data)
+        || (bv->buf && bv->buf != bv->data)) {
+        errno = EINVAL;
+        return -1;
+    }
+    newsize = bv->size + BLOBVEC_HDRSIZE + len;
+    if (grow_entries (bv) < 0 || grow_data (bv, newsize) < 0)
+        return -1;
+    hdr[0] = htonl (errnum);
+    hdr[1] = htonl (len);
+    memcpy (bv->data + bv->size, hdr, BLOBVEC_HDRSIZE);
+    if (len > 0)
+        memcpy (bv->data + bv->size + BLOBVEC_HDRSIZE, data, len);
+    bv->entries[bv->count].errnum = errnum;
+    bv->entries[bv->count].offset = bv->size + BLOBVEC_HDRSIZE;
+    bv->entries[bv->count].len = len;
+    bv->count++;
+    bv->size = newsize;
+    return 0;
+}
+
+struct blobvec *blobvec_decode (const void *buf, int len)
+{
+    struct blobvec *bv;
+    size_t offset = 0;
+
+    if (len < 0 || (len > 0 && !buf)) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if (!(bv = blobvec_create ()))
+        return NULL;
+    bv->buf = buf;
+    bv->size = len;
+    while (offset < len) {
+        uint32_t hdr[2];
+        uint32_t entry_len;
+
+        if (len - offset < BLOBVEC_HDRSIZE)
+            goto eproto;
+        memcpy (hdr, bv->buf + offset, BLOBVEC_HDRSIZE);
+        offset += BLOBVEC_HDRSIZE;
+        entry_len = ntohl (hdr[1]);
+        if (entry_len > len - offset || ntohl (hdr[0]) > INT32_MAX)
+            goto eproto;
+        if (grow_entries (bv) < 0)
+            goto error;
+        bv->entries[bv->count].errnum = ntohl (hdr[0]);
+        bv->entries[bv->count].offset = offset;
+        bv->entries[bv->count].len = entry_len;
+        bv->count++;
+        offset += entry_len;
+    }
+    return bv;
+eproto:
+    errno = EPROTO;
+error:
+    blobvec_destroy (bv);
+    return NULL;
+}
+
+int blobvec_encode (struct blobvec *bv, const void **buf, int *len)
+{
+    if (!bv || !buf || !len) {
+        errno = EINVAL;
+        return -1;
+    }
+    *buf = bv->buf;
+    *len = bv->size;
+    return 0;
+}
+
+int blobvec_count (struct blobvec *bv)
+{
+    return bv ? bv->count : 0;
+}
+
+int blobvec_get (struct blobvec *bv,
+                 int index,
+                 int *errnum,
+                 const void **data,
+                 int *len)
+{
+    if (!bv || index < 0 || index >= bv->count) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (errnum)
+        *errnum = bv->entries[index].errnum;
+    if (data) {
+        if (bv->entries[index].len > 0)
+            *data = bv->buf + bv->entries[index].offset;
+        else
+            *data = NULL;
+    }
+    if (len)
+        *len = bv->entries[index].len;
+    return 0;
+}
+
+/*
+ * vi:ts=4 sw=4 expandtab
+ */
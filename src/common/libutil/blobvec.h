@@ -0,0 +1,65 @@
+/************************************************************\
+ * Copyright 2021 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#ifndef _UTIL_BLOBVEC_H
+#define _UTIL_BLOBVEC_H
+
+/* blobvec - pack a vector of blobs into a single raw message payload
+ *
+ * Each entry is encoded as a 4 byte errno, a 4 byte length (both in network
+ * byte order), followed by 'length' bytes of data.  The errno allows
+ * per-entry failures to be returned in a batch response.
+ * Used for the content.load-batch and content.store-batch protocols.
+ */
+
+struct blobvec;
+
+/* Create an empty blobvec for encoding.
+ */
+struct blobvec *blobvec_create (void);
+
+/* Decode a blobvec from 'buf'.  Entries refer to 'buf' without copying,
+ * so 'buf' must remain valid for the life of the blobvec.
+ * Returns blobvec on success, NULL with errno set on failure (EPROTO if
+ * 'buf' is malformed).
+ */
+struct blobvec *blobvec_decode (const void *buf, int len);
+
+void blobvec_destroy (struct blobvec *bv);
+
+/* Append a copy of 'data' of length 'len' to 'bv', with an errno value
+ * (0 if none).  Entries may not be appended to a decoded blobvec.
+ * Returns 0 on success, -1 with errno set on failure.
+ */
+int blobvec_append (struct blobvec *bv, int errnum, const void *data, int len);
+
+/* Get the encoded form of 'bv'.  The buffer belongs to 'bv' and is
+ * invalidated by blobvec_append() or blobvec_destroy().
+ */
+int blobvec_encode (struct blobvec *bv, const void **buf, int *len);
+
+/* Return the number of entries in 'bv'.
+ */
+int blobvec_count (struct blobvec *bv);
+
+/* Get entry 'index' from 'bv'.  'errnum', 'data', and 'len' may be NULL
+ * if not needed.  Returns 0 on success, -1 with errno set on failure.
+ */
+int blobvec_get (struct blobvec *bv,
+                 int index,
+                 int *errnum,
+                 const void **data,
+                 int *len);
+
+#endif /* !_UTIL_BLOBVEC_H */
+
+/*
+ * vi:ts=4 sw=4 expandtab
+ */
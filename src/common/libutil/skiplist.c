@@ -0,0 +1,312 @@
+/************************************************************\
+ * Copyright 2021 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+/* skiplist.c - ordered list with O(log n) insert and reorder
+ *
+ * Each level is a circular, doubly linked list through a sentinel
+ * head node, so a node can be unlinked without searching for its
+ * predecessors.  This allows an item to be reordered after its sort key
+ * has changed, when a search by key would no longer find it.
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <stdlib.h>
+#include <stdint.h>
+#include <errno.h>
+
+#include "skiplist.h"
+
+#define SKIPLIST_MAX_LEVEL 16   // 4^16 items at p = 1/4
+
+struct skiplist_link {
+    struct skiplist_node *prev;
+    struct skiplist_node *next;
+};
+
+struct skiplist_node {
+    void *item;
+    int level;
+    struct skiplist_link link[];
+};
+
+struct skiplist {
+    skiplist_compare_f cmp;
+    int level;                  // number of levels in use
+    size_t size;
+    uint32_t seed;
+    struct skiplist_node *head; // sentinel
+    struct skiplist_node *cursor;
+};
+
+/* Choose a level with P(level > k) = (1/4)^k.
+ */
+static int random_level (struct skiplist *sl)
+{
+    uint32_t x = sl->seed;
+    int level = 1;
+
+    /* xorshift32 */
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    sl->seed = x;
+
+    while (level < SKIPLIST_MAX_LEVEL && (x & 3) == 0) {
+        level++;
+        x >>= 2;
+    }
+    return level;
+}
+
+static struct skiplist_node *node_create (void *item, int level)
+{
+    struct skiplist_node *node;
+
+    if (!(node = calloc (1, sizeof (*node)
+                            + level * sizeof (struct skiplist_link))))
+        return NULL;
+    node->item = item;
+    node->level = level;
+    return node;
+}
+
+static void node_unlink (struct skiplist_node *node)
+{
+    int i;
+
+    for (i = 0; i < node->level; i++) {
+        node->link[i].prev->link[i].next = node->link[i].next;
+        node->link[i].next->link[i].prev = node->link[i].prev;
+    }
+}
+
+/* Link 'node' after any items that compare less than or equal to it.
+ */
+static void node_link (struct skiplist *sl, struct skiplist_node *node)
+{
+    struct skiplist_node *head = sl->head;
+    struct skiplist_node *x = head;
+    int i;
+
+    while (sl->level < node->level)
+        sl->level++;
+    for (i = sl->level - 1; i >= 0; i--) {
+        struct skiplist_node *next;
+
+        while ((next = x->link[i].next) != head
+               && sl->cmp (next->item, node->item) <= 0)
+            x = next;
+        if (i < node->level) {
+            node->link[i].prev = x;
+            node->link[i].next = x->link[i].next;
+            x->link[i].next->link[i].prev = node;
+            x->link[i].next = node;
+        }
+    }
+}
+
+struct skiplist *skiplist_create (skiplist_compare_f cmp)
+{
+    struct skiplist *sl;
+    int i;
+
+    if (!cmp) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if (!(sl = calloc (1, sizeof (*sl))))
+        return NULL;
+    if (!(sl->head = node_create (NULL, SKIPLIST_MAX_LEVEL))) {
+        free (sl);
+        return NULL;
+    }
+    for (i = 0; i < SKIPLIST_MAX_LEVEL; i++) {
+        sl->head->link[i].prev = sl->head;
+        sl->head->link[i].next = sl->head;
+    }
+    sl->cmp = cmp;
+    sl->level = 1;
+    sl->seed = 2463534242;
+    sl->cursor = sl->head;
+    return sl;
+}
+
+void skiplist_destroy (struct skiplist *sl)
+{
+    if (sl) {
+        int saved_errno = errno;
+        struct skiplist_node *node = sl->head->link[0].next;
+        while (node != sl->head) {
+            struct skiplist_node *next = node->link[0].next;
+            free (node);
+            node = next;
+        }
+        free (sl->head);
+        free (sl);
+        errno = saved_errno;
+    }
+}
+
+void *skiplist_insert (struct skiplist *sl, void *item)
+{
+    struct skiplist_node *node;
+
+    if (!sl) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if (!(node = node_create (item, random_level (sl))))
+        return NULL;
+    node_link (sl, node);
+    sl->size++;
+    return node;
+}
+
+void skiplist_delete (struct skiplist *sl, void *handle)
+{
+    struct skiplist_node *node = handle;
+
+    if (sl && node) {
+        if (sl->cursor == node)
+            sl->cursor = node->link[0].prev;
+        node_unlink (node);
+        free (node);
+        sl->size--;
+    }
+}
+
+void skiplist_reorder (struct skiplist *sl, void *handle)
+{
+    struct skiplist_node *node = handle;
+
+    if (sl && node) {
+        node_unlink (node);
+        node_link (sl, node);
+    }
+}
+
+struct sortent {
+    struct skiplist_node *node;
+    size_t index;
+    skiplist_compare_f cmp;
+};
+
+static int sortent_cmp (const void *a, const void *b)
+{
+    const struct sortent *e1 = a;
+    const struct sortent *e2 = b;
+    int rc;
+
+    if ((rc = e1->cmp (e1->node->item, e2->node->item)) == 0)
+        rc = (e1->index > e2->index) - (e1->index < e2->index);
+    return rc;
+}
+
+int skiplist_sort (struct skiplist *sl)
+{
+    struct skiplist_node *tail[SKIPLIST_MAX_LEVEL];
+    struct skiplist_node *node;
+    struct sortent *ent;
+    size_t i;
+    int j;
+
+    if (!sl) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (sl->size < 2)
+        return 0;
+    if (!(ent = calloc (sl->size, sizeof (ent[0]))))
+        return -1;
+    node = sl->head->link[0].next;
+    for (i = 0; i < sl->size; i++) {
+        ent[i].node = node;
+        ent[i].index = i;
+        ent[i].cmp = sl->cmp;
+        node = node->link[0].next;
+    }
+    qsort (ent, sl->size, sizeof (ent[0]), sortent_cmp);
+
+    /* Relink nodes in sorted order, preserving their levels.
+     */
+    for (j = 0; j < SKIPLIST_MAX_LEVEL; j++)
+        tail[j] = sl->head;
+    for (i = 0; i < sl->size; i++) {
+        node = ent[i].node;
+        for (j = 0; j < node->level; j++) {
+            node->link[j].prev = tail[j];
+            tail[j]->link[j].next = node;
+            tail[j] = node;
+        }
+    }
+    for (j = 0; j < SKIPLIST_MAX_LEVEL; j++) {
+        tail[j]->link[j].next = sl->head;
+        sl->head->link[j].prev = tail[j];
+    }
+    free (ent);
+    return 0;
+}
+
+size_t skiplist_size (struct skiplist *sl)
+{
+    return sl ? sl->size : 0;
+}
+
+void *skiplist_handle_item (void *handle)
+{
+    struct skiplist_node *node = handle;
+
+    return node ? node->item : NULL;
+}
+
+void *skiplist_first (struct skiplist *sl)
+{
+    if (!sl)
+        return NULL;
+    sl->cursor = sl->head->link[0].next;
+    return sl->cursor->item; // head->item is NULL
+}
+
+void *skiplist_next (struct skiplist *sl)
+{
+    if (!sl)
+        return NULL;
+    sl->cursor = sl->cursor->link[0].next;
+    return sl->cursor->item;
+}
+
+void *skiplist_last (struct skiplist *sl)
+{
+    if (!sl)
+        return NULL;
+    sl->cursor = sl->head->link[0].prev;
+    return sl->cursor->item;
+}
+
+void *skiplist_prev (struct skiplist *sl)
+{
+    if (!sl)
+        return NULL;
+    sl->cursor = sl->cursor->link[0].prev;
+    return sl->cursor->item;
+}
+
+void *skiplist_cursor (struct skiplist *sl)
+{
+    if (!sl || sl->cursor == sl->head)
+        return NULL;
+    return sl->cursor;
+}
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
@@ -0,0 +1,74 @@
+/************************************************************\
+ * Copyright 2021 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#ifndef _UTIL_SKIPLIST_H
+#define _UTIL_SKIPLIST_H
+
+#include <stddef.h>
+
+/*  Ordered list implemented as a skip list.
+ *
+ *  Items are kept sorted by a comparator.  Insert is O(log n), and
+ *   delete and reorder by handle are O(log n) without searching, so an
+ *   item may be moved after its sort key has changed.  Items may be
+ *   iterated in order with a cursor, in the manner of zlistx.
+ *
+ *  Items that compare equal are kept in insertion order.
+ */
+
+typedef int (*skiplist_compare_f) (const void *item1, const void *item2);
+
+struct skiplist *skiplist_create (skiplist_compare_f cmp);
+void skiplist_destroy (struct skiplist *sl);
+
+/*  Insert 'item' in order.  Return a handle that may be used to delete
+ *   or reorder the item, or NULL on error with errno set.
+ */
+void *skiplist_insert (struct skiplist *sl, void *item);
+
+/*  Remove the item referred to by 'handle'.  The handle is invalid
+ *   after this call.  If the cursor points to the item, it is moved
+ *   to the previous item.
+ */
+void skiplist_delete (struct skiplist *sl, void *handle);
+
+/*  Move the item referred to by 'handle' to its sorted position,
+ *   e.g. after its sort key has changed.  The handle remains valid.
+ */
+void skiplist_reorder (struct skiplist *sl, void *handle);
+
+/*  Re-sort all items, e.g. after the sort keys of many items have
+ *   changed.  Handles remain valid.  Return 0 on success, -1 on error.
+ */
+int skiplist_sort (struct skiplist *sl);
+
+size_t skiplist_size (struct skiplist *sl);
+
+/*  Return the item referred to by 'handle'.
+ */
+void *skiplist_handle_item (void *handle);
+
+/*  Iterate in order.  first/last reset the cursor; next/prev move it.
+ *   Return NULL at the end of the list.
+ */
+void *skiplist_first (struct skiplist *sl);
+void *skiplist_next (struct skiplist *sl);
+void *skiplist_last (struct skiplist *sl);
+void *skiplist_prev (struct skiplist *sl);
+
+/*  Return the handle of the item at the cursor, or NULL.
+ */
+void *skiplist_cursor (struct skiplist *sl);
+
+#endif /* !_UTIL_SKIPLIST_H */
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
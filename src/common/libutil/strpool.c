@@ -0,0 +1,134 @@
+/************************************************************\
+ * Copyright 2021 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+/* strpool.c - reference counted string interning
+ *
+ * Each string is stored once, in an entry that also holds its
+ * reference count.  The hash key is the string within the entry, so
+ * the hash does not keep a second copy.  A pooled string is mapped
+ * back to its entry with container arithmetic on release.
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include <errno.h>
+
+#include "src/common/libczmqcontainers/czmq_containers.h"
+
+#include "strpool.h"
+
+struct strpool_entry {
+    unsigned int refs;
+    char s[];
+};
+
+struct strpool {
+    zhashx_t *hash;
+    size_t bytes;
+};
+
+static struct strpool_entry *entry_of (const char *s)
+{
+    return (struct strpool_entry *)(s - offsetof (struct strpool_entry, s));
+}
+
+static void entry_destructor (void **item)
+{
+    if (item) {
+        free (*item);
+        *item = NULL;
+    }
+}
+
+struct strpool *strpool_create (void)
+{
+    struct strpool *sp;
+
+    if (!(sp = calloc (1, sizeof (*sp))))
+        return NULL;
+    if (!(sp->hash = zhashx_new ())) {
+        free (sp);
+        errno = ENOMEM;
+        return NULL;
+    }
+    /* keys are owned by entries */
+    zhashx_set_key_duplicator (sp->hash, NULL);
+    zhashx_set_key_destructor (sp->hash, NULL);
+    zhashx_set_destructor (sp->hash, entry_destructor);
+    return sp;
+}
+
+void strpool_destroy (struct strpool *sp)
+{
+    if (sp) {
+        int saved_errno = errno;
+        zhashx_destroy (&sp->hash);
+        free (sp);
+        errno = saved_errno;
+    }
+}
+
+const char *strpool_intern (struct strpool *sp, const char *s)
+{
+    struct strpool_entry *entry;
+    size_t len;
+
+    if (!sp || !s) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if ((entry = zhashx_lookup (sp->hash, s))) {
+        entry->refs++;
+        return entry->s;
+    }
+    len = strlen (s) + 1;
+    if (!(entry = malloc (sizeof (*entry) + len)))
+        return NULL;
+    entry->refs = 1;
+    memcpy (entry->s, s, len);
+    if (zhashx_insert (sp->hash, entry->s, entry) < 0) {
+        free (entry);
+        errno = ENOMEM;
+        return NULL;
+    }
+    sp->bytes += sizeof (*entry) + len;
+    return entry->s;
+}
+
+void strpool_release (struct strpool *sp, const char *s)
+{
+    struct strpool_entry *entry;
+
+    if (!sp || !s)
+        return;
+    entry = entry_of (s);
+    if (--entry->refs == 0) {
+        sp->bytes -= sizeof (*entry) + strlen (entry->s) + 1;
+        zhashx_delete (sp->hash, entry->s);
+    }
+}
+
+size_t strpool_count (struct strpool *sp)
+{
+    return sp ? zhashx_size (sp->hash) : 0;
+}
+
+size_t strpool_bytes (struct strpool *sp)
+{
+    return sp ? sp->bytes : 0;
+}
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
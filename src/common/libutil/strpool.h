@@ -0,0 +1,50 @@
+/************************************************************\
+ * Copyright 2021 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#ifndef _UTIL_STRPOOL_H
+#define _UTIL_STRPOOL_H
+
+#include <stddef.h>
+
+/*  Pool of reference counted, interned strings.
+ *
+ *  Interning a string returns a pointer to a single shared copy,
+ *   so many records holding the same value store it once.  Each
+ *   successful strpool_intern() must be balanced by strpool_release().
+ */
+
+struct strpool *strpool_create (void);
+void strpool_destroy (struct strpool *sp);
+
+/*  Return the pooled copy of 's', adding it if not present, and
+ *   take a reference on it.  Return NULL on error with errno set.
+ */
+const char *strpool_intern (struct strpool *sp, const char *s);
+
+/*  Drop a reference on pooled string 's', as returned by
+ *   strpool_intern().  The string is freed with its last reference.
+ *   NULL is ignored.
+ */
+void strpool_release (struct strpool *sp, const char *s);
+
+/*  Return the number of distinct strings in the pool.
+ */
+size_t strpool_count (struct strpool *sp);
+
+/*  Return the approximate number of bytes of memory used by pooled
+ *   strings, not including the hash table.
+ */
+size_t strpool_bytes (struct strpool *sp);
+
+#endif /* !_UTIL_STRPOOL_H */
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
@@ -0,0 +1,147 @@
+/************************************************************\
+ * Copyright 2021 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#include <string.h>
+#include <errno.h>
+
+#include "src/common/libtap/tap.h"
+#include "src/common/libutil/blobvec.h"
+
+void test_basic (void)
+{
+    struct blobvec *bv;
+    struct blobvec *bv2;
+    const void *buf;
+    int len;
+    const void *data;
+    int errnum;
+    int size;
+
+    ok ((bv = blobvec_create ()) != NULL,
+        "blobvec_create works");
+    ok (blobvec_count (bv) == 0,
+        "blobvec_count returns 0");
+    ok (blobvec_encode (bv, &buf, &len) == 0 && len == 0,
+        "blobvec_encode of empty blobvec works");
+
+    ok (blobvec_append (bv, 0, "foo", 4) == 0,
+        "blobvec_append foo works");
+    ok (blobvec_append (bv, ENOENT, NULL, 0) == 0,
+        "blobvec_append ENOENT works");
+    ok (blobvec_append (bv, 0, NULL, 0) == 0,
+        "blobvec_append empty blob works");
+    ok (blobvec_append (bv, 0, "barbaz", 7) == 0,
+        "blobvec_append barbaz works");
+    ok (blobvec_count (bv) == 4,
+        "blobvec_count returns 4");
+    ok (blobvec_get (bv, 3, &errnum, &data, &size) == 0
+        && errnum == 0 && size == 7 && !strcmp (data, "barbaz"),
+        "blobvec_get returns appended entry");
+
+    ok (blobvec_encode (bv, &buf, &len) == 0,
+        "blobvec_encode works");
+    ok ((bv2 = blobvec_decode (buf, len)) != NULL,
+        "blobvec_decode works");
+    ok (blobvec_count (bv2) == 4,
+        "decoded blobvec has 4 entries");
+    ok (blobvec_get (bv2, 0, &errnum, &data, &size) == 0
+        && errnum == 0 && size == 4 && !strcmp (data, "foo"),
+        "entry 0 is foo");
+    ok (blobvec_get (bv2, 1, &errnum, &data, &size) == 0
+        && errnum == ENOENT && size == 0 && data == NULL,
+        "entry 1 is ENOENT");
+    ok (blobvec_get (bv2, 2, &errnum, &data, &size) == 0
+        && errnum == 0 && size == 0 && data == NULL,
+        "entry 2 is empty");
+    ok (blobvec_get (bv2, 3, NULL, &data, NULL) == 0
+        && !strcmp (data, "barbaz"),
+        "entry 3 is barbaz");
+    errno = 0;
+    ok (blobvec_get (bv2, 4, NULL, NULL, NULL) < 0 && errno == EINVAL,
+        "blobvec_get index=4 fails with EINVAL");
+    errno = 0;
+    ok (blobvec_append (bv2, 0, "x", 1) < 0 && errno == EINVAL,
+        "blobvec_append to decoded blobvec fails with EINVAL");
+
+    errno = 0;
+    ok (blobvec_decode (buf, len - 1) == NULL && errno == EPROTO,
+        "blobvec_decode of truncated buffer fails with EPROTO");
+    errno = 0;
+    ok (blobvec_decode (buf, 3) == NULL && errno == EPROTO,
+        "blobvec_decode of truncated header fails with EPROTO");
+
+    blobvec_destroy (bv2);
+    blobvec_destroy (bv);
+}
+
+void test_large (void)
+{
+    struct blobvec *bv;
+    struct blobvec *bv2;
+    const void *buf;
+    int len;
+    int i;
+    int errors = 0;
+
+    if (!(bv = blobvec_create ()))
+        BAIL_OUT ("blobvec_create failed");
+    for (i = 0; i < 10000; i++) {
+        if (blobvec_append (bv, 0, &i, sizeof (i)) < 0)
+            BAIL_OUT ("blobvec_append failed");
+    }
+    ok (blobvec_encode (bv, &buf, &len) == 0
+        && (bv2 = blobvec_decode (buf, len)) != NULL,
+        "encoded and decoded 10000 entries");
+    for (i = 0; i < 10000; i++) {
+        const void *data;
+        int size;
+        if (blobvec_get (bv2, i, NULL, &data, &size) < 0
+            || size != sizeof (i)
+            || memcmp (data, &i, sizeof (i)) != 0)
+            errors++;
+    }
+    ok (errors == 0,
+        "all 10000 entries decoded correctly");
+    blobvec_destroy (bv2);
+    blobvec_destroy (bv);
+}
+
+void test_inval (void)
+{
+    errno = 0;
+    ok (blobvec_append (NULL, 0, "foo", 4) < 0 && errno == EINVAL,
+        "blobvec_append bv=NULL fails with EINVAL");
+    errno = 0;
+    ok (blobvec_decode (NULL, 4) == NULL && errno == EINVAL,
+        "blobvec_decode buf=NULL fails with EINVAL");
+    errno = 0;
+    ok (blobvec_encode (NULL, NULL, NULL) < 0 && errno == EINVAL,
+        "blobvec_encode bv=NULL fails with EINVAL");
+    ok (blobvec_count (NULL) == 0,
+        "blobvec_count bv=NULL returns 0");
+    lives_ok ({blobvec_destroy (NULL);},
+        "blobvec_destroy NULL doesn't crash");
+}
+
+int main (int argc, char *argv[])
+{
+    plan (NO_PLAN);
+
+    test_basic ();
+    test_large ();
+    test_inval ();
+
+    done_testing ();
+    return 0;
+}
+
+/*
+ * vi:ts=4 sw=4 expandtab
+ */
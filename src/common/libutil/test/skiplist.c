@@ -0,0 +1,218 @@
+/************************************************************\
+ * Copyright 2021 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <errno.h>
+
+#include "src/common/libtap/tap.h"
+#include "src/common/libutil/skiplist.h"
+
+struct item {
+    int key;
+    int id;
+    void *handle;
+};
+
+static int item_cmp (const void *a, const void *b)
+{
+    const struct item *i1 = a;
+    const struct item *i2 = b;
+
+    if (i1->key != i2->key)
+        return i1->key < i2->key ? -1 : 1;
+    return 0;
+}
+
+/* Return true if list is sorted and contains 'count' items,
+ * in both directions.
+ */
+static bool check_sorted (struct skiplist *sl, int count)
+{
+    struct item *item, *prev = NULL;
+    int n = 0;
+
+    item = skiplist_first (sl);
+    while (item) {
+        if (prev && item_cmp (prev, item) > 0)
+            return false;
+        prev = item;
+        n++;
+        item = skiplist_next (sl);
+    }
+    if (n != count)
+        return false;
+    n = 0;
+    prev = NULL;
+    item = skiplist_last (sl);
+    while (item) {
+        if (prev && item_cmp (prev, item) < 0)
+            return false;
+        prev = item;
+        n++;
+        item = skiplist_prev (sl);
+    }
+    return n == count;
+}
+
+void test_basic (void)
+{
+    struct skiplist *sl;
+    struct item items[] = {
+        { .key = 3, .id = 0 },
+        { .key = 1, .id = 1 },
+        { .key = 2, .id = 2 },
+        { .key = 1, .id = 3 },
+    };
+    struct item *item;
+    void *handle;
+
+    ok (skiplist_create (NULL) == NULL && errno == EINVAL,
+        "skiplist_create cmp=NULL fails with EINVAL");
+    ok ((sl = skiplist_create (item_cmp)) != NULL,
+        "skiplist_create works");
+    ok (skiplist_size (sl) == 0,
+        "skiplist_size returns 0");
+    ok (skiplist_first (sl) == NULL && skiplist_last (sl) == NULL,
+        "skiplist_first/last return NULL on empty list");
+    ok (skiplist_cursor (sl) == NULL,
+        "skiplist_cursor returns NULL on empty list");
+
+    for (int i = 0; i < 4; i++)
+        items[i].handle = skiplist_insert (sl, &items[i]);
+    ok (items[0].handle && items[1].handle
+        && items[2].handle && items[3].handle,
+        "skiplist_insert works");
+    ok (skiplist_size (sl) == 4,
+        "skiplist_size returns 4");
+    ok (skiplist_handle_item (items[2].handle) == &items[2],
+        "skiplist_handle_item works");
+
+    item = skiplist_first (sl);
+    ok (item == &items[1],
+        "skiplist_first returns first of equal items inserted");
+    ok (skiplist_cursor (sl) == items[1].handle,
+        "skiplist_cursor returns handle of first item");
+    item = skiplist_next (sl);
+    ok (item == &items[3],
+        "skiplist_next returns second of equal items inserted");
+    item = skiplist_next (sl);
+    ok (item == &items[2],
+        "skiplist_next returns key=2");
+    item = skiplist_next (sl);
+    ok (item == &items[0],
+        "skiplist_next returns key=3");
+    ok (skiplist_next (sl) == NULL,
+        "skiplist_next returns NULL at end of list");
+    ok (skiplist_next (sl) == &items[1],
+        "skiplist_next wraps to first item");
+
+    (void)skiplist_first (sl);
+    (void)skiplist_next (sl);
+    skiplist_delete (sl, items[3].handle);
+    ok (skiplist_size (sl) == 3,
+        "skiplist_delete of cursor item works");
+    ok (skiplist_next (sl) == &items[2],
+        "skiplist_next after delete of cursor item continues iteration");
+
+    items[0].key = 0;
+    skiplist_reorder (sl, items[0].handle);
+    ok (skiplist_first (sl) == &items[0],
+        "skiplist_reorder moves item with changed key to front");
+    items[0].key = 5;
+    skiplist_reorder (sl, items[0].handle);
+    ok (skiplist_last (sl) == &items[0],
+        "skiplist_reorder moves item with changed key to back");
+    ok (check_sorted (sl, 3),
+        "list is sorted");
+
+    (void)skiplist_last (sl);
+    handle = skiplist_cursor (sl);
+    ok (handle == items[0].handle,
+        "skiplist_cursor returns handle of last item");
+
+    skiplist_destroy (sl);
+
+    skiplist_delete (NULL, NULL);
+    skiplist_reorder (NULL, NULL);
+    skiplist_destroy (NULL);
+    ok (skiplist_size (NULL) == 0,
+        "skiplist_size (NULL) returns 0");
+    ok (skiplist_insert (NULL, &items[0]) == NULL && errno == EINVAL,
+        "skiplist_insert sl=NULL fails with EINVAL");
+    ok (skiplist_sort (NULL) < 0 && errno == EINVAL,
+        "skiplist_sort sl=NULL fails with EINVAL");
+    ok (skiplist_first (NULL) == NULL && skiplist_next (NULL) == NULL
+        && skiplist_last (NULL) == NULL && skiplist_prev (NULL) == NULL,
+        "skiplist iterators return NULL with sl=NULL");
+}
+
+void test_many (void)
+{
+    const int count = 10000;
+    struct skiplist *sl;
+    struct item *items;
+    bool failed = false;
+    int i;
+
+    if (!(items = calloc (count, sizeof (items[0]))))
+        BAIL_OUT ("out of memory");
+    if (!(sl = skiplist_create (item_cmp)))
+        BAIL_OUT ("skiplist_create failed");
+    srand (42);
+    for (i = 0; i < count; i++) {
+        items[i].key = rand () % 1000;
+        items[i].id = i;
+        if (!(items[i].handle = skiplist_insert (sl, &items[i])))
+            failed = true;
+    }
+    ok (!failed && skiplist_size (sl) == count,
+        "inserted %d items", count);
+    ok (check_sorted (sl, count),
+        "list is sorted");
+
+    for (i = 0; i < count; i += 3) {
+        items[i].key = rand () % 1000;
+        skiplist_reorder (sl, items[i].handle);
+    }
+    ok (check_sorted (sl, count),
+        "list is sorted after reordering one third of items");
+
+    for (i = 0; i < count; i++)
+        items[i].key = rand () % 1000;
+    ok (skiplist_sort (sl) == 0,
+        "skiplist_sort works after changing all keys");
+    ok (check_sorted (sl, count),
+        "list is sorted");
+
+    for (i = 0; i < count; i += 2)
+        skiplist_delete (sl, items[i].handle);
+    ok (skiplist_size (sl) == count / 2,
+        "deleted half of items");
+    ok (check_sorted (sl, count / 2),
+        "list is sorted");
+
+    skiplist_destroy (sl);
+    free (items);
+}
+
+int main (int argc, char *argv[])
+{
+    plan (NO_PLAN);
+
+    test_basic ();
+    test_many ();
+
+    done_testing ();
+}
+
+/*
+ * vi:ts=4 sw=4 expandtab
+ */
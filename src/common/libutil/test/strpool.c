@@ -0,0 +1,98 @@
+/************************************************************\
+ * Copyright 2021 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include "src/common/libtap/tap.h"
+#include "src/common/libutil/strpool.h"
+
+static void test_basic (void)
+{
+    struct strpool *sp;
+    const char *a, *b, *c;
+    char buf[16];
+
+    ok ((sp = strpool_create ()) != NULL,
+        "strpool_create works");
+    ok (strpool_count (sp) == 0 && strpool_bytes (sp) == 0,
+        "new pool is empty");
+
+    a = strpool_intern (sp, "hostname");
+    ok (a != NULL && !strcmp (a, "hostname"),
+        "strpool_intern returns copy of string");
+    strcpy (buf, "hostname");
+    b = strpool_intern (sp, buf);
+    ok (b == a,
+        "interning an equal string returns the same pointer");
+    c = strpool_intern (sp, "sleep");
+    ok (c != NULL && c != a,
+        "interning a different string returns a different pointer");
+    ok (strpool_count (sp) == 2,
+        "pool contains two strings");
+    ok (strpool_bytes (sp) > strlen ("hostname") + strlen ("sleep"),
+        "strpool_bytes accounts for strings");
+
+    strpool_release (sp, a);
+    ok (strpool_count (sp) == 2,
+        "string remains in pool while referenced");
+    ok (!strcmp (b, "hostname"),
+        "remaining reference is still valid");
+    strpool_release (sp, b);
+    ok (strpool_count (sp) == 1,
+        "string is removed with its last reference");
+    strpool_release (sp, c);
+    ok (strpool_count (sp) == 0 && strpool_bytes (sp) == 0,
+        "pool is empty after all references are released");
+
+    strpool_release (sp, NULL);
+    pass ("strpool_release ignores NULL");
+
+    a = strpool_intern (sp, "");
+    ok (a != NULL && *a == '\0',
+        "empty string can be interned");
+    strpool_release (sp, a);
+
+    strpool_destroy (sp);
+}
+
+static void test_errors (void)
+{
+    struct strpool *sp;
+
+    if (!(sp = strpool_create ()))
+        BAIL_OUT ("strpool_create failed");
+    errno = 0;
+    ok (strpool_intern (NULL, "foo") == NULL && errno == EINVAL,
+        "strpool_intern sp=NULL fails with EINVAL");
+    errno = 0;
+    ok (strpool_intern (sp, NULL) == NULL && errno == EINVAL,
+        "strpool_intern s=NULL fails with EINVAL");
+    ok (strpool_count (NULL) == 0 && strpool_bytes (NULL) == 0,
+        "strpool_count/bytes sp=NULL return 0");
+    strpool_destroy (sp);
+    strpool_destroy (NULL);
+}
+
+int main (int argc, char *argv[])
+{
+    plan (NO_PLAN);
+
+    test_basic ();
+    test_errors ();
+
+    done_testing ();
+    return 0;
+}
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
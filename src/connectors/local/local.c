@@ -222,6 +222,29 @@ static int override_retry_count (struct usock_retry_params *retry)
     return 0;
 }
 
+/* If FLUX_LOCAL_CONNECTOR_SHMEM is set to a nonzero value, move message
+ * traffic to shared memory after connecting.  A value greater than 1 sets
+ * the ring size in bytes.
+ */
+static int get_shmem_size (size_t *size)
+{
+    const char *s;
+    unsigned long n = 0;
+
+    if ((s = getenv ("FLUX_LOCAL_CONNECTOR_SHMEM"))) {
+        char *endptr;
+
+        errno = 0;
+        n = strtoul (s, &endptr, 10);
+        if (errno != 0 || *endptr != '\0') {
+            errno = EINVAL;
+            return -1;
+        }
+    }
+    *size = n > 1 ? n : 0;
+    return n > 0 ? 1 : 0;
+}
+
 /* Path is interpreted as the directory containing the unix domain socket.
  */
 flux_t *connector_init (const char *path, int flags)
@@ -229,8 +252,12 @@ flux_t *connector_init (const char *path, int flags)
     struct local_connector *ctx;
     struct usock_retry_params retry = USOCK_RETRY_DEFAULT;
     struct flux_msg_cred server_cred;
+    size_t shmem_size;
+    int shmem;
 
-    if (!path || override_retry_count (&retry) < 0) {
+    if (!path
+        || override_retry_count (&retry) < 0
+        || (shmem = get_shmem_size (&shmem_size)) < 0) {
         errno = EINVAL;
         return NULL;
     }
@@ -249,6 +276,10 @@ flux_t *connector_init (const char *path, int flags)
     ctx->owner = server_cred.userid;
     if (!(ctx->uclient = usock_client_create (ctx->fd)))
         goto error;
+    /* Fall back to the socket if the broker does not support shmem.
+     */
+    if (shmem)
+        (void)usock_client_enable_shmem (ctx->uclient, shmem_size);
     if (!(ctx->h = flux_handle_create (ctx, &handle_ops, flags)))
         goto error;
     return ctx->h;
@@ -26,6 +26,7 @@
 #include <sys/socket.h>
 #include <ctype.h>
 #include <inttypes.h>
+#include <jansson.h>
 #include <flux/core.h>
 
 #include "src/common/libczmqcontainers/czmq_containers.h"
@@ -266,8 +267,67 @@ error:
         flux_log_error (h, "error responding to config-reload request");
 }
 
+/* Report I/O counts for each client connection, in addition to the
+ * message counters reported by the default module stats handler.
+ */
+static void stats_cb (flux_t *h,
+                      flux_msg_handler_t *mh,
+                      const flux_msg_t *msg,
+                      void *arg)
+{
+    struct connector_local *ctx = arg;
+    struct usock_conn *uconn;
+    flux_msgcounters_t mcs;
+    json_t *conns;
+    int count = 0;
+
+    if (!(conns = json_object ()))
+        goto nomem;
+    uconn = usock_server_first_conn (ctx->server);
+    while (uconn) {
+        const struct usock_conn_stats *stats = usock_conn_get_stats (uconn);
+        json_t *o;
+
+        if (!(o = json_pack ("{s:I s:I s:I s:I s:I s:b}",
+                             "recv-calls", (json_int_t)stats->recv_calls,
+                             "recv-count", (json_int_t)stats->recv_count,
+                             "send-calls", (json_int_t)stats->send_calls,
+                             "send-count", (json_int_t)stats->send_count,
+                             "wakeups", (json_int_t)stats->wakeups,
+                             "shmem", usock_conn_is_shmem (uconn))))
+            goto nomem;
+        if (json_object_set_new (conns, usock_conn_get_uuid (uconn), o) < 0) {
+            json_decref (o);
+            goto nomem;
+        }
+        count++;
+        uconn = usock_server_next_conn (ctx->server);
+    }
+    flux_get_msgcounters (h, &mcs);
+    if (flux_respond_pack (h, msg, "{s:i s:i s:i s:i s:i s:i s:i s:i s:i s:O}",
+                           "#request (tx)", mcs.request_tx,
+                           "#request (rx)", mcs.request_rx,
+                           "#response (tx)", mcs.response_tx,
+                           "#response (rx)", mcs.response_rx,
+                           "#event (tx)", mcs.event_tx,
+                           "#event (rx)", mcs.event_rx,
+                           "#keepalive (tx)", mcs.keepalive_tx,
+                           "#keepalive (rx)", mcs.keepalive_rx,
+                           "connection-count", count,
+                           "connections", conns) < 0)
+        flux_log_error (h, "error responding to stats-get request");
+    json_decref (conns);
+    return;
+nomem:
+    if (flux_respond_error (h, msg, ENOMEM, NULL) < 0)
+        flux_log_error (h, "error responding to stats-get request");
+    json_decref (conns);
+}
+
 static const struct flux_msg_handler_spec htab[] = {
     { FLUX_MSGTYPE_REQUEST,  "connector-local.config-reload", reload_cb, 0 },
+    { FLUX_MSGTYPE_REQUEST,  "connector-local.stats.get", stats_cb,
+      FLUX_ROLE_USER },
     FLUX_MSGHANDLER_TABLE_END,
 };
 
@@ -15,7 +15,7 @@
  * As such, it is hungry for inodes and may run the file system out of them
  * if used in anger!
  *
- * There are four main operations (RPC handlers):
+ * The main operations (RPC handlers) are:
  *
  * content-backing.load:
  * Given a blobref, lookup blob and return it or a "not found" error.
@@ -23,6 +23,9 @@
  * content-backing.store:
  * Given a blob, store it and return its blobref
  *
+ * content-backing.load-batch, content-backing.store-batch:
+ * Same as above, but for a vector of blobrefs or blobs in one message.
+ *
  * kvs-checkpoint.get:
  * Given a string key, lookup string value and return it or a "not found" error.
  *
@@ -30,6 +33,9 @@
  * Given a string key and string value, store it and return.
  * If the key exists, overwrite.
  *
+ * content-files.gc:
+ * Remove blobs that are unreachable from the KVS (see content-gc.h).
+ *
  * The content operations are per RFC 10 and are the main storage behind
  * the Flux KVS.
  *
@@ -51,12 +57,19 @@
 #if HAVE_CONFIG_H
 #include "config.h"
 #endif
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <dirent.h>
+#include <fcntl.h>
 #include <flux/core.h>
+#include <jansson.h>
 
 #include "src/common/libutil/blobref.h"
+#include "src/common/libutil/blobvec.h"
 #include "src/common/libutil/log.h"
 
 #include "src/common/libcontent/content-util.h"
+#include "src/common/libcontent/content-gc.h"
 
 #include "filedb.h"
 
@@ -65,6 +78,8 @@ struct content_files {
     char *dbpath;
     flux_t *h;
     const char *hashfun;
+    struct content_gc *gc;
+    DIR *sweep_dir;
 };
 
 /* Handle a content-backing.load request from the rank 0 broker's
@@ -97,6 +112,7 @@ static void load_cb (flux_t *h,
     }
     if (filedb_get (ctx->dbpath, blobref, &data, &size, &errstr) < 0)
         goto error;
+    content_gc_note (ctx->gc, blobref);
     if (flux_respond_raw (h, msg, data, size) < 0)
         flux_log_error (h, "error responding to load request");
     free (data);
@@ -131,6 +147,7 @@ void store_cb (flux_t *h,
                       blobref,
                       sizeof (blobref)) < 0)
         goto error;
+    content_gc_note (ctx->gc, blobref);
     if (filedb_put (ctx->dbpath, blobref, data, size, &errstr) < 0)
         goto error;
     if (flux_respond_raw (h, msg, blobref, strlen (blobref) + 1) < 0)
@@ -141,6 +158,137 @@ error:
         flux_log_error (h, "error responding to store request");
 }
 
+/* Handle a content-backing.load-batch request from the rank 0 broker's
+ * content-cache service.  The raw request payload is a blobvec of blobrefs.
+ * The raw response payload is a blobvec of blobs in the same order,
+ * with per-blob errors.
+ */
+static void load_batch_cb (flux_t *h,
+                           flux_msg_handler_t *mh,
+                           const flux_msg_t *msg,
+                           void *arg)
+{
+    struct content_files *ctx = arg;
+    const void *buf;
+    int len;
+    struct blobvec *request = NULL;
+    struct blobvec *response = NULL;
+    const char *errstr = NULL;
+    int i;
+
+    if (flux_request_decode_raw (msg, NULL, &buf, &len) < 0)
+        goto error;
+    if (!(request = blobvec_decode (buf, len))
+        || !(response = blobvec_create ()))
+        goto error;
+    for (i = 0; i < blobvec_count (request); i++) {
+        const char *blobref;
+        int blobref_size;
+        void *data = NULL;
+        size_t size;
+        const char *ignore = NULL;
+        int rc;
+
+        if (blobvec_get (request,
+                         i,
+                         NULL,
+                         (const void **)&blobref,
+                         &blobref_size) < 0)
+            goto error;
+        if (!blobref || blobref[blobref_size - 1] != '\0'
+                     || blobref_validate (blobref) < 0) {
+            errno = EPROTO;
+            errstr = "invalid blobref";
+            goto error;
+        }
+        if (filedb_get (ctx->dbpath, blobref, &data, &size, &ignore) < 0)
+            rc = blobvec_append (response, errno, NULL, 0);
+        else {
+            content_gc_note (ctx->gc, blobref);
+            rc = blobvec_append (response, 0, data, size);
+        }
+        free (data);
+        if (rc < 0)
+            goto error;
+    }
+    if (blobvec_encode (response, &buf, &len) < 0)
+        goto error;
+    if (flux_respond_raw (h, msg, buf, len) < 0)
+        flux_log_error (h, "error responding to load-batch request");
+    blobvec_destroy (request);
+    blobvec_destroy (response);
+    return;
+error:
+    if (flux_respond_error (h, msg, errno, errstr) < 0)
+        flux_log_error (h, "error responding to load-batch request");
+    blobvec_destroy (request);
+    blobvec_destroy (response);
+}
+
+/* Handle a content-backing.store-batch request from the rank 0 broker's
+ * content-cache service.  The raw request payload is a blobvec of blobs.
+ * The raw response payload is a blobvec of blobrefs in the same order,
+ * with per-blob errors.
+ */
+void store_batch_cb (flux_t *h,
+                     flux_msg_handler_t *mh,
+                     const flux_msg_t *msg,
+                     void *arg)
+{
+    struct content_files *ctx = arg;
+    const void *buf;
+    int len;
+    struct blobvec *request = NULL;
+    struct blobvec *response = NULL;
+    int i;
+
+    if (flux_request_decode_raw (msg, NULL, &buf, &len) < 0)
+        goto error;
+    if (!(request = blobvec_decode (buf, len))
+        || !(response = blobvec_create ()))
+        goto error;
+    for (i = 0; i < blobvec_count (request); i++) {
+        char blobref[BLOBREF_MAX_STRING_SIZE];
+        const void *data;
+        int size;
+        const char *ignore = NULL;
+        int rc;
+
+        if (blobvec_get (request, i, NULL, &data, &size) < 0)
+            goto error;
+        if (blobref_hash (ctx->hashfun,
+                          (uint8_t *)data,
+                          size,
+                          blobref,
+                          sizeof (blobref)) < 0)
+            rc = blobvec_append (response, errno, NULL, 0);
+        else {
+            content_gc_note (ctx->gc, blobref);
+            if (filedb_put (ctx->dbpath, blobref, data, size, &ignore) < 0)
+                rc = blobvec_append (response, errno, NULL, 0);
+            else
+                rc = blobvec_append (response,
+                                     0,
+                                     blobref,
+                                     strlen (blobref) + 1);
+        }
+        if (rc < 0)
+            goto error;
+    }
+    if (blobvec_encode (response, &buf, &len) < 0)
+        goto error;
+    if (flux_respond_raw (h, msg, buf, len) < 0)
+        flux_log_error (h, "error responding to store-batch request");
+    blobvec_destroy (request);
+    blobvec_destroy (response);
+    return;
+error:
+    if (flux_respond_error (h, msg, errno, NULL) < 0)
+        flux_log_error (h, "error responding to store-batch request");
+    blobvec_destroy (request);
+    blobvec_destroy (response);
+}
+
 /* Handle a kvs-checkpoint.get request from the rank 0 kvs module.
  * The KVS stores its last root reference here for restart purposes.
  *
@@ -208,6 +356,109 @@ error:
         flux_log_error (h, "error responding to kvs-checkpoint.put request");
 }
 
+/* Garbage collection operations (see content-gc.h).
+ * Files in the store that are not named with a valid blobref,
+ * such as checkpoint keys, are skipped by the sweep.
+ */
+static int gc_load (void *arg, const char *blobref, void **datap, int *sizep)
+{
+    struct content_files *ctx = arg;
+    void *data;
+    size_t size;
+
+    if (filedb_get (ctx->dbpath, blobref, &data, &size, NULL) < 0)
+        return -1;
+    *datap = data;
+    *sizep = size;
+    return 0;
+}
+
+static int gc_sweep_begin (void *arg)
+{
+    struct content_files *ctx = arg;
+
+    if (!(ctx->sweep_dir = opendir (ctx->dbpath)))
+        return -1;
+    return 0;
+}
+
+static int gc_sweep_next (void *arg, char *blobref, int blobrefsz, int *size)
+{
+    struct content_files *ctx = arg;
+    struct dirent *dent;
+    struct stat sb;
+
+    errno = 0;
+    while ((dent = readdir (ctx->sweep_dir))) {
+        if (blobref_validate (dent->d_name) < 0
+            || strlen (dent->d_name) >= blobrefsz)
+            continue;
+        if (fstatat (dirfd (ctx->sweep_dir), dent->d_name, &sb, 0) < 0) {
+            if (errno == ENOENT)
+                continue;
+            return -1;
+        }
+        strcpy (blobref, dent->d_name);
+        *size = sb.st_size;
+        return 1;
+    }
+    return errno == 0 ? 0 : -1;
+}
+
+static void gc_sweep_end (void *arg)
+{
+    struct content_files *ctx = arg;
+
+    (void)closedir (ctx->sweep_dir);
+    ctx->sweep_dir = NULL;
+}
+
+static int gc_remove (void *arg, const char *blobref)
+{
+    struct content_files *ctx = arg;
+
+    return filedb_remove (ctx->dbpath, blobref, NULL);
+}
+
+static const struct content_gc_ops gc_ops = {
+    .load = gc_load,
+    .sweep_begin = gc_sweep_begin,
+    .sweep_next = gc_sweep_next,
+    .sweep_end = gc_sweep_end,
+    .remove = gc_remove,
+};
+
+/* Handle a content-files.gc request.  The response is sent once
+ * garbage collection has completed.
+ */
+static void gc_cb (flux_t *h,
+                   flux_msg_handler_t *mh,
+                   const flux_msg_t *msg,
+                   void *arg)
+{
+    struct content_files *ctx = arg;
+
+    content_gc_request (ctx->gc, msg);
+}
+
+static void stats_get_cb (flux_t *h,
+                          flux_msg_handler_t *mh,
+                          const flux_msg_t *msg,
+                          void *arg)
+{
+    struct content_files *ctx = arg;
+    json_t *gc;
+
+    if (!(gc = content_gc_stats (ctx->gc)))
+        goto error;
+    if (flux_respond_pack (h, msg, "{s:o}", "gc", gc) < 0)
+        flux_log_error (h, "error responding to stats-get request");
+    return;
+error:
+    if (flux_respond_error (h, msg, errno, NULL) < 0)
+        flux_log_error (h, "error responding to stats-get request");
+}
+
 /* Destroy module context.
  */
 static void content_files_destroy (struct content_files *ctx)
@@ -215,6 +466,7 @@ static void content_files_destroy (struct content_files *ctx)
     if (ctx) {
         int saved_errno = errno;
         flux_msg_handler_delvec (ctx->handlers);
+        content_gc_destroy (ctx->gc);
         free (ctx->dbpath);
         free (ctx);
         errno = saved_errno;
@@ -227,8 +479,12 @@ static void content_files_destroy (struct content_files *ctx)
 static const struct flux_msg_handler_spec htab[] = {
     { FLUX_MSGTYPE_REQUEST, "content-backing.load",    load_cb, 0 },
     { FLUX_MSGTYPE_REQUEST, "content-backing.store",   store_cb, 0 },
+    { FLUX_MSGTYPE_REQUEST, "content-backing.load-batch", load_batch_cb, 0 },
+    { FLUX_MSGTYPE_REQUEST, "content-backing.store-batch", store_batch_cb, 0 },
     { FLUX_MSGTYPE_REQUEST, "kvs-checkpoint.get", checkpoint_get_cb, 0 },
     { FLUX_MSGTYPE_REQUEST, "kvs-checkpoint.put", checkpoint_put_cb, 0 },
+    { FLUX_MSGTYPE_REQUEST, "content-files.gc", gc_cb, 0 },
+    { FLUX_MSGTYPE_REQUEST, "content-files.stats.get", stats_get_cb, 0 },
     FLUX_MSGHANDLER_TABLE_END,
 };
 
@@ -280,6 +536,8 @@ static struct content_files *content_files_create (flux_t *h)
         if (mkdir (ctx->dbpath, 0700) < 0)
             goto error;
     }
+    if (!(ctx->gc = content_gc_create (h, &gc_ops, ctx)))
+        goto error;
     if (flux_msg_handler_addvec (h, htab, ctx, &ctx->handlers) < 0)
         goto error;
     return ctx;
@@ -98,6 +98,28 @@ int filedb_put (const char *dbpath,
     return 0;
 }
 
+int filedb_remove (const char *dbpath, const char *key, const char **errstr)
+{
+    char path[1024];
+
+    if (strlen (key) == 0 || strchr (key, '/') || !strcmp (key, "..")
+                          || !strcmp (key, ".")) {
+        errno = EINVAL;
+        if (errstr)
+            *errstr = "invalid key";
+        return -1;
+    }
+    if (snprintf (path, sizeof (path), "%s/%s", dbpath, key) >= sizeof (path)) {
+        errno = EOVERFLOW;
+        if (errstr)
+            *errstr = "key name too long for internal buffer";
+        return -1;
+    }
+    if (unlink (path) < 0)
+        return -1;
+    return 0;
+}
+
 /*
  * vi:ts=4 sw=4 expandtab
  */
@@ -37,6 +37,13 @@ int filedb_put (const char *dbpath,
                 size_t size,
                 const char **errstr);
 
+/* Remove file named 'key' from the dbpath directory.  On success, 0 is
+ * returned.  On failure, -1 is returned with errno set.
+ * Pass '*errstr' in pre-set to NULL and if a human readable error message
+ * is appropriate, it is assigned on error (do not free).
+ */
+int filedb_remove (const char *dbpath, const char *key, const char **errstr);
+
 #endif /* !_CONTENT_FILES_FILEDB_H */
 
 /*
@@ -68,6 +68,26 @@ void test_badargs (const char *dbpath)
         "filedb_put key=<long> failed with EOVERFLOW");
     ok (errstr != NULL,
         "and error string was set");
+
+    /* remove */
+
+    errno = 0;
+    errstr = NULL;
+    ok (filedb_remove (dbpath, "..", &errstr) < 0 && errno == EINVAL,
+        "filedb_remove key=\"..\" failed with EINVAL");
+    ok (errstr != NULL,
+        "and error string was set");
+
+    errno = 0;
+    errstr = NULL;
+    ok (filedb_remove (dbpath, longkey, &errstr) < 0 && errno == EOVERFLOW,
+        "filedb_remove key=<long> failed with EOVERFLOW");
+    ok (errstr != NULL,
+        "and error string was set");
+
+    errno = 0;
+    ok (filedb_remove (dbpath, "noexist", NULL) < 0 && errno == ENOENT,
+        "filedb_remove key=noexist fails with ENOENT");
 }
 
 void test_simple (const char *dbpath)
@@ -99,6 +119,15 @@ void test_simple (const char *dbpath)
     ok (data && size == sizeof (val2) && memcmp (data, val2, size) == 0,
         "and returned the updated data");
     free (data);
+
+    /* remove */
+
+    ok (filedb_remove (dbpath, "key1", &errstr) == 0,
+        "filedb_remove key1 works");
+    errno = 0;
+    ok (filedb_get (dbpath, "key1", &data, &size, &errstr) < 0
+        && errno == ENOENT,
+        "filedb_get key1 fails with ENOENT after remove");
 }
 
 int main (int argc, char *argv[])
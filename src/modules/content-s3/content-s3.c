@@ -15,6 +15,7 @@
 #include <flux/core.h>
 
 #include "src/common/libutil/blobref.h"
+#include "src/common/libutil/blobvec.h"
 #include "src/common/libutil/log.h"
 
 #include "src/common/libcontent/content-util.h"
@@ -313,6 +314,128 @@ error:
         flux_log_error (h, "error responding to store request");
 }
 
+/* Handle a content-backing.load-batch request from the rank 0 broker's
+ * content-cache service.  The raw request payload is a blobvec of blobrefs.
+ * The raw response payload is a blobvec of blobs in the same order,
+ * with per-blob errors.
+ */
+static void load_batch_cb (flux_t *h,
+                           flux_msg_handler_t *mh,
+                           const flux_msg_t *msg,
+                           void *arg)
+{
+    struct content_s3 *ctx = arg;
+    const void *buf;
+    int len;
+    struct blobvec *request = NULL;
+    struct blobvec *response = NULL;
+    const char *errstr = NULL;
+    int i;
+
+    if (flux_request_decode_raw (msg, NULL, &buf, &len) < 0)
+        goto error;
+    if (!(request = blobvec_decode (buf, len))
+        || !(response = blobvec_create ()))
+        goto error;
+    for (i = 0; i < blobvec_count (request); i++) {
+        const char *blobref;
+        int blobref_size;
+        void *data = NULL;
+        size_t size;
+        const char *ignore = NULL;
+        int rc;
+
+        if (blobvec_get (request,
+                         i,
+                         NULL,
+                         (const void **)&blobref,
+                         &blobref_size) < 0)
+            goto error;
+        if (!blobref || blobref[blobref_size - 1] != '\0'
+                     || blobref_validate (blobref) < 0) {
+            errno = EPROTO;
+            errstr = "invalid blobref";
+            goto error;
+        }
+        if (s3_get (ctx->cfg, blobref, &data, &size, &ignore) < 0)
+            rc = blobvec_append (response, errno, NULL, 0);
+        else
+            rc = blobvec_append (response, 0, data, size);
+        free (data);
+        if (rc < 0)
+            goto error;
+    }
+    if (blobvec_encode (response, &buf, &len) < 0)
+        goto error;
+    if (flux_respond_raw (h, msg, buf, len) < 0)
+        flux_log_error (h, "error responding to load-batch request");
+    blobvec_destroy (request);
+    blobvec_destroy (response);
+    return;
+error:
+    if (flux_respond_error (h, msg, errno, errstr) < 0)
+        flux_log_error (h, "error responding to load-batch request");
+    blobvec_destroy (request);
+    blobvec_destroy (response);
+}
+
+/* Handle a content-backing.store-batch request from the rank 0 broker's
+ * content-cache service.  The raw request payload is a blobvec of blobs.
+ * The raw response payload is a blobvec of blobrefs in the same order,
+ * with per-blob errors.
+ */
+void store_batch_cb (flux_t *h,
+                     flux_msg_handler_t *mh,
+                     const flux_msg_t *msg,
+                     void *arg)
+{
+    struct content_s3 *ctx = arg;
+    const void *buf;
+    int len;
+    struct blobvec *request = NULL;
+    struct blobvec *response = NULL;
+    int i;
+
+    if (flux_request_decode_raw (msg, NULL, &buf, &len) < 0)
+        goto error;
+    if (!(request = blobvec_decode (buf, len))
+        || !(response = blobvec_create ()))
+        goto error;
+    for (i = 0; i < blobvec_count (request); i++) {
+        char blobref[BLOBREF_MAX_STRING_SIZE];
+        const void *data;
+        int size;
+        const char *ignore = NULL;
+        int rc;
+
+        if (blobvec_get (request, i, NULL, &data, &size) < 0)
+            goto error;
+        if (blobref_hash (ctx->hashfun,
+                          (uint8_t *)data,
+                          size,
+                          blobref,
+                          sizeof (blobref)) < 0
+            || s3_put (ctx->cfg, blobref, data, size, &ignore) < 0)
+            rc = blobvec_append (response, errno, NULL, 0);
+        else
+            rc = blobvec_append (response, 0, blobref, strlen (blobref) + 1);
+        if (rc < 0)
+            goto error;
+    }
+    if (blobvec_encode (response, &buf, &len) < 0)
+        goto error;
+    if (flux_respond_raw (h, msg, buf, len) < 0)
+        flux_log_error (h, "error responding to store-batch request");
+    blobvec_destroy (request);
+    blobvec_destroy (response);
+    return;
+error:
+    if (flux_respond_error (h, msg, errno, NULL) < 0)
+        flux_log_error (h, "error responding to store-batch request");
+    blobvec_destroy (request);
+    blobvec_destroy (response);
+}
+
 /* Handle a kvs-checkpoint.get request from the rank 0 kvs module.
  * The KVS stores its last root reference here for restart purposes.
  *
@@ -392,6 +515,8 @@ error:
 static const struct flux_msg_handler_spec htab[] = {
     { FLUX_MSGTYPE_REQUEST, "content-backing.load",    load_cb, 0 },
     { FLUX_MSGTYPE_REQUEST, "content-backing.store",   store_cb, 0 },
+    { FLUX_MSGTYPE_REQUEST, "content-backing.load-batch", load_batch_cb, 0 },
+    { FLUX_MSGTYPE_REQUEST, "content-backing.store-batch", store_batch_cb, 0 },
     { FLUX_MSGTYPE_REQUEST, "kvs-checkpoint.get", checkpoint_get_cb, 0 },
     { FLUX_MSGTYPE_REQUEST, "kvs-checkpoint.put", checkpoint_put_cb, 0 },
     { FLUX_MSGTYPE_REQUEST, "content-s3.config-reload", config_reload_cb, 0 },
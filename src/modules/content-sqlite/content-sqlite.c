@@ -13,28 +13,115 @@
 #if HAVE_CONFIG_H
 #include "config.h"
 #endif
+#include <limits.h>
 #include <sqlite3.h>
 #include <lz4.h>
+#include <lz4hc.h>
+#include <jansson.h>
 #include <flux/core.h>
 
 #include "src/common/libutil/blobref.h"
+#include "src/common/libutil/blobvec.h"
 #include "src/common/libutil/log.h"
 #include "src/common/libutil/errno_safe.h"
+#include "src/common/libutil/fsd.h"
+#include "src/common/libutil/monotime.h"
+#include "src/common/libutil/tstat.h"
 
 #include "src/common/libcontent/content-util.h"
+#include "src/common/libcontent/content-gc.h"
 
 const size_t lzo_buf_chunksize = 1024*1024;
 const size_t compression_threshold = 256; /* compress blobs >= this size */
 
+/* Blobs are compressed with one of the following codecs, selected with
+ * the codec=NAME module option.  The codec only affects how new blobs are
+ * encoded:  all LZ4 variants share a decoder, and a blob compressed with
+ * a dictionary records the dictionary id in the objects table.
+ *
+ * LZ4 has no dictionary trainer, so the "lz4-dict" codec uses a
+ * sample-prefix dictionary:  the first small blobs stored are concatenated
+ * until 'dict_size' bytes are collected, then the result is saved to the
+ * dict table and used for subsequent blobs of 'dict_compression_threshold'
+ * bytes or more.  Unlike a trained dictionary (e.g. zstd's
+ * ZDICT_trainFromBuffer()), no common substrings are selected, so it only
+ * helps blobs that repeat content of those early samples.
+ */
+enum codec_type {
+    CODEC_NONE,
+    CODEC_LZ4,
+    CODEC_LZ4HC,
+    CODEC_LZ4_DICT,
+};
+
+const int default_dict_size = 65536;    /* LZ4 window, also the maximum */
+const int dict_sample_max = 4096;       /* only sample blobs <= this size */
+const int dict_compression_threshold = 32;
+
+/* Compression stats are accumulated per uncompressed blob size class.
+ */
+static const struct {
+    const char *name;
+    int limit;                          /* size class holds blobs < limit */
+} size_class[] = {
+    { "<256",   256 },
+    { "<4K",    4096 },
+    { "<64K",   65536 },
+    { "<1M",    1048576 },
+    { ">=1M",   INT_MAX },
+};
+#define SIZE_CLASS_COUNT (sizeof (size_class) / sizeof (size_class[0]))
+
+struct codec_stats {
+    int stores;
+    int64_t raw_bytes;
+    int64_t stored_bytes;
+    double encode_ms;
+    int loads;
+    double decode_ms;
+};
+
+struct dictionary {
+    int id;
+    void *data;
+    int size;
+};
+
+/* In durable mode, the database uses a write-ahead log with synchronous=FULL
+ * so that each transaction commit is crash safe.  To amortize the cost of
+ * syncing, stores are grouped into one transaction until either
+ * 'group_size' stores are pending or the group has been open for
+ * 'group_timeout' seconds.  Store responses are deferred until the group
+ * is committed, so a content.flush that waits on outstanding stores also
+ * waits for the commit.
+ */
+const int default_group_size = 256;
+const double default_group_timeout = 0.001;
+
 const char *sql_create_table = "CREATE TABLE if not exists objects("
                                "  hash CHAR(20) PRIMARY KEY,"
                                "  size INT,"
-                               "  object BLOB"
+                               "  object BLOB,"
+                               "  dict INT DEFAULT 0"
                                ");";
-const char *sql_load = "SELECT object,size FROM objects"
+const char *sql_check_dict_column = "SELECT dict FROM objects LIMIT 0";
+const char *sql_add_dict_column = "ALTER TABLE objects"
+                                  "  ADD COLUMN dict INT DEFAULT 0";
+const char *sql_load = "SELECT object,size,dict FROM objects"
                        "  WHERE hash = ?1 LIMIT 1";
-const char *sql_store = "INSERT INTO objects (hash,size,object) "
-                        "  values (?1, ?2, ?3)";
+const char *sql_store = "INSERT INTO objects (hash,size,object,dict) "
+                        "  values (?1, ?2, ?3, ?4)";
+
+const char *sql_sweep = "SELECT hash,length(object) FROM objects"
+                        "  WHERE hash > ?1 ORDER BY hash LIMIT ?2";
+const char *sql_delete = "DELETE FROM objects WHERE hash = ?1";
+
+const char *sql_create_table_dict = "CREATE TABLE if not exists dict("
+                                    "  id INTEGER PRIMARY KEY,"
+                                    "  data BLOB"
+                                    ");";
+const char *sql_dict_get = "SELECT id,data FROM dict ORDER BY id";
+const char *sql_dict_put = "INSERT INTO dict (id,data) values (?1, ?2)";
 
 const char *sql_create_table_checkpt = "CREATE TABLE if not exists checkpt("
                                        "  key TEXT UNIQUE,"
@@ -45,6 +132,24 @@ const char *sql_checkpt_get = "SELECT value FROM checkpt"
 const char *sql_checkpt_put = "REPLACE INTO checkpt (key,value) "
                               "  values (?1, ?2)";
 
+/* Garbage collection iterates over the objects table in batches of keys,
+ * so that rows are never deleted while the select statement is active.
+ */
+const int sweep_batch_size = 256;
+
+struct sweep_entry {
+    uint8_t hash[BLOBREF_MAX_DIGEST_SIZE];
+    int hash_len;
+    int size;
+};
+
+struct group_pending {
+    const flux_msg_t *msg;
+    void *data;
+    int len;
+    struct group_pending *next;
+};
+
 struct content_sqlite {
     flux_msg_handler_t **handlers;
     char *dbfile;
@@ -53,10 +158,39 @@ struct content_sqlite {
     sqlite3_stmt *store_stmt;
     sqlite3_stmt *checkpt_get_stmt;
     sqlite3_stmt *checkpt_put_stmt;
+    sqlite3_stmt *dict_put_stmt;
+    sqlite3_stmt *delete_stmt;
     flux_t *h;
     const char *hashfun;
     size_t lzo_bufsize;
     void *lzo_buf;
+    enum codec_type codec;
+    int hc_level;
+    struct dictionary *dicts;       /* all dictionaries, for decoding */
+    int dict_count;
+    struct dictionary *cur_dict;    /* dictionary for encoding (or NULL) */
+    LZ4_stream_t *dict_stream;      /* cur_dict preloaded */
+    LZ4_stream_t *stream;
+    int dict_size;
+    void *sample_buf;               /* dictionary samples being collected */
+    int sample_len;
+    struct codec_stats stats[SIZE_CLASS_COUNT];
+    bool durable;
+    int group_size;
+    double group_timeout;
+    flux_watcher_t *group_timer;
+    bool in_transaction;
+    int group_count;                /* stores in current group */
+    struct timespec group_t0;
+    struct group_pending *pending;  /* deferred responses (FIFO) */
+    struct group_pending *pending_tail;
+    tstat_t group_stats;            /* stores per committed group */
+    tstat_t commit_stats;           /* commit latency (ms) */
+    struct content_gc *gc;
+    sqlite3_stmt *sweep_stmt;
+    struct sweep_entry *sweep;      /* current batch of keys */
+    int sweep_count;
+    int sweep_index;
 };
 
 static void log_sqlite_error (struct content_sqlite *ctx, const char *fmt, ...)
@@ -122,6 +256,207 @@ static int grow_lzo_buf (struct content_sqlite *ctx, size_t size)
     return 0;
 }
 
+static const char *codec_name (enum codec_type codec)
+{
+    switch (codec) {
+        case CODEC_NONE:
+            return "none";
+        case CODEC_LZ4:
+            return "lz4";
+        case CODEC_LZ4HC:
+            return "lz4hc";
+        case CODEC_LZ4_DICT:
+            return "lz4-dict";
+    }
+    return "unknown";
+}
+
+static struct codec_stats *codec_stats_get (struct content_sqlite *ctx,
+                                            int size)
+{
+    int i;
+
+    for (i = 0; i < SIZE_CLASS_COUNT - 1; i++) {
+        if (size < size_class[i].limit)
+            break;
+    }
+    return &ctx->stats[i];
+}
+
+static struct dictionary *dict_lookup (struct content_sqlite *ctx, int id)
+{
+    int i;
+
+    for (i = 0; i < ctx->dict_count; i++) {
+        if (ctx->dicts[i].id == id)
+            return &ctx->dicts[i];
+    }
+    return NULL;
+}
+
+/* Add dictionary to ctx->dicts.  Takes ownership of 'data' on success.
+ */
+static struct dictionary *dict_add (struct content_sqlite *ctx,
+                                    int id,
+                                    void *data,
+                                    int size)
+{
+    struct dictionary *dicts;
+    struct dictionary *d;
+
+    if (!(dicts = realloc (ctx->dicts, (ctx->dict_count + 1) * sizeof (*d))))
+        return NULL;
+    ctx->dicts = dicts;
+    d = &ctx->dicts[ctx->dict_count++];
+    d->id = id;
+    d->data = data;
+    d->size = size;
+    return d;
+}
+
+/* Make 'd' the dictionary used for encoding new blobs.
+ * ctx->dicts may be reallocated later, so preload the stream using
+ * d->data, which does not move.
+ */
+static void dict_activate (struct content_sqlite *ctx, struct dictionary *d)
+{
+    LZ4_loadDict (ctx->dict_stream, d->data, d->size);
+    ctx->cur_dict = d;
+}
+
+/* Save collected samples as a new (sample-prefix) dictionary and
+ * start using it.
+ */
+static int dict_save (struct content_sqlite *ctx)
+{
+    int id = ctx->dict_count > 0 ? ctx->dicts[ctx->dict_count - 1].id + 1 : 1;
+    struct dictionary *d;
+
+    if (sqlite3_bind_int (ctx->dict_put_stmt, 1, id) != SQLITE_OK
+        || sqlite3_bind_blob (ctx->dict_put_stmt,
+                              2,
+                              ctx->sample_buf,
+                              ctx->sample_len,
+                              SQLITE_STATIC) != SQLITE_OK) {
+        log_sqlite_error (ctx, "dict: binding");
+        set_errno_from_sqlite_error (ctx);
+        goto error;
+    }
+    if (sqlite3_step (ctx->dict_put_stmt) != SQLITE_DONE) {
+        log_sqlite_error (ctx, "dict: executing stmt");
+        set_errno_from_sqlite_error (ctx);
+        goto error;
+    }
+    sqlite3_reset (ctx->dict_put_stmt);
+    if (!(d = dict_add (ctx, id, ctx->sample_buf, ctx->sample_len)))
+        return -1;
+    ctx->sample_buf = NULL;
+    ctx->sample_len = 0;
+    /* cur_dict may have moved if ctx->dicts was reallocated.
+     */
+    dict_activate (ctx, d);
+    flux_log (ctx->h,
+              LOG_DEBUG,
+              "dict: saved sample dictionary %d (%d bytes)",
+              d->id,
+              d->size);
+    return 0;
+error:
+    ERRNO_SAFE_WRAP (sqlite3_reset, ctx->dict_put_stmt);
+    return -1;
+}
+
+/* Add a small blob to the dictionary samples, and save the dictionary
+ * once enough samples have been collected.
+ */
+static int dict_sample (struct content_sqlite *ctx, const void *data, int size)
+{
+    int len;
+
+    if (size == 0 || size > dict_sample_max)
+        return 0;
+    if (!ctx->sample_buf) {
+        if (!(ctx->sample_buf = malloc (ctx->dict_size)))
+            return -1;
+    }
+    len = ctx->dict_size - ctx->sample_len;
+    if (len > size)
+        len = size;
+    memcpy ((char *)ctx->sample_buf + ctx->sample_len, data, len);
+    ctx->sample_len += len;
+    if (ctx->sample_len == ctx->dict_size)
+        return dict_save (ctx);
+    return 0;
+}
+
+/* Compress 'data' into ctx->lzo_buf with the configured codec.
+ * Returns the compressed size, or 0 if the blob should be stored raw.
+ * The id of the dictionary used, if any, is stored in 'dict_id'.
+ */
+static int blob_encode (struct content_sqlite *ctx,
+                        const void *data,
+                        int size,
+                        int *dict_id)
+{
+    int out_len = LZ4_compressBound (size);
+    int r = 0;
+
+    *dict_id = 0;
+    if (ctx->codec == CODEC_LZ4_DICT && !ctx->cur_dict) {
+        if (dict_sample (ctx, data, size) < 0)
+            return -1;
+    }
+    if (ctx->codec == CODEC_NONE)
+        return 0;
+    if (ctx->codec == CODEC_LZ4_DICT && ctx->cur_dict) {
+        if (size < dict_compression_threshold)
+            return 0;
+    }
+    else if (size < compression_threshold)
+        return 0;
+    if (ctx->lzo_bufsize < out_len && grow_lzo_buf (ctx, out_len) < 0)
+        return -1;
+    switch (ctx->codec) {
+        case CODEC_LZ4_DICT:
+            if (ctx->cur_dict) {
+                memcpy (ctx->stream, ctx->dict_stream, sizeof (*ctx->stream));
+                r = LZ4_compress_fast_continue (ctx->stream,
+                                                data,
+                                                ctx->lzo_buf,
+                                                size,
+                                                out_len,
+                                                1);
+                *dict_id = ctx->cur_dict->id;
+                break;
+            }
+            // fallthrough
+        case CODEC_LZ4:
+            r = LZ4_compress_default (data, ctx->lzo_buf, size, out_len);
+            break;
+        case CODEC_LZ4HC:
+            r = LZ4_compress_HC (data,
+                                 ctx->lzo_buf,
+                                 size,
+                                 out_len,
+                                 ctx->hc_level);
+            break;
+        case CODEC_NONE:
+            break;
+    }
+    if (r == 0) {
+        errno = EINVAL;
+        return -1;
+    }
+    /* Incompressible blobs are stored raw.  Legacy lz4 behavior was to
+     * keep them compressed, so preserve that for the lz4 codec.
+     */
+    if (r >= size && ctx->codec != CODEC_LZ4) {
+        *dict_id = 0;
+        return 0;
+    }
+    return r;
+}
+
 /* Load blob from objects table, uncompressing if necessary.
  * Returns 0 on success, -1 on error with errno set.
  * On successful return, must call sqlite3_reset (ctx->load_stmt),
@@ -137,6 +472,9 @@ static int content_sqlite_load (struct content_sqlite *ctx,
     const void *data = NULL;
     int size = 0;
     int uncompressed_size;
+    int dict_id;
+    struct codec_stats *stats;
+    struct timespec t0;
 
     if ((hash_len = blobref_strtohash (blobref, hash, sizeof (hash))) < 0) {
         errno = ENOENT;
@@ -170,11 +508,28 @@ static int content_sqlite_load (struct content_sqlite *ctx,
         goto error;
     }
     uncompressed_size = sqlite3_column_int (ctx->load_stmt, 1);
+    dict_id = sqlite3_column_int (ctx->load_stmt, 2); // NULL -> 0
+    monotime (&t0);
     if (uncompressed_size != -1) {
+        struct dictionary *d = NULL;
+        int r;
         if (ctx->lzo_bufsize < uncompressed_size
                                 && grow_lzo_buf (ctx, uncompressed_size) < 0)
             goto error;
-        int r = LZ4_decompress_safe (data,
+        if (dict_id != 0 && !(d = dict_lookup (ctx, dict_id))) {
+            flux_log (ctx->h, LOG_ERR, "load: unknown dictionary %d", dict_id);
+            errno = EINVAL;
+            goto error;
+        }
+        if (d)
+            r = LZ4_decompress_safe_usingDict (data,
+                                               ctx->lzo_buf,
+                                               size,
+                                               uncompressed_size,
+                                               d->data,
+                                               d->size);
+        else
+            r = LZ4_decompress_safe (data,
                                      ctx->lzo_buf,
                                      size,
                                      uncompressed_size);
@@ -190,6 +545,9 @@ static int content_sqlite_load (struct content_sqlite *ctx,
         data = ctx->lzo_buf;
         size = uncompressed_size;
     }
+    stats = codec_stats_get (ctx, size);
+    stats->loads++;
+    stats->decode_ms += monotime_since (t0);
     *datap = data;
     *sizep = size;
     return 0;
@@ -211,6 +569,10 @@ static int content_sqlite_store (struct content_sqlite *ctx,
     uint8_t hash[BLOBREF_MAX_DIGEST_SIZE];
     int hash_len;
     int uncompressed_size = -1;
+    int dict_id;
+    struct codec_stats *stats = codec_stats_get (ctx, size);
+    struct timespec t0;
+    int r;
 
     if (blobref_hash (ctx->hashfun,
                       (uint8_t *)data,
@@ -220,20 +582,19 @@ static int content_sqlite_store (struct content_sqlite *ctx,
         return -1;
     if ((hash_len = blobref_strtohash (blobref, hash, sizeof (hash))) < 0)
         return -1;
-    if (size >= compression_threshold) {
-        int r;
-        int out_len = LZ4_compressBound(size);
-        if (ctx->lzo_bufsize < out_len && grow_lzo_buf (ctx, out_len) < 0)
-            return -1;
-        r = LZ4_compress_default (data, ctx->lzo_buf, size, out_len);
-        if (r == 0) {
-            errno = EINVAL;
-            return -1;
-        }
+    content_gc_note (ctx->gc, blobref);
+    stats->stores++;
+    stats->raw_bytes += size;
+    monotime (&t0);
+    if ((r = blob_encode (ctx, data, size, &dict_id)) < 0)
+        return -1;
+    stats->encode_ms += monotime_since (t0);
+    if (r > 0) {
         uncompressed_size = size;
         size = r;
         data = ctx->lzo_buf;
     }
+    stats->stored_bytes += size;
     if (sqlite3_bind_text (ctx->store_stmt,
                            1,
                            (char *)hash,
@@ -259,6 +620,11 @@ static int content_sqlite_store (struct content_sqlite *ctx,
         set_errno_from_sqlite_error (ctx);
         goto error;
     }
+    if (sqlite3_bind_int (ctx->store_stmt, 4, dict_id) != SQLITE_OK) {
+        log_sqlite_error (ctx, "store: binding dict");
+        set_errno_from_sqlite_error (ctx);
+        goto error;
+    }
     if (sqlite3_step (ctx->store_stmt) != SQLITE_DONE
                     && sqlite3_errcode (ctx->db) != SQLITE_CONSTRAINT) {
         log_sqlite_error (ctx, "store: executing stmt");
@@ -272,6 +638,112 @@ error:
     return -1;
 }
 
+/* Begin a group commit transaction if one is not already open.
+ */
+static int group_begin (struct content_sqlite *ctx)
+{
+    if (!ctx->in_transaction) {
+        if (sqlite3_exec (ctx->db, "BEGIN", NULL, NULL, NULL) != SQLITE_OK) {
+            log_sqlite_error (ctx, "group: begin transaction");
+            set_errno_from_sqlite_error (ctx);
+            return -1;
+        }
+        ctx->in_transaction = true;
+        ctx->group_count = 0;
+        monotime (&ctx->group_t0);
+        flux_timer_watcher_reset (ctx->group_timer, ctx->group_timeout, 0.);
+        flux_watcher_start (ctx->group_timer);
+    }
+    return 0;
+}
+
+/* Commit the open group, if any, and send deferred responses.
+ * If the commit fails, the deferred requests receive an error response.
+ */
+static int group_commit (struct content_sqlite *ctx)
+{
+    struct group_pending *gp;
+    int errnum = 0;
+
+    if (!ctx->in_transaction)
+        return 0;
+    flux_watcher_stop (ctx->group_timer);
+    ctx->in_transaction = false;
+    if (sqlite3_exec (ctx->db, "COMMIT", NULL, NULL, NULL) != SQLITE_OK) {
+        log_sqlite_error (ctx, "group: commit transaction");
+        set_errno_from_sqlite_error (ctx);
+        errnum = errno;
+    }
+    else {
+        tstat_push (&ctx->commit_stats, monotime_since (ctx->group_t0));
+        tstat_push (&ctx->group_stats, ctx->group_count);
+    }
+    while ((gp = ctx->pending)) {
+        ctx->pending = gp->next;
+        if (errnum == 0) {
+            if (flux_respond_raw (ctx->h, gp->msg, gp->data, gp->len) < 0)
+                flux_log_error (ctx->h, "group: flux_respond_raw");
+        }
+        else {
+            if (flux_respond_error (ctx->h, gp->msg, errnum, NULL) < 0)
+                flux_log_error (ctx->h, "group: flux_respond_error");
+        }
+        flux_msg_decref (gp->msg);
+        free (gp->data);
+        free (gp);
+    }
+    ctx->pending_tail = NULL;
+    if (errnum != 0) {
+        errno = errnum;
+        return -1;
+    }
+    return 0;
+}
+
+/* Defer a response to 'msg' with payload 'data' until the open group is
+ * committed.  'count' is the number of stores the request contributed to
+ * the group.  The group is committed if it has reached its size limit.
+ */
+static int group_defer (struct content_sqlite *ctx,
+                        const flux_msg_t *msg,
+                        const void *data,
+                        int len,
+                        int count)
+{
+    struct group_pending *gp;
+
+    if (!(gp = calloc (1, sizeof (*gp))))
+        return -1;
+    if (len > 0) {
+        if (!(gp->data = malloc (len))) {
+            free (gp);
+            return -1;
+        }
+        memcpy (gp->data, data, len);
+    }
+    gp->len = len;
+    gp->msg = flux_msg_incref (msg);
+    if (ctx->pending_tail)
+        ctx->pending_tail->next = gp;
+    else
+        ctx->pending = gp;
+    ctx->pending_tail = gp;
+    ctx->group_count += count;
+    if (ctx->group_count >= ctx->group_size)
+        (void)group_commit (ctx); // errors are returned to requestors
+    return 0;
+}
+
+static void group_timer_cb (flux_reactor_t *r,
+                            flux_watcher_t *w,
+                            int revents,
+                            void *arg)
+{
+    struct content_sqlite *ctx = arg;
+
+    (void)group_commit (ctx);
+}
+
 static void load_cb (flux_t *h,
                      flux_msg_handler_t *mh,
                      const flux_msg_t *msg,
@@ -297,6 +769,7 @@ static void load_cb (flux_t *h,
     }
     if (content_sqlite_load (ctx, blobref, &data, &size) < 0)
         goto error;
+    content_gc_note (ctx->gc, blobref);
     if (flux_respond_raw (h, msg, data, size) < 0)
         flux_log_error (h, "load: flux_respond_raw");
     (void )sqlite3_reset (ctx->load_stmt);
@@ -320,8 +793,15 @@ void store_cb (flux_t *h,
         flux_log_error (h, "store: request decode failed");
         goto error;
     }
+    if (ctx->durable && group_begin (ctx) < 0)
+        goto error;
     if (content_sqlite_store (ctx, data, size, blobref, sizeof (blobref)) < 0)
         goto error;
+    if (ctx->durable) {
+        if (group_defer (ctx, msg, blobref, strlen (blobref) + 1, 1) < 0)
+            goto error;
+        return;
+    }
     if (flux_respond_raw (h, msg, blobref, strlen (blobref) + 1) < 0)
         flux_log_error (h, "store: flux_respond_raw");
     return;
@@ -330,6 +810,155 @@ error:
         flux_log_error (h, "store: flux_respond_error");
 }
 
+/* Handle a batch of loads in one request.  The raw request payload is a
+ * blobvec of blobrefs.  The raw response payload is a blobvec of blobs in
+ * the same order, with per-blob errors.
+ */
+static void load_batch_cb (flux_t *h,
+                           flux_msg_handler_t *mh,
+                           const flux_msg_t *msg,
+                           void *arg)
+{
+    struct content_sqlite *ctx = arg;
+    const void *buf;
+    int len;
+    struct blobvec *request = NULL;
+    struct blobvec *response = NULL;
+    int i;
+
+    if (flux_request_decode_raw (msg, NULL, &buf, &len) < 0) {
+        flux_log_error (h, "load-batch: request decode failed");
+        goto error;
+    }
+    if (!(request = blobvec_decode (buf, len))
+        || !(response = blobvec_create ()))
+        goto error;
+    for (i = 0; i < blobvec_count (request); i++) {
+        const char *blobref;
+        int blobref_size;
+        const void *data;
+        int size;
+        int rc;
+
+        if (blobvec_get (request,
+                         i,
+                         NULL,
+                         (const void **)&blobref,
+                         &blobref_size) < 0)
+            goto error;
+        if (!blobref || blobref[blobref_size - 1] != '\0') {
+            errno = EPROTO;
+            flux_log_error (h, "load-batch: malformed blobref");
+            goto error;
+        }
+        if (content_sqlite_load (ctx, blobref, &data, &size) < 0)
+            rc = blobvec_append (response, errno, NULL, 0);
+        else {
+            content_gc_note (ctx->gc, blobref);
+            rc = blobvec_append (response, 0, data, size);
+            (void )sqlite3_reset (ctx->load_stmt);
+        }
+        if (rc < 0)
+            goto error;
+    }
+    if (blobvec_encode (response, &buf, &len) < 0)
+        goto error;
+    if (flux_respond_raw (h, msg, buf, len) < 0)
+        flux_log_error (h, "load-batch: flux_respond_raw");
+    blobvec_destroy (request);
+    blobvec_destroy (response);
+    return;
+error:
+    if (flux_respond_error (h, msg, errno, NULL) < 0)
+        flux_log_error (h, "load-batch: flux_respond_error");
+    blobvec_destroy (request);
+    blobvec_destroy (response);
+}
+
+/* Handle a batch of stores in one request.  The raw request payload is a
+ * blobvec of blobs.  The raw response payload is a blobvec of blobrefs in
+ * the same order, with per-blob errors.  The inserts are performed in a
+ * single transaction, or in durable mode, added to the open group.
+ */
+static void store_batch_cb (flux_t *h,
+                            flux_msg_handler_t *mh,
+                            const flux_msg_t *msg,
+                            void *arg)
+{
+    struct content_sqlite *ctx = arg;
+    const void *buf;
+    int len;
+    struct blobvec *request = NULL;
+    struct blobvec *response = NULL;
+    bool in_transaction = false;
+    int i;
+
+    if (flux_request_decode_raw (msg, NULL, &buf, &len) < 0) {
+        flux_log_error (h, "store-batch: request decode failed");
+        goto error;
+    }
+    if (!(request = blobvec_decode (buf, len))
+        || !(response = blobvec_create ()))
+        goto error;
+    if (ctx->durable) {
+        if (group_begin (ctx) < 0)
+            goto error;
+    }
+    else {
+        if (sqlite3_exec (ctx->db, "BEGIN", NULL, NULL, NULL) != SQLITE_OK) {
+            log_sqlite_error (ctx, "store-batch: begin transaction");
+            set_errno_from_sqlite_error (ctx);
+            goto error;
+        }
+        in_transaction = true;
+    }
+    for (i = 0; i < blobvec_count (request); i++) {
+        char blobref[BLOBREF_MAX_STRING_SIZE];
+        const void *data;
+        int size;
+        int rc;
+
+        if (blobvec_get (request, i, NULL, &data, &size) < 0)
+            goto error;
+        if (content_sqlite_store (ctx,
+                                  data,
+                                  size,
+                                  blobref,
+                                  sizeof (blobref)) < 0)
+            rc = blobvec_append (response, errno, NULL, 0);
+        else
+            rc = blobvec_append (response, 0, blobref, strlen (blobref) + 1);
+        if (rc < 0)
+            goto error;
+    }
+    if (in_transaction) {
+        in_transaction = false;
+        if (sqlite3_exec (ctx->db, "COMMIT", NULL, NULL, NULL) != SQLITE_OK) {
+            log_sqlite_error (ctx, "store-batch: commit transaction");
+            set_errno_from_sqlite_error (ctx);
+            goto error;
+        }
+    }
+    if (blobvec_encode (response, &buf, &len) < 0)
+        goto error;
+    if (ctx->durable) {
+        if (group_defer (ctx, msg, buf, len, blobvec_count (request)) < 0)
+            goto error;
+    }
+    else if (flux_respond_raw (h, msg, buf, len) < 0)
+        flux_log_error (h, "store-batch: flux_respond_raw");
+    blobvec_destroy (request);
+    blobvec_destroy (response);
+    return;
+error:
+    if (in_transaction)
+        ERRNO_SAFE_WRAP (sqlite3_exec, ctx->db, "ROLLBACK", NULL, NULL, NULL);
+    if (flux_respond_error (h, msg, errno, NULL) < 0)
+        flux_log_error (h, "store-batch: flux_respond_error");
+    blobvec_destroy (request);
+    blobvec_destroy (response);
+}
+
 void checkpoint_get_cb (flux_t *h,
                         flux_msg_handler_t *mh,
                         const flux_msg_t *msg,
@@ -388,6 +1017,11 @@ void checkpoint_put_cb (flux_t *h,
         errno = EINVAL;
         goto error;
     }
+    /* The checkpoint may refer to blobs in the open group,
+     * so commit them first.
+     */
+    if (group_commit (ctx) < 0)
+        goto error;
     if (sqlite3_bind_text (ctx->checkpt_put_stmt,
                            1,
                            (char *)key,
@@ -422,10 +1056,290 @@ error:
     (void )sqlite3_reset (ctx->checkpt_put_stmt);
 }
 
+static int gc_load (void *arg, const char *blobref, void **datap, int *sizep)
+{
+    struct content_sqlite *ctx = arg;
+    const void *data;
+    int size;
+    void *cpy = NULL;
+
+    if (content_sqlite_load (ctx, blobref, &data, &size) < 0)
+        return -1;
+    if (size > 0 && !(cpy = malloc (size))) {
+        ERRNO_SAFE_WRAP (sqlite3_reset, ctx->load_stmt);
+        return -1;
+    }
+    if (size > 0)
+        memcpy (cpy, data, size);
+    (void )sqlite3_reset (ctx->load_stmt);
+    *datap = cpy;
+    *sizep = size;
+    return 0;
+}
+
+static int gc_sweep_begin (void *arg)
+{
+    struct content_sqlite *ctx = arg;
+
+    if (!(ctx->sweep = calloc (sweep_batch_size, sizeof (ctx->sweep[0]))))
+        return -1;
+    if (sqlite3_prepare_v2 (ctx->db,
+                            sql_sweep,
+                            -1,
+                            &ctx->sweep_stmt,
+                            NULL) != SQLITE_OK) {
+        log_sqlite_error (ctx, "preparing sweep stmt");
+        set_errno_from_sqlite_error (ctx);
+        return -1;
+    }
+    ctx->sweep_count = 0;
+    ctx->sweep_index = 0;
+    return 0;
+}
+
+/* Fetch the next batch of keys following the last key of the
+ * previous batch.
+ */
+static int gc_sweep_fill (struct content_sqlite *ctx)
+{
+    struct sweep_entry last = { .hash_len = 0 };
+    int rc;
+
+    if (ctx->sweep_count > 0)
+        last = ctx->sweep[ctx->sweep_count - 1];
+    ctx->sweep_count = 0;
+    ctx->sweep_index = 0;
+    if (sqlite3_bind_text (ctx->sweep_stmt,
+                           1,
+                           (char *)last.hash,
+                           last.hash_len,
+                           SQLITE_TRANSIENT) != SQLITE_OK
+        || sqlite3_bind_int (ctx->sweep_stmt,
+                             2,
+                             sweep_batch_size) != SQLITE_OK) {
+        log_sqlite_error (ctx, "sweep: binding");
+        goto error;
+    }
+    while ((rc = sqlite3_step (ctx->sweep_stmt)) == SQLITE_ROW) {
+        struct sweep_entry *entry = &ctx->sweep[ctx->sweep_count];
+        int len = sqlite3_column_bytes (ctx->sweep_stmt, 0);
+
+        if (len > sizeof (entry->hash))
+            continue;
+        memcpy (entry->hash, sqlite3_column_text (ctx->sweep_stmt, 0), len);
+        entry->hash_len = len;
+        entry->size = sqlite3_column_int (ctx->sweep_stmt, 1);
+        ctx->sweep_count++;
+    }
+    if (rc != SQLITE_DONE) {
+        log_sqlite_error (ctx, "sweep: executing stmt");
+        goto error;
+    }
+    sqlite3_reset (ctx->sweep_stmt);
+    return 0;
+error:
+    set_errno_from_sqlite_error (ctx);
+    ERRNO_SAFE_WRAP (sqlite3_reset, ctx->sweep_stmt);
+    return -1;
+}
+
+static int gc_sweep_next (void *arg, char *blobref, int blobrefsz, int *size)
+{
+    struct content_sqlite *ctx = arg;
+    struct sweep_entry *entry;
+
+    if (ctx->sweep_index == ctx->sweep_count) {
+        /* A short batch is the last one.
+         */
+        if (ctx->sweep_index > 0 && ctx->sweep_count < sweep_batch_size)
+            return 0;
+        if (gc_sweep_fill (ctx) < 0)
+            return -1;
+        if (ctx->sweep_count == 0)
+            return 0;
+    }
+    entry = &ctx->sweep[ctx->sweep_index++];
+    if (blobref_hashtostr (ctx->hashfun,
+                           entry->hash,
+                           entry->hash_len,
+                           blobref,
+                           blobrefsz) < 0)
+        return -1;
+    *size = entry->size;
+    return 1;
+}
+
+static void gc_sweep_end (void *arg)
+{
+    struct content_sqlite *ctx = arg;
+
+    sqlite3_finalize (ctx->sweep_stmt);
+    ctx->sweep_stmt = NULL;
+    free (ctx->sweep);
+    ctx->sweep = NULL;
+}
+
+/* In durable mode, deletes are added to the group commit,
+ * since committing each one would be slow.
+ */
+static int gc_remove (void *arg, const char *blobref)
+{
+    struct content_sqlite *ctx = arg;
+    uint8_t hash[BLOBREF_MAX_DIGEST_SIZE];
+    int hash_len;
+
+    if ((hash_len = blobref_strtohash (blobref, hash, sizeof (hash))) < 0)
+        return -1;
+    if (ctx->durable && group_begin (ctx) < 0)
+        return -1;
+    if (sqlite3_bind_text (ctx->delete_stmt,
+                           1,
+                           (char *)hash,
+                           hash_len,
+                           SQLITE_STATIC) != SQLITE_OK) {
+        log_sqlite_error (ctx, "delete: binding key");
+        goto error;
+    }
+    if (sqlite3_step (ctx->delete_stmt) != SQLITE_DONE) {
+        log_sqlite_error (ctx, "delete: executing stmt");
+        goto error;
+    }
+    sqlite3_reset (ctx->delete_stmt);
+    if (ctx->durable && ++ctx->group_count >= ctx->group_size) {
+        if (group_commit (ctx) < 0)
+            return -1;
+    }
+    return 0;
+error:
+    set_errno_from_sqlite_error (ctx);
+    ERRNO_SAFE_WRAP (sqlite3_reset, ctx->delete_stmt);
+    return -1;
+}
+
+static int gc_compact (void *arg)
+{
+    struct content_sqlite *ctx = arg;
+
+    if (group_commit (ctx) < 0)
+        return -1;
+    if (sqlite3_exec (ctx->db, "VACUUM", NULL, NULL, NULL) != SQLITE_OK) {
+        log_sqlite_error (ctx, "vacuum");
+        set_errno_from_sqlite_error (ctx);
+        return -1;
+    }
+    return 0;
+}
+
+static const struct content_gc_ops gc_ops = {
+    .load = gc_load,
+    .sweep_begin = gc_sweep_begin,
+    .sweep_next = gc_sweep_next,
+    .sweep_end = gc_sweep_end,
+    .remove = gc_remove,
+    .compact = gc_compact,
+};
+
+static void gc_cb (flux_t *h,
+                   flux_msg_handler_t *mh,
+                   const flux_msg_t *msg,
+                   void *arg)
+{
+    struct content_sqlite *ctx = arg;
+
+    content_gc_request (ctx->gc, msg);
+}
+
+static json_t *tstat_tojson (tstat_t *ts)
+{
+    return json_pack ("{s:i s:f s:f s:f s:f}",
+                      "count", tstat_count (ts),
+                      "min", tstat_min (ts),
+                      "mean", tstat_mean (ts),
+                      "stddev", tstat_stddev (ts),
+                      "max", tstat_max (ts));
+}
+
+static json_t *codec_stats_tojson (struct content_sqlite *ctx)
+{
+    json_t *a;
+    json_t *o;
+    int i;
+
+    if (!(a = json_array ()))
+        return NULL;
+    for (i = 0; i < SIZE_CLASS_COUNT; i++) {
+        struct codec_stats *stats = &ctx->stats[i];
+        if (!(o = json_pack ("{s:s s:i s:I s:I s:f s:i s:f}",
+                             "size", size_class[i].name,
+                             "stores", stats->stores,
+                             "raw-bytes", (json_int_t)stats->raw_bytes,
+                             "stored-bytes", (json_int_t)stats->stored_bytes,
+                             "encode-ms", stats->encode_ms,
+                             "loads", stats->loads,
+                             "decode-ms", stats->decode_ms))
+            || json_array_append_new (a, o) < 0) {
+            json_decref (o);
+            json_decref (a);
+            return NULL;
+        }
+    }
+    return a;
+}
+
+static void stats_get_cb (flux_t *h,
+                          flux_msg_handler_t *mh,
+                          const flux_msg_t *msg,
+                          void *arg)
+{
+    struct content_sqlite *ctx = arg;
+    json_t *group = NULL;
+    json_t *commit = NULL;
+    json_t *compression = NULL;
+    json_t *gc = NULL;
+
+    if (!(group = tstat_tojson (&ctx->group_stats))
+        || !(commit = tstat_tojson (&ctx->commit_stats))
+        || !(compression = codec_stats_tojson (ctx))
+        || !(gc = content_gc_stats (ctx->gc))) {
+        errno = ENOMEM;
+        goto error;
+    }
+    if (flux_respond_pack (h,
+                           msg,
+                           "{s:b s:i s:f s:i s:O s:O s:s s:i s:i s:O s:O}",
+                           "durable", ctx->durable,
+                           "group-size-limit", ctx->group_size,
+                           "group-timeout", ctx->group_timeout,
+                           "group-pending", ctx->group_count,
+                           "group-size", group,
+                           "commit-latency-ms", commit,
+                           "codec", codec_name (ctx->codec),
+                           "dictionaries", ctx->dict_count,
+                           "dictionary-size",
+                           ctx->cur_dict ? ctx->cur_dict->size : 0,
+                           "compression", compression,
+                           "gc", gc) < 0)
+        flux_log_error (h, "error responding to stats-get request");
+    json_decref (group);
+    json_decref (commit);
+    json_decref (compression);
+    json_decref (gc);
+    return;
+error:
+    if (flux_respond_error (h, msg, errno, NULL) < 0)
+        flux_log_error (h, "error responding to stats-get request");
+    json_decref (group);
+    json_decref (commit);
+    json_decref (compression);
+    json_decref (gc);
+}
+
 static void content_sqlite_closedb (struct content_sqlite *ctx)
 {
     if (ctx) {
         int saved_errno = errno;
+        content_gc_destroy (ctx->gc); // may finalize sweep_stmt
+        ctx->gc = NULL;
         if (ctx->store_stmt) {
             if (sqlite3_finalize (ctx->store_stmt) != SQLITE_OK)
                 log_sqlite_error (ctx, "sqlite_finalize store_stmt");
@@ -442,6 +1356,14 @@ static void content_sqlite_closedb (struct content_sqlite *ctx)
             if (sqlite3_finalize (ctx->checkpt_put_stmt) != SQLITE_OK)
                 log_sqlite_error (ctx, "sqlite_finalize checkpt_put_stmt");
         }
+        if (ctx->dict_put_stmt) {
+            if (sqlite3_finalize (ctx->dict_put_stmt) != SQLITE_OK)
+                log_sqlite_error (ctx, "sqlite_finalize dict_put_stmt");
+        }
+        if (ctx->delete_stmt) {
+            if (sqlite3_finalize (ctx->delete_stmt) != SQLITE_OK)
+                log_sqlite_error (ctx, "sqlite_finalize delete_stmt");
+        }
         if (ctx->db) {
             if (sqlite3_close (ctx->db) != SQLITE_OK)
                 log_sqlite_error (ctx, "sqlite3_close");
@@ -450,6 +1372,79 @@ static void content_sqlite_closedb (struct content_sqlite *ctx)
     }
 }
 
+/* Databases created before codec support lack the objects.dict column.
+ */
+static int content_sqlite_upgrade (struct content_sqlite *ctx)
+{
+    sqlite3_stmt *stmt;
+
+    if (sqlite3_prepare_v2 (ctx->db,
+                            sql_check_dict_column,
+                            -1,
+                            &stmt,
+                            NULL) == SQLITE_OK) {
+        sqlite3_finalize (stmt);
+        return 0;
+    }
+    if (sqlite3_exec (ctx->db,
+                      sql_add_dict_column,
+                      NULL,
+                      NULL,
+                      NULL) != SQLITE_OK) {
+        log_sqlite_error (ctx, "adding dict column to object table");
+        return -1;
+    }
+    return 0;
+}
+
+/* Load all dictionaries, since any of them may be needed to decode blobs.
+ * The most recent one is used to encode new blobs.
+ */
+static int content_sqlite_load_dicts (struct content_sqlite *ctx)
+{
+    sqlite3_stmt *stmt;
+    int rc;
+
+    if (sqlite3_prepare_v2 (ctx->db,
+                            sql_dict_get,
+                            -1,
+                            &stmt,
+                            NULL) != SQLITE_OK) {
+        log_sqlite_error (ctx, "preparing dict_get stmt");
+        return -1;
+    }
+    while ((rc = sqlite3_step (stmt)) == SQLITE_ROW) {
+        int id = sqlite3_column_int (stmt, 0);
+        int size = sqlite3_column_bytes (stmt, 1);
+        const void *data = sqlite3_column_blob (stmt, 1);
+        void *cpy;
+
+        if (size == 0)
+            continue;
+        if (!(cpy = malloc (size)))
+            goto nomem;
+        memcpy (cpy, data, size);
+        if (!dict_add (ctx, id, cpy, size)) {
+            free (cpy);
+            goto nomem;
+        }
+    }
+    if (rc != SQLITE_DONE) {
+        log_sqlite_error (ctx, "loading dictionaries");
+        sqlite3_finalize (stmt);
+        return -1;
+    }
+    sqlite3_finalize (stmt);
+    if (ctx->codec == CODEC_LZ4_DICT && ctx->dict_count > 0)
+        dict_activate (ctx, &ctx->dicts[ctx->dict_count - 1]);
+    return 0;
+nomem:
+    sqlite3_finalize (stmt);
+    flux_log (ctx->h, LOG_ERR, "out of memory loading dictionaries");
+    return -1;
+}
+
+
 /* Open the database file ctx->dbfile and set up the database.
  */
 static int content_sqlite_opendb (struct content_sqlite *ctx)
@@ -461,7 +1456,8 @@ static int content_sqlite_opendb (struct content_sqlite *ctx)
         goto error;
     }
     if (sqlite3_exec (ctx->db,
-                      "PRAGMA journal_mode=OFF",
+                      ctx->durable ? "PRAGMA journal_mode=WAL"
+                                   : "PRAGMA journal_mode=OFF",
                       NULL,
                       NULL,
                       NULL) != SQLITE_OK) {
@@ -469,7 +1465,8 @@ static int content_sqlite_opendb (struct content_sqlite *ctx)
         goto error;
     }
     if (sqlite3_exec (ctx->db,
-                      "PRAGMA synchronous=OFF",
+                      ctx->durable ? "PRAGMA synchronous=FULL"
+                                   : "PRAGMA synchronous=OFF",
                       NULL,
                       NULL,
                       NULL) != SQLITE_OK) {
@@ -492,6 +1489,18 @@ static int content_sqlite_opendb (struct content_sqlite *ctx)
         log_sqlite_error (ctx, "creating object table");
         goto error;
     }
+    if (content_sqlite_upgrade (ctx) < 0)
+        goto error;
+    if (sqlite3_exec (ctx->db,
+                      sql_create_table_dict,
+                      NULL,
+                      NULL,
+                      NULL) != SQLITE_OK) {
+        log_sqlite_error (ctx, "creating dict table");
+        goto error;
+    }
+    if (content_sqlite_load_dicts (ctx) < 0)
+        goto error;
     if (sqlite3_exec (ctx->db,
                       sql_create_table_checkpt,
                       NULL,
@@ -532,6 +1541,22 @@ static int content_sqlite_opendb (struct content_sqlite *ctx)
         log_sqlite_error (ctx, "preparing checkpt_put stmt");
         goto error;
     }
+    if (sqlite3_prepare_v2 (ctx->db,
+                            sql_dict_put,
+                            -1,
+                            &ctx->dict_put_stmt,
+                            NULL) != SQLITE_OK) {
+        log_sqlite_error (ctx, "preparing dict_put stmt");
+        goto error;
+    }
+    if (sqlite3_prepare_v2 (ctx->db,
+                            sql_delete,
+                            -1,
+                            &ctx->delete_stmt,
+                            NULL) != SQLITE_OK) {
+        log_sqlite_error (ctx, "preparing delete stmt");
+        goto error;
+    }
     return 0;
 error:
     set_errno_from_sqlite_error (ctx);
@@ -542,9 +1567,20 @@ static void content_sqlite_destroy (struct content_sqlite *ctx)
 {
     if (ctx) {
         int saved_errno = errno;
+        int i;
         flux_msg_handler_delvec (ctx->handlers);
+        content_gc_destroy (ctx->gc);
+        flux_watcher_destroy (ctx->group_timer);
         free (ctx->dbfile);
         free (ctx->lzo_buf);
+        for (i = 0; i < ctx->dict_count; i++)
+            free (ctx->dicts[i].data);
+        free (ctx->dicts);
+        if (ctx->dict_stream)
+            LZ4_freeStream (ctx->dict_stream);
+        if (ctx->stream)
+            LZ4_freeStream (ctx->stream);
+        free (ctx->sample_buf);
         free (ctx);
         errno = saved_errno;
     }
@@ -553,12 +1589,101 @@ static void content_sqlite_destroy (struct content_sqlite *ctx)
 static const struct flux_msg_handler_spec htab[] = {
     { FLUX_MSGTYPE_REQUEST, "content-backing.load",    load_cb, 0 },
     { FLUX_MSGTYPE_REQUEST, "content-backing.store",   store_cb, 0 },
+    { FLUX_MSGTYPE_REQUEST, "content-backing.load-batch", load_batch_cb, 0 },
+    { FLUX_MSGTYPE_REQUEST, "content-backing.store-batch", store_batch_cb, 0 },
     { FLUX_MSGTYPE_REQUEST, "kvs-checkpoint.get", checkpoint_get_cb, 0 },
     { FLUX_MSGTYPE_REQUEST, "kvs-checkpoint.put", checkpoint_put_cb, 0 },
+    { FLUX_MSGTYPE_REQUEST, "content-sqlite.stats.get", stats_get_cb, 0 },
+    { FLUX_MSGTYPE_REQUEST, "content-sqlite.gc", gc_cb, 0 },
     FLUX_MSGHANDLER_TABLE_END,
 };
 
-static struct content_sqlite *content_sqlite_create (flux_t *h)
+/* Parse codec NAME, where lz4hc optionally takes a level, e.g. lz4hc:12.
+ */
+static int parse_codec (struct content_sqlite *ctx, const char *name)
+{
+    char *endptr;
+
+    if (!strcmp (name, "none"))
+        ctx->codec = CODEC_NONE;
+    else if (!strcmp (name, "lz4"))
+        ctx->codec = CODEC_LZ4;
+    else if (!strcmp (name, "lz4-dict"))
+        ctx->codec = CODEC_LZ4_DICT;
+    else if (!strcmp (name, "lz4hc")) {
+        ctx->codec = CODEC_LZ4HC;
+        ctx->hc_level = LZ4HC_CLEVEL_DEFAULT;
+    }
+    else if (!strncmp (name, "lz4hc:", 6)) {
+        ctx->codec = CODEC_LZ4HC;
+        errno = 0;
+        ctx->hc_level = strtol (name + 6, &endptr, 10);
+        if (errno != 0
+            || *endptr != '\0'
+            || ctx->hc_level < 1
+            || ctx->hc_level > LZ4HC_CLEVEL_MAX)
+            return -1;
+    }
+    else
+        return -1;
+    return 0;
+}
+
+static int parse_args (struct content_sqlite *ctx, int argc, char **argv)
+{
+    int i;
+    char *endptr;
+
+    for (i = 0; i < argc; i++) {
+        if (!strcmp (argv[i], "durable"))
+            ctx->durable = true;
+        else if (!strncmp (argv[i], "group-size=", 11)) {
+            errno = 0;
+            ctx->group_size = strtol (argv[i] + 11, &endptr, 10);
+            if (errno != 0 || *endptr != '\0' || ctx->group_size < 1) {
+                flux_log (ctx->h, LOG_ERR, "invalid %s", argv[i]);
+                errno = EINVAL;
+                return -1;
+            }
+        }
+        else if (!strncmp (argv[i], "codec=", 6)) {
+            if (parse_codec (ctx, argv[i] + 6) < 0) {
+                flux_log (ctx->h, LOG_ERR, "invalid %s", argv[i]);
+                errno = EINVAL;
+                return -1;
+            }
+        }
+        else if (!strncmp (argv[i], "dict-size=", 10)) {
+            errno = 0;
+            ctx->dict_size = strtol (argv[i] + 10, &endptr, 10);
+            if (errno != 0
+                || *endptr != '\0'
+                || ctx->dict_size < 1
+                || ctx->dict_size > default_dict_size) {
+                flux_log (ctx->h, LOG_ERR, "invalid %s", argv[i]);
+                errno = EINVAL;
+                return -1;
+            }
+        }
+        else if (!strncmp (argv[i], "group-timeout=", 14)) {
+            if (fsd_parse_duration (argv[i] + 14, &ctx->group_timeout) < 0) {
+                flux_log (ctx->h, LOG_ERR, "invalid %s", argv[i]);
+                errno = EINVAL;
+                return -1;
+            }
+        }
+        else {
+            flux_log (ctx->h, LOG_ERR, "unknown option: %s", argv[i]);
+            errno = EINVAL;
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static struct content_sqlite *content_sqlite_create (flux_t *h,
+                                                     int argc,
+                                                     char **argv)
 {
     struct content_sqlite *ctx;
     const char *backing_path;
@@ -569,6 +1694,23 @@ static struct content_sqlite *content_sqlite_create (flux_t *h)
         goto error;
     ctx->lzo_bufsize = lzo_buf_chunksize;
     ctx->h = h;
+    ctx->group_size = default_group_size;
+    ctx->group_timeout = default_group_timeout;
+    ctx->codec = CODEC_LZ4;
+    ctx->dict_size = default_dict_size;
+    if (parse_args (ctx, argc, argv) < 0)
+        goto error;
+    if (!(ctx->dict_stream = LZ4_createStream ())
+        || !(ctx->stream = LZ4_createStream ())) {
+        errno = ENOMEM;
+        goto error;
+    }
+    if (!(ctx->group_timer = flux_timer_watcher_create (flux_get_reactor (h),
+                                                        ctx->group_timeout,
+                                                        0.,
+                                                        group_timer_cb,
+                                                        ctx)))
+        goto error;
 
     /* Some tunables:
      * - the hash function, e.g. sha1, sha256
@@ -604,6 +1746,8 @@ static struct content_sqlite *content_sqlite_create (flux_t *h)
         if (flux_attr_set (h, "content.backing-path", ctx->dbfile) < 0)
             goto error;
     }
+    if (!(ctx->gc = content_gc_create (h, &gc_ops, ctx)))
+        goto error;
     if (flux_msg_handler_addvec (h, htab, ctx, &ctx->handlers) < 0)
         goto error;
     return ctx;
@@ -616,7 +1760,7 @@ int mod_main (flux_t *h, int argc, char **argv)
 {
     struct content_sqlite *ctx;
 
-    if (!(ctx = content_sqlite_create (h))) {
+    if (!(ctx = content_sqlite_create (h, argc, argv))) {
         flux_log_error (h, "content_sqlite_create failed");
         return -1;
     }
@@ -632,6 +1776,8 @@ int mod_main (flux_t *h, int argc, char **argv)
         flux_log_error (h, "flux_reactor_run");
         goto done;
     }
+    if (group_commit (ctx) < 0)
+        flux_log_error (h, "error committing final group");
     if (content_unregister_backing_store (h) < 0)
         goto done;
 done:
@@ -34,6 +34,7 @@ struct bulk_exec {
     struct aux_item *aux;
 
     int max_start_per_loop;  /* Max subprocess started per event loop cb */
+    int tree_launch;         /* Start multi-rank commands with rexec.tree */
     int total;               /* Total processes expected to run */
     int started;             /* Number of processes that have reached start */
     int complete;            /* Number of processes that have completed */
@@ -271,12 +272,66 @@ static int subprocess_destroy (flux_t *h, flux_subprocess_t *p)
     return 0;
 }
 
+static int exec_add_process (struct bulk_exec *exec, flux_subprocess_t *p)
+{
+    if (flux_subprocess_aux_set (p, "job-exec::exec", exec, NULL) < 0
+       || zlist_append (exec->processes, p) < 0) {
+        if (subprocess_destroy (exec->h, p) < 0)
+            flux_log_error (exec->h, "Unable to destroy pid %ju",
+                    (uintmax_t) flux_subprocess_pid (p));
+        return -1;
+    }
+    zlist_freefn (exec->processes, p,
+                 (zlist_free_fn *) flux_subprocess_unref,
+                 true);
+    return 0;
+}
+
+/*  Start all ranks of cmd with one request that fans out over the TBON,
+ *   instead of one flux_rexec(3) RPC per rank from this rank.
+ */
+static int exec_start_cmd_tree (struct bulk_exec *exec, struct exec_cmd *cmd)
+{
+    int count = idset_count (cmd->ranks);
+    flux_subprocess_t **procs;
+    int rc = -1;
+    int i;
+
+    if (!(procs = calloc (count, sizeof (procs[0]))))
+        return -1;
+    if (flux_rexec_tree (exec->h,
+                         cmd->ranks,
+                         cmd->flags,
+                         cmd->cmd,
+                         &exec->ops,
+                         procs) < 0)
+        goto out;
+    for (i = 0; i < count; i++) {
+        if (exec_add_process (exec, procs[i]) < 0) {
+            while (++i < count) {
+                if (subprocess_destroy (exec->h, procs[i]) < 0)
+                    flux_log_error (exec->h, "Unable to destroy subprocess");
+            }
+            goto out;
+        }
+    }
+    idset_range_clear (cmd->ranks, 0, INT_MAX);
+    rc = count;
+out:
+    free (procs);
+    return rc;
+}
+
 static int exec_start_cmd (struct bulk_exec *exec,
                            struct exec_cmd *cmd,
                            int max)
 {
     int count = 0;
     uint32_t rank;
+
+    if (exec->tree_launch && idset_count (cmd->ranks) > 1)
+        return exec_start_cmd_tree (exec, cmd);
+
     rank = idset_first (cmd->ranks);
     while (rank != IDSET_INVALID_ID && (max < 0 || count < max)) {
         flux_subprocess_t *p = flux_rexec (exec->h,
@@ -284,18 +339,8 @@ static int exec_start_cmd (struct bulk_exec *exec,
                                            cmd->flags,
                                            cmd->cmd,
                                            &exec->ops);
-        if (!p)
-            return -1;
-        if (flux_subprocess_aux_set (p, "job-exec::exec", exec, NULL) < 0
-           || zlist_append (exec->processes, p) < 0) {
-            if (subprocess_destroy (exec->h, p) < 0)
-                flux_log_error (exec->h, "Unable to destroy pid %ju",
-                        (uintmax_t) flux_subprocess_pid (p));
+        if (!p || exec_add_process (exec, p) < 0)
             return -1;
-        }
-        zlist_freefn (exec->processes, p,
-                     (zlist_free_fn *) flux_subprocess_unref,
-                     true);
 
         idset_clear (cmd->ranks, rank);
         rank = idset_next (cmd->ranks, rank);
@@ -322,7 +367,7 @@ static int exec_start_cmds (struct bulk_exec *exec, int max)
         if (idset_count (cmd->ranks) == 0)
             zlist_remove (exec->commands, cmd);
         if (max > 0)
-            max -= rc;
+            max = rc < max ? max - rc : 0;
 
     }
     return 0;
@@ -392,6 +437,11 @@ struct bulk_exec * bulk_exec_create (struct bulk_exec_ops *ops, void *arg)
     return exec;
 }
 
+void bulk_exec_set_tree_launch (struct bulk_exec *exec, bool enable)
+{
+    exec->tree_launch = enable;
+}
+
 int bulk_exec_set_max_per_loop (struct bulk_exec *exec, int max)
 {
     if (max == 0) {
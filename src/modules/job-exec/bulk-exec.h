@@ -13,6 +13,7 @@
 #ifndef HAVE_JOB_EXEC_BULK_EXEC_H
 #define HAVE_JOB_EXEC_BULK_EXEC_H 1
 
+#include <stdbool.h>
 #include <flux/core.h>
 
 struct bulk_exec;
@@ -55,6 +56,12 @@ int bulk_exec_aux_set (struct bulk_exec *exec,
  */
 int bulk_exec_set_max_per_loop (struct bulk_exec *exec, int max);
 
+/*  Start commands that span more than one rank with a single
+ *   flux_rexec_tree(3) request that fans out over the TBON, instead of
+ *   one flux_rexec(3) per rank.  max_per_loop does not apply.
+ */
+void bulk_exec_set_tree_launch (struct bulk_exec *exec, bool enable);
+
 void bulk_exec_destroy (struct bulk_exec *exec);
 
 int bulk_exec_push_cmd (struct bulk_exec *exec,
@@ -40,6 +40,7 @@ extern char **environ;
 static const char *default_cwd = "/tmp";
 static const char *default_job_shell = NULL;
 static const char *flux_imp_path = NULL;
+static int tree_launch = 1;
 
 /* Configuration for "bulk" execution implementation. Used only for testing
  *  for now.
@@ -224,6 +225,7 @@ static int exec_init (struct jobinfo *job)
         flux_log_error (job->h, "exec_init: bulk_exec_create");
         goto err;
     }
+    bulk_exec_set_tree_launch (exec, tree_launch);
     if (!(conf = exec_conf_create (job->jobspec))) {
         flux_log_error (job->h, "exec_init: exec_conf_create");
         goto err;
@@ -400,16 +402,32 @@ static int exec_config (flux_t *h, int argc, char **argv)
         return -1;
     }
 
+    /*  Check configuration for exec.tree-launch */
+    if (flux_conf_unpack (flux_get_conf (h),
+                          &err,
+                          "{s?:{s?b}}",
+                          "exec",
+                            "tree-launch", &tree_launch) < 0) {
+        flux_log (h, LOG_ERR,
+                  "error reading config value exec.tree-launch: %s",
+                  err.errbuf);
+        return -1;
+    }
+
     /* Finally, override values on cmdline */
     for (int i = 0; i < argc; i++) {
         if (strncmp (argv[i], "job-shell=", 10) == 0)
             default_job_shell = argv[i]+10;
         else if (strncmp (argv[i], "imp=", 4) == 0)
             flux_imp_path = argv[i]+4;
+        else if (strncmp (argv[i], "tree-launch=", 12) == 0)
+            tree_launch = atoi (argv[i]+12) ? 1 : 0;
     }
     flux_log (h, LOG_DEBUG, "using default shell path %s", default_job_shell);
     if (flux_imp_path)
         flux_log (h, LOG_DEBUG, "using imp path %s", flux_imp_path);
+    if (!tree_launch)
+        flux_log (h, LOG_DEBUG, "tree launch disabled");
     return 0;
 }
 
@@ -20,45 +20,61 @@
 #include "allow.h"
 
 #include "src/common/libeventlog/eventlog.h"
+#include "src/common/libutil/errno_safe.h"
 
-/* Parse the submit userid from the event log.
- * Assume "submit" is the first event.
+/* Parse the submit userid from eventlog entry 'entry'.
  */
-static int eventlog_get_userid (struct info_ctx *ctx, const char *s,
-                                uint32_t *useridp)
+static int entry_get_userid (struct info_ctx *ctx, json_t *entry,
+                             uint32_t *useridp)
 {
-    json_t *a = NULL;
-    json_t *entry = NULL;
     const char *name = NULL;
     json_t *context = NULL;
     int userid;
-    int rv = -1;
 
-    if (!(a = eventlog_decode (s))) {
-        flux_log_error (ctx->h, "%s: eventlog_decode", __FUNCTION__);
-        goto error;
-    }
-    if (!(entry = json_array_get (a, 0))) {
-        errno = EINVAL;
-        goto error;
-    }
     if (eventlog_entry_parse (entry, NULL, &name, &context) < 0) {
-        flux_log_error (ctx->h, "%s: eventlog_decode", __FUNCTION__);
-        goto error;
+        flux_log_error (ctx->h, "%s: eventlog_entry_parse", __FUNCTION__);
+        return -1;
     }
     if (strcmp (name, "submit") != 0 || !context) {
         flux_log_error (ctx->h, "%s: invalid event", __FUNCTION__);
         errno = EINVAL;
-        goto error;
+        return -1;
     }
     if (json_unpack (context, "{ s:i }", "userid", &userid) < 0) {
         errno = EPROTO;
-        goto error;
+        return -1;
     }
     (*useridp) = userid;
+    return 0;
+}
+
+/* Parse the submit userid from the event log.
+ * Assume "submit" is the first event, and decode only that entry.
+ */
+static int eventlog_get_userid (struct info_ctx *ctx, const char *s,
+                                uint32_t *useridp)
+{
+    const char *term;
+    char *first = NULL;
+    json_t *entry = NULL;
+    int rv = -1;
+
+    if (!(term = strchr (s, '\n'))) {
+        errno = EINVAL;
+        goto error;
+    }
+    if (!(first = strndup (s, term - s + 1)))
+        goto error;
+    if (!(entry = eventlog_entry_decode (first))) {
+        flux_log_error (ctx->h, "%s: eventlog_entry_decode", __FUNCTION__);
+        goto error;
+    }
+    if (entry_get_userid (ctx, entry, useridp) < 0)
+        goto error;
     rv = 0;
 error:
-    json_decref (a);
+    ERRNO_SAFE_WRAP (free, first);
+    ERRNO_SAFE_WRAP (json_decref, entry);
     return rv;
 }
 
@@ -103,6 +119,31 @@ int eventlog_allow (struct info_ctx *ctx, const flux_msg_t *msg,
     return 0;
 }
 
+int eventlog_allow_index (struct info_ctx *ctx,
+                          const flux_msg_t *msg,
+                          flux_jobid_t id,
+                          struct eventlog_index *idx)
+{
+    struct flux_msg_cred cred;
+
+    if (flux_msg_get_cred (msg, &cred) < 0)
+        return -1;
+    if (!(cred.rolemask & FLUX_ROLE_OWNER)) {
+        json_t *entry;
+        uint32_t userid;
+        if (!(entry = eventlog_index_get (idx, 0))) {
+            errno = EINVAL;
+            return -1;
+        }
+        if (entry_get_userid (ctx, entry, &userid) < 0)
+            return -1;
+        store_lru (ctx, id, userid);
+        if (flux_msg_cred_authorize (cred, userid) < 0)
+            return -1;
+    }
+    return 0;
+}
+
 int eventlog_allow_lru (struct info_ctx *ctx,
                         const flux_msg_t *msg,
                         flux_jobid_t id)
@@ -13,6 +13,8 @@
 
 #include <flux/core.h>
 
+#include "src/common/libeventlog/eventlog_index.h"
+
 #include "job-info.h"
 
 /* Determine if user who sent request 'msg' is allowed to
@@ -23,6 +25,14 @@
 int eventlog_allow (struct info_ctx *ctx, const flux_msg_t *msg,
                     flux_jobid_t id, const char *s);
 
+/* Like eventlog_allow(), but take the job owner from the first entry
+ * of indexed eventlog 'idx'.
+ */
+int eventlog_allow_index (struct info_ctx *ctx,
+                          const flux_msg_t *msg,
+                          flux_jobid_t id,
+                          struct eventlog_index *idx);
+
 /* Determine if user who sent request 'msg' is allowed to access job
  * eventlog via LRU cache.  Returns 1 if access allowed, 0 if
  * indeterminate, -1 on error (including EPERM if access not allowed).
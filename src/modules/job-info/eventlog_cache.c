@@ -0,0 +1,70 @@
+/************************************************************\
+ * Copyright 2021 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+/* eventlog_cache.c - LRU cache of indexed job eventlogs */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <flux/core.h>
+
+#include "src/common/libutil/lru_cache.h"
+
+#include "job-info.h"
+#include "eventlog_cache.h"
+
+struct eventlog_index *eventlog_cache_get (struct info_ctx *ctx,
+                                           flux_jobid_t id)
+{
+    char key[64];
+    struct eventlog_index *idx;
+
+    snprintf (key, sizeof (key), "%ju", (uintmax_t)id);
+
+    if (!(idx = lru_cache_get (ctx->eventlog_lru, key))) {
+        if (!(idx = eventlog_index_create ()))
+            return NULL;
+        if (lru_cache_put (ctx->eventlog_lru, key, idx) < 0) {
+            eventlog_index_destroy (idx);
+            return NULL;
+        }
+    }
+    return idx;
+}
+
+struct eventlog_index *eventlog_cache_update (struct info_ctx *ctx,
+                                              flux_jobid_t id,
+                                              const char *s)
+{
+    struct eventlog_index *idx;
+
+    if (!(idx = eventlog_cache_get (ctx, id)))
+        return NULL;
+    if (strlen (s) < eventlog_index_size (idx)) {
+        char key[64];
+
+        snprintf (key, sizeof (key), "%ju", (uintmax_t)id);
+        (void)lru_cache_remove (ctx->eventlog_lru, key);
+        if (!(idx = eventlog_cache_get (ctx, id)))
+            return NULL;
+    }
+    if (eventlog_index_update (idx, s) < 0)
+        return NULL;
+    return idx;
+}
+
+bool eventlog_cache_complete (struct eventlog_index *idx)
+{
+    return eventlog_index_find (idx, "clean", -1) >= 0;
+}
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
@@ -0,0 +1,49 @@
+/************************************************************\
+ * Copyright 2021 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#ifndef _FLUX_JOB_INFO_EVENTLOG_CACHE_H
+#define _FLUX_JOB_INFO_EVENTLOG_CACHE_H
+
+#include <flux/core.h>
+
+#include "src/common/libeventlog/eventlog_index.h"
+
+#include "job-info.h"
+
+/* Recently used main job eventlogs are kept decoded and indexed in an
+ * LRU cache, so that watchers and seek requests need only decode
+ * entries appended since the eventlog was last seen.
+ */
+
+/* Return the cached index for job 'id', creating an empty one if
+ * the job is not cached.  The index remains valid only until the
+ * next call that may modify the cache.
+ */
+struct eventlog_index *eventlog_cache_get (struct info_ctx *ctx,
+                                           flux_jobid_t id);
+
+/* Update the cached index for job 'id' with eventlog 's', decoding only
+ * new entries.  If 's' does not extend the cached eventlog, the index is
+ * rebuilt from 's'.
+ */
+struct eventlog_index *eventlog_cache_update (struct info_ctx *ctx,
+                                              flux_jobid_t id,
+                                              const char *s);
+
+/* Return true if the indexed eventlog is complete ("clean" was posted),
+ * so it will not grow further.
+ */
+bool eventlog_cache_complete (struct eventlog_index *idx);
+
+#endif /* ! _FLUX_JOB_INFO_EVENTLOG_CACHE_H */
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
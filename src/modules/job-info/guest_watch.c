@@ -25,6 +25,7 @@
 
 #include "job-info.h"
 #include "watch.h"
+#include "eventlog_cache.h"
 
 /* This code (entrypoint guest_watch()) handles all
  * of the tricky / racy things related to reading an eventlog from the
@@ -317,39 +318,35 @@ error:
 static int check_guest_namespace_status (struct guest_watch_ctx *gw,
                                          const char *s)
 {
-    json_t *a = NULL;
-    size_t index;
-    json_t *event;
-    int rv = -1;
+    struct eventlog_index *idx;
+    int seq = -1;
 
-    if (!(a = eventlog_decode (s)))
-        goto error;
+    if (!(idx = eventlog_cache_update (gw->ctx, gw->id, s)))
+        return -1;
 
-    json_array_foreach (a, index, event) {
-        const char *name;
+    if (eventlog_index_find (idx, "start", -1) >= 0)
+        gw->guest_started = true;
+    while (!gw->guest_released
+           && (seq = eventlog_index_find (idx, "release", seq)) >= 0) {
         json_t *context = NULL;
-        if (eventlog_entry_parse (event, NULL, &name, &context) < 0)
-            goto error;
-        if (!strcmp (name, "start"))
-            gw->guest_started = true;
-        if (!strcmp (name, "release")) {
-            void *iter = json_object_iter (context);
-            while (iter && !gw->guest_released) {
-                const char *key = json_object_iter_key (iter);
-                if (!strcmp (key, "final")) {
-                    json_t *value = json_object_iter_value (iter);
-                    if (json_is_boolean (value) && json_is_true (value))
-                        gw->guest_released = true;
-                }
-                iter = json_object_iter_next (context, iter);
+        void *iter;
+        if (eventlog_entry_parse (eventlog_index_get (idx, seq),
+                                  NULL,
+                                  NULL,
+                                  &context) < 0)
+            return -1;
+        iter = json_object_iter (context);
+        while (iter && !gw->guest_released) {
+            const char *key = json_object_iter_key (iter);
+            if (!strcmp (key, "final")) {
+                json_t *value = json_object_iter_value (iter);
+                if (json_is_boolean (value) && json_is_true (value))
+                    gw->guest_released = true;
             }
+            iter = json_object_iter_next (context, iter);
         }
     }
-
-    rv = 0;
-error:
-    json_decref (a);
-    return rv;
+    return 0;
 }
 
 static void get_main_eventlog_continuation (flux_future_t *f, void *arg)
@@ -20,6 +20,8 @@
 #include "lookup.h"
 #include "watch.h"
 #include "guest_watch.h"
+#include "seek.h"
+#include "eventlog_cache.h"
 
 static void disconnect_cb (flux_t *h, flux_msg_handler_t *mh,
                            const flux_msg_t *msg, void *arg)
@@ -36,10 +38,12 @@ static void stats_cb (flux_t *h, flux_msg_handler_t *mh,
     int lookups = zlist_size (ctx->lookups);
     int watchers = zlist_size (ctx->watchers);
     int guest_watchers = zlist_size (ctx->guest_watchers);
-    if (flux_respond_pack (h, msg, "{s:i s:i s:i}",
+    int eventlog_cache = lru_cache_size (ctx->eventlog_lru);
+    if (flux_respond_pack (h, msg, "{s:i s:i s:i s:i}",
                            "lookups", lookups,
                            "watchers", watchers,
-                           "guest_watchers", guest_watchers) < 0) {
+                           "guest_watchers", guest_watchers,
+                           "eventlog_cache", eventlog_cache) < 0) {
         flux_log_error (h, "%s: flux_respond_pack", __FUNCTION__);
         goto error;
     }
@@ -56,6 +60,11 @@ static const struct flux_msg_handler_spec htab[] = {
       .cb           = lookup_cb,
       .rolemask     = FLUX_ROLE_USER
     },
+    { .typemask     = FLUX_MSGTYPE_REQUEST,
+      .topic_glob   = "job-info.eventlog-seek",
+      .cb           = seek_cb,
+      .rolemask     = FLUX_ROLE_USER
+    },
     { .typemask     = FLUX_MSGTYPE_REQUEST,
       .topic_glob   = "job-info.eventlog-watch",
       .cb           = watch_cb,
@@ -96,6 +105,8 @@ static void info_ctx_destroy (struct info_ctx *ctx)
             guest_watch_cleanup (ctx);
             zlist_destroy (&ctx->guest_watchers);
         }
+        if (ctx->eventlog_lru)
+            lru_cache_destroy (ctx->eventlog_lru);
         free (ctx);
         errno = saved_errno;
     }
@@ -112,6 +123,10 @@ static struct info_ctx *info_ctx_create (flux_t *h)
     if (!(ctx->owner_lru = lru_cache_create (OWNER_LRU_MAXSIZE)))
         goto error;
     lru_cache_set_free_f (ctx->owner_lru, (lru_cache_free_f)free);
+    if (!(ctx->eventlog_lru = lru_cache_create (EVENTLOG_LRU_MAXSIZE)))
+        goto error;
+    lru_cache_set_free_f (ctx->eventlog_lru,
+                          (lru_cache_free_f)eventlog_index_destroy);
     if (!(ctx->lookups = zlist_new ()))
         goto error;
     if (!(ctx->watchers = zlist_new ()))
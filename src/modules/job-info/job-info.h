@@ -17,11 +17,13 @@
 #include "src/common/libutil/lru_cache.h"
 
 #define OWNER_LRU_MAXSIZE 1000
+#define EVENTLOG_LRU_MAXSIZE 1000
 
 struct info_ctx {
     flux_t *h;
     flux_msg_handler_t **handlers;
     lru_cache_t *owner_lru; /* jobid -> owner LRU */
+    lru_cache_t *eventlog_lru; /* jobid -> struct eventlog_index LRU */
     zlist_t *lookups;
     zlist_t *watchers;
     zlist_t *guest_watchers;
@@ -0,0 +1,207 @@
+/************************************************************\
+ * Copyright 2021 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+/* seek.c - handle job-info.eventlog-seek for job-info
+ *
+ * Request: {"id":I, "name"?:s, "after"?:i}
+ *
+ * Return entries of the main job eventlog with sequence number greater
+ * than 'after' (default -1, i.e. from the beginning).  If 'name' is set,
+ * only the first such entry with that name is returned.  Sequence
+ * numbers count eventlog entries from zero.
+ *
+ * Response: {"seq":i, "events":[entry, ...]}
+ * where 'seq' is the sequence number of the last entry returned.
+ * If no matching entries are found, fail with ENOENT.
+ *
+ * The eventlog is served from the eventlog cache if it is complete
+ * there, otherwise it is looked up and only new entries are decoded.
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <jansson.h>
+#include <flux/core.h>
+
+#include "src/common/libczmqcontainers/czmq_containers.h"
+#include "src/common/libjob/job.h"
+
+#include "job-info.h"
+#include "seek.h"
+#include "allow.h"
+#include "eventlog_cache.h"
+
+struct seek_ctx {
+    struct info_ctx *ctx;
+    const flux_msg_t *msg;
+    flux_jobid_t id;
+    char *name;
+    int after;
+    flux_future_t *f;
+};
+
+static void seek_ctx_destroy (void *data)
+{
+    if (data) {
+        struct seek_ctx *s = data;
+        flux_msg_decref (s->msg);
+        free (s->name);
+        flux_future_destroy (s->f);
+        free (s);
+    }
+}
+
+static struct seek_ctx *seek_ctx_create (struct info_ctx *ctx,
+                                         const flux_msg_t *msg,
+                                         flux_jobid_t id,
+                                         const char *name,
+                                         int after)
+{
+    struct seek_ctx *s = calloc (1, sizeof (*s));
+
+    if (!s)
+        return NULL;
+    s->ctx = ctx;
+    s->id = id;
+    s->after = after;
+    if (name && !(s->name = strdup (name))) {
+        seek_ctx_destroy (s);
+        errno = ENOMEM;
+        return NULL;
+    }
+    s->msg = flux_msg_incref (msg);
+    return s;
+}
+
+static int seek_respond (struct info_ctx *ctx,
+                         const flux_msg_t *msg,
+                         struct eventlog_index *idx,
+                         const char *name,
+                         int after)
+{
+    json_t *events;
+    int seq;
+    int last = -1;
+
+    if (!(events = json_array ())) {
+        errno = ENOMEM;
+        return -1;
+    }
+    while ((seq = eventlog_index_find (idx, name, after)) >= 0) {
+        if (json_array_append (events, eventlog_index_get (idx, seq)) < 0) {
+            json_decref (events);
+            errno = ENOMEM;
+            return -1;
+        }
+        last = after = seq;
+        if (name)
+            break;
+    }
+    if (last < 0) {
+        json_decref (events);
+        errno = ENOENT;
+        return -1;
+    }
+    if (flux_respond_pack (ctx->h, msg, "{s:i s:o}",
+                           "seq", last,
+                           "events", events) < 0)
+        flux_log_error (ctx->h, "%s: flux_respond_pack", __FUNCTION__);
+    return 0;
+}
+
+static void seek_continuation (flux_future_t *f, void *arg)
+{
+    struct seek_ctx *s = arg;
+    struct info_ctx *ctx = s->ctx;
+    struct eventlog_index *idx;
+    const char *str;
+
+    if (flux_kvs_lookup_get (f, &str) < 0) {
+        if (errno != ENOENT)
+            flux_log_error (ctx->h, "%s: flux_kvs_lookup_get", __FUNCTION__);
+        goto error;
+    }
+    if (!(idx = eventlog_cache_update (ctx, s->id, str))) {
+        flux_log_error (ctx->h, "%s: eventlog_cache_update", __FUNCTION__);
+        goto error;
+    }
+    if (eventlog_allow_index (ctx, s->msg, s->id, idx) < 0)
+        goto error;
+    if (seek_respond (ctx, s->msg, idx, s->name, s->after) < 0)
+        goto error;
+    goto done;
+error:
+    if (flux_respond_error (ctx->h, s->msg, errno, NULL) < 0)
+        flux_log_error (ctx->h, "%s: flux_respond_error", __FUNCTION__);
+done:
+    /* flux future destroyed in seek_ctx_destroy, which is called
+     * via zlist_remove() */
+    zlist_remove (ctx->lookups, s);
+}
+
+void seek_cb (flux_t *h, flux_msg_handler_t *mh,
+              const flux_msg_t *msg, void *arg)
+{
+    struct info_ctx *ctx = arg;
+    struct seek_ctx *s = NULL;
+    struct eventlog_index *idx;
+    flux_jobid_t id;
+    const char *name = NULL;
+    int after = -1;
+    char key[64];
+
+    if (flux_request_unpack (msg, NULL, "{s:I s?:s s?:i}",
+                             "id", &id,
+                             "name", &name,
+                             "after", &after) < 0) {
+        flux_log_error (h, "%s: flux_request_unpack", __FUNCTION__);
+        goto error;
+    }
+
+    /* A complete eventlog will not change, so if it is cached
+     * there is no need to look it up again.
+     */
+    if ((idx = eventlog_cache_get (ctx, id))
+        && eventlog_cache_complete (idx)) {
+        if (eventlog_allow_index (ctx, msg, id, idx) < 0)
+            goto error;
+        if (seek_respond (ctx, msg, idx, name, after) < 0)
+            goto error;
+        return;
+    }
+
+    if (!(s = seek_ctx_create (ctx, msg, id, name, after)))
+        goto error;
+    if (flux_job_kvs_key (key, sizeof (key), id, "eventlog") < 0) {
+        errno = EINVAL;
+        goto error;
+    }
+    if (!(s->f = flux_kvs_lookup (h, NULL, 0, key))
+        || flux_future_then (s->f, -1, seek_continuation, s) < 0) {
+        flux_log_error (h, "%s: flux_kvs_lookup", __FUNCTION__);
+        goto error;
+    }
+    if (zlist_append (ctx->lookups, s) < 0) {
+        flux_log_error (h, "%s: zlist_append", __FUNCTION__);
+        goto error;
+    }
+    zlist_freefn (ctx->lookups, s, seek_ctx_destroy, true);
+    return;
+
+error:
+    if (flux_respond_error (h, msg, errno, NULL) < 0)
+        flux_log_error (h, "%s: flux_respond_error", __FUNCTION__);
+    seek_ctx_destroy (s);
+}
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
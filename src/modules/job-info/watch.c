@@ -25,6 +25,7 @@
 #include "watch.h"
 #include "guest_watch.h"
 #include "allow.h"
+#include "eventlog_cache.h"
 
 struct watch_ctx {
     struct info_ctx *ctx;
@@ -37,6 +38,7 @@ struct watch_ctx {
     flux_future_t *watch_f;
     bool allow;
     bool cancel;
+    size_t offset;      // eventlog bytes received so far
 };
 
 static void watch_continuation (flux_future_t *f, void *arg);
@@ -202,9 +204,12 @@ static bool eventlog_parse_next (const char **pp, const char **tok,
     return true;
 }
 
-static int check_eventlog_end (struct watch_ctx *w,
-                               const char *tok,
-                               size_t toklen)
+/* Decode eventlog entry 'tok' and return 1 if it is the "clean" event,
+ * 0 if not, or -1 on error.
+ */
+static int check_entry_end (struct watch_ctx *w,
+                            const char *tok,
+                            size_t toklen)
 {
     char *str = NULL;
     json_t *o = NULL;
@@ -238,6 +243,31 @@ error:
     return rc;
 }
 
+/* Return 1 if eventlog entry 'tok' is the "clean" event, 0 if not,
+ * or -1 on error.  Entries of the main job eventlog are indexed in the
+ * eventlog cache, so that an entry already decoded on behalf of another
+ * watcher (or seek request) is not decoded again.  If the entry cannot
+ * be indexed, e.g. the cached eventlog was evicted since this watch
+ * began, fall back to decoding it directly.
+ */
+static int check_eventlog_end (struct watch_ctx *w,
+                               const char *tok,
+                               size_t toklen)
+{
+    struct eventlog_index *idx;
+    const char *name = NULL;
+    int seq;
+
+    if ((idx = eventlog_cache_get (w->ctx, w->id))
+        && (seq = eventlog_index_append (idx, w->offset, tok, toklen)) >= 0
+        && eventlog_entry_parse (eventlog_index_get (idx, seq),
+                                 NULL,
+                                 &name,
+                                 NULL) == 0)
+        return !strcmp (name, "clean") ? 1 : 0;
+    return check_entry_end (w, tok, toklen);
+}
+
 static void watch_continuation (flux_future_t *f, void *arg)
 {
     struct watch_ctx *w = arg;
@@ -281,7 +311,9 @@ static void watch_continuation (flux_future_t *f, void *arg)
          * known ruleset, so it will hang.
          */
         if (!w->guest && !strcmp (w->path, "eventlog")) {
-            if (check_eventlog_end (w, tok, toklen) > 0) {
+            int end = check_eventlog_end (w, tok, toklen);
+            w->offset += toklen;
+            if (end > 0) {
                 if (flux_kvs_lookup_cancel (w->watch_f) < 0) {
                     flux_log_error (ctx->h, "%s: flux_kvs_lookup_cancel",
                                     __FUNCTION__);
@@ -22,11 +22,15 @@
 #include "src/common/libczmqcontainers/czmq_containers.h"
 #include "src/common/libutil/fluid.h"
 #include "src/common/libutil/jpath.h"
+#include "src/common/libutil/errno_safe.h"
+#include "src/common/libutil/monotime.h"
+#include "src/common/libutil/tstat.h"
 #include "src/common/libjob/sign_none.h"
 #include "src/common/libjob/job_hash.h"
 #include "src/common/libeventlog/eventlog.h"
 
 #include "validate.h"
+#include "vpool.h"
 
 /* job-ingest takes in signed jobspec submitted through flux_job_submit(),
  * performing the following tasks for each job:
@@ -37,13 +41,31 @@
  * 4) commit job data to KVS per RFC 16 (KVS Job Schema)
  * 5) make "job-manager.submit" request announcing new jobid
  *
+ * Step 2 is performed by external validator processes by default.  If
+ * the builtin-validator option is set, jobspec is instead decoded and
+ * checked against jobspec version 1 in-process, on a pool of threads.
+ * External validators then run only if validator-plugins is also set.
+ *
  * For performance, the above actions are batched, so that if job requests
- * arrive within the 'batch_timeout' window, they are combined into one
- * KVS transaction and one job-manager request.
+ * arrive within the batch window, they are combined into one KVS transaction
+ * and one job-manager request.  The window adapts to load: when no KVS
+ * commits are in flight, a new batch is flushed on the next reactor loop
+ * iteration; otherwise the window tracks recent commit latency, up to
+ * 'batch_timeout'.  Up to 'max_inflight' batches may be committing at once.
+ * Once that limit is reached, the current batch keeps growing until a
+ * commit completes.  Batches are announced to the job manager in the order
+ * they were created, regardless of the order their commits complete.
  *
  * The jobid is returned to the user in response to the job-ingest.submit RPC.
  * Responses are sent after the job has been successfully ingested.
  *
+ * job-ingest.submit-bulk accepts an array of jobs in one request, either
+ * individually signed ("jobs"), or as one signed array of jobspecs ("J").
+ * The shared signature is restricted to the instance owner, since the IMP
+ * needs a signature per job for guest jobs.  Each job is processed as
+ * above, and one response is sent with a result for each job, in order,
+ * once all jobs have been ingested or have failed.
+ *
  * Currently all KVS data is committed under job.<fluid-dothex>,
  * where <fluid-dothex> is the jobid converted to 16-bit, 0-padded hex
  * strings delimited by periods, e.g.
@@ -64,22 +86,63 @@
 
 
 /* The batch_timeout (seconds) is the maximum length of time
- * any given job request is delayed before initiating a KVS commit.
+ * any given job request is delayed before initiating a KVS commit,
+ * unless the number of commits in flight is at its limit.
  * Too large, and individual job submit latency will suffer.
  * Too small, and KVS commit overhead will increase.
  */
 const double batch_timeout = 0.01;
 
+/* The adaptive batch window is this fraction of the moving average
+ * of KVS commit latency, clamped to batch_timeout.
+ */
+const double batch_window_factor = 0.5;
+
+/* Weight of each new sample in the commit latency moving average.
+ */
+const double commit_latency_alpha = 0.25;
+
+/* Default maximum number of batches with KVS commits in flight.
+ */
+const int default_max_inflight = 4;
+
 /* Timeout (seconds) to wait for validators to terminate when
  * stopped by closing their stdin.  If the timer pops, stop the reactor
  * and allow validate_destroy() to signal them.
  */
 const double shutdown_timeout = 5.;
 
+/* Default number of threads for the builtin validator.
+ */
+const int default_validator_threads = 4;
+
+/* Upper bounds of histogram buckets for latency (ms) and batch size.
+ * Each histogram has an additional, unbounded last bucket.
+ */
+static const double latency_bucket[] = {
+    0.1, 0.25, 0.5, 1., 2.5, 5., 10., 25., 50., 100., 250., 1000.,
+};
+static const double batch_size_bucket[] = {
+    1., 2., 4., 8., 16., 32., 64., 128., 256., 512., 1024.,
+};
+#define LATENCY_BUCKETS (sizeof (latency_bucket) / sizeof (latency_bucket[0]))
+#define BATCH_SIZE_BUCKETS \
+    (sizeof (batch_size_bucket) / sizeof (batch_size_bucket[0]))
+#define HISTOGRAM_MAX_BUCKETS 16
+
+struct histogram {
+    tstat_t ts;
+    const double *bucket;
+    int nbuckets;
+    unsigned int count[HISTOGRAM_MAX_BUCKETS + 1];
+};
 
 struct job_ingest_ctx {
     flux_t *h;
     struct validate *validate;
+    struct vpool *vpool;
+    struct histogram builtin_latency;
+    struct histogram external_latency;
 #if HAVE_FLUX_SECURITY
     flux_security_t *sec;
 #endif
@@ -88,22 +151,41 @@ struct job_ingest_ctx {
 
     struct batch *batch;
     flux_watcher_t *timer;
+    bool batch_deferred;        // batch timer expired with max_inflight reached
 
     int batch_count;            // if nonzero, batch by count not timer
 
+    zlist_t *inflight;          // batches awaiting commit/announce, in order
+    int commits_active;         // number of KVS commits in flight
+    int max_inflight;           // limit on commits_active (timer mode only)
+    double commit_latency;      // moving average of commit latency (s)
+    double batch_window;        // current batch window (s)
+    struct histogram batch_size;
+    struct histogram commit_latency_ms;
+
     bool shutdown;              // no new jobs are accepted in shutdown mode
     int shutdown_process_count; // number of validators executing at shutdown
     flux_watcher_t *shutdown_timer;
 };
 
+struct bulk {
+    const flux_msg_t *msg; // submit-bulk request message
+    json_t *results;    // result for each job, in request order
+    int pending;        // jobs without a result (+1 while jobs are added)
+};
+
 struct job {
     fluid_t id;         // jobid
 
     const flux_msg_t *msg; // submit request message
+    struct bulk *bulk;  // submit-bulk request, if any
+    int index;          // index of job in submit-bulk request
     const char *J;      // signed jobspec
+    char *J_buf;        // signed jobspec, if owned by job
     struct flux_msg_cred cred;    // submitting user's creds
     int urgency;        // requested job urgency
     int flags;          // submit flags
+    struct timespec t_validate; // validation start time
 
     char *jobspec;      // jobspec, not \0 terminated (unwrapped from signed)
     int jobspecsz;      // jobspec string length
@@ -114,11 +196,20 @@ struct job {
     struct job_ingest_ctx *ctx;
 };
 
+enum batch_state {
+    BATCH_OPEN,
+    BATCH_COMMITTING,
+    BATCH_COMMITTED,
+    BATCH_FAILED,
+};
+
 struct batch {
     struct job_ingest_ctx *ctx;
     flux_kvs_txn_t *txn;
     zlist_t *jobs;
     json_t *joblist;
+    enum batch_state state;
+    struct timespec t_commit;
 };
 
 struct batch_response {
@@ -131,6 +222,66 @@ struct batch_response {
 
 static int make_key (char *buf, int bufsz, struct job *job, const char *name);
 
+static void histogram_init (struct histogram *hist,
+                            const double *bucket,
+                            int nbuckets)
+{
+    memset (hist, 0, sizeof (*hist));
+    hist->bucket = bucket;
+    hist->nbuckets = nbuckets;
+}
+
+static void histogram_push (struct histogram *hist, double value)
+{
+    int i;
+
+    tstat_push (&hist->ts, value);
+    for (i = 0; i < hist->nbuckets; i++) {
+        if (value <= hist->bucket[i])
+            break;
+    }
+    hist->count[i]++;
+}
+
+/* Encode 'hist' in the tstat summary form used by other stats.get handlers,
+ * with bucket counts in an object under 'name', keyed by upper bound.
+ */
+static json_t *histogram_tojson (struct histogram *hist, const char *name)
+{
+    json_t *buckets;
+    json_t *o;
+    int i;
+
+    if (!(buckets = json_object ()))
+        return NULL;
+    for (i = 0; i <= hist->nbuckets; i++) {
+        char key[32];
+        json_t *val;
+
+        if (i < hist->nbuckets)
+            snprintf (key, sizeof (key), "%g", hist->bucket[i]);
+        else
+            snprintf (key, sizeof (key), "inf");
+        if (!(val = json_integer (hist->count[i]))
+            || json_object_set_new (buckets, key, val) < 0) {
+            json_decref (val);
+            json_decref (buckets);
+            return NULL;
+        }
+    }
+    if (!(o = json_pack ("{s:i s:f s:f s:f s:f s:o}",
+                         "count", tstat_count (&hist->ts),
+                         "min", tstat_min (&hist->ts),
+                         "mean", tstat_mean (&hist->ts),
+                         "stddev", tstat_stddev (&hist->ts),
+                         "max", tstat_max (&hist->ts),
+                         name, buckets))) {
+        json_decref (buckets);
+        return NULL;
+    }
+    return o;
+}
+
 /* Free decoded jobspec after it has been transferred to the batch txn,
  * to conserve memory.
  */
@@ -148,6 +299,7 @@ static void job_destroy (struct job *job)
 {
     if (job) {
         int saved_errno = errno;
+        free (job->J_buf);
         free (job->jobspec);
         flux_msg_decref (job->msg);
         json_decref (job->jobspec_obj);
@@ -178,6 +330,118 @@ error:
     return NULL;
 }
 
+/* Create a job for entry 'index' of a submit-bulk request.
+ */
+static struct job *job_create_bulk (struct bulk *bulk,
+                                    int index,
+                                    struct flux_msg_cred cred,
+                                    int urgency,
+                                    int flags,
+                                    struct job_ingest_ctx *ctx)
+{
+    struct job *job;
+
+    if (!(job = calloc (1, sizeof (*job))))
+        return NULL;
+    job->msg = flux_msg_incref (bulk->msg);
+    job->bulk = bulk;
+    job->index = index;
+    job->cred = cred;
+    job->urgency = urgency;
+    job->flags = flags;
+    job->ctx = ctx;
+    return job;
+}
+
+static void bulk_destroy (struct bulk *bulk)
+{
+    if (bulk) {
+        int saved_errno = errno;
+        flux_msg_decref (bulk->msg);
+        json_decref (bulk->results);
+        free (bulk);
+        errno = saved_errno;
+    }
+}
+
+static struct bulk *bulk_create (const flux_msg_t *msg, int count)
+{
+    struct bulk *bulk;
+
+    if (!(bulk = calloc (1, sizeof (*bulk))))
+        return NULL;
+    bulk->msg = flux_msg_incref (msg);
+    if (!(bulk->results = json_array ()))
+        goto nomem;
+    for (int i = 0; i < count; i++) {
+        if (json_array_append_new (bulk->results, json_null ()) < 0)
+            goto nomem;
+    }
+    bulk->pending = count + 1;
+    return bulk;
+nomem:
+    bulk_destroy (bulk);
+    errno = ENOMEM;
+    return NULL;
+}
+
+/* Drop one pending result.  Once none remain, respond to the
+ * submit-bulk request and destroy 'bulk'.
+ */
+static void bulk_release (flux_t *h, struct bulk *bulk)
+{
+    if (--bulk->pending > 0)
+        return;
+    if (flux_respond_pack (h, bulk->msg, "{s:O}", "results", bulk->results) < 0)
+        flux_log_error (h, "%s: flux_respond_pack", __FUNCTION__);
+    bulk_destroy (bulk);
+}
+
+static void bulk_set_error (flux_t *h,
+                            struct bulk *bulk,
+                            int index,
+                            int errnum,
+                            const char *errmsg)
+{
+    json_t *o;
+
+    if (!(o = json_pack ("{s:i s:s}",
+                         "errnum", errnum,
+                         "errmsg", errmsg ? errmsg : strerror (errnum)))
+        || json_array_set_new (bulk->results, index, o) < 0)
+        flux_log_error (h, "%s: error recording result", __FUNCTION__);
+    bulk_release (h, bulk);
+}
+
+/* Respond to the submit request of 'job' with an error.
+ */
+static void job_respond_error (struct job *job, int errnum, const char *errmsg)
+{
+    flux_t *h = job->ctx->h;
+
+    if (job->bulk)
+        bulk_set_error (h, job->bulk, job->index, errnum, errmsg);
+    else if (flux_respond_error (h, job->msg, errnum, errmsg) < 0)
+        flux_log_error (h, "%s: flux_respond_error", __FUNCTION__);
+}
+
+/* Respond to the submit request of 'job' with its jobid.
+ */
+static void job_respond_id (struct job *job)
+{
+    flux_t *h = job->ctx->h;
+
+    if (job->bulk) {
+        json_t *o;
+        if (!(o = json_pack ("{s:I}", "id", job->id))
+            || json_array_set_new (job->bulk->results, job->index, o) < 0)
+            flux_log_error (h, "%s: error recording result", __FUNCTION__);
+        bulk_release (h, job->bulk);
+    }
+    else if (flux_respond_pack (h, job->msg, "{s:I}", "id", job->id) < 0)
+        flux_log_error (h, "%s: flux_respond_pack", __FUNCTION__);
+}
+
 static void batch_destroy (struct batch *batch)
 {
     if (batch) {
@@ -303,11 +567,9 @@ error:
 static void batch_respond_error (struct batch *batch,
                                  int errnum, const char *errstr)
 {
-    flux_t *h = batch->ctx->h;
     struct job *job = zlist_first (batch->jobs);
     while (job) {
-        if (flux_respond_error (h, job->msg, errnum, errstr) < 0)
-            flux_log_error (h, "%s: flux_respond_error", __FUNCTION__);
+        job_respond_error (job, errnum, errstr);
         job = zlist_next (batch->jobs);
     }
 }
@@ -317,7 +579,6 @@ static void batch_respond_error (struct batch *batch,
  */
 static void batch_respond (struct batch *batch, struct batch_response *br)
 {
-    flux_t *h = batch->ctx->h;
     const char *errmsg;
     struct job *job = zlist_first (batch->jobs);
 
@@ -327,12 +588,10 @@ static void batch_respond (struct batch *batch, struct batch_response *br)
     }
 
     while (job) {
-        if ((errmsg = zhashx_lookup (br->errors, &job->id))) {
-            if (flux_respond_error (h, job->msg, EINVAL, errmsg) < 0)
-                flux_log_error (h, "batch_respond: flux_respond_error");
-        }
-        else if (flux_respond_pack (h, job->msg, "{s:I}", "id", job->id) < 0)
-            flux_log_error (h, "%s: flux_respond_pack", __FUNCTION__);
+        if ((errmsg = zhashx_lookup (br->errors, &job->id)))
+            job_respond_error (job, EINVAL, errmsg);
+        else
+            job_respond_id (job);
         job = zlist_next (batch->jobs);
     }
 }
@@ -435,21 +694,73 @@ error:
     flux_future_destroy (f);
 }
 
+/* Announce batches whose KVS commits have completed, in creation order.
+ * Stop at the first batch that is still committing.
+ */
+static void batch_announce_ready (struct job_ingest_ctx *ctx)
+{
+    struct batch *batch;
+
+    while ((batch = zlist_first (ctx->inflight))
+           && batch->state != BATCH_COMMITTING) {
+        zlist_remove (ctx->inflight, batch);
+        if (batch->state == BATCH_COMMITTED)
+            batch_announce (batch);
+        else
+            batch_destroy (batch);
+    }
+}
+
+/* Fold the latency of a completed commit into the moving average,
+ * and recompute the batch window from it.
+ */
+static void batch_window_update (struct job_ingest_ctx *ctx, double ms)
+{
+    double latency = ms / 1000.;
+
+    histogram_push (&ctx->commit_latency_ms, ms);
+    flux_stats_timing (ctx->h, "job-ingest.commit-latency", ms);
+    if (tstat_count (&ctx->commit_latency_ms.ts) == 1)
+        ctx->commit_latency = latency;
+    else {
+        ctx->commit_latency = commit_latency_alpha * latency
+                            + (1. - commit_latency_alpha) * ctx->commit_latency;
+    }
+    ctx->batch_window = ctx->commit_latency * batch_window_factor;
+    if (ctx->batch_window > batch_timeout)
+        ctx->batch_window = batch_timeout;
+}
+
+static void batch_flush (struct job_ingest_ctx *ctx);
+
 /* Get result of KVS commit.
- * If successful, announce job(s) to job-manager.
+ * If successful, mark batch committed so it can be announced to the
+ * job-manager once all batches ahead of it have been announced.
  */
 static void batch_flush_continuation (flux_future_t *f, void *arg)
 {
     struct batch *batch = arg;
+    struct job_ingest_ctx *ctx = batch->ctx;
 
+    ctx->commits_active--;
+    batch_window_update (ctx, monotime_since (batch->t_commit));
     if (flux_future_get (f, NULL) < 0) {
         batch_respond_error (batch, errno, "KVS commit failed");
-        batch_destroy (batch);
-    }
-    else {
-        batch_announce (batch);
+        batch->state = BATCH_FAILED;
     }
+    else
+        batch->state = BATCH_COMMITTED;
     flux_future_destroy (f);
+
+    batch_announce_ready (ctx);
+
+    /* If the current batch was held back because too many commits
+     * were in flight, it may go now.
+     */
+    if (ctx->batch
+        && ctx->batch_deferred
+        && ctx->commits_active < ctx->max_inflight)
+        batch_flush (ctx);
 }
 
 /*
@@ -464,31 +775,57 @@ static void batch_flush (struct job_ingest_ctx *ctx)
 
     batch = ctx->batch;
     ctx->batch = NULL;
-
+    ctx->batch_deferred = false;
+    flux_watcher_stop (ctx->timer);
+
+    histogram_push (&ctx->batch_size, zlist_size (batch->jobs));
+    if (flux_stats_enabled (ctx->h, NULL)) {
+        flux_stats_gauge_set (ctx->h, "job-ingest.batch-size",
+                              zlist_size (batch->jobs));
+        flux_stats_count (ctx->h, "job-ingest.batches",
+                          tstat_count (&ctx->batch_size.ts));
+    }
+    if (zlist_append (ctx->inflight, batch) < 0) {
+        batch_respond_error (batch, ENOMEM, "error queuing batch");
+        goto error;
+    }
+    monotime (&batch->t_commit);
     if (!(f = flux_kvs_commit (ctx->h, NULL, 0, batch->txn))) {
         batch_respond_error (batch, errno, "flux_kvs_commit failed");
-        goto error;
+        goto error_inflight;
     }
     if (flux_future_then (f, -1., batch_flush_continuation, batch) < 0) {
         batch_respond_error (batch, errno, "flux_future_then (kvs) failed");
         flux_future_destroy (f);
         if (batch_cleanup (batch, NULL) < 0)
             flux_log_error (ctx->h, "%s: KVS cleanup failure", __FUNCTION__);
-        goto error;
+        goto error_inflight;
     }
+    batch->state = BATCH_COMMITTING;
+    ctx->commits_active++;
     return;
+error_inflight:
+    zlist_remove (ctx->inflight, batch);
 error:
     batch_destroy (batch);
 }
 
-/* batch timer - expires 'batch_timeout' seconds after batch was created.
+/* batch timer - expires when the batch window closes.
+ * If the maximum number of commits are already in flight, defer the flush
+ * until one completes, allowing the batch to keep growing meanwhile.
  */
 static void batch_timer_cb (flux_reactor_t *r,
                             flux_watcher_t *w,
                             int revents,
                             void *arg)
 {
-    batch_flush ((struct job_ingest_ctx *) arg);
+    struct job_ingest_ctx *ctx = arg;
+
+    if (ctx->commits_active >= ctx->max_inflight) {
+        ctx->batch_deferred = true;
+        return;
+    }
+    batch_flush (ctx);
 }
 
 /* Format key within the KVS directory of 'job'.
@@ -512,6 +849,7 @@ static int batch_add_job (struct batch *batch, struct job *job)
     json_t *jobentry;
     json_t *entry = NULL;
     char *entrystr = NULL;
+    const char *sender;
     double t;
 
     if (zlist_append (batch->jobs, job) < 0) {
@@ -556,6 +894,17 @@ static int batch_add_job (struct batch *batch, struct job *job)
                                 "flags", job->flags,
                                 "jobspec", job->jobspec_obj)))
         goto nomem;
+    /* The job manager uses the uuid of the submitting connection to
+     * scope events-watch requests that do not list job ids.
+     */
+    if ((sender = flux_msg_route_first (job->msg))) {
+        json_t *o = json_string (sender);
+        if (!o || json_object_set_new (jobentry, "sender", o) < 0) {
+            json_decref (o);
+            json_decref (jobentry);
+            goto nomem;
+        }
+    }
     if (json_array_append_new (batch->joblist, jobentry) < 0) {
         json_decref (jobentry);
         goto nomem;
@@ -584,12 +933,15 @@ static int ingest_add_job (struct job_ingest_ctx *ctx, struct job *job)
 
     /* Add job to the current "batch" of new jobs, creating the batch if
      * one doesn't exist already.  Submit is finalized upon timer expiration.
+     * If no commits are in flight, don't delay: the timer fires on the next
+     * reactor loop iteration, picking up any requests already received.
      */
     if (!ctx->batch) {
         if (!(ctx->batch = batch_create (ctx)))
             return -1;
         if (!ctx->batch_count) {
-            flux_timer_watcher_reset (ctx->timer, batch_timeout, 0.);
+            double window = ctx->commits_active > 0 ? ctx->batch_window : 0.;
+            flux_timer_watcher_reset (ctx->timer, window, 0.);
             flux_watcher_start (ctx->timer);
         }
     }
@@ -606,8 +958,11 @@ void validate_continuation (flux_future_t *f, void *arg)
 {
     struct job *job = arg;
     struct job_ingest_ctx *ctx = job->ctx;
-    flux_t *h = flux_future_get_flux (f);
     const char *errmsg = NULL;
+    double latency = monotime_since (job->t_validate);
+
+    histogram_push (&ctx->external_latency, latency);
+    flux_stats_timing (ctx->h, "job-ingest.validate.external", latency);
 
     /* If jobspec validation failed, respond immediately to the user.
      */
@@ -622,135 +977,242 @@ void validate_continuation (flux_future_t *f, void *arg)
     flux_future_destroy (f);
     return;
 error:
-    if (flux_respond_error (h, job->msg, errno, errmsg) < 0)
-        flux_log_error (h, "%s: flux_respond_error", __FUNCTION__);
+    job_respond_error (job, errno, errmsg);
     job_destroy (job);
     flux_future_destroy (f);
 }
 
-static int valid_flags (int flags)
+/* Validate decoded jobspec with external validators asynchronously.
+ * Continue submission process in validate_continuation().
+ * On error, set 'errmsg' to an error suitable for the submitting user,
+ * if available.
+ */
+static int validate_external (struct job_ingest_ctx *ctx,
+                              struct job *job,
+                              char *errbuf,
+                              int errbufsz,
+                              const char **errmsg)
 {
-    int allowed = FLUX_JOB_DEBUG | FLUX_JOB_WAITABLE | FLUX_JOB_NOVALIDATE;
-    if ((flags & ~allowed)) {
-        errno = EPROTO;
+    flux_future_t *f = NULL;
+    json_error_t e;
+    json_t *o;
+
+    if (!(o = json_pack_ex (&e, 0,
+                            "{s:O s:i s:i s:i s:i}",
+                            "jobspec", job->jobspec_obj,
+                            "userid", job->cred.userid,
+                            "rolemask", job->cred.rolemask,
+                            "urgency", job->urgency,
+                            "flags", job->flags))) {
+        snprintf (errbuf, errbufsz, "Internal error: %s", e.text);
+        *errmsg = errbuf;
         return -1;
     }
+    monotime (&job->t_validate);
+    if (!(f = validate_job (ctx->validate, o))
+        || flux_future_then (f, -1., validate_continuation, job) < 0)
+        goto error;
+    json_decref (o);
     return 0;
+error:
+    ERRNO_SAFE_WRAP (json_decref, o);
+    ERRNO_SAFE_WRAP (flux_future_destroy, f);
+    return -1;
 }
 
-/* Handle "job-ingest.submit" request to add a new job.
- */
-static void submit_cb (flux_t *h, flux_msg_handler_t *mh,
-                       const flux_msg_t *msg, void *arg)
+void vpool_continuation (flux_future_t *f, void *arg)
 {
-    struct job_ingest_ctx *ctx = arg;
-    struct job *job = NULL;
+    struct job *job = arg;
+    struct job_ingest_ctx *ctx = job->ctx;
     const char *errmsg = NULL;
     char errbuf[256];
-    int64_t userid_signer;
-    const char *mech_type;
-    flux_future_t *f = NULL;
-    json_error_t e;
-    json_t *o = NULL;
+    double latency = monotime_since (job->t_validate);
 
-    if (ctx->shutdown) {
-        errno = ENOSYS;
-        goto error;
-    }
+    histogram_push (&ctx->builtin_latency, latency);
+    flux_stats_timing (ctx->h, "job-ingest.validate.builtin", latency);
 
-    /* Parse request.
+    /* If jobspec validation failed, respond immediately to the user.
      */
-    if (!(job = job_create (msg, ctx)))
+    if (vpool_check_get (f, &job->jobspec_obj) < 0) {
+        errmsg = future_strerror (f, errno);
+        goto error;
+    }
+    if (ctx->validate) {
+        if (validate_external (ctx, job, errbuf, sizeof (errbuf), &errmsg) < 0)
+            goto error;
+    }
+    else if (ingest_add_job (ctx, job) < 0)
         goto error;
+
+    flux_future_destroy (f);
+    return;
+error:
+    job_respond_error (job, errno, errmsg);
+    job_destroy (job);
+    flux_future_destroy (f);
+}
+
+static int valid_flags (int flags)
+{
+    int allowed = FLUX_JOB_DEBUG | FLUX_JOB_WAITABLE | FLUX_JOB_NOVALIDATE;
+    if ((flags & ~allowed)) {
+        errno = EPROTO;
+        return -1;
+    }
+    return 0;
+}
+
+/* Check urgency and flags of a submit or submit-bulk request.
+ * On error, set 'errmsg' to an error suitable for the submitting user.
+ */
+static int check_submit_args (struct flux_msg_cred cred,
+                              int urgency,
+                              int flags,
+                              char *errbuf,
+                              int errbufsz,
+                              const char **errmsg)
+{
     /* Validate submit flags.
      */
-    if (valid_flags (job->flags) < 0)
-        goto error;
-    if (!(job->cred.rolemask & FLUX_ROLE_OWNER)
-        && (job->flags & FLUX_JOB_NOVALIDATE)) {
-        snprintf (errbuf, sizeof (errbuf),
+    if (valid_flags (flags) < 0)
+        return -1;
+    if (!(cred.rolemask & FLUX_ROLE_OWNER)
+        && (flags & FLUX_JOB_NOVALIDATE)) {
+        snprintf (errbuf, errbufsz,
                 "only the instance owner can submit with FLUX_JOB_NOVALIDATE");
-        errmsg = errbuf;
+        *errmsg = errbuf;
         errno = EPERM;
-        goto error;
+        return -1;
     }
     /* Validate requested job urgency.
      */
-    if (job->urgency < FLUX_JOB_URGENCY_MIN
-            || job->urgency > FLUX_JOB_URGENCY_MAX) {
-        snprintf (errbuf, sizeof (errbuf), "urgency range is [%d:%d]",
+    if (urgency < FLUX_JOB_URGENCY_MIN
+            || urgency > FLUX_JOB_URGENCY_MAX) {
+        snprintf (errbuf, errbufsz, "urgency range is [%d:%d]",
                   FLUX_JOB_URGENCY_MIN, FLUX_JOB_URGENCY_MAX);
-        errmsg = errbuf;
+        *errmsg = errbuf;
         errno = EINVAL;
-        goto error;
+        return -1;
     }
-    if (!(job->cred.rolemask & FLUX_ROLE_OWNER)
-           && job->urgency > FLUX_JOB_URGENCY_DEFAULT) {
-        snprintf (errbuf, sizeof (errbuf),
+    if (!(cred.rolemask & FLUX_ROLE_OWNER)
+           && urgency > FLUX_JOB_URGENCY_DEFAULT) {
+        snprintf (errbuf, errbufsz,
                   "only the instance owner can submit with urgency >%d",
                   FLUX_JOB_URGENCY_DEFAULT);
-        errmsg = errbuf;
+        *errmsg = errbuf;
         errno = EINVAL;
-        goto error;
+        return -1;
     }
     /* Only owner can set FLUX_JOB_WAITABLE.
      */
-    if (!(job->cred.rolemask & FLUX_ROLE_OWNER)
-            && (job->flags & FLUX_JOB_WAITABLE)) {
+    if (!(cred.rolemask & FLUX_ROLE_OWNER)
+            && (flags & FLUX_JOB_WAITABLE)) {
         snprintf (errbuf,
-                  sizeof (errbuf),
+                  errbufsz,
                   "only the instance onwer can submit with FLUX_JOB_WAITABLE");
-        errmsg = errbuf;
+        *errmsg = errbuf;
         errno = EINVAL;
-        goto error;
+        return -1;
     }
-    /* Validate jobspec signature, and unwrap(J) -> jobspec,  jobspecsz.
-     * Userid claimed by signature must match authenticated job->cred.userid.
-     * If not the instance owner, a strong signature is required
-     * to give the IMP permission to launch processes on behalf of the user.
-     */
+    return 0;
+}
+
+/* Validate signature of 'J', and unwrap(J) -> payload, payloadsz.
+ * The payload is a copy which the caller must free.
+ * Userid claimed by signature must match authenticated cred.userid.
+ * If not the instance owner, a strong signature is required
+ * to give the IMP permission to launch processes on behalf of the user.
+ */
+static int unwrap_signed (struct job_ingest_ctx *ctx,
+                          const char *J,
+                          struct flux_msg_cred cred,
+                          char **payload,
+                          int *payloadsz,
+                          char *errbuf,
+                          int errbufsz,
+                          const char **errmsg)
+{
+    int64_t userid_signer;
+    const char *mech_type;
+    char *buf = NULL;
+    int bufsz;
 #if HAVE_FLUX_SECURITY
-    const void *jobspec;
-    if (flux_sign_unwrap_anymech (ctx->sec, job->J, &jobspec, &job->jobspecsz,
+    const void *data;
+    if (flux_sign_unwrap_anymech (ctx->sec, J, &data, &bufsz,
                                   &mech_type, &userid_signer,
                                   FLUX_SIGN_NOVERIFY) < 0) {
-        errmsg = flux_security_last_error (ctx->sec);
-        goto error;
+        *errmsg = flux_security_last_error (ctx->sec);
+        return -1;
     }
-    if (!(job->jobspec = malloc (job->jobspecsz)))
-        goto error;
-    memcpy (job->jobspec, jobspec, job->jobspecsz);
+    if (!(buf = malloc (bufsz)))
+        return -1;
+    memcpy (buf, data, bufsz);
 #else
     uint32_t userid_signer_u32;
     /* Simplified unwrap only understands mech=none.
      * Unlike flux-security version, returned payload must be freed,
      * and returned userid is a uint32_t.
      */
-    if (sign_none_unwrap (job->J, (void **)&job->jobspec, &job->jobspecsz,
-                          &userid_signer_u32) < 0) {
-        errmsg = "could not unwrap jobspec";
-        goto error;
+    if (sign_none_unwrap (J, (void **)&buf, &bufsz, &userid_signer_u32) < 0) {
+        *errmsg = "could not unwrap jobspec";
+        return -1;
     }
     mech_type = "none";
     userid_signer = userid_signer_u32;
 #endif
-    if (userid_signer != job->cred.userid) {
-        snprintf (errbuf, sizeof (errbuf),
+    if (userid_signer != cred.userid) {
+        snprintf (errbuf, errbufsz,
                   "signer=%lu != requestor=%lu",
                   (unsigned long)userid_signer,
-                  (unsigned long)job->cred.userid);
-        errmsg = errbuf;
+                  (unsigned long)cred.userid);
+        *errmsg = errbuf;
         errno = EPERM;
         goto error;
     }
-    if (!(job->cred.rolemask & FLUX_ROLE_OWNER)
+    if (!(cred.rolemask & FLUX_ROLE_OWNER)
                                 && !strcmp (mech_type, "none")) {
-        snprintf (errbuf, sizeof (errbuf),
+        snprintf (errbuf, errbufsz,
                   "only instance owner can use sign-type=none");
-        errmsg = errbuf;
+        *errmsg = errbuf;
         errno = EPERM;
         goto error;
     }
+    *payload = buf;
+    *payloadsz = bufsz;
+    return 0;
+error:
+    ERRNO_SAFE_WRAP (free, buf);
+    return -1;
+}
+
+/* Decode and validate jobspec, then add job to the current batch.
+ * Validation may continue asynchronously in vpool_continuation()
+ * or validate_continuation().
+ * On error, set 'errmsg' to an error suitable for the submitting user,
+ * if available.
+ */
+static int job_ingest (struct job_ingest_ctx *ctx,
+                       struct job *job,
+                       char *errbuf,
+                       int errbufsz,
+                       const char **errmsg)
+{
+    flux_future_t *f;
+    json_error_t e;
+
+    if (ctx->vpool && !(job->flags & FLUX_JOB_NOVALIDATE)) {
+        /* Decode and validate jobspec on the builtin validator pool.
+         * Continue submission process in vpool_continuation().
+         */
+        monotime (&job->t_validate);
+        if (!(f = vpool_check (ctx->vpool, job->jobspec, job->jobspecsz)))
+            return -1;
+        if (flux_future_then (f, -1., vpool_continuation, job) < 0) {
+            ERRNO_SAFE_WRAP (flux_future_destroy, f);
+            return -1;
+        }
+        return 0;
+    }
     /* Decode jobspec, returning detailed parse errors to the user.
      * N.B. fails if jobspec was submitted as YAML.
      */
@@ -758,41 +1220,202 @@ static void submit_cb (flux_t *h, flux_msg_handler_t *mh,
                                          job->jobspecsz,
                                          0,
                                          &e))) {
-        snprintf (errbuf, sizeof (errbuf), "jobspec: invalid JSON: %s", e.text);
-        errmsg = errbuf;
+        snprintf (errbuf, errbufsz, "jobspec: invalid JSON: %s", e.text);
+        *errmsg = errbuf;
         errno = EINVAL;
+        return -1;
+    }
+    if (ctx->validate && !(job->flags & FLUX_JOB_NOVALIDATE))
+        return validate_external (ctx, job, errbuf, errbufsz, errmsg);
+    return ingest_add_job (ctx, job);
+}
+
+/* Handle "job-ingest.submit" request to add a new job.
+ */
+static void submit_cb (flux_t *h, flux_msg_handler_t *mh,
+                       const flux_msg_t *msg, void *arg)
+{
+    struct job_ingest_ctx *ctx = arg;
+    struct job *job = NULL;
+    const char *errmsg = NULL;
+    char errbuf[256];
+
+    if (ctx->shutdown) {
+        errno = ENOSYS;
         goto error;
     }
-    if (ctx->validate && !(job->flags & FLUX_JOB_NOVALIDATE)) {
-        /* Validate jobspec asynchronously.
-         * Continue submission process in validate_continuation().
-         */
-        if (!(o = json_pack_ex (&e, 0,
-                                "{s:O s:i s:i s:i s:i}",
-                                "jobspec", job->jobspec_obj,
-                                "userid", job->cred.userid,
-                                "rolemask", job->cred.rolemask,
-                                "urgency", job->urgency,
-                                "flags", job->flags))) {
-            snprintf (errbuf, sizeof (errbuf), "Internal error: %s", e.text);
-            errmsg = errbuf;
+
+    /* Parse request.
+     */
+    if (!(job = job_create (msg, ctx)))
+        goto error;
+    if (check_submit_args (job->cred,
+                           job->urgency,
+                           job->flags,
+                           errbuf,
+                           sizeof (errbuf),
+                           &errmsg) < 0)
+        goto error;
+    if (unwrap_signed (ctx,
+                       job->J,
+                       job->cred,
+                       &job->jobspec,
+                       &job->jobspecsz,
+                       errbuf,
+                       sizeof (errbuf),
+                       &errmsg) < 0)
+        goto error;
+    if (job_ingest (ctx, job, errbuf, sizeof (errbuf), &errmsg) < 0)
+        goto error;
+    return;
+error:
+    if (flux_respond_error (h, msg, errno, errmsg) < 0)
+        flux_log_error (h, "%s: flux_respond_error", __FUNCTION__);
+    job_destroy (job);
+}
+
+/* Set up job from entry 'value' of a submit-bulk request.  The entry is
+ * a signed jobspec, or with a shared signature, an unsigned jobspec,
+ * in which case a per-job J is created with sign-type=none.
+ */
+static int job_setup_bulk (struct job_ingest_ctx *ctx,
+                           struct job *job,
+                           json_t *value,
+                           bool shared,
+                           char *errbuf,
+                           int errbufsz,
+                           const char **errmsg)
+{
+    const char *s;
+
+    if (!(s = json_string_value (value))) {
+        *errmsg = "job-ingest.submit-bulk jobs should be strings";
+        errno = EPROTO;
+        return -1;
+    }
+    if (shared) {
+        job->jobspecsz = strlen (s);
+        if (!(job->jobspec = strdup (s))
+            || !(job->J_buf = sign_none_wrap (s,
+                                              job->jobspecsz,
+                                              job->cred.userid)))
+            return -1;
+        job->J = job->J_buf;
+        return 0;
+    }
+    job->J = s;
+    return unwrap_signed (ctx,
+                          job->J,
+                          job->cred,
+                          &job->jobspec,
+                          &job->jobspecsz,
+                          errbuf,
+                          errbufsz,
+                          errmsg);
+}
+
+/* Handle "job-ingest.submit-bulk" request to add many jobs.
+ */
+static void submit_bulk_cb (flux_t *h, flux_msg_handler_t *mh,
+                            const flux_msg_t *msg, void *arg)
+{
+    struct job_ingest_ctx *ctx = arg;
+    struct flux_msg_cred cred;
+    struct bulk *bulk;
+    const char *errmsg = NULL;
+    char errbuf[256];
+    json_t *jobs = NULL;
+    const char *J = NULL;
+    char *payload = NULL;
+    int payloadsz;
+    json_t *shared = NULL;
+    int urgency;
+    int flags;
+    size_t index;
+    json_t *value;
+
+    if (ctx->shutdown) {
+        errno = ENOSYS;
+        goto error;
+    }
+    if (flux_request_unpack (msg, NULL, "{s?o s?s s:i s:i}",
+                             "jobs", &jobs,
+                             "J", &J,
+                             "urgency", &urgency,
+                             "flags", &flags) < 0
+        || flux_msg_get_cred (msg, &cred) < 0)
+        goto error;
+    if (check_submit_args (cred,
+                           urgency,
+                           flags,
+                           errbuf,
+                           sizeof (errbuf),
+                           &errmsg) < 0)
+        goto error;
+    /* A shared signature covers a json array of jobspec strings.
+     */
+    if (J) {
+        json_error_t e;
+
+        if (!(cred.rolemask & FLUX_ROLE_OWNER)) {
+            errmsg = "only the instance owner can submit with"
+                     " a shared signature";
+            errno = EPERM;
             goto error;
         }
-        if (!(f = validate_job (ctx->validate, o)))
+        if (unwrap_signed (ctx,
+                           J,
+                           cred,
+                           &payload,
+                           &payloadsz,
+                           errbuf,
+                           sizeof (errbuf),
+                           &errmsg) < 0)
             goto error;
-        if (flux_future_then (f, -1., validate_continuation, job) < 0)
+        if (!(shared = json_loadb (payload, payloadsz, 0, &e))) {
+            snprintf (errbuf, sizeof (errbuf), "invalid JSON: %s", e.text);
+            errmsg = errbuf;
+            errno = EPROTO;
             goto error;
-        json_decref (o);
+        }
+        jobs = shared;
     }
-    else if (ingest_add_job (ctx, job) < 0)
+    if (!jobs || !json_is_array (jobs)) {
+        errmsg = "job-ingest.submit-bulk requires an array of jobs";
+        errno = EPROTO;
         goto error;
+    }
+    if (!(bulk = bulk_create (msg, json_array_size (jobs))))
+        goto error;
+    json_array_foreach (jobs, index, value) {
+        struct job *job;
+
+        errmsg = NULL;
+        if (!(job = job_create_bulk (bulk, index, cred, urgency, flags, ctx))) {
+            bulk_set_error (h, bulk, index, errno, NULL);
+            continue;
+        }
+        if (job_setup_bulk (ctx,
+                            job,
+                            value,
+                            shared ? true : false,
+                            errbuf,
+                            sizeof (errbuf),
+                            &errmsg) < 0
+            || job_ingest (ctx, job, errbuf, sizeof (errbuf), &errmsg) < 0) {
+            job_respond_error (job, errno, errmsg);
+            job_destroy (job);
+        }
+    }
+    bulk_release (h, bulk);
+    json_decref (shared);
+    free (payload);
     return;
 error:
-    json_decref (o);
     if (flux_respond_error (h, msg, errno, errmsg) < 0)
         flux_log_error (h, "%s: flux_respond_error", __FUNCTION__);
-    job_destroy (job);
-    flux_future_destroy (f);
+    json_decref (shared);
+    free (payload);
 }
 
 static void exit_cb (void *arg)
@@ -865,9 +1488,69 @@ error:
         flux_log_error (h, "%s: flux_respond_error", __FUNCTION__);
 }
 
+static void stats_cb (flux_t *h,
+                      flux_msg_handler_t *mh,
+                      const flux_msg_t *msg,
+                      void *arg)
+{
+    struct job_ingest_ctx *ctx = arg;
+    json_t *builtin = NULL;
+    json_t *external = NULL;
+    json_t *size = NULL;
+    json_t *commit = NULL;
+
+    if (!(builtin = histogram_tojson (&ctx->builtin_latency, "histogram-ms"))
+        || !(external = histogram_tojson (&ctx->external_latency,
+                                          "histogram-ms"))
+        || !(size = histogram_tojson (&ctx->batch_size, "histogram"))
+        || !(commit = histogram_tojson (&ctx->commit_latency_ms,
+                                        "histogram-ms"))) {
+        errno = ENOMEM;
+        goto error;
+    }
+    if (flux_respond_pack (h,
+                           msg,
+                           "{s:{s:b s:b s:i s:O s:O}"
+                           " s:{s:f s:f s:i s:i s:i s:O s:O}}",
+                           "validate",
+                           "builtin-enabled", ctx->vpool ? 1 : 0,
+                           "external-enabled", ctx->validate ? 1 : 0,
+                           "builtin-wake-errors",
+                           vpool_wake_errors (ctx->vpool),
+                           "builtin", builtin,
+                           "external", external,
+                           "batch",
+                           "window-ms", ctx->batch_window * 1000.,
+                           "commit-latency-avg-ms", ctx->commit_latency * 1000.,
+                           "commits-active", ctx->commits_active,
+                           "max-inflight", ctx->max_inflight,
+                           "pending", (int)zlist_size (ctx->inflight),
+                           "size", size,
+                           "commit-latency", commit) < 0)
+        flux_log_error (h, "%s: flux_respond_pack", __FUNCTION__);
+    json_decref (builtin);
+    json_decref (external);
+    json_decref (size);
+    json_decref (commit);
+    return;
+error:
+    if (flux_respond_error (h, msg, errno, NULL) < 0)
+        flux_log_error (h, "%s: flux_respond_error", __FUNCTION__);
+    json_decref (builtin);
+    json_decref (external);
+    json_decref (size);
+    json_decref (commit);
+}
+
 static const struct flux_msg_handler_spec htab[] = {
     { FLUX_MSGTYPE_REQUEST,  "job-ingest.getinfo", getinfo_cb, 0},
+    { FLUX_MSGTYPE_REQUEST,  "job-ingest.stats.get", stats_cb, 0 },
     { FLUX_MSGTYPE_REQUEST,  "job-ingest.submit", submit_cb, FLUX_ROLE_USER },
+    { FLUX_MSGTYPE_REQUEST,
+      "job-ingest.submit-bulk",
+      submit_bulk_cb,
+      FLUX_ROLE_USER
+    },
     { FLUX_MSGTYPE_REQUEST,  "job-ingest.shutdown", shutdown_cb, 0 },
     FLUX_MSGHANDLER_TABLE_END,
 };
@@ -880,13 +1563,34 @@ int job_ingest_ctx_init (struct job_ingest_ctx *ctx,
     flux_reactor_t *r = flux_get_reactor (h);
     const char *usage_message =
         "Usage: flux module load [OPTIONS] job-ingest"
-        " [validator-plugins=LIST] [validator-args=ARGS]";
+        " [validator-plugins=LIST] [validator-args=ARGS]"
+        " [builtin-validator] [builtin-validator-threads=N]"
+        " [batch-count=N] [batch-max-inflight=N]";
     const char *plugins = NULL;
     const char *valargs = NULL;
     bool use_validator = true;
+    bool use_builtin = false;
+    int builtin_threads = default_validator_threads;
 
     memset (ctx, 0, sizeof (*ctx));
     ctx->h = h;
+    ctx->max_inflight = default_max_inflight;
+    histogram_init (&ctx->builtin_latency,
+                    latency_bucket,
+                    LATENCY_BUCKETS);
+    histogram_init (&ctx->external_latency,
+                    latency_bucket,
+                    LATENCY_BUCKETS);
+    histogram_init (&ctx->commit_latency_ms,
+                    latency_bucket,
+                    LATENCY_BUCKETS);
+    histogram_init (&ctx->batch_size,
+                    batch_size_bucket,
+                    BATCH_SIZE_BUCKETS);
+    if (!(ctx->inflight = zlist_new ())) {
+        errno = ENOMEM;
+        return -1;
+    }
 
     /*  Process cmdline args */
     for (int i = 0; i < argc; i++) {
@@ -904,9 +1608,33 @@ int job_ingest_ctx_init (struct job_ingest_ctx *ctx,
                 return -1;
             }
         }
+        else if (!strncmp (argv[i], "batch-max-inflight=", 19)) {
+            char *endptr;
+            ctx->max_inflight = strtol (argv[i]+19, &endptr, 0);
+            if (*endptr != '\0' || ctx->max_inflight < 1) {
+                flux_log (h, LOG_ERR,
+                          "Invalid batch-max-inflight: %s", argv[i]);
+                errno = EINVAL;
+                return -1;
+            }
+        }
         else if (!strcmp (argv[i], "disable-validator")) {
             use_validator = false;
         }
+        else if (!strcmp (argv[i], "builtin-validator")) {
+            use_builtin = true;
+        }
+        else if (!strncmp (argv[i], "builtin-validator-threads=", 26)) {
+            char *endptr;
+            builtin_threads = strtol (argv[i]+26, &endptr, 0);
+            if (*endptr != '\0' || builtin_threads < 1) {
+                flux_log (h, LOG_ERR,
+                          "Invalid builtin-validator-threads: %s", argv[i]);
+                errno = EINVAL;
+                return -1;
+            }
+            use_builtin = true;
+        }
         else {
             flux_log (h, LOG_ERR, "invalid option %s", argv[i]);
             flux_log (h, LOG_ERR, "%s", usage_message);
@@ -914,6 +1642,17 @@ int job_ingest_ctx_init (struct job_ingest_ctx *ctx,
             return -1;
         }
     }
+    if (use_validator && use_builtin) {
+        if (!(ctx->vpool = vpool_create (h, builtin_threads))) {
+            flux_log_error (h, "vpool_create");
+            return -1;
+        }
+        /* External validators supplement the builtin validator only
+         * if explicitly configured.
+         */
+        if (!plugins)
+            use_validator = false;
+    }
     if (use_validator &&
         !(ctx->validate = validate_create (h, plugins, valargs))) {
         flux_log_error (h, "validate_create");
@@ -1029,9 +1768,11 @@ done:
     flux_msg_handler_delvec (ctx.handlers);
     flux_watcher_destroy (ctx.timer);
     flux_watcher_destroy (ctx.shutdown_timer);
+    zlist_destroy (&ctx.inflight);
 #if HAVE_FLUX_SECURITY
     flux_security_destroy (ctx.sec);
 #endif
+    vpool_destroy (ctx.vpool);
     validate_destroy (ctx.validate);
     return rc;
 }
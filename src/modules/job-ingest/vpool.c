@@ -0,0 +1,367 @@
+/************************************************************\
+ * Copyright 2021 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+/* vpool - in-process jobspec validation on a thread pool
+ *
+ * Jobspec is decoded and checked with flux_jobspec1_check() on one of
+ * a fixed number of threads, so a burst of submissions is not
+ * serialized behind the reactor, or behind validator processes.
+ *
+ * Requests are handed to the threads on a queue protected by a mutex.
+ * Completed requests are moved to a second queue, and a byte is
+ * written to a pipe watched by the reactor, which then fulfills the
+ * futures.  Only the reactor thread touches futures.
+ *
+ * The future is fulfilled with the decoded jobspec object on success.
+ * On failure, the reason the job did not pass validation is assigned
+ * to the future's extended error string.
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <unistd.h>
+#include <string.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <jansson.h>
+#include <flux/core.h>
+
+#include "src/common/libutil/errno_safe.h"
+#include "src/common/libjob/jobspec1_private.h"
+
+#include "vpool.h"
+
+struct vpool_req {
+    struct vpool_req *next;
+    int refcount;           // future and pool each hold a reference
+    flux_future_t *f;       // NULL if future was destroyed
+    char *jobspec;
+    int jobspecsz;
+    json_t *obj;
+    int errnum;
+    char errbuf[256];
+};
+
+struct req_queue {
+    struct vpool_req *head;
+    struct vpool_req *tail;
+};
+
+struct vpool {
+    flux_t *h;
+    pthread_t *threads;
+    int nthreads;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    struct req_queue pending;
+    struct req_queue done;
+    bool shutdown;
+    int fds[2];
+    int wake_errors;
+    flux_watcher_t *w;
+};
+
+static void req_queue_push (struct req_queue *q, struct vpool_req *req)
+{
+    req->next = NULL;
+    if (q->tail)
+        q->tail->next = req;
+    else
+        q->head = req;
+    q->tail = req;
+}
+
+static struct vpool_req *req_queue_pop (struct req_queue *q)
+{
+    struct vpool_req *req = q->head;
+    if (req) {
+        q->head = req->next;
+        if (!q->head)
+            q->tail = NULL;
+        req->next = NULL;
+    }
+    return req;
+}
+
+static void req_decref (struct vpool_req *req)
+{
+    if (req && --req->refcount == 0) {
+        int saved_errno = errno;
+        free (req->jobspec);
+        json_decref (req->obj);
+        free (req);
+        errno = saved_errno;
+    }
+}
+
+/* Future aux destructor: the future no longer exists, so the pool
+ * must not fulfill it.
+ */
+static void req_future_destroyed (void *arg)
+{
+    struct vpool_req *req = arg;
+    req->f = NULL;
+    req_decref (req);
+}
+
+/* Fail the future of a request that will not be checked, e.g. because
+ * the pool is being destroyed, and drop the pool's reference.
+ */
+static void req_cancel (struct vpool_req *req)
+{
+    if (req->f)
+        flux_future_fulfill_error (req->f, ECANCELED, NULL);
+    req_decref (req);
+}
+
+static void json_decref_wrapper (void *arg)
+{
+    json_decref (arg);
+}
+
+/* Runs on a pool thread.  Only 'req' is accessed.
+ */
+static void req_check (struct vpool_req *req)
+{
+    flux_jobspec1_t *jobspec = NULL;
+    flux_jobspec1_error_t error;
+    json_error_t e;
+
+    if (!(req->obj = json_loadb (req->jobspec, req->jobspecsz, 0, &e))) {
+        snprintf (req->errbuf, sizeof (req->errbuf),
+                  "jobspec: invalid JSON: %s", e.text);
+        req->errnum = EINVAL;
+        return;
+    }
+    if (!(jobspec = jobspec1_from_json (req->obj))) {
+        req->errnum = errno;
+        return;
+    }
+    if (flux_jobspec1_check (jobspec, &error) < 0) {
+        snprintf (req->errbuf, sizeof (req->errbuf), "%s", error.text);
+        req->errnum = EINVAL;
+    }
+    flux_jobspec1_destroy (jobspec);
+}
+
+static void *vpool_thread (void *arg)
+{
+    struct vpool *vp = arg;
+    struct vpool_req *req;
+    char c = 0;
+
+    pthread_mutex_lock (&vp->lock);
+    for (;;) {
+        while (!vp->shutdown && !vp->pending.head)
+            pthread_cond_wait (&vp->cond, &vp->lock);
+        if (vp->shutdown)
+            break;
+        req = req_queue_pop (&vp->pending);
+        pthread_mutex_unlock (&vp->lock);
+
+        req_check (req);
+
+        pthread_mutex_lock (&vp->lock);
+        /* Wake the reactor on the transition to non-empty.  The pipe
+         * can only be full if the reactor is already due to run
+         * vpool_done_cb(), so a failed write is harmless.  The flux
+         * handle is not thread safe, so it is not logged.
+         */
+        if (!vp->done.head && write (vp->fds[1], &c, 1) < 0)
+            vp->wake_errors++;
+        req_queue_push (&vp->done, req);
+    }
+    pthread_mutex_unlock (&vp->lock);
+    return NULL;
+}
+
+/* Reactor callback: fulfill futures for completed requests.
+ */
+static void vpool_done_cb (flux_reactor_t *r,
+                           flux_watcher_t *w,
+                           int revents,
+                           void *arg)
+{
+    struct vpool *vp = arg;
+    struct req_queue done;
+    struct vpool_req *req;
+    char buf[64];
+
+    while (read (vp->fds[0], buf, sizeof (buf)) > 0)
+        ;
+    pthread_mutex_lock (&vp->lock);
+    done = vp->done;
+    vp->done.head = vp->done.tail = NULL;
+    pthread_mutex_unlock (&vp->lock);
+
+    while ((req = req_queue_pop (&done))) {
+        if (req->f) {
+            if (req->errnum)
+                flux_future_fulfill_error (req->f,
+                                           req->errnum,
+                                           req->errbuf[0] ? req->errbuf
+                                                          : NULL);
+            else {
+                flux_future_fulfill (req->f,
+                                     req->obj,
+                                     json_decref_wrapper);
+                req->obj = NULL;
+            }
+        }
+        req_decref (req);
+    }
+}
+
+flux_future_t *vpool_check (struct vpool *vp,
+                            const char *jobspec,
+                            int jobspecsz)
+{
+    struct vpool_req *req;
+    flux_future_t *f = NULL;
+
+    if (!vp || !jobspec || jobspecsz < 0) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if (!(req = calloc (1, sizeof (*req))))
+        return NULL;
+    req->refcount = 1;
+    if (!(req->jobspec = malloc (jobspecsz)))
+        goto error;
+    memcpy (req->jobspec, jobspec, jobspecsz);
+    req->jobspecsz = jobspecsz;
+    if (!(f = flux_future_create (NULL, NULL)))
+        goto error;
+    flux_future_set_flux (f, vp->h);
+    if (flux_future_aux_set (f, "vpool::req", req, req_future_destroyed) < 0)
+        goto error;
+    req->f = f;
+    req->refcount++;
+
+    pthread_mutex_lock (&vp->lock);
+    req_queue_push (&vp->pending, req);
+    pthread_cond_signal (&vp->cond);
+    pthread_mutex_unlock (&vp->lock);
+    return f;
+error:
+    flux_future_destroy (f);
+    req_decref (req);
+    return NULL;
+}
+
+int vpool_wake_errors (struct vpool *vp)
+{
+    int count;
+
+    if (!vp)
+        return 0;
+    pthread_mutex_lock (&vp->lock);
+    count = vp->wake_errors;
+    pthread_mutex_unlock (&vp->lock);
+    return count;
+}
+
+int vpool_check_get (flux_future_t *f, json_t **jobspec_obj)
+{
+    const void *result;
+
+    if (flux_future_get (f, &result) < 0)
+        return -1;
+    if (jobspec_obj)
+        *jobspec_obj = json_incref ((json_t *)result);
+    return 0;
+}
+
+void vpool_destroy (struct vpool *vp)
+{
+    if (vp) {
+        int saved_errno = errno;
+        struct vpool_req *req;
+        int i;
+
+        if (vp->threads) {
+            pthread_mutex_lock (&vp->lock);
+            vp->shutdown = true;
+            pthread_cond_broadcast (&vp->cond);
+            pthread_mutex_unlock (&vp->lock);
+            for (i = 0; i < vp->nthreads; i++)
+                pthread_join (vp->threads[i], NULL);
+            free (vp->threads);
+        }
+        /* Threads are gone.  Fail futures of requests that were not
+         * handed back to the reactor, and drop the pool's reference.
+         */
+        while ((req = req_queue_pop (&vp->pending)))
+            req_cancel (req);
+        while ((req = req_queue_pop (&vp->done)))
+            req_cancel (req);
+        flux_watcher_destroy (vp->w);
+        if (vp->fds[0] >= 0)
+            close (vp->fds[0]);
+        if (vp->fds[1] >= 0)
+            close (vp->fds[1]);
+        pthread_cond_destroy (&vp->cond);
+        pthread_mutex_destroy (&vp->lock);
+        free (vp);
+        errno = saved_errno;
+    }
+}
+
+struct vpool *vpool_create (flux_t *h, int nthreads)
+{
+    struct vpool *vp;
+    int e;
+
+    if (nthreads < 1) {
+        errno = EINVAL;
+        return NULL;
+    }
+    if (!(vp = calloc (1, sizeof (*vp))))
+        return NULL;
+    vp->h = h;
+    vp->fds[0] = vp->fds[1] = -1;
+    pthread_mutex_init (&vp->lock, NULL);
+    pthread_cond_init (&vp->cond, NULL);
+    if (pipe2 (vp->fds, O_CLOEXEC | O_NONBLOCK) < 0)
+        goto error;
+    if (!(vp->w = flux_fd_watcher_create (flux_get_reactor (h),
+                                          vp->fds[0],
+                                          FLUX_POLLIN,
+                                          vpool_done_cb,
+                                          vp)))
+        goto error;
+    flux_watcher_start (vp->w);
+
+    /* Seed the jansson hash function before threads decode objects
+     * concurrently.
+     */
+    json_object_seed (0);
+
+    if (!(vp->threads = calloc (nthreads, sizeof (vp->threads[0]))))
+        goto error;
+    for (vp->nthreads = 0; vp->nthreads < nthreads; vp->nthreads++) {
+        if ((e = pthread_create (&vp->threads[vp->nthreads],
+                                 NULL,
+                                 vpool_thread,
+                                 vp))) {
+            errno = e;
+            goto error;
+        }
+    }
+    return vp;
+error:
+    ERRNO_SAFE_WRAP (vpool_destroy, vp);
+    return NULL;
+}
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
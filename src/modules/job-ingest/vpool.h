@@ -0,0 +1,47 @@
+/************************************************************\
+ * Copyright 2021 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+#ifndef _JOB_INGEST_VPOOL_H
+#define _JOB_INGEST_VPOOL_H
+
+#include <flux/core.h>
+#include <jansson.h>
+
+struct vpool;
+
+/* Decode jobspec and check it against jobspec version 1 on a pool
+ * thread.  'jobspec' need not be \0 terminated and is copied.
+ * Future is fulfilled once the check is complete.
+ */
+flux_future_t *vpool_check (struct vpool *vp,
+                            const char *jobspec,
+                            int jobspecsz);
+
+/* Get the decoded jobspec object from a successful check.
+ * The caller must json_decref() the returned object.
+ */
+int vpool_check_get (flux_future_t *f, json_t **jobspec_obj);
+
+/* Return the number of times a pool thread failed to wake the reactor.
+ */
+int vpool_wake_errors (struct vpool *vp);
+
+struct vpool *vpool_create (flux_t *h, int nthreads);
+
+/* Destroy the pool.  Futures of checks that have not completed are
+ * fulfilled with ECANCELED.
+ */
+void vpool_destroy (struct vpool *vp);
+
+#endif /* !_JOB_INGEST_VPOOL_H */
+
+/*
+ * vi:tabstop=4 shiftwidth=4 expandtab
+ */
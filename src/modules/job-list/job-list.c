@@ -29,14 +29,30 @@ static void stats_cb (flux_t *h, flux_msg_handler_t *mh,
     int inactive = zlistx_size (ctx->jsctx->inactive);
     int idsync_lookups = zlistx_size (ctx->idsync_lookups);
     int idsync_waits = zhashx_size (ctx->idsync_waits);
-    if (flux_respond_pack (h, msg, "{s:{s:i s:i s:i} s:{s:i s:i}}",
+    int njobs = zhashx_size (ctx->jsctx->index);
+    size_t string_bytes = strpool_bytes (ctx->jsctx->strings);
+    int strings = strpool_count (ctx->jsctx->strings);
+    double per_job = 0.;
+
+    /* approximate, annotations and dependencies are not counted */
+    if (njobs > 0)
+        per_job = sizeof (struct job) + (double)string_bytes / njobs;
+
+    if (flux_respond_pack (h, msg,
+                           "{s:{s:i s:i s:i} s:{s:i s:i}"
+                           " s:{s:i s:i s:I s:f}}",
                            "jobs",
                            "pending", pending,
                            "running", running,
                            "inactive", inactive,
                            "idsync",
                            "lookups", idsync_lookups,
-                           "waits", idsync_waits) < 0) {
+                           "waits", idsync_waits,
+                           "memory",
+                           "job_size", (int)sizeof (struct job),
+                           "strings", strings,
+                           "string_bytes", (json_int_t)string_bytes,
+                           "bytes_per_job", per_job) < 0) {
         flux_log_error (h, "%s: flux_respond_pack", __FUNCTION__);
         goto error;
     }
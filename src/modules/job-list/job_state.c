@@ -13,6 +13,7 @@
 #if HAVE_CONFIG_H
 #include "config.h"
 #endif
+#include <stddef.h>
 #include <jansson.h>
 #include <assert.h>
 #include <flux/core.h>
@@ -92,39 +93,82 @@ static int job_urgency_cmp (const void *a1, const void *a2)
     return rc;
 }
 
+/* A job that reaches CLEANUP without running is placed on the
+ * running list by the time it entered CLEANUP.
+ */
+static double job_running_time (const struct job *job)
+{
+    return job->t_run > 0. ? job->t_run : job->t_cleanup;
+}
+
 /* Compare items for sorting in list by timestamp (note that sorting
  * is in reverse order, most recently (i.e. bigger timestamp)
- * running/completed comes first).  N.B. zlistx_comparator_fn
- * signature
+ * running/completed comes first), job id (bigger first) second, so
+ * that a position in the list can be described by (timestamp, id).
+ * N.B. zlistx_comparator_fn signature
  */
 static int job_running_cmp (const void *a1, const void *a2)
 {
     const struct job *j1 = a1;
     const struct job *j2 = a2;
+    int rc;
 
-    return NUMCMP (j2->t_run, j1->t_run);
+    if ((rc = NUMCMP (job_running_time (j2), job_running_time (j1))) == 0)
+        rc = NUMCMP (j2->id, j1->id);
+    return rc;
 }
 
 static int job_inactive_cmp (const void *a1, const void *a2)
 {
     const struct job *j1 = a1;
     const struct job *j2 = a2;
+    int rc;
+
+    if ((rc = NUMCMP (j2->t_inactive, j1->t_inactive)) == 0)
+        rc = NUMCMP (j2->id, j1->id);
+    return rc;
+}
+
+int job_list_cmp (int state, const struct job *j1, const struct job *j2)
+{
+    if (state == FLUX_JOB_STATE_PENDING)
+        return job_urgency_cmp (j1, j2);
+    else if (state == FLUX_JOB_STATE_RUNNING)
+        return job_running_cmp (j1, j2);
+    return job_inactive_cmp (j1, j2);
+}
 
-    return NUMCMP (j2->t_inactive, j1->t_inactive);
+double job_list_key (int state, const struct job *job)
+{
+    if (state == FLUX_JOB_STATE_PENDING)
+        return job->priority;
+    else if (state == FLUX_JOB_STATE_RUNNING)
+        return job_running_time (job);
+    return job->t_inactive;
+}
+
+void job_list_key_set (int state, struct job *job, double key)
+{
+    if (state == FLUX_JOB_STATE_PENDING)
+        job->priority = key;
+    else if (state == FLUX_JOB_STATE_RUNNING)
+        job->t_run = key;
+    else
+        job->t_inactive = key;
 }
 
 static void job_destroy (void *data)
 {
     struct job *job = data;
     if (job) {
-        json_decref (job->exception_context);
+        struct strpool *sp = job->ctx->jsctx->strings;
         json_decref (job->annotations);
-        json_decref (job->jobspec_job);
-        json_decref (job->jobspec_cmd);
-        json_decref (job->R);
         grudgeset_destroy (job->dependencies);
-        free (job->ranks);
-        free (job->nodelist);
+        strpool_release (sp, job->name);
+        strpool_release (sp, job->ranks);
+        strpool_release (sp, job->nodelist);
+        strpool_release (sp, job->exception_type);
+        strpool_release (sp, job->exception_note);
         zlist_destroy (&job->next_states);
         free (job);
     }
@@ -163,6 +207,21 @@ static struct job *job_create (struct list_ctx *ctx, flux_jobid_t id)
     return job;
 }
 
+/* Replace the interned string at 'dst' with an interned copy of 's'.
+ * 's' may be NULL.  Returns -1 with errno set on error.
+ */
+static int job_set_string (struct job *job, const char **dst, const char *s)
+{
+    struct strpool *sp = job->ctx->jsctx->strings;
+    const char *new = NULL;
+
+    if (s && !(new = strpool_intern (sp, s)))
+        return -1;
+    strpool_release (sp, *dst);
+    *dst = new;
+    return 0;
+}
+
 static void json_decref_wrapper (void **data)
 {
     if (data) {
@@ -219,16 +278,213 @@ static void revert_job_state (struct list_ctx *ctx,
     }
 }
 
+/* Hash numerical userid in 'key'.
+ * N.B. zhashx_hash_fn signature
+ */
+static size_t userid_hasher (const void *key)
+{
+    const uint32_t *userid = key;
+    return *userid;
+}
+
+/* Compare hash keys.
+ * N.B. zhashx_comparator_fn signature
+ */
+static int userid_cmp (const void *key1, const void *key2)
+{
+    const uint32_t *userid1 = key1;
+    const uint32_t *userid2 = key2;
+
+    return NUMCMP (*userid1, *userid2);
+}
+
+static void user_jobs_destroy (void *data)
+{
+    struct user_jobs *uj = data;
+    if (uj) {
+        zlistx_destroy (&uj->pending);
+        zlistx_destroy (&uj->running);
+        zlistx_destroy (&uj->inactive);
+        free (uj);
+    }
+}
+
+static void user_jobs_destroy_wrapper (void **data)
+{
+    struct user_jobs **uj = (struct user_jobs **)data;
+    user_jobs_destroy (*uj);
+}
+
+static struct user_jobs *user_jobs_create (uint32_t userid)
+{
+    struct user_jobs *uj;
+
+    if (!(uj = calloc (1, sizeof (*uj))))
+        return NULL;
+    uj->userid = userid;
+    if (!(uj->pending = zlistx_new ())
+        || !(uj->running = zlistx_new ())
+        || !(uj->inactive = zlistx_new ())) {
+        user_jobs_destroy (uj);
+        errno = ENOMEM;
+        return NULL;
+    }
+    zlistx_set_comparator (uj->pending, job_urgency_cmp);
+    zlistx_set_comparator (uj->running, job_running_cmp);
+    zlistx_set_comparator (uj->inactive, job_inactive_cmp);
+    return uj;
+}
+
+/* Lookup the user_jobs entry for 'userid', creating it if necessary */
+static struct user_jobs *user_jobs_get (struct job_state_ctx *jsctx,
+                                        uint32_t userid)
+{
+    struct user_jobs *uj;
+
+    if (!(uj = zhashx_lookup (jsctx->users, &userid))) {
+        if (!(uj = user_jobs_create (userid)))
+            return NULL;
+        /* key is owned by user_jobs */
+        if (zhashx_insert (jsctx->users, &uj->userid, uj) < 0) {
+            user_jobs_destroy (uj);
+            errno = ENOMEM;
+            return NULL;
+        }
+    }
+    return uj;
+}
+
+/* Return user list corresponding to the primary list 'list' */
+static zlistx_t *user_jobs_list (struct job_state_ctx *jsctx,
+                                 struct user_jobs *uj,
+                                 zlistx_t *list)
+{
+    if (list == jsctx->pending)
+        return uj->pending;
+    else if (list == jsctx->running)
+        return uj->running;
+    else if (list == jsctx->inactive)
+        return uj->inactive;
+    return NULL;
+}
+
+/* Map a single FLUX_JOB_RESULT_* value to an index in jsctx->results */
+static int result_index (flux_job_result_t result)
+{
+    switch (result) {
+        case FLUX_JOB_RESULT_COMPLETED:
+            return 0;
+        case FLUX_JOB_RESULT_FAILED:
+            return 1;
+        case FLUX_JOB_RESULT_CANCELED:
+            return 2;
+        case FLUX_JOB_RESULT_TIMEOUT:
+            return 3;
+    }
+    return -1;
+}
+
+/* Add job to secondary indexes.  Must be called after the job has
+ * been placed on 'list'.  See job_insert_list() for 'sorted'.
+ */
+static void job_index_insert (struct job_state_ctx *jsctx,
+                              struct job *job,
+                              zlistx_t *list,
+                              bool sorted)
+{
+    struct user_jobs *uj;
+    zlistx_t *ulist;
+    int i;
+
+    if (!(uj = user_jobs_get (jsctx, job->userid))) {
+        flux_log_error (jsctx->h, "%s: user_jobs_get", __FUNCTION__);
+        return;
+    }
+    ulist = user_jobs_list (jsctx, uj, list);
+    if (ulist == uj->pending)
+        job->user_list_handle = zlistx_insert (ulist,
+                                               job,
+                                               search_direction (job));
+    else if (sorted)
+        job->user_list_handle = zlistx_insert (ulist, job, true);
+    else
+        job->user_list_handle = zlistx_add_start (ulist, job);
+    if (!job->user_list_handle)
+        flux_log_error (jsctx->h, "%s: zlistx_insert", __FUNCTION__);
+
+    if (list == jsctx->inactive
+        && (i = result_index (job->result)) >= 0) {
+        zlistx_t *rlist = jsctx->results[i];
+        if (sorted)
+            job->result_list_handle = zlistx_insert (rlist, job, true);
+        else
+            job->result_list_handle = zlistx_add_start (rlist, job);
+        if (!job->result_list_handle)
+            flux_log_error (jsctx->h, "%s: zlistx_insert", __FUNCTION__);
+    }
+}
+
+/* Remove job from secondary indexes, 'list' is the primary list the
+ * job is being removed from.
+ */
+static void job_index_remove (struct job_state_ctx *jsctx,
+                              struct job *job,
+                              zlistx_t *list)
+{
+    if (job->user_list_handle) {
+        struct user_jobs *uj = zhashx_lookup (jsctx->users, &job->userid);
+        if (uj) {
+            zlistx_t *ulist = user_jobs_list (jsctx, uj, list);
+            if (zlistx_detach (ulist, job->user_list_handle) < 0)
+                flux_log_error (jsctx->h, "%s: zlistx_detach",
+                                __FUNCTION__);
+        }
+        job->user_list_handle = NULL;
+    }
+    if (job->result_list_handle) {
+        int i = result_index (job->result);
+        if (i >= 0
+            && zlistx_detach (jsctx->results[i], job->result_list_handle) < 0)
+            flux_log_error (jsctx->h, "%s: zlistx_detach", __FUNCTION__);
+        job->result_list_handle = NULL;
+    }
+}
+
+/* Move a pending job into place after a priority change */
+static void job_reorder_pending (struct job_state_ctx *jsctx,
+                                 struct job *job)
+{
+    zlistx_reorder (jsctx->pending,
+                    job->list_handle,
+                    search_direction (job));
+    if (job->user_list_handle) {
+        struct user_jobs *uj = zhashx_lookup (jsctx->users, &job->userid);
+        if (uj)
+            zlistx_reorder (uj->pending,
+                            job->user_list_handle,
+                            search_direction (job));
+    }
+}
+
+/* Place job on the list for 'newstate'.  If 'sorted' is false, jobs
+ * are added to the head of the running and inactive lists, and the
+ * caller must sort the lists afterwards (see job_list_sort()).
+ * Otherwise they are inserted in order, searching from the head,
+ * since a job that just started or became inactive is usually the
+ * most recent.
+ */
 static void job_insert_list (struct job_state_ctx *jsctx,
                              struct job *job,
-                             flux_job_state_t newstate)
+                             flux_job_state_t newstate,
+                             bool sorted)
 {
-    /* Note: comparator is set for running & inactive lists, but the
-     * sort calls are not called on zlistx_add_start() */
+    zlistx_t *list;
+
     if (newstate == FLUX_JOB_STATE_DEPEND
         || newstate == FLUX_JOB_STATE_PRIORITY
         || newstate == FLUX_JOB_STATE_SCHED) {
-        if (!(job->list_handle = zlistx_insert (jsctx->pending,
+        list = jsctx->pending;
+        if (!(job->list_handle = zlistx_insert (list,
                                                 job,
                                                 search_direction (job))))
             flux_log_error (jsctx->h, "%s: zlistx_insert",
@@ -236,17 +492,25 @@ static void job_insert_list (struct job_state_ctx *jsctx,
     }
     else if (newstate == FLUX_JOB_STATE_RUN
              || newstate == FLUX_JOB_STATE_CLEANUP) {
-        if (!(job->list_handle = zlistx_add_start (jsctx->running,
-                                                   job)))
-            flux_log_error (jsctx->h, "%s: zlistx_add_start",
-                            __FUNCTION__);
+        list = jsctx->running;
+        if (sorted)
+            job->list_handle = zlistx_insert (list, job, true);
+        else
+            job->list_handle = zlistx_add_start (list, job);
+        if (!job->list_handle)
+            flux_log_error (jsctx->h, "%s: zlistx_insert", __FUNCTION__);
     }
     else { /* newstate == FLUX_JOB_STATE_INACTIVE */
-        if (!(job->list_handle = zlistx_add_start (jsctx->inactive,
-                                                   job)))
-            flux_log_error (jsctx->h, "%s: zlistx_add_start",
-                            __FUNCTION__);
+        list = jsctx->inactive;
+        if (sorted)
+            job->list_handle = zlistx_insert (list, job, true);
+        else
+            job->list_handle = zlistx_add_start (list, job);
+        if (!job->list_handle)
+            flux_log_error (jsctx->h, "%s: zlistx_insert", __FUNCTION__);
     }
+    if (job->list_handle)
+        job_index_insert (jsctx, job, list, sorted);
 }
 
 /* remove job from one list and move it to another based on the
@@ -260,8 +524,9 @@ static void job_change_list (struct job_state_ctx *jsctx,
         flux_log_error (jsctx->h, "%s: zlistx_detach",
                         __FUNCTION__);
     job->list_handle = NULL;
+    job_index_remove (jsctx, job, oldlist);
 
-    job_insert_list (jsctx, job, newstate);
+    job_insert_list (jsctx, job, newstate, true);
 }
 
 static zlistx_t *get_list (struct job_state_ctx *jsctx, flux_job_state_t state)
@@ -303,9 +568,7 @@ static void update_job_state_and_list (struct list_ctx *ctx,
         job_change_list (jsctx, job, oldlist, newstate);
     else if (oldlist == jsctx->pending
              && newstate == FLUX_JOB_STATE_SCHED)
-        zlistx_reorder (jsctx->pending,
-                        job->list_handle,
-                        search_direction (job));
+        job_reorder_pending (jsctx, job);
 }
 
 static void list_id_respond (struct list_ctx *ctx,
@@ -403,6 +666,7 @@ static int jobspec_parse (struct list_ctx *ctx,
     json_error_t error;
     json_t *jobspec = NULL;
     json_t *tasks, *resources, *command, *jobspec_job = NULL;
+    const char *name = NULL;
     int rc = -1;
 
     if (!(jobspec = json_loads (s, 0, &error))) {
@@ -431,7 +695,6 @@ static int jobspec_parse (struct list_ctx *ctx,
                       __FUNCTION__, (uintmax_t)job->id);
             goto nonfatal_error;
         }
-        job->jobspec_job = json_incref (jobspec_job);
     }
 
     if (json_unpack_ex (jobspec, &error, 0,
@@ -458,12 +721,10 @@ static int jobspec_parse (struct list_ctx *ctx,
         goto nonfatal_error;
     }
 
-    job->jobspec_cmd = json_incref (command);
-
-    if (job->jobspec_job) {
-        if (json_unpack_ex (job->jobspec_job, &error, 0,
+    if (jobspec_job) {
+        if (json_unpack_ex (jobspec_job, &error, 0,
                             "{s?:s}",
-                            "name", &job->name) < 0) {
+                            "name", &name) < 0) {
             flux_log (ctx->h, LOG_ERR,
                       "%s: job %ju invalid job dictionary: %s",
                       __FUNCTION__, (uintmax_t)job->id, error.text);
@@ -473,16 +734,21 @@ static int jobspec_parse (struct list_ctx *ctx,
 
     /* If user did not specify job.name, we treat arg 0 of the command
      * as the job name */
-    if (!job->name) {
-        json_t *arg0 = json_array_get (job->jobspec_cmd, 0);
+    if (!name) {
+        json_t *arg0 = json_array_get (command, 0);
         if (!arg0 || !json_is_string (arg0)) {
             flux_log (ctx->h, LOG_ERR,
                       "%s: job %ju invalid job command",
                       __FUNCTION__, (uintmax_t)job->id);
             goto nonfatal_error;
         }
-        job->name = parse_job_name (json_string_value (arg0));
-        assert (job->name);
+        name = parse_job_name (json_string_value (arg0));
+        assert (name);
+    }
+    if (job_set_string (job, &job->name, name) < 0) {
+        flux_log_error (ctx->h, "%s: job %ju: job_set_string",
+                        __FUNCTION__, (uintmax_t)job->id);
+        goto error;
     }
 
     if (json_unpack_ex (jobspec, &error, 0,
@@ -630,18 +896,21 @@ static int R_lookup_parse (struct list_ctx *ctx,
     struct rlist *rl = NULL;
     struct idset *idset = NULL;
     struct hostlist *hl = NULL;
+    json_t *R = NULL;
+    char *ranks = NULL;
+    char *nodelist = NULL;
     json_error_t error;
     int flags = IDSET_FLAG_BRACKETS | IDSET_FLAG_RANGE;
     int saved_errno, rc = -1;
 
-    if (!(job->R = json_loads (s, 0, &error))) {
+    if (!(R = json_loads (s, 0, &error))) {
         flux_log (ctx->h, LOG_ERR,
                   "%s: job %ju invalid R: %s",
                   __FUNCTION__, (uintmax_t)job->id, error.text);
         goto nonfatal_error;
     }
 
-    if (!(rl = rlist_from_json (job->R, &error))) {
+    if (!(rl = rlist_from_json (R, &error))) {
         flux_log_error (ctx->h, "rlist_from_json: %s", error.text);
         goto nonfatal_error;
     }
@@ -652,7 +921,8 @@ static int R_lookup_parse (struct list_ctx *ctx,
         goto nonfatal_error;
 
     job->nnodes = idset_count (idset);
-    if (!(job->ranks = idset_encode (idset, flags)))
+    if (!(ranks = idset_encode (idset, flags))
+        || job_set_string (job, &job->ranks, ranks) < 0)
         goto nonfatal_error;
 
     /* reading nodelist from R directly would avoid the creation /
@@ -663,7 +933,8 @@ static int R_lookup_parse (struct list_ctx *ctx,
     if (!(hl = rlist_nodelist (rl)))
         goto nonfatal_error;
 
-    if (!(job->nodelist = hostlist_encode (hl)))
+    if (!(nodelist = hostlist_encode (hl))
+        || job_set_string (job, &job->nodelist, nodelist) < 0)
         goto nonfatal_error;
 
     /* nonfatal error - invalid R, but we'll continue on.  job listing
@@ -671,9 +942,12 @@ static int R_lookup_parse (struct list_ctx *ctx,
 nonfatal_error:
     rc = 0;
     saved_errno = errno;
+    free (ranks);
+    free (nodelist);
     hostlist_destroy (hl);
     idset_destroy (idset);
     rlist_destroy (rl);
+    json_decref (R);
     errno = saved_errno;
     return rc;
 }
@@ -1099,7 +1373,7 @@ static int depthfirst_map_one (struct list_ctx *ctx, const char *key,
         flux_log_error (ctx->h, "%s: zhashx_insert", __FUNCTION__);
         goto done;
     }
-    job_insert_list (ctx->jsctx, job, job->state);
+    job_insert_list (ctx->jsctx, job, job->state, false);
 
     rc = 1;
 done:
@@ -1160,20 +1434,52 @@ done:
     return rc;
 }
 
+/* Sort 'list' and update the list handle stored at 'handle_offset'
+ * in each job.  N.B. zlistx_sort() swaps items between nodes rather
+ * than moving the nodes, so previously stored handles are stale.
+ */
+static void job_list_sort (zlistx_t *list, size_t handle_offset)
+{
+    struct job *job;
+
+    zlistx_sort (list);
+    job = zlistx_first (list);
+    while (job) {
+        void **handle = (void **)((char *)job + handle_offset);
+        *handle = zlistx_cursor (list);
+        job = zlistx_next (list);
+    }
+}
+
 /* Read jobs present in the KVS at startup. */
 int job_state_init_from_kvs (struct list_ctx *ctx)
 {
+    struct job_state_ctx *jsctx = ctx->jsctx;
     const char *dirname = "job";
     int dirskip = strlen (dirname);
+    struct user_jobs *uj;
     int count;
+    int i;
 
     count = depthfirst_map (ctx, dirname, dirskip);
     if (count < 0)
         return -1;
     flux_log (ctx->h, LOG_DEBUG, "%s: read %d jobs", __FUNCTION__, count);
 
-    zlistx_sort (ctx->jsctx->running);
-    zlistx_sort (ctx->jsctx->inactive);
+    /* pending lists are sorted on insert */
+    job_list_sort (jsctx->running, offsetof (struct job, list_handle));
+    job_list_sort (jsctx->inactive, offsetof (struct job, list_handle));
+    uj = zhashx_first (jsctx->users);
+    while (uj) {
+        job_list_sort (uj->running,
+                       offsetof (struct job, user_list_handle));
+        job_list_sort (uj->inactive,
+                       offsetof (struct job, user_list_handle));
+        uj = zhashx_next (jsctx->users);
+    }
+    for (i = 0; i < JOB_RESULT_INDEX_COUNT; i++)
+        job_list_sort (jsctx->results[i],
+                       offsetof (struct job, result_list_handle));
     return 0;
 }
 
@@ -1337,9 +1643,7 @@ static int journal_priority_event (struct job_state_ctx *jsctx,
 
     if (job->state & FLUX_JOB_STATE_PENDING
         && job->priority != orig_priority)
-        zlistx_reorder (jsctx->pending,
-                        job->list_handle,
-                        search_direction (job));
+        job_reorder_pending (jsctx, job);
 
     return job_transition_state (jsctx,
                                  job,
@@ -1439,12 +1743,14 @@ static int exception_context_parse (flux_t *h,
 
     if (!job->exception_occurred
         || severity < job->exception_severity) {
+        if (job_set_string (job, &job->exception_type, type) < 0
+            || job_set_string (job, &job->exception_note, note) < 0) {
+            flux_log_error (h, "%s: job %ju: job_set_string",
+                            __FUNCTION__, (uintmax_t)job->id);
+            return -1;
+        }
         job->exception_occurred = true;
         job->exception_severity = severity;
-        job->exception_type = type;
-        job->exception_note = note;
-        json_decref (job->exception_context);
-        job->exception_context = json_incref (context);
     }
 
     if (severityP)
@@ -1787,6 +2093,7 @@ struct job_state_ctx *job_state_create (struct list_ctx *ctx)
 {
     struct job_state_ctx *jsctx = NULL;
     int saved_errno;
+    int i;
 
     if (!(jsctx = calloc (1, sizeof (*jsctx)))) {
         flux_log_error (ctx->h, "calloc");
@@ -1819,6 +2126,23 @@ struct job_state_ctx *job_state_create (struct list_ctx *ctx)
     if (!(jsctx->processing = zlistx_new ()))
         goto error;
 
+    if (!(jsctx->strings = strpool_create ()))
+        goto error;
+
+    if (!(jsctx->users = zhashx_new ()))
+        goto error;
+    zhashx_set_key_hasher (jsctx->users, userid_hasher);
+    zhashx_set_key_comparator (jsctx->users, userid_cmp);
+    zhashx_set_key_duplicator (jsctx->users, NULL);
+    zhashx_set_key_destructor (jsctx->users, NULL);
+    zhashx_set_destructor (jsctx->users, user_jobs_destroy_wrapper);
+
+    for (i = 0; i < JOB_RESULT_INDEX_COUNT; i++) {
+        if (!(jsctx->results[i] = zlistx_new ()))
+            goto error;
+        zlistx_set_comparator (jsctx->results[i], job_inactive_cmp);
+    }
+
     if (!(jsctx->futures = zlistx_new ()))
         goto error;
 
@@ -1853,10 +2177,38 @@ error:
     return NULL;
 }
 
+zlistx_t *job_state_user_list (struct job_state_ctx *jsctx,
+                               uint32_t userid,
+                               int state)
+{
+    struct user_jobs *uj;
+
+    if (!(uj = zhashx_lookup (jsctx->users, &userid)))
+        return NULL;
+    if (state == FLUX_JOB_STATE_PENDING)
+        return uj->pending;
+    else if (state == FLUX_JOB_STATE_RUNNING)
+        return uj->running;
+    else if (state == FLUX_JOB_STATE_INACTIVE)
+        return uj->inactive;
+    return NULL;
+}
+
+zlistx_t *job_state_result_list (struct job_state_ctx *jsctx,
+                                 flux_job_result_t result)
+{
+    int i;
+
+    if ((i = result_index (result)) < 0)
+        return NULL;
+    return jsctx->results[i];
+}
+
 void job_state_destroy (void *data)
 {
     struct job_state_ctx *jsctx = data;
     if (jsctx) {
+        int i;
         /* Don't destroy processing until futures are complete */
         if (jsctx->futures) {
             flux_future_t *f;
@@ -1872,11 +2224,15 @@ void job_state_destroy (void *data)
         }
         /* Destroy index last, as it is the one that will actually
          * destroy the job objects */
+        for (i = 0; i < JOB_RESULT_INDEX_COUNT; i++)
+            zlistx_destroy (&jsctx->results[i]);
+        zhashx_destroy (&jsctx->users);
         zlistx_destroy (&jsctx->processing);
         zlistx_destroy (&jsctx->inactive);
         zlistx_destroy (&jsctx->running);
         zlistx_destroy (&jsctx->pending);
         zhashx_destroy (&jsctx->index);
+        strpool_destroy (jsctx->strings);
         zlistx_destroy (&jsctx->events_journal_backlog);
         flux_future_destroy (jsctx->events);
         free (jsctx);
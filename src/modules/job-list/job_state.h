@@ -17,6 +17,7 @@
 #include "job-list.h"
 #include "stats.h"
 #include "src/common/libutil/grudgeset.h"
+#include "src/common/libutil/strpool.h"
 #include "src/common/libczmqcontainers/czmq_containers.h"
 
 /* To handle the common case of user queries on job state, we will
@@ -35,9 +36,27 @@
  * There is also an additional list `processing` that stores jobs that
  * cannot yet be stored on one of the lists above.
  *
+ * Secondary indexes allow common queries to avoid walking every job:
+ *
+ * - users - hash of userid to struct user_jobs, holding that user's
+ *   jobs on pending, running, and inactive lists sorted identically
+ *   to the lists above.
+ * - results - inactive jobs by job result, one list per result,
+ *   sorted identically to the inactive list.
+ *
  * The list `futures` is used to store in process futures.
  */
 
+/* number of per-result inactive lists, one per FLUX_JOB_RESULT_* bit */
+#define JOB_RESULT_INDEX_COUNT 4
+
+struct user_jobs {
+    uint32_t userid;
+    zlistx_t *pending;
+    zlistx_t *running;
+    zlistx_t *inactive;
+};
+
 struct job_state_ctx {
     flux_t *h;
     struct list_ctx *ctx;
@@ -48,6 +67,13 @@ struct job_state_ctx {
     zlistx_t *processing;
     zlistx_t *futures;
 
+    /* interned job strings */
+    struct strpool *strings;
+
+    /* secondary indexes */
+    zhashx_t *users;
+    zlistx_t *results[JOB_RESULT_INDEX_COUNT];
+
     /*  Job statistics: */
     struct job_stats stats;
 
@@ -70,28 +96,28 @@ struct job {
     double t_submit;
     int flags;
     flux_job_state_t state;
-    const char *name;
     int ntasks;
     int nnodes;
-    char *ranks;
-    char *nodelist;
     double expiration;
     int wait_status;
     bool success;
     bool exception_occurred;
-    json_t *exception_context;
     int exception_severity;
-    const char *exception_type;
-    const char *exception_note;
     flux_job_result_t result;
+    int eventlog_seq;           /* last event seq read */
     json_t *annotations;
     struct grudgeset *dependencies;
-    int eventlog_seq;           /* last event seq read */
 
-    /* cache of job information */
-    json_t *jobspec_job;
-    json_t *jobspec_cmd;
-    json_t *R;
+    /* Only the fields served by job-list are extracted from jobspec,
+     * R, and exception events.  Strings are interned in
+     * job_state_ctx->strings, since many jobs share the same
+     * values.
+     */
+    const char *name;
+    const char *ranks;
+    const char *nodelist;
+    const char *exception_type;
+    const char *exception_note;
 
     /* Track which states we have seen and have completed transition
      * to.  We do not immediately update to the new state and place
@@ -109,6 +135,8 @@ struct job {
     unsigned int states_mask;
     unsigned int states_events_mask;
     void *list_handle;
+    void *user_list_handle;
+    void *result_list_handle;
 
     /* timestamp of when we enter the state
      *
@@ -140,6 +168,32 @@ void job_state_unpause_cb (flux_t *h, flux_msg_handler_t *mh,
 
 int job_state_init_from_kvs (struct list_ctx *ctx);
 
+/* Return list of 'userid' jobs in 'state', which must be one of
+ * FLUX_JOB_STATE_PENDING, FLUX_JOB_STATE_RUNNING, or
+ * FLUX_JOB_STATE_INACTIVE.  Returns NULL if the user has no jobs.
+ */
+zlistx_t *job_state_user_list (struct job_state_ctx *jsctx,
+                               uint32_t userid,
+                               int state);
+
+/* Return list of inactive jobs with 'result', which must be a single
+ * FLUX_JOB_RESULT_* value.
+ */
+zlistx_t *job_state_result_list (struct job_state_ctx *jsctx,
+                                 flux_job_result_t result);
+
+/* Compare jobs by their order in the list for 'state', which must be
+ * one of FLUX_JOB_STATE_PENDING, FLUX_JOB_STATE_RUNNING, or
+ * FLUX_JOB_STATE_INACTIVE.  Jobs are ordered by a key (priority, run
+ * time, or inactive time), then by job id.
+ */
+int job_list_cmp (int state, const struct job *j1, const struct job *j2);
+
+/* Get or set the key 'job' is ordered by in the list for 'state'.
+ */
+double job_list_key (int state, const struct job *job);
+void job_list_key_set (int state, struct job *job, double key);
+
 #endif /* ! _FLUX_JOB_LIST_JOB_STATE_H */
 
 /*
@@ -44,36 +44,125 @@ bool job_filter (struct job *job, uint32_t userid, int states, int results)
     return true;
 }
 
+/* Maximum number of jobs in each response to a streaming
+ * job-list.list request.
+ */
+#define LIST_CHUNK_SIZE 1000
+
+/* Position after which a job-list.list query resumes: the list
+ * 'state' (FLUX_JOB_STATE_PENDING, RUNNING, or INACTIVE), and the sort
+ * key and id of the last job listed.  Since the position is described
+ * by key rather than by job, it remains valid after that job changes
+ * state or is removed.
+ */
+struct list_cursor {
+    int state;
+    double key;
+    flux_jobid_t id;
+};
+
+/* A job-list.list query in progress.  If 'msg' is set, the request
+ * is streaming and jobs are responded to in chunks of LIST_CHUNK_SIZE.
+ */
+struct list_query {
+    flux_t *h;
+    const flux_msg_t *msg;
+    json_t *jobs;
+    int count;
+    int max_entries;
+    json_t *attrs;
+    uint32_t userid;
+    int states;
+    int results;
+    bool resume;
+    struct list_cursor after;
+    struct job *last;
+};
+
+/* Respond with jobs accumulated so far and clear the jobs array */
+static int list_query_flush (struct list_query *q)
+{
+    if (flux_respond_pack (q->h, q->msg, "{s:O}", "jobs", q->jobs) < 0) {
+        flux_log_error (q->h, "%s: flux_respond_pack", __FUNCTION__);
+        return -1;
+    }
+    json_array_clear (q->jobs);
+    return 0;
+}
+
+/* Return the list of candidate jobs in 'state' (one of
+ * FLUX_JOB_STATE_PENDING, RUNNING, or INACTIVE) for the query.
+ * Secondary indexes are used to avoid walking jobs that cannot pass
+ * the filter.  Returns NULL if there are no candidate jobs.
+ */
+static zlistx_t *get_query_list (struct list_ctx *ctx,
+                                 struct list_query *q,
+                                 int state)
+{
+    zlistx_t *list;
+
+    if (state == FLUX_JOB_STATE_PENDING)
+        list = ctx->jsctx->pending;
+    else if (state == FLUX_JOB_STATE_RUNNING)
+        list = ctx->jsctx->running;
+    else
+        list = ctx->jsctx->inactive;
+
+    if (q->userid != FLUX_USERID_UNKNOWN) {
+        if (!(list = job_state_user_list (ctx->jsctx, q->userid, state)))
+            return NULL;
+    }
+
+    /* a single result can be looked up in the result index */
+    if (state == FLUX_JOB_STATE_INACTIVE
+        && (q->results & (q->results - 1)) == 0) {
+        zlistx_t *rlist = job_state_result_list (ctx->jsctx, q->results);
+        if (rlist && zlistx_size (rlist) < zlistx_size (list))
+            list = rlist;
+    }
+    return list;
+}
+
 /* Put jobs from list onto jobs array, breaking if max_entries has
- * been reached. Returns 1 if jobs array is full, 0 if continue, -1
- * one error with errno set:
+ * been reached.  If 'after' is set, skip jobs that sort at or before
+ * the cursor in 'list'.  Returns 1 if max_entries has been reached,
+ * 0 if continue, -1 one error with errno set:
  *
  * ENOMEM - out of memory
  */
-int get_jobs_from_list (json_t *jobs,
+int get_jobs_from_list (struct list_query *q,
                         job_list_error_t *errp,
                         zlistx_t *list,
-                        int max_entries,
-                        json_t *attrs,
-                        uint32_t userid,
-                        int states,
-                        int results)
+                        const struct list_cursor *after)
 {
     struct job *job;
 
     job = zlistx_first (list);
+    if (after) {
+        struct job key = { .id = after->id };
+
+        job_list_key_set (after->state, &key, after->key);
+        while (job && job_list_cmp (after->state, job, &key) <= 0)
+            job = zlistx_next (list);
+    }
     while (job) {
-        if (job_filter (job, userid, states, results)) {
+        if (job_filter (job, q->userid, q->states, q->results)) {
             json_t *o;
-            if (!(o = job_to_json (job, attrs, errp)))
+            if (!(o = job_to_json (job, q->attrs, errp)))
                 return -1;
-            if (json_array_append_new (jobs, o) < 0) {
+            if (json_array_append_new (q->jobs, o) < 0) {
                 json_decref (o);
                 errno = ENOMEM;
                 return -1;
             }
-            if (json_array_size (jobs) == max_entries)
+            q->count++;
+            q->last = job;
+            if (q->count == q->max_entries)
                 return 1;
+            if (q->msg
+                && json_array_size (q->jobs) == LIST_CHUNK_SIZE
+                && list_query_flush (q) < 0)
+                return -1;
         }
         job = zlistx_next (list);
     }
@@ -81,143 +170,201 @@ int get_jobs_from_list (json_t *jobs,
     return 0;
 }
 
-/* Create a JSON array of 'job' objects.  'max_entries' determines the
- * max number of jobs to return, 0=unlimited.  Returns JSON object
- * which the caller must free.  On error, return NULL with errno set:
+/* Put 'job' objects onto the query jobs array.  'max_entries'
+ * determines the max number of jobs to return, 0=unlimited.  If
+ * 'resume' is set, jobs are returned starting after the cursor.
+ * Returns 1 if max_entries has been reached, 0 if all jobs were
+ * listed.  On error, return -1 with errno set:
  *
  * EPROTO - malformed or empty attrs array, max_entries out of range
  * ENOMEM - out of memory
  */
-json_t *get_jobs (struct list_ctx *ctx,
-                  job_list_error_t *errp,
-                  int max_entries,
-                  json_t *attrs,
-                  uint32_t userid,
-                  int states,
-                  int results)
+int get_jobs (struct list_ctx *ctx,
+              job_list_error_t *errp,
+              struct list_query *q)
 {
-    json_t *jobs = NULL;
-    int saved_errno;
+    const int states[] = { FLUX_JOB_STATE_PENDING,
+                           FLUX_JOB_STATE_RUNNING,
+                           FLUX_JOB_STATE_INACTIVE };
+    bool resumed = !q->resume;
     int ret = 0;
-
-    if (!(jobs = json_array ()))
-        goto error_nomem;
+    int i;
 
     /* We return jobs in the following order, pending, running,
      * inactive */
 
-    if (states & FLUX_JOB_STATE_PENDING) {
-        if ((ret = get_jobs_from_list (jobs,
-                                       errp,
-                                       ctx->jsctx->pending,
-                                       max_entries,
-                                       attrs,
-                                       userid,
-                                       states,
-                                       results)) < 0)
-            goto error;
-    }
+    for (i = 0; i < 3 && !ret; i++) {
+        const struct list_cursor *after = NULL;
+        zlistx_t *list;
 
-    if (states & FLUX_JOB_STATE_RUNNING) {
-        if (!ret) {
-            if ((ret = get_jobs_from_list (jobs,
-                                           errp,
-                                           ctx->jsctx->running,
-                                           max_entries,
-                                           attrs,
-                                           userid,
-                                           states,
-                                           results)) < 0)
-                goto error;
+        if (!resumed) {
+            if (q->after.state != states[i])
+                continue;
+            after = &q->after;
+            resumed = true;
         }
+        if (!(q->states & states[i]))
+            continue;
+        if (!(list = get_query_list (ctx, q, states[i])))
+            continue;
+        if ((ret = get_jobs_from_list (q, errp, list, after)) < 0)
+            return -1;
     }
 
-    if (states & FLUX_JOB_STATE_INACTIVE) {
-        if (!ret) {
-            if ((ret = get_jobs_from_list (jobs,
-                                           errp,
-                                           ctx->jsctx->inactive,
-                                           max_entries,
-                                           attrs,
-                                           userid,
-                                           states,
-                                           results)) < 0)
-                goto error;
-        }
-    }
+    return ret;
+}
 
-    return jobs;
+/* Return the list (FLUX_JOB_STATE_PENDING, RUNNING, or INACTIVE)
+ * that a job in 'state' is kept on.
+ */
+static int list_state (flux_job_state_t state)
+{
+    if ((state & FLUX_JOB_STATE_PENDING))
+        return FLUX_JOB_STATE_PENDING;
+    else if ((state & FLUX_JOB_STATE_RUNNING))
+        return FLUX_JOB_STATE_RUNNING;
+    return FLUX_JOB_STATE_INACTIVE;
+}
 
-error_nomem:
-    errno = ENOMEM;
-error:
-    saved_errno = errno;
-    json_decref (jobs);
-    errno = saved_errno;
-    return NULL;
+static void list_cursor_set (struct list_cursor *cur, struct job *job)
+{
+    cur->state = list_state (job->state);
+    cur->key = job_list_key (cur->state, job);
+    cur->id = job->id;
+}
+
+/* Parse the optional "after" member of a job-list.list request,
+ * which is either the cursor object returned with a previous
+ * response, or the id of a job, in which case listing resumes after
+ * that job's current position.
+ */
+static int list_cursor_parse (struct list_ctx *ctx,
+                              job_list_error_t *errp,
+                              json_t *o,
+                              struct list_cursor *cur)
+{
+    json_int_t id;
+
+    if (json_is_integer (o)) {
+        flux_jobid_t jobid = json_integer_value (o);
+        struct job *job;
+
+        if (!(job = zhashx_lookup (ctx->jsctx->index, &jobid))
+            || job->state == FLUX_JOB_STATE_NEW) {
+            seterror (errp, "invalid payload: unknown job in after");
+            errno = ENOENT;
+            return -1;
+        }
+        list_cursor_set (cur, job);
+        return 0;
+    }
+    if (json_unpack (o, "{s:i s:F s:I}",
+                     "state", &cur->state,
+                     "key", &cur->key,
+                     "id", &id) < 0
+        || (cur->state != FLUX_JOB_STATE_PENDING
+            && cur->state != FLUX_JOB_STATE_RUNNING
+            && cur->state != FLUX_JOB_STATE_INACTIVE)) {
+        seterror (errp, "invalid payload: invalid cursor in after");
+        errno = EPROTO;
+        return -1;
+    }
+    cur->id = id;
+    return 0;
 }
 
 void list_cb (flux_t *h, flux_msg_handler_t *mh,
               const flux_msg_t *msg, void *arg)
 {
     struct list_ctx *ctx = arg;
-    job_list_error_t err;
-    json_t *jobs = NULL;
-    json_t *attrs;
-    int max_entries;
-    uint32_t userid;
-    int states;
-    int results;
-
-    if (flux_request_unpack (msg, NULL, "{s:i s:o s:i s:i s:i}",
-                             "max_entries", &max_entries,
-                             "attrs", &attrs,
-                             "userid", &userid,
-                             "states", &states,
-                             "results", &results) < 0) {
+    job_list_error_t err = {{0}};
+    struct list_query q = { .h = h };
+    json_t *after = NULL;
+    int ret;
+
+    if (flux_request_unpack (msg, NULL, "{s:i s:o s:i s:i s:i s?:o}",
+                             "max_entries", &q.max_entries,
+                             "attrs", &q.attrs,
+                             "userid", &q.userid,
+                             "states", &q.states,
+                             "results", &q.results,
+                             "after", &after) < 0) {
         seterror (&err, "invalid payload: %s", flux_msg_last_error (msg));
         errno = EPROTO;
         goto error;
     }
-    if (max_entries < 0) {
+    if (q.max_entries < 0) {
         seterror (&err, "invalid payload: max_entries < 0 not allowed");
         errno = EPROTO;
         goto error;
     }
-    if (!json_is_array (attrs)) {
+    if (!json_is_array (q.attrs)) {
         seterror (&err, "invalid payload: attrs must be an array");
         errno = EPROTO;
         goto error;
     }
+    if (after) {
+        if (list_cursor_parse (ctx, &err, after, &q.after) < 0)
+            goto error;
+        q.resume = true;
+    }
     /* If user sets no states, assume they want all information */
-    if (!states)
-        states = (FLUX_JOB_STATE_PENDING
-                  | FLUX_JOB_STATE_RUNNING
-                  | FLUX_JOB_STATE_INACTIVE);
+    if (!q.states)
+        q.states = (FLUX_JOB_STATE_PENDING
+                    | FLUX_JOB_STATE_RUNNING
+                    | FLUX_JOB_STATE_INACTIVE);
 
     /* If user sets no results, assume they want all information */
-    if (!results)
-        results = (FLUX_JOB_RESULT_COMPLETED
-                   | FLUX_JOB_RESULT_FAILED
-                   | FLUX_JOB_RESULT_CANCELED
-                   | FLUX_JOB_RESULT_TIMEOUT);
-
-    if (!(jobs = get_jobs (ctx, &err, max_entries,
-                           attrs, userid, states, results)))
+    if (!q.results)
+        q.results = (FLUX_JOB_RESULT_COMPLETED
+                     | FLUX_JOB_RESULT_FAILED
+                     | FLUX_JOB_RESULT_CANCELED
+                     | FLUX_JOB_RESULT_TIMEOUT);
+
+    if (flux_msg_is_streaming (msg))
+        q.msg = msg;
+
+    if (!(q.jobs = json_array ())) {
+        errno = ENOMEM;
+        goto error;
+    }
+
+    if ((ret = get_jobs (ctx, &err, &q)) < 0)
         goto error;
 
-    if (flux_respond_pack (h, msg, "{s:O}", "jobs", jobs) < 0) {
+    if (q.msg) {
+        if (json_array_size (q.jobs) > 0 && list_query_flush (&q) < 0)
+            goto error;
+        if (flux_respond_error (h, msg, ENODATA, NULL) < 0)
+            flux_log_error (h, "%s: flux_respond_error", __FUNCTION__);
+    }
+    else if (ret == 1) {
+        /* max_entries was reached, return a cursor to resume from */
+        struct list_cursor cur;
+
+        list_cursor_set (&cur, q.last);
+        if (flux_respond_pack (h, msg, "{s:O s:{s:i s:f s:I}}",
+                               "jobs", q.jobs,
+                               "cursor",
+                                 "state", cur.state,
+                                 "key", cur.key,
+                                 "id", (json_int_t)cur.id) < 0) {
+            flux_log_error (h, "%s: flux_respond_pack", __FUNCTION__);
+            goto error;
+        }
+    }
+    else if (flux_respond_pack (h, msg, "{s:O}", "jobs", q.jobs) < 0) {
         flux_log_error (h, "%s: flux_respond_pack", __FUNCTION__);
         goto error;
     }
 
-    json_decref (jobs);
+    json_decref (q.jobs);
     return;
 
 error:
     if (flux_respond_error (h, msg, errno, err.text) < 0)
         flux_log_error (h, "%s: flux_respond_error", __FUNCTION__);
-    json_decref (jobs);
+    json_decref (q.jobs);
 }
 
 /* Create a JSON array of 'job' objects.  'since' limits entries
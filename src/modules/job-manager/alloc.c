@@ -25,6 +25,7 @@
 #include <assert.h>
 
 #include "src/common/libczmqcontainers/czmq_containers.h"
+#include "src/common/libutil/skiplist.h"
 
 #include "job.h"
 #include "alloc.h"
@@ -35,8 +36,8 @@
 struct alloc {
     struct job_manager *ctx;
     flux_msg_handler_t **handlers;
-    zlistx_t *queue;
-    zlistx_t *pending_jobs;
+    struct skiplist *queue;
+    struct skiplist *pending_jobs;
     bool ready;
     bool disable;
     char *disable_reason;
@@ -51,20 +52,47 @@ struct alloc {
     char *sched_sender; // for disconnect
 };
 
+/* Jobs in alloc->queue and alloc->pending_jobs are sorted by
+ * job_comparator(), and each list holds a reference on its jobs.
+ * A job is in at most one list at a time, and job->handle refers to it.
+ */
+static int queue_insert (struct skiplist *sl, struct job *job)
+{
+    assert (job->handle == NULL);
+    if (!(job->handle = skiplist_insert (sl, job)))
+        return -1;
+    job_incref (job);
+    return 0;
+}
+
+static void queue_delete (struct skiplist *sl, struct job *job)
+{
+    if (job->handle) {
+        skiplist_delete (sl, job->handle);
+        job->handle = NULL;
+        job_decref (job);
+    }
+}
+
+static void queue_destroy (struct skiplist *sl)
+{
+    if (sl) {
+        struct job *job;
+        while ((job = skiplist_first (sl)))
+            queue_delete (sl, job);
+        skiplist_destroy (sl);
+    }
+}
+
 static void requeue_pending (struct alloc *alloc, struct job *job)
 {
     struct job_manager *ctx = alloc->ctx;
-    bool fwd = job->priority > (FLUX_JOB_PRIORITY_MAX / 2);
     bool cleared = false;
 
     assert (job->alloc_pending);
-    if (job->handle) {
-        if (zlistx_delete (alloc->pending_jobs, job->handle) < 0)
-            flux_log (ctx->h, LOG_ERR, "failed to dequeue pending job");
-        job->handle = NULL;
-    }
+    queue_delete (alloc->pending_jobs, job);
     job->alloc_pending = 0;
-    if (!(job->handle = zlistx_insert (alloc->queue, job, fwd)))
+    if (queue_insert (alloc->queue, job) < 0)
         flux_log (ctx->h, LOG_ERR, "failed to enqueue job for scheduling");
     job->alloc_queued = 1;
     annotations_sched_clear (job, &cleared);
@@ -224,11 +252,8 @@ static void alloc_response_cb (flux_t *h, flux_msg_handler_t *mh,
     }
     switch (type) {
     case FLUX_SCHED_ALLOC_SUCCESS:
-        if (alloc->alloc_limit) {
-            if (zlistx_delete (alloc->pending_jobs, job->handle) < 0)
-                flux_log (ctx->h, LOG_ERR, "failed to dequeue pending job");
-            job->handle = NULL;
-        }
+        if (alloc->alloc_limit)
+            queue_delete (alloc->pending_jobs, job);
         if (job->has_resources) {
             flux_log (h,
                       LOG_ERR,
@@ -266,11 +291,8 @@ static void alloc_response_cb (flux_t *h, flux_msg_handler_t *mh,
     case FLUX_SCHED_ALLOC_DENY: // error
         alloc->alloc_pending_count--;
         job->alloc_pending = 0;
-        if (alloc->alloc_limit) {
-            if (zlistx_delete (alloc->pending_jobs, job->handle) < 0)
-                flux_log (ctx->h, LOG_ERR, "failed to dequeue pending job");
-            job->handle = NULL;
-        }
+        if (alloc->alloc_limit)
+            queue_delete (alloc->pending_jobs, job);
         annotations_clear (job, &cleared);
         if (cleared) {
             if (event_job_post_pack (ctx->event, job, "annotations",
@@ -293,11 +315,8 @@ static void alloc_response_cb (flux_t *h, flux_msg_handler_t *mh,
         if (job->state == FLUX_JOB_STATE_SCHED)
             requeue_pending (alloc, job);
         else {
-            if (alloc->alloc_limit) {
-                if (zlistx_delete (alloc->pending_jobs, job->handle) < 0)
-                    flux_log (ctx->h, LOG_ERR, "failed to dequeue pending job");
-                job->handle = NULL;
-            }
+            if (alloc->alloc_limit)
+                queue_delete (alloc->pending_jobs, job);
             annotations_clear (job, &cleared);
         }
         job->alloc_pending = 0;
@@ -434,7 +453,7 @@ static void ready_cb (flux_t *h, flux_msg_handler_t *mh,
     }
     ctx->alloc->ready = true;
     flux_log (h, LOG_DEBUG, "scheduler: ready %s", mode);
-    count = zlistx_size (ctx->alloc->queue);
+    count = skiplist_size (ctx->alloc->queue);
     if (flux_respond_pack (h, msg, "{s:i}", "count", count) < 0)
         flux_log_error (h, "%s: flux_respond_pack", __FUNCTION__);
     /* Restart any free requests that might have been interrupted
@@ -477,7 +496,7 @@ static void prep_cb (flux_reactor_t *r, flux_watcher_t *w,
     * first job has priority=MIN, all other jobs must have the same priority,
     * and no alloc requests can be sent.
     */
-    if ((job = zlistx_first (alloc->queue))
+    if ((job = skiplist_first (alloc->queue))
         && job->priority != FLUX_JOB_PRIORITY_MIN)
         flux_watcher_start (alloc->idle);
 }
@@ -503,21 +522,19 @@ static void check_cb (flux_reactor_t *r, flux_watcher_t *w,
     * first job has priority=MIN, all other jobs must have the same priority,
     * and no alloc requests can be sent.
     */
-    if ((job = zlistx_first (alloc->queue))
+    if ((job = skiplist_first (alloc->queue))
         && job->priority != FLUX_JOB_PRIORITY_MIN) {
-        bool fwd = job->priority > (FLUX_JOB_PRIORITY_MAX / 2);
         if (alloc_request (alloc, job) < 0) {
             flux_log_error (ctx->h, "alloc_request fatal error");
             flux_reactor_stop_error (flux_get_reactor (ctx->h));
             return;
         }
-        zlistx_delete (alloc->queue, job->handle);
-        job->handle = NULL;
+        queue_delete (alloc->queue, job);
         job->alloc_pending = 1;
         job->alloc_queued = 0;
         alloc->alloc_pending_count++;
         if (alloc->alloc_limit) {
-            if (!(job->handle = zlistx_insert (alloc->pending_jobs, job, fwd)))
+            if (queue_insert (alloc->pending_jobs, job) < 0)
                 flux_log (ctx->h, LOG_ERR, "failed to enqueue pending job");
         }
         if ((job->flags & FLUX_JOB_DEBUG))
@@ -551,9 +568,7 @@ int alloc_enqueue_alloc_request (struct alloc *alloc, struct job *job)
         && !job->alloc_queued
         && !job->alloc_pending
         && job->priority != FLUX_JOB_PRIORITY_MIN) {
-        bool fwd = job->priority > (FLUX_JOB_PRIORITY_MAX / 2);
-        assert (job->handle == NULL);
-        if (!(job->handle = zlistx_insert (alloc->queue, job, fwd)))
+        if (queue_insert (alloc->queue, job) < 0)
             return -1;
         job->alloc_queued = 1;
     }
@@ -566,8 +581,7 @@ int alloc_enqueue_alloc_request (struct alloc *alloc, struct job *job)
 void alloc_dequeue_alloc_request (struct alloc *alloc, struct job *job)
 {
     if (job->alloc_queued) {
-        zlistx_delete (alloc->queue, job->handle);
-        job->handle = NULL;
+        queue_delete (alloc->queue, job);
         job->alloc_queued = 0;
     }
 }
@@ -587,53 +601,33 @@ int alloc_cancel_alloc_request (struct alloc *alloc, struct job *job)
 /* called from list_handle_request() */
 struct job *alloc_queue_first (struct alloc *alloc)
 {
-    return zlistx_first (alloc->queue);
+    return skiplist_first (alloc->queue);
 }
 
 struct job *alloc_queue_next (struct alloc *alloc)
 {
-    return zlistx_next (alloc->queue);
+    return skiplist_next (alloc->queue);
 }
 
 /* called from reprioritize_job() */
 void alloc_queue_reorder (struct alloc *alloc, struct job *job)
 {
-    bool fwd = job->priority > (FLUX_JOB_PRIORITY_MAX / 2);
-
-    zlistx_reorder (alloc->queue, job->handle, fwd);
+    skiplist_reorder (alloc->queue, job->handle);
 }
 
 void alloc_pending_reorder (struct alloc *alloc, struct job *job)
 {
-    if (alloc->alloc_limit) {
-        bool fwd = job->priority > (FLUX_JOB_PRIORITY_MAX / 2);
-        zlistx_reorder (alloc->pending_jobs, job->handle, fwd);
-    }
+    if (alloc->alloc_limit)
+        skiplist_reorder (alloc->pending_jobs, job->handle);
 }
 
 int alloc_queue_reprioritize (struct alloc *alloc)
 {
-    struct job *job;
-    zlistx_sort (alloc->queue);
-
-    /*  N.B.: zlistx_sort() invalidates all list handles since
-     *   the sort swaps contents of nodes, not the nodes themselves.
-     *   Therefore, job handles into the list must be re-acquired here:
+    /*  N.B.: skiplist_sort() relinks nodes, so job handles remain valid.
      */
-
-    job = zlistx_first (alloc->queue);
-    while (job) {
-        job->handle = zlistx_cursor (alloc->queue);
-        job = zlistx_next (alloc->queue);
-    }
-
-    zlistx_sort (alloc->pending_jobs);
-
-    job = zlistx_first (alloc->pending_jobs);
-    while (job) {
-        job->handle = zlistx_cursor (alloc->pending_jobs);
-        job = zlistx_next (alloc->pending_jobs);
-    }
+    if (skiplist_sort (alloc->queue) < 0
+        || skiplist_sort (alloc->pending_jobs) < 0)
+        return -1;
 
     if (alloc->alloc_limit)
         return alloc_queue_recalc_pending (alloc);
@@ -644,8 +638,8 @@ int alloc_queue_reprioritize (struct alloc *alloc)
 /* called if highest priority job may have changed */
 int alloc_queue_recalc_pending (struct alloc *alloc)
 {
-    struct job *head = zlistx_first (alloc->queue);
-    struct job *tail = zlistx_last (alloc->pending_jobs);
+    struct job *head = skiplist_first (alloc->queue);
+    struct job *tail = skiplist_last (alloc->pending_jobs);
     while (alloc->alloc_limit
            && head
            && tail) {
@@ -658,8 +652,8 @@ int alloc_queue_recalc_pending (struct alloc *alloc)
         }
         else
             break;
-        head = zlistx_next (alloc->queue);
-        tail = zlistx_prev (alloc->pending_jobs);
+        head = skiplist_next (alloc->queue);
+        tail = skiplist_prev (alloc->pending_jobs);
     }
     return 0;
 }
@@ -753,7 +747,7 @@ static void alloc_admin_cb (flux_t *h,
                            "reason",
                            reason ? reason : "",
                            "queue_length",
-                           zlistx_size (alloc->queue),
+                           skiplist_size (alloc->queue),
                            "alloc_pending",
                            alloc->alloc_pending_count,
                            "free_pending",
@@ -791,8 +785,8 @@ void alloc_ctx_destroy (struct alloc *alloc)
         flux_watcher_destroy (alloc->prep);
         flux_watcher_destroy (alloc->check);
         flux_watcher_destroy (alloc->idle);
-        zlistx_destroy (&alloc->queue);
-        zlistx_destroy (&alloc->pending_jobs);
+        queue_destroy (alloc->queue);
+        queue_destroy (alloc->pending_jobs);
         free (alloc->disable_reason);
         free (alloc->sched_sender);
         free (alloc);
@@ -817,17 +811,9 @@ struct alloc *alloc_ctx_create (struct job_manager *ctx)
     if (!(alloc = calloc (1, sizeof (*alloc))))
         return NULL;
     alloc->ctx = ctx;
-    if (!(alloc->queue = zlistx_new()))
-        goto error;
-    zlistx_set_destructor (alloc->queue, job_destructor);
-    zlistx_set_comparator (alloc->queue, job_comparator);
-    zlistx_set_duplicator (alloc->queue, job_duplicator);
-
-    if (!(alloc->pending_jobs = zlistx_new()))
+    if (!(alloc->queue = skiplist_create (job_comparator))
+        || !(alloc->pending_jobs = skiplist_create (job_comparator)))
         goto error;
-    zlistx_set_destructor (alloc->pending_jobs, job_destructor);
-    zlistx_set_comparator (alloc->pending_jobs, job_comparator);
-    zlistx_set_duplicator (alloc->pending_jobs, job_duplicator);
 
     if (flux_msg_handler_addvec (ctx->h, htab, ctx, &alloc->handlers) < 0)
         goto error;
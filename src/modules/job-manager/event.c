@@ -39,9 +39,11 @@
 #include <jansson.h>
 #include <flux/core.h>
 #include <time.h>
+#include <ctype.h>
 
 #include "src/common/libczmqcontainers/czmq_containers.h"
 #include "src/common/libeventlog/eventlog.h"
+#include "src/common/libutil/monotime.h"
 #include "ccan/ptrint/ptrint.h"
 
 #include "alloc.h"
@@ -64,6 +66,7 @@ struct event {
     zlist_t *pending;
     zlist_t *pub_futures;
     zhashx_t *evindex;
+    ssize_t state_count[FLUX_JOB_NR_STATES]; // transitions into each state
 };
 
 struct event_batch {
@@ -72,6 +75,7 @@ struct event_batch {
     flux_future_t *f;
     json_t *state_trans;
     zlist_t *responses; // responses deferred until batch complete
+    struct timespec t_start;
 };
 
 static struct event_batch *event_batch_create (struct event *event);
@@ -91,6 +95,9 @@ static void commit_continuation (flux_future_t *f, void *arg)
         flux_log_error (ctx->h, "%s: eventlog update failed", __FUNCTION__);
         flux_reactor_stop_error (flux_get_reactor (ctx->h));
     }
+    flux_stats_timing (ctx->h,
+                       "job-manager.commit-latency",
+                       monotime_since (batch->t_start));
     zlist_remove (event->pending, batch);
     event_batch_destroy (batch);
 }
@@ -223,6 +230,7 @@ static struct event_batch *event_batch_create (struct event *event)
     if (!(batch = calloc (1, sizeof (*batch))))
         return NULL;
     batch->event = event;
+    monotime (&batch->t_start);
     return batch;
 }
 
@@ -759,6 +767,34 @@ static int event_job_cache (struct event *event,
     return job_event_id_set (job, id);
 }
 
+static inline int state_index (flux_job_state_t state)
+{
+    int i = 0;
+    while (!(state & (1<<i)))
+        i++;
+    return i;
+}
+
+static void update_state_stats (struct event *event, flux_job_state_t state)
+{
+    flux_t *h = event->ctx->h;
+    int i = state_index (state);
+    char name[64];
+    char *p;
+
+    event->state_count[i]++;
+    (void)snprintf (name,
+                    sizeof (name),
+                    "job-manager.state.%s",
+                    flux_job_statetostr (state, false));
+    for (p = name; *p != '\0'; p++)
+        *p = tolower (*p);
+    flux_stats_count (h, name, event->state_count[i]);
+    flux_stats_gauge_set (h, "job-manager.active",
+                          zhashx_size (event->ctx->active_jobs));
+    flux_stats_gauge_set (h, "job-manager.running", event->ctx->running_jobs);
+}
+
 int event_job_post_entry (struct event *event,
                           struct job *job,
                           const char *name,
@@ -783,6 +819,8 @@ int event_job_post_entry (struct event *event,
     /* call before eventlog_seq increment below */
     if (journal_process_event (event->ctx->journal,
                                job->id,
+                               job->userid,
+                               job->sender,
                                eventlog_seq,
                                name,
                                entry) < 0)
@@ -819,6 +857,9 @@ int event_job_post_entry (struct event *event,
              && (old_state & FLUX_JOB_STATE_RUNNING))
         event->ctx->running_jobs--;
 
+    if (job->state != old_state && flux_stats_enabled (event->ctx->h, NULL))
+        update_state_stats (event, job->state);
+
     /*  N.B. Job may recursively call this function from event_jobtap_call()
      *   which may end up destroying the job before returning from the
      *   function. Until the recursive nature of these functions is
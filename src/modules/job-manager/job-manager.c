@@ -74,9 +74,19 @@ static void stats_cb (flux_t *h, flux_msg_handler_t *mh,
 {
     struct job_manager *ctx = arg;
     int journal_listeners = journal_listeners_count (ctx->journal);
-    if (flux_respond_pack (h, msg, "{s:{s:i}}",
+    int journal_watchers = journal_watchers_count (ctx->journal);
+    double rate = 0.;
+
+    if (ctx->restart_time > 0.)
+        rate = ctx->restart_jobs / ctx->restart_time;
+    if (flux_respond_pack (h, msg, "{s:{s:i s:i} s:{s:i s:f s:f}}",
                            "journal",
-                             "listeners", journal_listeners) < 0) {
+                             "listeners", journal_listeners,
+                             "watchers", journal_watchers,
+                           "restart",
+                             "jobs", ctx->restart_jobs,
+                             "time", ctx->restart_time,
+                             "jobs-per-sec", rate) < 0) {
         flux_log_error (h, "%s: flux_respond_pack", __FUNCTION__);
         goto error;
     }
@@ -19,6 +19,8 @@ struct job_manager {
     zhashx_t *active_jobs;
     int running_jobs; // count of jobs in RUN | CLEANUP state
     flux_jobid_t max_jobid; // largest jobid allocated thus far
+    int restart_jobs; // count of jobs loaded from KVS on restart
+    double restart_time; // time to load jobs from KVS on restart (sec)
     struct start *start;
     struct alloc *alloc;
     struct event *event;
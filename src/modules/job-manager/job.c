@@ -36,6 +36,7 @@ void job_decref (struct job *job)
         json_decref (job->end_event);
         flux_msg_decref (job->waiter);
         json_decref (job->jobspec_redacted);
+        free (job->sender);
         json_decref (job->annotations);
         grudgeset_destroy (job->dependencies);
         subscribers_destroy (job);
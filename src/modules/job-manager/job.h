@@ -28,6 +28,7 @@ struct job {
     double t_submit;
     int flags;
     json_t *jobspec_redacted;
+    char *sender;               // uuid of submitting connection, if known
     int eventlog_seq;           // eventlog count / sequence number
     flux_job_state_t state;
     json_t *end_event;      // event that caused transition to CLEANUP state
@@ -52,7 +53,7 @@ struct job {
 
     struct bitmap *events;  // set of events by id posted to this job
 
-    void *handle;           // zlistx_t handle
+    void *handle;           // alloc queue handle
     int refcount;           // private to job.c
 
     struct aux_item *aux;
@@ -9,18 +9,35 @@
 \************************************************************/
 
 /* journal.c - job event journaling and streaming to listeners
+ *
+ * job-manager.events-journal streams events of all jobs to instance
+ * owner listeners.
+ *
+ * job-manager.events-watch multiplexes the events of many jobs on one
+ * response stream, so that a client such as a workflow manager need not
+ * open a job-info.eventlog-watch per job.  It may be used by guests.
+ * The request may contain an array of job "ids" to watch, or if omitted,
+ * all jobs of the requesting user that post events after the request
+ * is received are watched.  Only events posted while the job is active
+ * are available: with "ids", events still in the journal history are
+ * replayed first, and any ids that are not active are returned in an
+ * "inactive" array in the first response.  When all listed jobs have
+ * posted their "clean" event, the stream is terminated with ENODATA.
  */
 
 #if HAVE_CONFIG_H
 #include "config.h"
 #endif
+#include <string.h>
 #include <jansson.h>
 #include <flux/core.h>
 
 #include "src/common/libczmqcontainers/czmq_containers.h"
 #include "src/common/libeventlog/eventlog.h"
 #include "src/common/libutil/errno_safe.h"
+#include "src/common/libjob/job_hash.h"
 
+#include "job.h"
 #include "journal.h"
 
 #define EVENTS_MAXLEN 1000
@@ -29,6 +46,7 @@ struct journal {
     struct job_manager *ctx;
     flux_msg_handler_t **handlers;
     struct flux_msglist *listeners;
+    struct flux_msglist *watchers;
     /* holds most recent events for listeners */
     zlist_t *events;
     int events_maxlen;
@@ -37,6 +55,10 @@ struct journal {
 struct journal_filter { // stored as aux item in request message
     json_t *allow;      // allow, deny are owned by message
     json_t *deny;
+    uint32_t userid;    // events-watch: requestor
+    char *sender;       // events-watch: requestor's connection uuid
+    zhashx_t *ids;      // events-watch: jobs to watch, or NULL for all
+    flux_jobid_t *idv;  // storage for ids keys
 };
 
 static bool allow_deny_check (const flux_msg_t *msg, const char *name)
@@ -58,6 +80,25 @@ static bool allow_deny_check (const flux_msg_t *msg, const char *name)
     return add_entry;
 }
 
+/* Return true if events-watch request 'msg' should receive events
+ * of job 'id'.  Without a list of ids, only jobs submitted over the
+ * same connection as the watch request are watched.
+ */
+static bool watch_check (const flux_msg_t *msg,
+                         flux_jobid_t id,
+                         uint32_t userid,
+                         const char *sender)
+{
+    struct journal_filter *filter = flux_msg_aux_get (msg, "filter");
+
+    if (filter->ids)
+        return zhashx_lookup (filter->ids, &id) ? true : false;
+    return filter->userid == userid
+        && filter->sender != NULL
+        && sender != NULL
+        && !strcmp (filter->sender, sender);
+}
+
 /* wrap the eventlog entry in another object with the job id and
  * eventlog_seq.
  *
@@ -90,8 +131,47 @@ static void json_decref_wrapper (void *data)
     json_decref (o);
 }
 
+static void journal_process_watchers (struct journal *journal,
+                                     flux_jobid_t id,
+                                     uint32_t userid,
+                                     const char *sender,
+                                     const char *name,
+                                     json_t *wrapped_entry)
+{
+    flux_t *h = journal->ctx->h;
+    const flux_msg_t *msg;
+
+    msg = flux_msglist_first (journal->watchers);
+    while (msg) {
+        if (watch_check (msg, id, userid, sender)) {
+            struct journal_filter *filter = flux_msg_aux_get (msg, "filter");
+
+            if (allow_deny_check (msg, name)) {
+                if (flux_respond_pack (h, msg,
+                                       "{s:[O]}", "events", wrapped_entry) < 0)
+                    flux_log_error (h, "%s: flux_respond_pack", __FUNCTION__);
+            }
+            /* "clean" is the final event of a job.  End the stream
+             * once all listed jobs are done.
+             */
+            if (filter->ids && !strcmp (name, "clean")) {
+                zhashx_delete (filter->ids, &id);
+                if (zhashx_size (filter->ids) == 0) {
+                    if (flux_respond_error (h, msg, ENODATA, NULL) < 0)
+                        flux_log_error (h, "%s: flux_respond_error",
+                                        __FUNCTION__);
+                    flux_msglist_delete (journal->watchers);
+                }
+            }
+        }
+        msg = flux_msglist_next (journal->watchers);
+    }
+}
+
 int journal_process_event (struct journal *journal,
                            flux_jobid_t id,
+                           uint32_t userid,
+                           const char *sender,
                            int eventlog_seq,
                            const char *name,
                            json_t *entry)
@@ -112,6 +192,12 @@ int journal_process_event (struct journal *journal,
         }
         msg = flux_msglist_next (journal->listeners);
     }
+    journal_process_watchers (journal,
+                              id,
+                              userid,
+                              sender,
+                              name,
+                              wrapped_entry);
 
     if (zlist_size (journal->events) > journal->events_maxlen)
         zlist_remove (journal->events, zlist_head (journal->events));
@@ -134,7 +220,14 @@ error:
 
 static void filter_destroy (struct journal_filter *filter)
 {
-    ERRNO_SAFE_WRAP (free, filter);
+    if (filter) {
+        int saved_errno = errno;
+        zhashx_destroy (&filter->ids);
+        free (filter->idv);
+        free (filter->sender);
+        free (filter);
+        errno = saved_errno;
+    }
 }
 
 static void journal_handle_request (flux_t *h,
@@ -220,6 +313,172 @@ error:
     json_decref (a);
 }
 
+/* Set up filter->ids from the 'ids' array of an events-watch request.
+ * Inactive jobs are appended to 'inactive'.
+ */
+static int watch_ids_setup (struct job_manager *ctx,
+                            struct journal_filter *filter,
+                            struct flux_msg_cred cred,
+                            json_t *ids,
+                            json_t *inactive,
+                            const char **errstr)
+{
+    size_t index;
+    json_t *value;
+
+    if (!json_is_array (ids)) {
+        *errstr = "job-manager.events-watch ids should be an array";
+        goto eproto;
+    }
+    if (!(filter->ids = job_hash_create ()))
+        return -1;
+    if (!(filter->idv = calloc (json_array_size (ids) + 1,
+                                sizeof (filter->idv[0]))))
+        return -1;
+    json_array_foreach (ids, index, value) {
+        flux_jobid_t *id = &filter->idv[index];
+        struct job *job;
+
+        if (!json_is_integer (value)) {
+            *errstr = "job-manager.events-watch ids should be job IDs";
+            goto eproto;
+        }
+        *id = json_integer_value (value);
+        if (!(job = zhashx_lookup (ctx->active_jobs, id))) {
+            if (json_array_append (inactive, value) < 0) {
+                errno = ENOMEM;
+                return -1;
+            }
+            continue;
+        }
+        if (flux_msg_cred_authorize (cred, job->userid) < 0) {
+            *errstr = "guests can only watch their own jobs";
+            return -1;
+        }
+        (void)zhashx_insert (filter->ids, id, id);
+    }
+    return 0;
+eproto:
+    errno = EPROTO;
+    return -1;
+}
+
+static void watch_handle_request (flux_t *h,
+                                  flux_msg_handler_t *mh,
+                                  const flux_msg_t *msg,
+                                  void *arg)
+{
+    struct job_manager *ctx = arg;
+    struct journal *journal = ctx->journal;
+    struct journal_filter *filter;
+    struct flux_msg_cred cred;
+    const char *errstr = NULL;
+    json_t *ids = NULL;
+    json_t *a = NULL;
+    json_t *inactive = NULL;
+    json_t *wrapped_entry;
+
+    if (!(filter = calloc (1, sizeof (*filter))))
+        goto error;
+    if (flux_request_unpack (msg, NULL, "{s?o s?o s?o}",
+                             "ids", &ids,
+                             "allow", &filter->allow,
+                             "deny", &filter->deny) < 0
+        || flux_msg_aux_set (msg, "filter", filter,
+                             (flux_free_f)filter_destroy) < 0) {
+        filter_destroy (filter);
+        goto error;
+    }
+    if (!flux_msg_is_streaming (msg)) {
+        errno = EPROTO;
+        errstr = "job-manager.events-watch requires streaming RPC flag";
+        goto error;
+    }
+    if (filter->allow && !json_is_object (filter->allow)) {
+        errno = EPROTO;
+        errstr = "job-manager.events-watch allow should be an object";
+        goto error;
+    }
+    if (filter->deny && !json_is_object (filter->deny)) {
+        errno = EPROTO;
+        errstr = "job-manager.events-watch deny should be an object";
+        goto error;
+    }
+    if (flux_msg_get_cred (msg, &cred) < 0)
+        goto error;
+    filter->userid = cred.userid;
+    if (!ids && flux_msg_route_first (msg)) {
+        if (!(filter->sender = strdup (flux_msg_route_first (msg))))
+            goto nomem;
+    }
+
+    /* With a list of ids, replay events still in the journal history.
+     * Without, only events posted from now on are sent, since the
+     * caller is waiting for jobs it has yet to submit over this same
+     * connection.
+     */
+    if (ids) {
+        if (!(inactive = json_array ()) || !(a = json_array ()))
+            goto nomem;
+        if (watch_ids_setup (ctx, filter, cred, ids, inactive, &errstr) < 0)
+            goto error;
+        wrapped_entry = zlist_first (journal->events);
+        while (wrapped_entry) {
+            flux_jobid_t id;
+            const char *name;
+
+            if (json_unpack (wrapped_entry,
+                             "{s:I s:{s:s}}",
+                             "id", &id,
+                             "entry",
+                               "name", &name) < 0) {
+                flux_log (h, LOG_ERR, "invalid wrapped entry");
+                goto error;
+            }
+            if (watch_check (msg, id, cred.userid, NULL)
+                && allow_deny_check (msg, name)) {
+                if (json_array_append (a, wrapped_entry) < 0)
+                    goto nomem;
+            }
+            wrapped_entry = zlist_next (journal->events);
+        }
+        if (json_array_size (a) > 0 || json_array_size (inactive) > 0) {
+            if (flux_respond_pack (h, msg,
+                                   "{s:O s:O}",
+                                   "events", a,
+                                   "inactive", inactive) < 0)
+                flux_log_error (h,
+                                "error responding to job-manager.events-watch");
+        }
+        if (zhashx_size (filter->ids) == 0) {
+            errno = ENODATA;
+            goto error;
+        }
+    }
+    if (flux_msglist_append (journal->watchers, msg) < 0)
+        goto error;
+    json_decref (a);
+    json_decref (inactive);
+    return;
+
+nomem:
+    errno = ENOMEM;
+error:
+    if (flux_respond_error (h, msg, errno, errstr) < 0)
+        flux_log_error (h, "error responding to job-manager.events-watch");
+    json_decref (a);
+    json_decref (inactive);
+}
+
+static void watch_cancel_request (flux_t *h, flux_msg_handler_t *mh,
+                                  const flux_msg_t *msg, void *arg)
+{
+    struct job_manager *ctx = arg;
+
+    if (flux_msglist_cancel (h, ctx->journal->watchers, msg) < 0)
+        flux_log_error (h, "error handling job-manager.events-watch-cancel");
+}
+
 static void journal_cancel_request (flux_t *h, flux_msg_handler_t *mh,
                                     const flux_msg_t *msg, void *arg)
 {
@@ -238,6 +497,8 @@ void journal_listeners_disconnect_rpc (flux_t *h,
 
     if (flux_msglist_disconnect (ctx->journal->listeners, msg) < 0)
         flux_log_error (h, "error handling job-manager.disconnect (journal)");
+    if (flux_msglist_disconnect (ctx->journal->watchers, msg) < 0)
+        flux_log_error (h, "error handling job-manager.disconnect (watch)");
 }
 
 void journal_ctx_destroy (struct journal *journal)
@@ -259,6 +520,18 @@ void journal_ctx_destroy (struct journal *journal)
             }
             flux_msglist_destroy (journal->listeners);
         }
+        if (journal->watchers) {
+            const flux_msg_t *msg;
+
+            msg = flux_msglist_first (journal->watchers);
+            while (msg) {
+                if (flux_respond_error (h, msg, ENODATA, NULL) < 0)
+                    flux_log_error (h, "error responding to watch request");
+                flux_msglist_delete (journal->watchers);
+                msg = flux_msglist_next (journal->watchers);
+            }
+            flux_msglist_destroy (journal->watchers);
+        }
         if (journal->events)
             zlist_destroy (&journal->events);
         free (journal);
@@ -279,6 +552,18 @@ static const struct flux_msg_handler_spec htab[] = {
         journal_cancel_request,
         0
     },
+    {
+        FLUX_MSGTYPE_REQUEST,
+        "job-manager.events-watch",
+        watch_handle_request,
+        FLUX_ROLE_USER
+    },
+    {
+        FLUX_MSGTYPE_REQUEST,
+        "job-manager.events-watch-cancel",
+        watch_cancel_request,
+        FLUX_ROLE_USER
+    },
     FLUX_MSGHANDLER_TABLE_END,
 };
 
@@ -292,7 +577,8 @@ struct journal *journal_ctx_create (struct job_manager *ctx)
     journal->ctx = ctx;
     if (flux_msg_handler_addvec (ctx->h, htab, ctx, &journal->handlers) < 0)
         goto error;
-    if (!(journal->listeners = flux_msglist_create ()))
+    if (!(journal->listeners = flux_msglist_create ())
+        || !(journal->watchers = flux_msglist_create ()))
         goto error;
     if (!(journal->events = zlist_new ()))
         goto nomem;
@@ -324,6 +610,13 @@ int journal_listeners_count (struct journal *journal)
     return -1;
 }
 
+int journal_watchers_count (struct journal *journal)
+{
+    if (journal)
+        return flux_msglist_count (journal->watchers);
+    return -1;
+}
+
 /*
  * vi:tabstop=4 shiftwidth=4 expandtab
  */
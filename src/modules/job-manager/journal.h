@@ -19,10 +19,13 @@
 #include "job-manager.h"
 
 /* Process the event by sending to any listeners that request the
- * event and append to the journal history.
+ * event and append to the journal history.  'sender' is the uuid of
+ * the connection that submitted the job, or NULL if unknown.
  */
 int journal_process_event (struct journal *journal,
                            flux_jobid_t id,
+                           uint32_t userid,
+                           const char *sender,
                            int eventlog_seq,
                            const char *name,
                            json_t *entry);
@@ -36,6 +39,7 @@ void journal_listeners_disconnect_rpc (flux_t *h,
                                        void *arg);
 
 int journal_listeners_count (struct journal *journal);
+int journal_watchers_count (struct journal *journal);
 
 #endif /* _FLUX_JOB_MANAGER_JOURNAL_H */
 
@@ -14,9 +14,11 @@
 #include "config.h"
 #endif
 #include <stdlib.h>
+#include <string.h>
 #include <flux/core.h>
 
 #include "src/common/libutil/fluid.h"
+#include "src/common/libutil/monotime.h"
 #include "src/common/libczmqcontainers/czmq_containers.h"
 
 #include "job.h"
@@ -30,6 +32,10 @@
  */
 typedef int (*restart_map_f)(struct job *job, void *arg);
 
+/* Maximum number of outstanding KVS requests during restart.
+ */
+#define RESTART_WINDOW 256
+
 const char *checkpoint_key = "checkpoint.job-manager";
 
 int restart_count_char (const char *s, char c)
@@ -42,99 +48,246 @@ int restart_count_char (const char *s, char c)
     return count;
 }
 
-static struct job *lookup_job (flux_t *h, flux_jobid_t id)
+/* A restart_req is either a readdir of a directory under 'job.'
+ * ('key' is set), or a lookup of a job's eventlog and jobspec.
+ */
+struct restart_req {
+    char *key;
+    flux_jobid_t id;
+    flux_future_t *f1;
+    flux_future_t *f2;
+};
+
+/* Requests are sent in the order they are queued, keeping up to
+ * RESTART_WINDOW requests outstanding.  Responses are handled in the
+ * order requests were sent, so while waiting on the oldest request,
+ * responses to the others continue to arrive.
+ */
+struct restart_map {
+    flux_t *h;
+    int dirskip;
+    restart_map_f cb;
+    void *arg;
+    zlist_t *todo;      // requests not yet sent
+    zlist_t *pending;   // requests sent, awaiting response
+    int count;
+};
+
+static void restart_req_destroy (struct restart_req *req)
+{
+    if (req) {
+        int saved_errno = errno;
+        flux_future_destroy (req->f1);
+        flux_future_destroy (req->f2);
+        free (req->key);
+        free (req);
+        errno = saved_errno;
+    }
+}
+
+static int restart_map_push (struct restart_map *map,
+                             const char *key,
+                             flux_jobid_t id)
+{
+    struct restart_req *req;
+
+    if (!(req = calloc (1, sizeof (*req))))
+        return -1;
+    if (key && !(req->key = strdup (key)))
+        goto error;
+    req->id = id;
+    if (zlist_append (map->todo, req) < 0) {
+        errno = ENOMEM;
+        goto error;
+    }
+    return 0;
+error:
+    restart_req_destroy (req);
+    return -1;
+}
+
+static int restart_req_send (struct restart_map *map, struct restart_req *req)
 {
-    flux_future_t *f1 = NULL;
-    flux_future_t *f2 = NULL;
     char k1[64], k2[64];
-    const char *eventlog, *jobspec;
-    struct job *job = NULL;
 
-    if (flux_job_kvs_key (k1, sizeof (k1), id, "eventlog") < 0
-        || flux_job_kvs_key (k2, sizeof (k2), id, "jobspec") < 0)
-        return NULL;
-    if (!(f1 = flux_kvs_lookup (h, NULL, 0, k1))
-        || !(f2 = flux_kvs_lookup (h, NULL, 0, k2)))
-        goto done;
-    if (flux_kvs_lookup_get (f1, &eventlog) < 0
-            || flux_kvs_lookup_get (f2, &jobspec) < 0)
-        goto done;
-    job = job_create_from_eventlog (id, eventlog, jobspec);
-done:
-    flux_future_destroy (f1);
-    flux_future_destroy (f2);
-    return job;
+    if (req->key) {
+        if (!(req->f1 = flux_kvs_lookup (map->h,
+                                         NULL,
+                                         FLUX_KVS_READDIR,
+                                         req->key)))
+            return -1;
+        return 0;
+    }
+    if (flux_job_kvs_key (k1, sizeof (k1), req->id, "eventlog") < 0
+        || flux_job_kvs_key (k2, sizeof (k2), req->id, "jobspec") < 0)
+        return -1;
+    if (!(req->f1 = flux_kvs_lookup (map->h, NULL, 0, k1))
+        || !(req->f2 = flux_kvs_lookup (map->h, NULL, 0, k2)))
+        return -1;
+    return 0;
 }
 
-static int depthfirst_map_one (flux_t *h, const char *key, int dirskip,
-                               restart_map_f cb, void *arg)
+static int restart_job_finish (struct restart_map *map,
+                               struct restart_req *req)
 {
-    flux_jobid_t id;
-    struct job *job = NULL;
+    const char *eventlog, *jobspec;
+    struct job *job;
     int rc = -1;
 
-    if (strlen (key) <= dirskip) {
-        errno = EINVAL;
+    if (flux_kvs_lookup_get (req->f1, &eventlog) < 0
+        || flux_kvs_lookup_get (req->f2, &jobspec) < 0)
         return -1;
-    }
-    if (fluid_decode (key + dirskip + 1, &id, FLUID_STRING_DOTHEX) < 0)
+    if (!(job = job_create_from_eventlog (req->id, eventlog, jobspec)))
         return -1;
-    if (!(job = lookup_job (h, id)))
-        return -1;
-    if (cb (job, arg) < 0)
+    if (map->cb (job, map->arg) < 0)
         goto done;
-    rc = 1;
+    map->count++;
+    rc = 0;
 done:
     job_decref (job);
     return rc;
 }
 
-static int depthfirst_map (flux_t *h, const char *key,
-                           int dirskip, restart_map_f cb, void *arg)
+/* Queue a job lookup for each sub-directory of a complete job key
+ * (job.A.B.C.D), or a readdir for each sub-directory otherwise.
+ */
+static int restart_dir_finish (struct restart_map *map,
+                               struct restart_req *req)
 {
-    flux_future_t *f;
     const flux_kvsdir_t *dir;
     flux_kvsitr_t *itr;
     const char *name;
     int path_level;
-    int count = 0;
     int rc = -1;
 
-    path_level = restart_count_char (key + dirskip, '.');
-    if (!(f = flux_kvs_lookup (h, NULL, FLUX_KVS_READDIR, key)))
-        return -1;
-    if (flux_kvs_lookup_get_dir (f, &dir) < 0) {
+    path_level = restart_count_char (req->key + map->dirskip, '.');
+    if (flux_kvs_lookup_get_dir (req->f1, &dir) < 0) {
         if (errno == ENOENT && path_level == 0)
-            rc = 0;
-        goto done;
+            return 0;
+        return -1;
     }
     if (!(itr = flux_kvsitr_create (dir)))
-        goto done;
+        return -1;
     while ((name = flux_kvsitr_next (itr))) {
         char *nkey;
+        flux_jobid_t id;
         int n;
+
         if (!flux_kvsdir_isdir (dir, name))
             continue;
         if (!(nkey = flux_kvsdir_key_at (dir, name)))
-            goto done_destroyitr;
-        if (path_level == 3) // orig 'key' = .A.B.C, thus 'nkey' is complete
-            n = depthfirst_map_one (h, nkey, dirskip, cb, arg);
+            goto done;
+        if (path_level == 3) { // orig 'key' = .A.B.C, thus 'nkey' is complete
+            if (strlen (nkey) <= map->dirskip) {
+                errno = EINVAL;
+                n = -1;
+            }
+            else if ((n = fluid_decode (nkey + map->dirskip + 1,
+                                        &id,
+                                        FLUID_STRING_DOTHEX)) == 0)
+                n = restart_map_push (map, NULL, id);
+        }
         else
-            n = depthfirst_map (h, nkey, dirskip, cb, arg);
+            n = restart_map_push (map, nkey, 0);
         if (n < 0) {
             int saved_errno = errno;
             free (nkey);
             errno = saved_errno;
-            goto done_destroyitr;
+            goto done;
         }
-        count += n;
         free (nkey);
     }
-    rc = count;
-done_destroyitr:
+    rc = 0;
+done:
     flux_kvsitr_destroy (itr);
+    return rc;
+}
+
+static void restart_map_destroy (struct restart_map *map)
+{
+    if (map) {
+        int saved_errno = errno;
+        struct restart_req *req;
+        if (map->todo) {
+            while ((req = zlist_pop (map->todo)))
+                restart_req_destroy (req);
+            zlist_destroy (&map->todo);
+        }
+        if (map->pending) {
+            while ((req = zlist_pop (map->pending)))
+                restart_req_destroy (req);
+            zlist_destroy (&map->pending);
+        }
+        free (map);
+        errno = saved_errno;
+    }
+}
+
+static struct restart_map *restart_map_create (flux_t *h,
+                                               int dirskip,
+                                               restart_map_f cb,
+                                               void *arg)
+{
+    struct restart_map *map;
+
+    if (!(map = calloc (1, sizeof (*map))))
+        return NULL;
+    map->h = h;
+    map->dirskip = dirskip;
+    map->cb = cb;
+    map->arg = arg;
+    if (!(map->todo = zlist_new ())
+        || !(map->pending = zlist_new ())) {
+        errno = ENOMEM;
+        goto error;
+    }
+    return map;
+error:
+    restart_map_destroy (map);
+    return NULL;
+}
+
+/* Walk the job directory under 'key', calling 'cb' for each job found.
+ * Return the number of jobs, or -1 on error.
+ */
+static int pipeline_map (flux_t *h, const char *key,
+                         int dirskip, restart_map_f cb, void *arg)
+{
+    struct restart_map *map;
+    struct restart_req *req;
+    int rc = -1;
+
+    if (!(map = restart_map_create (h, dirskip, cb, arg)))
+        return -1;
+    if (restart_map_push (map, key, 0) < 0)
+        goto done;
+    while (zlist_size (map->todo) > 0 || zlist_size (map->pending) > 0) {
+        while (zlist_size (map->pending) < RESTART_WINDOW
+               && (req = zlist_pop (map->todo))) {
+            if (restart_req_send (map, req) < 0
+                || zlist_append (map->pending, req) < 0) {
+                restart_req_destroy (req);
+                goto done;
+            }
+        }
+        req = zlist_pop (map->pending);
+        if (req->key) {
+            if (restart_dir_finish (map, req) < 0) {
+                restart_req_destroy (req);
+                goto done;
+            }
+        }
+        else {
+            if (restart_job_finish (map, req) < 0) {
+                restart_req_destroy (req);
+                goto done;
+            }
+        }
+        restart_req_destroy (req);
+    }
+    rc = map->count;
 done:
-    flux_future_destroy (f);
+    restart_map_destroy (map);
     return rc;
 }
 
@@ -206,13 +359,21 @@ int restart_from_kvs (struct job_manager *ctx)
     int dirskip = strlen (dirname);
     int count;
     struct job *job;
+    struct timespec t0;
 
     /* Load any active jobs present in the KVS at startup.
      */
-    count = depthfirst_map (ctx->h, dirname, dirskip, restart_map_cb, ctx);
+    monotime (&t0);
+    count = pipeline_map (ctx->h, dirname, dirskip, restart_map_cb, ctx);
     if (count < 0)
         return -1;
-    flux_log (ctx->h, LOG_INFO, "restart: %d jobs", count);
+    ctx->restart_jobs = count;
+    ctx->restart_time = monotime_since (t0) / 1000.;
+    flux_log (ctx->h,
+              LOG_INFO,
+              "restart: %d jobs in %.3fs",
+              count,
+              ctx->restart_time);
     /* Post flux-restart to any jobs in SCHED state, so they may
      * transition back to PRIORITY and re-obtain the priority.
      *
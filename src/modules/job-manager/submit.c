@@ -13,6 +13,7 @@
 #if HAVE_CONFIG_H
 #include "config.h"
 #endif
+#include <string.h>
 #include <jansson.h>
 #include <flux/core.h>
 
@@ -38,21 +39,27 @@ struct submit {
 static struct job *submit_unpack_job (json_t *o)
 {
     struct job *job;
+    const char *sender = NULL;
 
     if (!(job = job_create ()))
         return NULL;
-    if (json_unpack (o, "{s:I s:i s:i s:f s:i s:O}",
+    if (json_unpack (o, "{s:I s:i s:i s:f s:i s:O s?s}",
                         "id", &job->id,
                         "urgency", &job->urgency,
                         "userid", &job->userid,
                         "t_submit", &job->t_submit,
                         "flags", &job->flags,
-                        "jobspec", &job->jobspec_redacted) < 0) {
+                        "jobspec", &job->jobspec_redacted,
+                        "sender", &sender) < 0) {
         errno = EPROTO;
-        job_decref (job);
-        job = NULL;
+        goto error;
     }
+    if (sender && !(job->sender = strdup (sender)))
+        goto error;
     return job;
+error:
+    job_decref (job);
+    return NULL;
 }
 
 zlistx_t *submit_jobs_to_list (json_t *jobs)
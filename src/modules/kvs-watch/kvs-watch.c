@@ -15,12 +15,14 @@
 #endif
 #include <jansson.h>
 #include <assert.h>
+#include <string.h>
 #include <flux/core.h>
 
 #include "src/common/libczmqcontainers/czmq_containers.h"
 #include "src/common/libkvs/treeobj.h"
 #include "src/common/libkvs/kvs_util_private.h"
 #include "src/common/libutil/blobref.h"
+#include "src/common/libutil/errno_safe.h"
 
 /* State for one watcher */
 struct watcher {
@@ -41,6 +43,16 @@ struct watcher {
     struct ns_monitor *nsm;     // back pointer for removal
     json_t *prev;               // previous watch value for KVS_WATCH_FULL/UNIQ
     int append_offset;          // offset for KVS_WATCH_APPEND
+    int append_blobs;           // valref blobs sent for KVS_WATCH_APPEND
+    bool append_treeobj;        // lookup treeobj for KVS_WATCH_APPEND
+};
+
+/* Blobs being loaded for a KVS_WATCH_APPEND watcher,
+ * stored in the aux of the content load future.
+ */
+struct append_load {
+    int count;                  // number of blobs in load request
+    int blobs;                  // valref blob count after this load
 };
 
 /* Current KVS root.
@@ -75,8 +87,17 @@ struct watch_ctx {
     flux_t *h;
     flux_msg_handler_t **handlers;
     zhash_t *namespaces;        // hash of monitored namespaces
+    int64_t append_bytes_loaded;  // KVS_WATCH_APPEND blob bytes loaded
+    int64_t append_bytes_avoided; // KVS_WATCH_APPEND bytes not reloaded
 };
 
+static void lookup_continuation (flux_future_t *f, void *arg);
+static flux_future_t *lookupat (flux_t *h,
+                                struct watcher *w,
+                                const char *blobref,
+                                int root_seq,
+                                const char *ns);
+
 static void watcher_destroy (struct watcher *w)
 {
     if (w) {
@@ -111,6 +132,14 @@ static struct watcher *watcher_create (const flux_msg_t *msg, const char *key,
         goto error_nomem;
     w->flags = flags;
     w->rootseq = -1;
+    /* If the key's valref treeobj is available, only newly appended
+     * blobs need be loaded on each change.  See handle_append_treeobj().
+     */
+    if ((flags & FLUX_KVS_WATCH_APPEND)
+        && !(flags & (FLUX_KVS_TREEOBJ
+                      | FLUX_KVS_READDIR
+                      | FLUX_KVS_READLINK)))
+        w->append_treeobj = true;
     return w;
 error_nomem:
     errno = ENOMEM;
@@ -363,6 +392,167 @@ static int handle_append_response (flux_t *h,
     return 0;
 }
 
+/* Push a future that must complete before the response being processed
+ * onto the head of w->lookups, so responses remain in commit order.
+ */
+static int watcher_push_lookup (struct watcher *w, flux_future_t *f)
+{
+    if (zlist_push (w->lookups, f) < 0) {
+        errno = ENOMEM;
+        return -1;
+    }
+    if (flux_future_then (f, -1., lookup_continuation, w) < 0) {
+        zlist_remove (w->lookups, f);
+        return -1;
+    }
+    return 0;
+}
+
+/* KVS_WATCH_APPEND lookups are made with FLUX_KVS_TREEOBJ.  If the key
+ * is a valref, send a content load request for the blobs appended since
+ * the last response, rather than having the KVS load and return the
+ * whole value on every change.  The response is sent by
+ * handle_append_load().
+ */
+static int handle_append_treeobj (flux_t *h,
+                                  struct watcher *w,
+                                  json_t *val,
+                                  const char *rootref,
+                                  int root_seq,
+                                  bool initial)
+{
+    struct watch_ctx *ctx = w->nsm->ctx;
+    struct append_load *al = NULL;
+    const char **refs = NULL;
+    flux_future_t *f = NULL;
+    int first;
+    int count;
+    int i;
+
+    if (treeobj_is_symlink (val)) {
+        /* The link may be retargeted, so stop using treeobj lookups
+         * for this watcher and look up the value at the same root.
+         */
+        w->append_treeobj = false;
+        if (!(f = lookupat (h, w, rootref, root_seq, w->nsm->ns_name)))
+            return -1;
+        if (initial && flux_future_aux_set (f, "initial", f, NULL) < 0)
+            goto error;
+        if (watcher_push_lookup (w, f) < 0)
+            goto error;
+        return 0;
+    }
+    if (treeobj_is_val (val)) {
+        /* A val is converted to a valref with one blob on first append.
+         */
+        w->append_blobs = 1;
+        if (initial)
+            return handle_initial_response (h, w, val, root_seq);
+        return handle_append_response (h, w, val);
+    }
+    if (!treeobj_is_valref (val)) {
+        errno = EISDIR;
+        return -1;
+    }
+    if (initial)
+        w->initial_rootseq = root_seq;
+    if ((count = treeobj_get_count (val)) < 0)
+        return -1;
+    first = w->responded ? w->append_blobs : 0;
+    /* Blobs are never removed by an append, so the key must have been
+     * overwritten.
+     */
+    if (count < first) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (count == first) {
+        json_t *empty;
+        if (!(empty = treeobj_create_val (NULL, 0)))
+            return -1;
+        if (flux_respond_pack (h, w->request, "{ s:o }", "val", empty) < 0) {
+            flux_log_error (h, "%s: flux_respond_pack", __FUNCTION__);
+            return -1;
+        }
+        w->responded = true;
+        return 0;
+    }
+    if (!(al = calloc (1, sizeof (*al))))
+        return -1;
+    al->count = count - first;
+    al->blobs = count;
+    if (!(refs = calloc (al->count + 1, sizeof (refs[0]))))
+        goto error;
+    for (i = 0; i < al->count; i++) {
+        if (!(refs[i] = treeobj_get_blobref (val, first + i)))
+            goto error;
+    }
+    if (!(f = flux_content_load_batch (h, refs, al->count, 0)))
+        goto error;
+    if (flux_future_aux_set (f, "append-load", al, free) < 0)
+        goto error;
+    al = NULL;
+    if (watcher_push_lookup (w, f) < 0)
+        goto error;
+    if (first > 0)
+        ctx->append_bytes_avoided += w->append_offset;
+    free (refs);
+    return 0;
+error:
+    ERRNO_SAFE_WRAP (free, al);
+    ERRNO_SAFE_WRAP (free, refs);
+    flux_future_destroy (f);
+    return -1;
+}
+
+/* Newly appended blobs have been loaded from the content cache.
+ * Respond with their concatenated data.
+ */
+static int handle_append_load (flux_t *h, struct watcher *w, flux_future_t *f)
+{
+    struct watch_ctx *ctx = w->nsm->ctx;
+    struct append_load *al = flux_future_aux_get (f, "append-load");
+    const void *buf;
+    int len;
+    char *data = NULL;
+    int total = 0;
+    json_t *val;
+    int i;
+
+    for (i = 0; i < al->count; i++) {
+        if (flux_content_load_batch_get (f, i, &buf, &len) < 0) {
+            flux_log_error (h, "%s: flux_content_load_batch_get", __FUNCTION__);
+            return -1;
+        }
+        total += len;
+    }
+    if (total > 0 && !(data = malloc (total)))
+        return -1;
+    total = 0;
+    for (i = 0; i < al->count; i++) {
+        (void)flux_content_load_batch_get (f, i, &buf, &len);
+        if (len > 0)
+            memcpy (data + total, buf, len);
+        total += len;
+    }
+    val = treeobj_create_val (data, total);
+    free (data);
+    if (!val)
+        return -1;
+    if (flux_respond_pack (h, w->request, "{ s:o }", "val", val) < 0) {
+        flux_log_error (h, "%s: flux_respond_pack", __FUNCTION__);
+        return -1;
+    }
+    if (w->responded)
+        w->append_offset += total;
+    else
+        w->append_offset = total;
+    w->append_blobs = al->blobs;
+    w->responded = true;
+    ctx->append_bytes_loaded += total;
+    return 0;
+}
+
 static int handle_normal_response (flux_t *h,
                                    struct watcher *w,
                                    json_t *val)
@@ -389,8 +579,16 @@ static void handle_lookup_response (flux_future_t *f,
     flux_t *h = flux_future_get_flux (f);
     int errnum;
     int root_seq;
+    const char *rootref;
     json_t *val;
 
+    if (flux_future_aux_get (f, "append-load")) {
+        if (!w->mute) {
+            if (handle_append_load (h, w, f) < 0)
+                goto error;
+        }
+        return;
+    }
     if (flux_future_aux_get (f, "initial")) {
 
         w->initial_rpc_received = true;
@@ -409,9 +607,10 @@ static void handle_lookup_response (flux_future_t *f,
             goto error;
         }
 
-        if (flux_rpc_get_unpack (f, "{ s:o s:i }",
+        if (flux_rpc_get_unpack (f, "{ s:o s:i s:s }",
                                  "val", &val,
-                                 "rootseq", &root_seq) < 0) {
+                                 "rootseq", &root_seq,
+                                 "rootref", &rootref) < 0) {
             /* It is worth mentioning ENOTSUP error conditions here.
              *
              * Recall that in namespace_monitor(), an initial getroot
@@ -432,7 +631,11 @@ static void handle_lookup_response (flux_future_t *f,
             goto error;
         }
 
-        if (handle_initial_response (h, w, val, root_seq) < 0)
+        if (flux_future_aux_get (f, "treeobj")) {
+            if (handle_append_treeobj (h, w, val, rootref, root_seq, true) < 0)
+                goto error;
+        }
+        else if (handle_initial_response (h, w, val, root_seq) < 0)
             goto error;
     }
     else {
@@ -445,9 +648,10 @@ static void handle_lookup_response (flux_future_t *f,
             goto error;
         }
 
-        if (flux_rpc_get_unpack (f, "{ s:o s:i }",
+        if (flux_rpc_get_unpack (f, "{ s:o s:i s:s }",
                                  "val", &val,
-                                 "rootseq", &root_seq) < 0)
+                                 "rootseq", &root_seq,
+                                 "rootref", &rootref) < 0)
             goto error;
 
         /* if we got some setroots before the initial rpc returned,
@@ -462,7 +666,16 @@ static void handle_lookup_response (flux_future_t *f,
                     goto error;
             }
             else if (w->flags & FLUX_KVS_WATCH_APPEND) {
-                if (handle_append_response (h, w, val) < 0)
+                if (flux_future_aux_get (f, "treeobj")) {
+                    if (handle_append_treeobj (h,
+                                               w,
+                                               val,
+                                               rootref,
+                                               root_seq,
+                                               false) < 0)
+                        goto error;
+                }
+                else if (handle_append_response (h, w, val) < 0)
                     goto error;
             }
             else {
@@ -513,6 +726,7 @@ static void lookup_continuation (flux_future_t *f, void *arg)
  * - blobref param replaces treeobj
  * - namespace param (ignores namespace associated with flux_t handle)
  * - cred params (see N.B. below)
+ * - FLUX_KVS_TREEOBJ is added for KVS_WATCH_APPEND (see watcher_create())
  * Use flux_rpc_get() not flux_kvs_lookup_get() to access the response.
  */
 static flux_future_t *lookupat (flux_t *h,
@@ -524,15 +738,18 @@ static flux_future_t *lookupat (flux_t *h,
     flux_msg_t *msg;
     json_t *o = NULL;
     flux_future_t *f;
+    int flags = w->flags;
     int saved_errno;
 
+    if (w->append_treeobj)
+        flags |= FLUX_KVS_TREEOBJ;
     if (!(msg = flux_request_encode ("kvs.lookup-plus", NULL)))
         return NULL;
     if (!w->initial_rpc_sent) {
         if (flux_msg_pack (msg, "{s:s s:s s:i}",
                            "key", w->key,
                            "namespace", ns,
-                           "flags", w->flags) < 0)
+                           "flags", flags) < 0)
             goto error;
     }
     else {
@@ -540,7 +757,7 @@ static flux_future_t *lookupat (flux_t *h,
             goto error;
         if (flux_msg_pack (msg, "{s:s s:i s:i s:O}",
                            "key", w->key,
-                           "flags", w->flags,
+                           "flags", flags,
                            "rootseq", root_seq,
                            "rootdir", o) < 0)
             goto error;
@@ -554,6 +771,12 @@ static flux_future_t *lookupat (flux_t *h,
         goto error;
     if (!(f = flux_rpc_message (h, msg, FLUX_NODEID_ANY, 0)))
         goto error;
+    if (w->append_treeobj) {
+        if (flux_future_aux_set (f, "treeobj", f, NULL) < 0) {
+            flux_future_destroy (f);
+            goto error;
+        }
+    }
     if (!w->initial_rpc_sent) {
         /* just need to set an aux as a flag, pointer to 'f' as aux
          * data is random pointer choice */
@@ -1044,10 +1267,13 @@ static void stats_cb (flux_t *h, flux_msg_handler_t *mh,
         watchers += zlist_size (nsm->watchers);
         nsm = zhash_next (ctx->namespaces);
     }
-    if (flux_respond_pack (h, msg, "{s:i s:i s:O}",
+    if (flux_respond_pack (h, msg, "{s:i s:i s:O s:{s:I s:I}}",
                            "watchers", watchers,
                            "namespace-count", (int)zhash_size (ctx->namespaces),
-                           "namespaces", stats) < 0)
+                           "namespaces", stats,
+                           "append",
+                             "bytes-loaded", ctx->append_bytes_loaded,
+                             "bytes-avoided", ctx->append_bytes_avoided) < 0)
         flux_log_error (h, "%s: flux_respond_pack", __FUNCTION__);
     json_decref (stats);
     return;
@@ -48,6 +48,7 @@ struct cache_entry {
                              * set, don't use data == NULL as test, as
                              * zero length data can be valid */
     bool dirty;
+    bool prefetched;        /* loaded by prefetch, not yet used */
     int errnum;
     char *blobref;
     int refcount;
@@ -70,6 +71,8 @@ struct cache {
      * through zhx */
     struct list_head notdirty_list;
     struct list_head valid_list;
+    ssize_t hits;           /* lookups that found a valid entry */
+    ssize_t misses;
 };
 
 static double cache_now (struct cache *cache)
@@ -114,6 +117,17 @@ bool cache_entry_get_dirty (struct cache_entry *entry)
     return (entry && entry->valid && entry->dirty);
 }
 
+bool cache_entry_get_prefetched (struct cache_entry *entry)
+{
+    return (entry && entry->prefetched);
+}
+
+void cache_entry_set_prefetched (struct cache_entry *entry, bool val)
+{
+    if (entry)
+        entry->prefetched = val;
+}
+
 int cache_entry_set_dirty (struct cache_entry *entry, bool val)
 {
     if (entry && entry->valid) {
@@ -360,6 +374,10 @@ struct cache_entry *cache_lookup (struct cache *cache, const char *ref)
     double current_time = cache_now (cache);
     if (entry && current_time > entry->lastuse_time)
         entry->lastuse_time = current_time;
+    if (entry && entry->valid)
+        cache->hits++;
+    else
+        cache->misses++;
     return entry;
 }
 
@@ -405,6 +423,16 @@ int cache_count_entries (struct cache *cache)
     return zhashx_size (cache->zhx);
 }
 
+void cache_get_lookup_stats (struct cache *cache,
+                             ssize_t *hits,
+                             ssize_t *misses)
+{
+    if (hits)
+        *hits = cache->hits;
+    if (misses)
+        *misses = cache->misses;
+}
+
 static int cache_entry_age (struct cache_entry *entry, struct cache *cache)
 {
     double current_time = cache_now (cache);
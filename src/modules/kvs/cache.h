@@ -59,6 +59,13 @@ int cache_entry_set_dirty (struct cache_entry *entry, bool val);
 int cache_entry_clear_dirty (struct cache_entry *entry);
 int cache_entry_force_clear_dirty (struct cache_entry *entry);
 
+/* Get/set cache entry's prefetch bit.
+ * The prefetch bit indicates that the entry was loaded speculatively,
+ * and has not yet been used by a lookup.
+ */
+bool cache_entry_get_prefetched (struct cache_entry *entry);
+void cache_entry_set_prefetched (struct cache_entry *entry, bool val);
+
 /* take/remove reference on the cache entry.  Useful if you are using
  * data from cache_entry_get_raw() or cache_entry_get_treeobj() and do
  * not want the cache entry to accidentally expire.
@@ -138,6 +145,13 @@ int cache_remove_entry (struct cache *cache, const char *ref);
  */
 int cache_count_entries (struct cache *cache);
 
+/* Get the number of cache_lookup() calls that found a valid entry
+ * (hits), or found no entry or an incomplete one (misses).
+ */
+void cache_get_lookup_stats (struct cache *cache,
+                             ssize_t *hits,
+                             ssize_t *misses);
+
 /* Expire cache entries that are not dirty, not incomplete, and last
  * used more than 'max_age' seconds ago.  If max_age == 0, expire all
  * entries that are not dirty/incomplete.
@@ -60,6 +60,9 @@ struct kvs_ctx {
     struct cache *cache;    /* blobref => cache_entry */
     kvsroot_mgr_t *krm;
     int faults;                 /* for kvs.stats.get, etc. */
+    int prefetch;               /* max prefetch refs per lookup */
+    int prefetch_loads;         /* for kvs.stats.get */
+    int prefetch_hits;
     flux_t *h;
     uint32_t rank;
     flux_watcher_t *prep_w;
@@ -548,9 +551,11 @@ static int load (struct kvs_ctx *ctx, const char *ref, wait_t *wait, bool *stall
         ctx->faults++;
     }
     /* If hash entry is incomplete (either created above or earlier),
-     * arrange to stall caller.
+     * arrange to stall caller.  A prefetch still in flight saves a
+     * partial round trip but is not counted as a stall avoided.
      */
     if (!cache_entry_get_valid (entry)) {
+        cache_entry_set_prefetched (entry, false);
         /* Potential future optimization, if this load() is called
          * multiple times from the same kvstxn and on the same
          * reference, we're effectively adding identical waiters onto
@@ -576,6 +581,36 @@ static int load (struct kvs_ctx *ctx, const char *ref, wait_t *wait, bool *stall
     return 0;
 }
 
+/* Start loading 'ref' into the cache without a waiter, in anticipation
+ * of a lookup that would otherwise stall on it.
+ * Return 0 on success, -1 on error.
+ */
+static int prefetch (struct kvs_ctx *ctx, const char *ref)
+{
+    struct cache_entry *entry;
+    int saved_errno, ret;
+
+    if (cache_lookup (ctx->cache, ref))
+        return 0;
+    if (!(entry = cache_entry_create (ref)))
+        return -1;
+    if (cache_insert (ctx->cache, entry) < 0) {
+        cache_entry_destroy (entry);
+        return -1;
+    }
+    if (content_load_request_send (ctx, ref) < 0) {
+        saved_errno = errno;
+        /* cache entry just created, should always work */
+        ret = cache_remove_entry (ctx->cache, ref);
+        assert (ret == 1);
+        errno = saved_errno;
+        return -1;
+    }
+    cache_entry_set_prefetched (entry, true);
+    ctx->prefetch_loads++;
+    return 0;
+}
+
 /*
  * store/write
  */
@@ -1184,6 +1219,20 @@ static int heartbeat_root_cb (struct kvsroot *root, void *arg)
     return 0;
 }
 
+static void update_stats (struct kvs_ctx *ctx)
+{
+    ssize_t hits, misses;
+
+    cache_get_lookup_stats (ctx->cache, &hits, &misses);
+    flux_stats_gauge_set (ctx->h, "kvs.cache.count",
+                          cache_count_entries (ctx->cache));
+    flux_stats_count (ctx->h, "kvs.cache.hits", hits);
+    flux_stats_count (ctx->h, "kvs.cache.misses", misses);
+    flux_stats_count (ctx->h, "kvs.faults", ctx->faults);
+    flux_stats_count (ctx->h, "kvs.prefetch.loads", ctx->prefetch_loads);
+    flux_stats_count (ctx->h, "kvs.prefetch.hits", ctx->prefetch_hits);
+}
+
 static void sync_cb (flux_future_t *f, void *arg)
 {
     struct kvs_ctx *ctx = arg;
@@ -1195,6 +1244,9 @@ static void sync_cb (flux_future_t *f, void *arg)
     if (cache_expire_entries (ctx->cache, max_lastuse_age) < 0)
         flux_log_error (ctx->h, "%s: cache_expire_entries", __FUNCTION__);
 
+    if (flux_stats_enabled (ctx->h, NULL))
+        update_stats (ctx);
+
     flux_future_reset (f);
 }
 
@@ -1213,6 +1265,17 @@ static int lookup_load_cb (lookup_t *lh, const char *ref, void *data)
     return 0;
 }
 
+static int lookup_prefetch_cb (lookup_t *lh, const char *ref, void *data)
+{
+    struct kvs_ctx *ctx = data;
+
+    if (prefetch (ctx, ref) < 0) {
+        flux_log_error (ctx->h, "%s: prefetch", __FUNCTION__);
+        return -1;
+    }
+    return 0;
+}
+
 static void lookup_wait_error_cb (wait_t *w, int errnum, void *arg)
 {
     lookup_t *lh = arg;
@@ -1273,6 +1336,7 @@ static lookup_t *lookup_common (flux_t *h, flux_msg_handler_t *mh,
         if (root_dirent) {
             if (treeobj_validate (root_dirent) < 0
                 || !treeobj_is_dirref (root_dirent)
+                || treeobj_get_count (root_dirent) != 1
                 || !(root_ref = treeobj_get_blobref (root_dirent, 0))) {
                 errno = EINVAL;
                 goto done;
@@ -1294,6 +1358,8 @@ static lookup_t *lookup_common (flux_t *h, flux_msg_handler_t *mh,
                                   flags,
                                   h)))
             goto done;
+        if (lookup_set_prefetch (lh, ctx->prefetch) < 0)
+            goto done;
     }
     else {
         int err;
@@ -1360,8 +1426,12 @@ static lookup_t *lookup_common (flux_t *h, flux_msg_handler_t *mh,
     }
     /* else lret == LOOKUP_PROCESS_FINISHED, fallthrough */
 
+    /* prefetch failure is not fatal to the lookup */
+    (void)lookup_iter_prefetch_refs (lh, lookup_prefetch_cb, ctx);
+
     rc = 0;
 done:
+    ctx->prefetch_hits += lookup_get_prefetch_hits (lh);
     wait_destroy (wait);
     if (rc < 0) {
         lookup_destroy (lh);
@@ -1395,6 +1465,7 @@ static void lookup_request_cb (flux_t *h, flux_msg_handler_t *mh,
     }
     if (flux_respond_pack (h, msg, "{ s:O }", "val", val) < 0)
         flux_log_error (h, "%s: flux_respond_pack", __FUNCTION__);
+    flux_stats_timing (h, "kvs.lookup.latency", lookup_get_age (lh));
     lookup_destroy (lh);
     json_decref (val);
     return;
@@ -1446,6 +1517,7 @@ static void lookup_plus_request_cb (flux_t *h, flux_msg_handler_t *mh,
                                "rootref", root_ref) < 0)
             flux_log_error (h, "%s: flux_respond_pack", __FUNCTION__);
     }
+    flux_stats_timing (h, "kvs.lookup.latency", lookup_get_age (lh));
     lookup_destroy (lh);
     json_decref (val);
     return;
@@ -1497,6 +1569,9 @@ static void finalize_transaction_bynames (struct kvs_ctx *ctx,
         nameval = json_string_value (name);
         if ((tr = treq_mgr_lookup_transaction (root->trm, nameval))) {
             treq_iter_request_copies (tr, finalize_transaction_req, &cbd);
+            if (!errnum)
+                flux_stats_timing (ctx->h, "kvs.commit.latency",
+                                   treq_get_age (tr));
             if (treq_mgr_remove_transaction (root->trm, nameval) < 0)
                 flux_log_error (ctx->h, "%s: treq_mgr_remove_transaction",
                                 __FUNCTION__);
@@ -2143,12 +2218,14 @@ static void stats_get_cb (flux_t *h, flux_msg_handler_t *mh,
                               "max", tstat_max (&ts)*scale)))
         goto nomem;
 
-    if (!(cstats = json_pack ("{ s:f s:O s:i s:i s:i }",
+    if (!(cstats = json_pack ("{ s:f s:O s:i s:i s:i s:i s:i }",
                               "obj size total (MiB)", (double)size/1048576,
                               "obj size (KiB)", tstats,
                               "#obj dirty", dirty,
                               "#obj incomplete", incomplete,
-                              "#faults", ctx->faults)))
+                              "#faults", ctx->faults,
+                              "#prefetch", ctx->prefetch_loads,
+                              "#prefetch hits", ctx->prefetch_hits)))
         goto nomem;
 
     if (!(nsstats = json_object ()))
@@ -2205,6 +2282,8 @@ static int stats_clear_root_cb (struct kvsroot *root, void *arg)
 static void stats_clear (struct kvs_ctx *ctx)
 {
     ctx->faults = 0;
+    ctx->prefetch_loads = 0;
+    ctx->prefetch_hits = 0;
 
     if (kvsroot_mgr_iter_roots (ctx->krm, stats_clear_root_cb, NULL) < 0)
         flux_log_error (ctx->h, "%s: kvsroot_mgr_iter_roots", __FUNCTION__);
@@ -2493,10 +2572,11 @@ static int namespace_list_cb (struct kvsroot *root, void *arg)
     if (root->remove)
         return 0;
 
-    if (!(o = json_pack ("{ s:s s:i s:i }",
+    if (!(o = json_pack ("{ s:s s:i s:i s:s }",
                          "namespace", root->ns_name,
                          "owner", root->owner,
-                         "flags", root->flags))) {
+                         "flags", root->flags,
+                         "rootref", root->ref))) {
         errno = ENOMEM;
         return -1;
     }
@@ -2702,6 +2782,8 @@ static void process_args (struct kvs_ctx *ctx, int ac, char **av)
     for (i = 0; i < ac; i++) {
         if (strncmp (av[i], "transaction-merge=", 13) == 0)
             ctx->transaction_merge = strtoul (av[i]+13, NULL, 10);
+        else if (strncmp (av[i], "prefetch=", 9) == 0)
+            ctx->prefetch = strtoul (av[i]+9, NULL, 10);
         else
             flux_log (ctx->h, LOG_ERR, "Unknown option `%s'", av[i]);
     }
@@ -36,11 +36,25 @@
 #define KVSTXN_MERGED          0x02 /* kvstxn is a merger of transactions */
 #define KVSTXN_MERGE_COMPONENT 0x04 /* kvstxn is member of a merger */
 
+/* A modified directory with more than HDIR_THRESHOLD entries is stored
+ * as a hashed directory (hdir), and an hdir bucket with more than
+ * HDIR_BUCKET_MAX entries is split.  An hdir is an RFC 11 dirref with
+ * more than one blobref, each referring to a dir object (bucket) that
+ * holds the entries whose names hash to it (see treeobj_dirref_index()).
+ * While a transaction is applied, buckets that are modified are replaced
+ * in the dirref's blobref array by copies of their dir objects, and
+ * stored again by kvstxn_unroll().
+ */
+#define HDIR_THRESHOLD         1024
+#define HDIR_BUCKET_MAX        512
+
 struct kvstxn_mgr {
     struct cache *cache;
     const char *ns_name;
     const char *hash_name;
     int noop_stores;            /* for kvs.stats.get, etc.*/
+    int hdir_threshold;
+    int hdir_bucket_max;
     zlist_t *ready;
     flux_t *h;
     void *aux;
@@ -346,8 +360,112 @@ static int store_cache (kvstxn_t *kt, json_t *o,
     return -1;
 }
 
+static int kvstxn_unroll (kvstxn_t *kt, json_t *dir);
+
+/* Store 'o' and add its cache entry to the dirty list if necessary.
+ */
+static int kvstxn_store_treeobj (kvstxn_t *kt, json_t *o,
+                                 char *ref, int ref_len)
+{
+    struct cache_entry *entry;
+    int ret;
+
+    if ((ret = store_cache (kt, o, false, ref, ref_len, &entry)) < 0)
+        return -1;
+    if (ret) {
+        if (kvstxn_add_dirty_cache_entry (kt, entry) < 0)
+            return -1;
+    }
+    return 0;
+}
+
+/* Distribute the entries of a large dir object over an array of new
+ * buckets (dir objects).  Buckets are filled to about half of
+ * hdir_bucket_max.
+ */
+static json_t *kvstxn_hdir_create (kvstxn_t *kt, json_t *dir)
+{
+    json_t *buckets;
+    json_t *dir_data;
+    const char *name;
+    json_t *dir_entry;
+    int count;
+    int i;
+
+    count = treeobj_get_count (dir) / (kt->ktm->hdir_bucket_max / 2 + 1) + 1;
+    if (!(dir_data = treeobj_get_data (dir))
+        || !(buckets = json_array ()))
+        return NULL;
+    for (i = 0; i < count; i++) {
+        if (json_array_append_new (buckets, treeobj_create_dir ()) < 0)
+            goto nomem;
+    }
+    json_object_foreach (dir_data, name, dir_entry) {
+        json_t *bucket = json_array_get (buckets,
+                                         treeobj_dirref_index (name, count));
+        if (treeobj_insert_entry_novalidate (bucket, name, dir_entry) < 0)
+            goto error;
+    }
+    return buckets;
+nomem:
+    errno = ENOMEM;
+error:
+    json_decref (buckets);
+    return NULL;
+}
+
+/* Store the modified (dir object) buckets in array 'buckets',
+ * replacing them with blobrefs.
+ */
+static int kvstxn_hdir_store (kvstxn_t *kt, json_t *buckets)
+{
+    json_t *bucket;
+    size_t index;
+
+    json_array_foreach (buckets, index, bucket) {
+        char bucket_ref[BLOBREF_MAX_STRING_SIZE];
+
+        if (!treeobj_is_dir (bucket))
+            continue;
+        if (kvstxn_unroll (kt, bucket) < 0 /* depth first */
+            || kvstxn_store_treeobj (kt, bucket,
+                                     bucket_ref, sizeof (bucket_ref)) < 0)
+            return -1;
+        if (json_array_set_new (buckets, index,
+                                json_string (bucket_ref)) < 0) {
+            errno = ENOMEM;
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/* Create a dirref from an array of stored bucket blobrefs.
+ */
+static json_t *kvstxn_hdir_dirref (json_t *buckets)
+{
+    json_t *dirref = NULL;
+    json_t *ref;
+    size_t index;
+
+    json_array_foreach (buckets, index, ref) {
+        if (!dirref) {
+            if (!(dirref = treeobj_create_dirref (json_string_value (ref))))
+                return NULL;
+        }
+        else if (treeobj_append_blobref (dirref, json_string_value (ref)) < 0) {
+            json_decref (dirref);
+            return NULL;
+        }
+    }
+    if (!dirref)
+        errno = EINVAL;
+    return dirref;
+}
+
 /* Store DIRVAL objects, converting them to DIRREFs.
  * Store (large) FILEVAL objects, converting them to FILEREFs.
+ * Large DIRVAL objects are stored as hashed directories.
  * Return 0 on success, -1 on error
  */
 static int kvstxn_unroll (kvstxn_t *kt, json_t *dir)
@@ -375,21 +493,37 @@ static int kvstxn_unroll (kvstxn_t *kt, json_t *dir)
         if (treeobj_is_dir (dir_entry)) {
             if (kvstxn_unroll (kt, dir_entry) < 0) /* depth first */
                 return -1;
-            if ((ret = store_cache (kt, dir_entry,
-                                    false, ref, sizeof (ref), &entry)) < 0)
-                return -1;
-            if (ret) {
-                if (kvstxn_add_dirty_cache_entry (kt, entry) < 0)
+            if (kt->ktm->hdir_threshold > 0
+                && treeobj_get_count (dir_entry) > kt->ktm->hdir_threshold) {
+                json_t *buckets;
+
+                if (!(buckets = kvstxn_hdir_create (kt, dir_entry)))
+                    return -1;
+                if (kvstxn_hdir_store (kt, buckets) < 0
+                    || !(ktmp = kvstxn_hdir_dirref (buckets))) {
+                    json_decref (buckets);
+                    return -1;
+                }
+                json_decref (buckets);
+            }
+            else {
+                if (kvstxn_store_treeobj (kt, dir_entry, ref, sizeof (ref)) < 0)
+                    return -1;
+                if (!(ktmp = treeobj_create_dirref (ref)))
                     return -1;
             }
-            if (!(ktmp = treeobj_create_dirref (ref)))
-                return -1;
             if (json_object_iter_set_new (dir, iter, ktmp) < 0) {
                 json_decref (ktmp);
                 errno = ENOMEM;
                 return -1;
             }
         }
+        else if (treeobj_is_dirref (dir_entry)
+                 && treeobj_get_count (dir_entry) > 1) {
+            /* store hdir buckets modified in place */
+            if (kvstxn_hdir_store (kt, treeobj_get_data (dir_entry)) < 0)
+                return -1;
+        }
         else if (treeobj_is_val (dir_entry)) {
             json_t *val_data;
 
@@ -556,6 +690,141 @@ static int kvstxn_append (kvstxn_t *kt, json_t *dirent,
     return 0;
 }
 
+/* Get the bucket of hdir 'hdir' that 'name' hashes to.  If
+ * the bucket is a blobref, replace it with a copy of the dir object from
+ * the cache, so it can be modified.  If the dir object is not cached,
+ * set 'missing_ref' and leave 'bucketp' NULL.
+ * Return 0 on success, -1 on error.
+ */
+static int kvstxn_hdir_bucket (kvstxn_t *kt, json_t *hdir,
+                               const char *name, json_t **bucketp,
+                               const char **missing_ref)
+{
+    struct cache_entry *entry;
+    json_t *hdir_data;
+    const json_t *bucket;
+    json_t *cpy;
+    json_t *o;
+    const char *ref;
+    int index;
+
+    if (!(hdir_data = treeobj_get_data (hdir))
+        || (index = treeobj_dirref_index (name,
+                                          json_array_size (hdir_data))) < 0
+        || !(o = json_array_get (hdir_data, index))) {
+        errno = ENOTRECOVERABLE;
+        return -1;
+    }
+    if (treeobj_is_dir (o)) {
+        *bucketp = o;
+        return 0;
+    }
+    if (!(ref = json_string_value (o))) {
+        errno = ENOTRECOVERABLE;
+        return -1;
+    }
+    if (!(entry = cache_lookup (kt->ktm->cache, ref))
+        || !cache_entry_get_valid (entry)) {
+        *missing_ref = ref;
+        *bucketp = NULL;
+        return 0;
+    }
+    if (!(bucket = cache_entry_get_treeobj (entry))
+        || !treeobj_is_dir (bucket)) {
+        errno = ENOTRECOVERABLE;
+        return -1;
+    }
+    /* do not corrupt store by modifying orig. */
+    if (!(cpy = treeobj_deep_copy (bucket)))
+        return -1;
+    if (json_array_set_new (hdir_data, index, cpy) < 0) {
+        errno = ENOMEM;
+        return -1;
+    }
+    *bucketp = cpy;
+    return 0;
+}
+
+/* Split the next bucket of hdir 'hdir' in linear hashing order,
+ * appending a new bucket.  If the bucket to split is not cached, set
+ * 'missing_ref'.  Return 0 on success, -1 on error.
+ */
+static int kvstxn_hdir_split (kvstxn_t *kt, json_t *hdir,
+                              const char **missing_ref)
+{
+    json_t *hdir_data;
+    json_t *bucket_data;
+    json_t *bucket;
+    json_t *cpy = NULL;
+    json_t *stay = NULL;
+    json_t *move = NULL;
+    const char *name;
+    json_t *dir_entry;
+    int count, level, index;
+    int rc;
+
+    if (!(hdir_data = treeobj_get_data (hdir))) {
+        errno = ENOTRECOVERABLE;
+        return -1;
+    }
+    count = json_array_size (hdir_data);
+    for (level = 1; level * 2 <= count; level *= 2)
+        ;
+    index = count - level;
+
+    bucket = json_array_get (hdir_data, index);
+    if (!treeobj_is_dir (bucket)) {
+        const char *ref = json_string_value (bucket);
+        struct cache_entry *entry;
+        const json_t *o;
+
+        if (!ref) {
+            errno = ENOTRECOVERABLE;
+            return -1;
+        }
+        if (!(entry = cache_lookup (kt->ktm->cache, ref))
+            || !cache_entry_get_valid (entry)) {
+            *missing_ref = ref;
+            return 0;
+        }
+        if (!(o = cache_entry_get_treeobj (entry)) || !treeobj_is_dir (o)) {
+            errno = ENOTRECOVERABLE;
+            return -1;
+        }
+        /* do not corrupt store by modifying orig. */
+        if (!(bucket = cpy = treeobj_deep_copy (o)))
+            return -1;
+    }
+    if (!(bucket_data = treeobj_get_data (bucket))
+        || !(stay = treeobj_create_dir ())
+        || !(move = treeobj_create_dir ()))
+        goto nomem;
+    json_object_foreach (bucket_data, name, dir_entry) {
+        json_t *dst = (treeobj_dirref_index (name, count + 1) == index)
+                      ? stay : move;
+        if (treeobj_insert_entry_novalidate (dst, name, dir_entry) < 0)
+            goto error;
+    }
+    /* json_array_*_new() steal the reference, even on failure */
+    rc = json_array_set_new (hdir_data, index, stay);
+    stay = NULL;
+    if (rc < 0)
+        goto nomem;
+    rc = json_array_append_new (hdir_data, move);
+    move = NULL;
+    if (rc < 0)
+        goto nomem;
+    json_decref (cpy);
+    return 0;
+nomem:
+    errno = ENOMEM;
+error:
+    json_decref (cpy);
+    json_decref (stay);
+    json_decref (move);
+    return -1;
+}
+
 /* link (key, dirent) into directory 'dir'.
  */
 static int kvstxn_link_dirent (kvstxn_t *kt,
@@ -567,6 +836,7 @@ static int kvstxn_link_dirent (kvstxn_t *kt,
     char *cpy = NULL;
     char *next, *name;
     json_t *dir = rootdir;
+    json_t *hdir = NULL;
     json_t *subdir = NULL, *dir_entry;
     int saved_errno, rc = -1;
 
@@ -591,6 +861,15 @@ static int kvstxn_link_dirent (kvstxn_t *kt,
     while ((next = strchr (name, '.'))) {
         *next++ = '\0';
 
+        if (treeobj_is_dirref (dir)) {
+            if (kvstxn_hdir_bucket (kt, dir, name, &dir, missing_ref) < 0) {
+                saved_errno = errno;
+                goto done;
+            }
+            if (!dir)
+                goto success; /* stall */
+        }
+
         if (!treeobj_is_dir (dir)) {
             saved_errno = ENOTRECOVERABLE;
             goto done;
@@ -612,6 +891,10 @@ static int kvstxn_link_dirent (kvstxn_t *kt,
             json_decref (subdir);
         } else if (treeobj_is_dir (dir_entry)) {
             subdir = dir_entry;
+        } else if (treeobj_is_dirref (dir_entry)
+                   && treeobj_get_count (dir_entry) > 1) {
+            /* hdir buckets are loaded as needed, within the dirref */
+            subdir = dir_entry;
         } else if (treeobj_is_dirref (dir_entry)) {
             struct cache_entry *entry;
             const char *ref;
@@ -712,8 +995,17 @@ static int kvstxn_link_dirent (kvstxn_t *kt,
         dir = subdir;
     }
     /* This is the final path component of the key.  Add/modify/delete
-     * it in the directory.
+     * it in the directory, or in the hdir bucket it hashes to.
      */
+    if (treeobj_is_dirref (dir)) {
+        hdir = dir;
+        if (kvstxn_hdir_bucket (kt, hdir, name, &dir, missing_ref) < 0) {
+            saved_errno = errno;
+            goto done;
+        }
+        if (!dir)
+            goto success; /* stall */
+    }
     if (!json_is_null (dirent)) {
         if (flags & FLUX_KVS_APPEND) {
             if (kvstxn_append (kt, dirent, dir, name, append) < 0) {
@@ -743,6 +1035,12 @@ static int kvstxn_link_dirent (kvstxn_t *kt,
             }
         }
     }
+    if (hdir && treeobj_get_count (dir) > kt->ktm->hdir_bucket_max) {
+        if (kvstxn_hdir_split (kt, hdir, missing_ref) < 0) {
+            saved_errno = errno;
+            goto done;
+        }
+    }
  success:
     rc = 0;
  done:
@@ -1088,6 +1386,8 @@ kvstxn_mgr_t *kvstxn_mgr_create (struct cache *cache,
     }
     ktm->h = h;
     ktm->aux = aux;
+    ktm->hdir_threshold = HDIR_THRESHOLD;
+    ktm->hdir_bucket_max = HDIR_BUCKET_MAX;
     return ktm;
 
  error:
@@ -1179,6 +1479,19 @@ void kvstxn_mgr_remove_transaction (kvstxn_mgr_t *ktm, kvstxn_t *kt,
     }
 }
 
+int kvstxn_mgr_set_hdir_limits (kvstxn_mgr_t *ktm,
+                                int threshold,
+                                int bucket_max)
+{
+    if (!ktm || threshold < 0 || bucket_max < 1) {
+        errno = EINVAL;
+        return -1;
+    }
+    ktm->hdir_threshold = threshold;
+    ktm->hdir_bucket_max = bucket_max;
+    return 0;
+}
+
 int kvstxn_mgr_get_noop_stores (kvstxn_mgr_t *ktm)
 {
     return ktm->noop_stores;
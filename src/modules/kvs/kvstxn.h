@@ -172,6 +172,15 @@ kvstxn_t *kvstxn_mgr_get_ready_transaction (kvstxn_mgr_t *ktm);
 void kvstxn_mgr_remove_transaction (kvstxn_mgr_t *ktm, kvstxn_t *kt,
                                     bool fallback);
 
+/* Set the directory size above which a modified directory is stored
+ * as a hashed directory (hdir), and the bucket size above which an hdir
+ * bucket is split.  A threshold of 0 disables hdir creation, though
+ * existing hdirs are still updated.  Returns -1 on error, 0 on success.
+ */
+int kvstxn_mgr_set_hdir_limits (kvstxn_mgr_t *ktm,
+                                int threshold,
+                                int bucket_max);
+
 int kvstxn_mgr_get_noop_stores (kvstxn_mgr_t *ktm);
 void kvstxn_mgr_clear_noop_stores (kvstxn_mgr_t *ktm);
 
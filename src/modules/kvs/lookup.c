@@ -25,6 +25,7 @@
 
 #include "src/common/libczmqcontainers/czmq_containers.h"
 #include "src/common/libutil/blobref.h"
+#include "src/common/libutil/monotime.h"
 #include "src/common/libkvs/treeobj.h"
 #include "src/common/libkvs/kvs_util_private.h"
 
@@ -76,7 +77,8 @@ struct lookup {
     json_t *val;           /* value of lookup */
 
     /* if valref_missing_refs is true, iterate on refs, else
-     * return missing_ref string.
+     * return missing_ref string.  valref_missing_refs may also be
+     * a dirref with several blobrefs, when all of its buckets are needed.
      */
     const json_t *valref_missing_refs;
     const char *missing_ref;
@@ -88,6 +90,12 @@ struct lookup {
     int errnum;                 /* errnum if error */
     int aux_errnum;
 
+    /* prefetch */
+    int prefetch_max;           /* max child dirrefs to prefetch */
+    int prefetch_hits;          /* prefetched cache entries used */
+
+    struct timespec t_create;   /* for lookup latency */
+
     /* API internal */
     zlist_t *levels;
     const json_t *wdirent;       /* result after walk() */
@@ -102,6 +110,24 @@ struct lookup {
     } state;
 };
 
+/* Look up 'ref' in the cache, returning the entry only if it is valid.
+ * The first use of an entry that was loaded by a prefetch is a stall
+ * avoided, and is counted.
+ */
+static struct cache_entry *cache_lookup_valid (lookup_t *lh, const char *ref)
+{
+    struct cache_entry *entry;
+
+    if (!(entry = cache_lookup (lh->cache, ref))
+        || !cache_entry_get_valid (entry))
+        return NULL;
+    if (cache_entry_get_prefetched (entry)) {
+        cache_entry_set_prefetched (entry, false);
+        lh->prefetch_hits++;
+    }
+    return entry;
+}
+
 static bool last_pathcomp (zlist_t *pathcomps, const void *data)
 {
     return (zlist_tail (pathcomps) == data);
@@ -350,6 +376,83 @@ cleanup:
     return ret;
 }
 
+/* Set lh->val to a copy of the directory referred to by 'dirref'.  If
+ * 'dirref' has more than one blobref, merge the dir objects ("buckets")
+ * into a single dir object.  Stall (lh->missing_ref or
+ * lh->valref_missing_refs set) if any dir object is not cached.
+ * Return 0 on success, -1 on error.  On success, stall should be checked.
+ */
+static int get_dirref_value (lookup_t *lh, const json_t *dirref, bool *stall)
+{
+    json_t *val = NULL;
+    json_t *val_data;
+    int count, i;
+
+    if ((count = treeobj_get_count (dirref)) < 0) {
+        lh->errnum = errno;
+        return -1;
+    }
+    if (count == 0) {
+        flux_log (lh->h, LOG_ERR, "invalid dirref count: %d", count);
+        lh->errnum = ENOTRECOVERABLE;
+        return -1;
+    }
+    for (i = 0; i < count; i++) {
+        const char *ref = treeobj_get_blobref (dirref, i);
+        if (!ref) {
+            lh->errnum = errno;
+            return -1;
+        }
+        if (!cache_lookup_valid (lh, ref)) {
+            if (count == 1)
+                lh->missing_ref = ref;
+            else
+                lh->valref_missing_refs = dirref;
+            (*stall) = true;
+            return 0;
+        }
+    }
+    if (!(val = treeobj_create_dir ())) {
+        lh->errnum = errno;
+        return -1;
+    }
+    val_data = treeobj_get_data (val);
+    for (i = 0; i < count; i++) {
+        struct cache_entry *entry;
+        const json_t *bucket;
+        json_t *cpy;
+
+        entry = cache_lookup (lh->cache, treeobj_get_blobref (dirref, i));
+        assert (cache_entry_get_valid (entry));
+        if (!(bucket = cache_entry_get_treeobj (entry))) {
+            flux_log (lh->h, LOG_ERR, "dirref points to non-treeobj");
+            lh->errnum = ENOTRECOVERABLE;
+            goto error;
+        }
+        if (!treeobj_is_dir (bucket)) {
+            /* dirref points to not dir */
+            lh->errnum = ENOTRECOVERABLE;
+            goto error;
+        }
+        if (!(cpy = treeobj_deep_copy (bucket))) {
+            lh->errnum = errno;
+            goto error;
+        }
+        if (json_object_update (val_data, treeobj_get_data (cpy)) < 0) {
+            json_decref (cpy);
+            lh->errnum = ENOMEM;
+            goto error;
+        }
+        json_decref (cpy);
+    }
+    lh->val = val;
+    (*stall) = false;
+    return 0;
+error:
+    json_decref (val);
+    return -1;
+}
+
 /* Get dirent of the requested path starting at the given root.
  *
  * Return true on success or error, error code is returned in ep and
@@ -377,25 +480,29 @@ static lookup_process_t walk (lookup_t *lh)
         if (treeobj_is_dirref (wl->dirent)) {
             const char *refstr;
             int refcount;
+            int index;
 
             if ((refcount = treeobj_get_count (wl->dirent)) < 0) {
                 lh->errnum = errno;
                 goto error;
             }
 
-            if (refcount != 1) {
+            if (refcount == 0) {
                 flux_log (lh->h, LOG_ERR, "invalid dirref count: %d", refcount);
                 lh->errnum = ENOTRECOVERABLE;
                 goto error;
             }
 
-            if (!(refstr = treeobj_get_blobref (wl->dirent, 0))) {
+            /* A dirref with several blobrefs refers to the buckets of a
+             * large directory, descend to the one pathcomp hashes to.
+             */
+            index = treeobj_dirref_index (pathcomp, refcount);
+            if (!(refstr = treeobj_get_blobref (wl->dirent, index))) {
                 lh->errnum = errno;
                 goto error;
             }
 
-            if (!(entry = cache_lookup (lh->cache, refstr))
-                || !cache_entry_get_valid (entry)) {
+            if (!(entry = cache_lookup_valid (lh, refstr))) {
                 lh->missing_ref = refstr;
                 return LOOKUP_PROCESS_LOAD_MISSING_REFS;
             }
@@ -566,6 +673,7 @@ lookup_t *lookup_create (struct cache *cache,
     }
 
     lh->h = h;
+    monotime (&lh->t_create);
 
     lh->cred = cred;
     lh->flags = flags;
@@ -652,7 +760,8 @@ int lookup_iter_missing_refs (lookup_t *lh, lookup_ref_f cb, void *data)
         if (lh->valref_missing_refs) {
             int refcount, i;
 
-            if (!treeobj_is_valref (lh->valref_missing_refs)) {
+            if (!treeobj_is_valref (lh->valref_missing_refs)
+                && !treeobj_is_dirref (lh->valref_missing_refs)) {
                 errno = ENOTRECOVERABLE;
                 return -1;
             }
@@ -687,6 +796,72 @@ int lookup_iter_missing_refs (lookup_t *lh, lookup_ref_f cb, void *data)
     return -1;
 }
 
+int lookup_set_prefetch (lookup_t *lh, int max)
+{
+    if (!lh || max < 0) {
+        errno = EINVAL;
+        return -1;
+    }
+    lh->prefetch_max = max;
+    return 0;
+}
+
+int lookup_get_prefetch_hits (lookup_t *lh)
+{
+    if (lh)
+        return lh->prefetch_hits;
+    return 0;
+}
+
+double lookup_get_age (lookup_t *lh)
+{
+    if (lh)
+        return monotime_since (lh->t_create);
+    return 0.;
+}
+
+int lookup_iter_prefetch_refs (lookup_t *lh, lookup_ref_f cb, void *data)
+{
+    json_t *dir_data;
+    const char *name;
+    json_t *dirent;
+    int count = 0;
+
+    if (!lh) {
+        errno = EINVAL;
+        return -1;
+    }
+    /* Only a directory returned by a successful FLUX_KVS_READDIR
+     * lookup is a candidate.  Its sub-directories are likely to be
+     * looked up next by a caller walking the tree recursively.
+     */
+    if (lh->state != LOOKUP_STATE_FINISHED
+        || lh->errnum != 0
+        || !(lh->flags & FLUX_KVS_READDIR)
+        || !lh->val
+        || !treeobj_is_dir (lh->val)
+        || lh->prefetch_max == 0)
+        return 0;
+    if (!(dir_data = treeobj_get_data (lh->val)))
+        return -1;
+    json_object_foreach (dir_data, name, dirent) {
+        const char *ref;
+
+        if (count == lh->prefetch_max)
+            break;
+        if (!treeobj_is_dirref (dirent)
+            || treeobj_get_count (dirent) != 1
+            || !(ref = treeobj_get_blobref (dirent, 0)))
+            continue;
+        if (cache_entry_get_valid (cache_lookup (lh->cache, ref)))
+            continue;
+        if (cb (lh, ref, data) < 0)
+            return -1;
+        count++;
+    }
+    return 0;
+}
+
 const char *lookup_missing_namespace (lookup_t *lh)
 {
    if (lh
@@ -756,8 +931,7 @@ static int get_single_blobref_valref_value (lookup_t *lh, bool *stall)
         lh->errnum = errno;
         return -1;
     }
-    if (!(entry = cache_lookup (lh->cache, reftmp))
-        || !cache_entry_get_valid (entry)) {
+    if (!(entry = cache_lookup_valid (lh, reftmp))) {
         lh->valref_missing_refs = lh->wdirent;
         (*stall) = true;
         return 0;
@@ -789,8 +963,7 @@ static int get_multi_blobref_valref_length (lookup_t *lh, int refcount,
             lh->errnum = errno;
             return -1;
         }
-        if (!(entry = cache_lookup (lh->cache, reftmp))
-            || !cache_entry_get_valid (entry)) {
+        if (!(entry = cache_lookup_valid (lh, reftmp))) {
             lh->valref_missing_refs = lh->wdirent;
             (*stall) = true;
             return 0;
@@ -890,9 +1063,9 @@ done:
 lookup_process_t lookup (lookup_t *lh)
 {
     const json_t *valtmp = NULL;
-    const char *reftmp;
     struct cache_entry *entry;
     bool is_replay = false;
+    bool stall;
     int refcount;
 
     if (!lh) {
@@ -965,8 +1138,7 @@ lookup_process_t lookup (lookup_t *lh)
                         lh->errnum = EISDIR;
                         goto error;
                     }
-                    if (!(entry = cache_lookup (lh->cache, lh->root_ref))
-                        || !cache_entry_get_valid (entry)) {
+                    if (!(entry = cache_lookup_valid (lh, lh->root_ref))) {
                         lh->missing_ref = lh->root_ref;
                         return LOOKUP_PROCESS_LOAD_MISSING_REFS;
                     }
@@ -1049,42 +1221,11 @@ lookup_process_t lookup (lookup_t *lh)
                     lh->errnum = EISDIR;
                     goto error;
                 }
-                if ((refcount = treeobj_get_count (lh->wdirent)) < 0) {
-                    lh->errnum = errno;
-                    goto error;
-                }
-                if (refcount != 1) {
-                    flux_log (lh->h, LOG_ERR, "invalid dirref count: %d",
-                              refcount);
-                    lh->errnum = ENOTRECOVERABLE;
-                    goto error;
-                }
-                if (!(reftmp = treeobj_get_blobref (lh->wdirent, 0))) {
-                    lh->errnum = errno;
+                if (get_dirref_value (lh, lh->wdirent, &stall) < 0)
                     goto error;
-                }
-                if (!(entry = cache_lookup (lh->cache, reftmp))
-                    || !cache_entry_get_valid (entry)) {
-                    lh->missing_ref = reftmp;
+                if (stall)
                     return LOOKUP_PROCESS_LOAD_MISSING_REFS;
-                }
-                if (!(valtmp = cache_entry_get_treeobj (entry))) {
-                    flux_log (lh->h, LOG_ERR, "dirref points to non-treeobj");
-                    lh->errnum = ENOTRECOVERABLE;
-                    goto error;
-                }
-                if (!treeobj_is_dir (valtmp)) {
-                    /* dirref points to not dir */
-                    lh->errnum = ENOTRECOVERABLE;
-                    goto error;
-                }
-                if (!(lh->val = treeobj_deep_copy (valtmp))) {
-                    lh->errnum = errno;
-                    goto error;
-                }
             } else if (treeobj_is_valref (lh->wdirent)) {
-                bool stall;
-
                 if ((lh->flags & FLUX_KVS_READLINK)) {
                     lh->errnum = EINVAL;
                     goto error;
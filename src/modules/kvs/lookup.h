@@ -74,6 +74,30 @@ json_t *lookup_get_value (lookup_t *lh);
  */
 int lookup_iter_missing_refs (lookup_t *lh, lookup_ref_f cb, void *data);
 
+/* Allow up to 'max' references to be offered to the caller for
+ * prefetch via lookup_iter_prefetch_refs().  Default is 0 (disabled).
+ */
+int lookup_set_prefetch (lookup_t *lh, int max);
+
+/* After lookup() returns LOOKUP_PROCESS_FINISHED for a FLUX_KVS_READDIR
+ * lookup, get sub-directory references of the result that are not yet
+ * in the KVS cache.  The caller may start loading them without waiting,
+ * so that a subsequent recursive lookup does not stall on each one.
+ *
+ * return -1 in callback to break iteration
+ */
+int lookup_iter_prefetch_refs (lookup_t *lh, lookup_ref_f cb, void *data);
+
+/* Get the number of prefetched cache entries this lookup has used,
+ * i.e. the number of stalls avoided by prefetch.
+ */
+int lookup_get_prefetch_hits (lookup_t *lh);
+
+/* Get time in milliseconds since the lookup was created, including
+ * any time spent stalled on missing refs.
+ */
+double lookup_get_age (lookup_t *lh);
+
 /* On lookup stall b/c of missing namespace, get missing namespace
  * returned by this function.
  *
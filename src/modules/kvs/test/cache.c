@@ -153,6 +153,20 @@ void cache_entry_basic_tests (void)
         && errno == EINVAL,
         "cache_entry_set_errnum_on_notdirty returns EINVAL with bad errnum");
 
+    ok (cache_entry_get_prefetched (NULL) == false,
+        "cache_entry_get_prefetched returns false on bad input");
+    cache_entry_set_prefetched (NULL, true);
+    diag ("cache_entry_set_prefetched accept NULL arg");
+
+    ok (cache_entry_get_prefetched (e) == false,
+        "cache_entry_get_prefetched returns false initially");
+    cache_entry_set_prefetched (e, true);
+    ok (cache_entry_get_prefetched (e) == true,
+        "cache_entry_get_prefetched returns true after set");
+    cache_entry_set_prefetched (e, false);
+    ok (cache_entry_get_prefetched (e) == false,
+        "cache_entry_get_prefetched returns false after clear");
+
     cache_entry_destroy (e);
     e = NULL;
 }
@@ -568,6 +582,7 @@ void cache_expiration_tests (void)
     struct cache_entry *e1, *e2, *e3, *e4, *e5, *e6;
     tstat_t ts;
     int size, incomplete, dirty;
+    ssize_t hits, misses;
     json_t *o1;
     json_t *otest;
     const json_t *otmp;
@@ -592,6 +607,9 @@ void cache_expiration_tests (void)
         "cache_lookup of wrong hash fails");
     ok ((e2 = cache_lookup (cache, "xxx1")) != NULL,
         "cache_lookup of correct hash works (last use=42)");
+    cache_get_lookup_stats (cache, &hits, &misses);
+    ok (hits == 0 && misses == 2,
+        "cache_get_lookup_stats counts missing and incomplete as misses");
     cache_entry_set_fake_time (e2, 42);
     ok (cache_entry_get_treeobj (e2) == NULL,
         "no treeobj object found");
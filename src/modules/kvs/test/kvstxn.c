@@ -3280,6 +3280,217 @@ void kvstxn_process_fallback_merge (void)
     ktest_finalize (cache, krm);
 }
 
+/* Apply 'ops' in a single transaction on top of 'root_ref'.
+ * Copy the new root reference to 'newroot'.
+ */
+static void hdir_commit (kvstxn_mgr_t *ktm,
+                         json_t *ops,
+                         const char *root_ref,
+                         char *newroot,
+                         int newroot_len)
+{
+    kvstxn_t *kt;
+    const char *ref;
+
+    ok (kvstxn_mgr_add_transaction (ktm, "hdir", ops, 0) == 0,
+        "kvstxn_mgr_add_transaction works");
+    ok ((kt = kvstxn_mgr_get_ready_transaction (ktm)) != NULL,
+        "kvstxn_mgr_get_ready_transaction returns ready kvstxn");
+    ok (kvstxn_process (kt, root_ref) == KVSTXN_PROCESS_DIRTY_CACHE_ENTRIES,
+        "kvstxn_process returns KVSTXN_PROCESS_DIRTY_CACHE_ENTRIES");
+    ok (kvstxn_iter_dirty_cache_entries (kt, cache_noop_cb, NULL) == 0,
+        "kvstxn_iter_dirty_cache_entries works for dirty cache entries");
+    ok (kvstxn_process (kt, root_ref) == KVSTXN_PROCESS_FINISHED,
+        "kvstxn_process returns KVSTXN_PROCESS_FINISHED");
+    ok ((ref = kvstxn_get_newroot_ref (kt)) != NULL,
+        "kvstxn_get_newroot_ref returns != NULL when processing complete");
+    snprintf (newroot, newroot_len, "%s", ref ? ref : "");
+    kvstxn_mgr_remove_transaction (ktm, kt, false);
+}
+
+/* Return the number of buckets of the hdir 'name' in root directory
+ * 'root_ref', or -1 if it is not an RFC 11 dirref with more than one
+ * blobref, each referring to a cached dir object.
+ */
+static int hdir_bucket_count (struct cache *cache,
+                              const char *root_ref,
+                              const char *name)
+{
+    struct cache_entry *entry;
+    const json_t *o;
+    const json_t *bucket;
+    const char *ref;
+    int count;
+    int i;
+
+    if (!(entry = cache_lookup (cache, root_ref))
+        || !(o = cache_entry_get_treeobj (entry))
+        || !(o = treeobj_peek_entry (o, name))
+        || !treeobj_is_dirref (o)
+        || treeobj_validate (o) < 0
+        || (count = treeobj_get_count (o)) < 2)
+        return -1;
+    for (i = 0; i < count; i++) {
+        if (!(ref = treeobj_get_blobref (o, i))
+            || !(entry = cache_lookup (cache, ref))
+            || !(bucket = cache_entry_get_treeobj (entry))
+            || !treeobj_is_dir (bucket))
+            return -1;
+    }
+    return count;
+}
+
+void kvstxn_process_hdir (void)
+{
+    struct cache *cache;
+    kvsroot_mgr_t *krm;
+    kvstxn_mgr_t *ktm;
+    lookup_t *lh;
+    json_t *ops;
+    json_t *o;
+    char rootref[BLOBREF_MAX_STRING_SIZE];
+    char newroot1[BLOBREF_MAX_STRING_SIZE];
+    char newroot2[BLOBREF_MAX_STRING_SIZE];
+    char newroot3[BLOBREF_MAX_STRING_SIZE];
+    char key[64];
+    char val[64];
+    struct flux_msg_cred cred = { .rolemask = FLUX_ROLE_OWNER, .userid = 0 };
+    int count1, count2;
+    int i;
+
+    cache = create_cache_with_empty_rootdir (rootref, sizeof (rootref));
+
+    ok ((krm = kvsroot_mgr_create (NULL, NULL)) != NULL,
+        "kvsroot_mgr_create works");
+
+    setup_kvsroot (krm, KVS_PRIMARY_NAMESPACE, cache, ref_dummy);
+
+    ok ((ktm = kvstxn_mgr_create (cache,
+                                  KVS_PRIMARY_NAMESPACE,
+                                  "sha1",
+                                  NULL,
+                                  &test_global)) != NULL,
+        "kvstxn_mgr_create works");
+
+    ok (kvstxn_mgr_set_hdir_limits (NULL, 4, 4) < 0 && errno == EINVAL,
+        "kvstxn_mgr_set_hdir_limits fails with EINVAL on bad input");
+    ok (kvstxn_mgr_set_hdir_limits (ktm, 4, 0) < 0 && errno == EINVAL,
+        "kvstxn_mgr_set_hdir_limits fails with EINVAL on bad bucket_max");
+    ok (kvstxn_mgr_set_hdir_limits (ktm, 4, 4) == 0,
+        "kvstxn_mgr_set_hdir_limits works");
+
+    /* a directory over threshold is stored as an hdir */
+    ops = json_array ();
+    for (i = 0; i < 12; i++) {
+        snprintf (key, sizeof (key), "dir.key%d", i);
+        snprintf (val, sizeof (val), "%d", i);
+        ops_append (ops, key, val, 0);
+    }
+    ops_append (ops, "small.key", "x", 0);
+    hdir_commit (ktm, ops, rootref, newroot1, sizeof (newroot1));
+    json_decref (ops);
+
+    count1 = hdir_bucket_count (cache, newroot1, "dir");
+    ok (count1 > 1,
+        "dir was stored as hdir with %d buckets", count1);
+    ok (hdir_bucket_count (cache, newroot1, "small") < 0,
+        "small dir was stored as dir");
+    for (i = 0; i < 12; i++) {
+        snprintf (key, sizeof (key), "dir.key%d", i);
+        snprintf (val, sizeof (val), "%d", i);
+        verify_value (cache, krm, KVS_PRIMARY_NAMESPACE, newroot1, key, val);
+    }
+    verify_value (cache, krm, KVS_PRIMARY_NAMESPACE, newroot1, "dir.nokey",
+                  NULL);
+
+    /* inserting into an hdir splits buckets as it grows */
+    ops = json_array ();
+    for (i = 12; i < 40; i++) {
+        snprintf (key, sizeof (key), "dir.key%d", i);
+        snprintf (val, sizeof (val), "%d", i);
+        ops_append (ops, key, val, 0);
+    }
+    ops_append (ops, "dir.key0", "zero", 0);
+    ops_append (ops, "dir.key1", NULL, 0);
+    ops_append (ops, "dir.sub.key", "sub", 0);
+    hdir_commit (ktm, ops, newroot1, newroot2, sizeof (newroot2));
+    json_decref (ops);
+
+    count2 = hdir_bucket_count (cache, newroot2, "dir");
+    ok (count2 > count1,
+        "hdir buckets were split, now %d buckets", count2);
+    verify_value (cache, krm, KVS_PRIMARY_NAMESPACE, newroot2, "dir.key0",
+                  "zero");
+    verify_value (cache, krm, KVS_PRIMARY_NAMESPACE, newroot2, "dir.key1",
+                  NULL);
+    verify_value (cache, krm, KVS_PRIMARY_NAMESPACE, newroot2, "dir.sub.key",
+                  "sub");
+    for (i = 2; i < 40; i++) {
+        snprintf (key, sizeof (key), "dir.key%d", i);
+        snprintf (val, sizeof (val), "%d", i);
+        verify_value (cache, krm, KVS_PRIMARY_NAMESPACE, newroot2, key, val);
+    }
+
+    /* readdir of an hdir returns the merged directory */
+    ok ((lh = lookup_create (cache,
+                             krm,
+                             KVS_PRIMARY_NAMESPACE,
+                             newroot2,
+                             0,
+                             "dir",
+                             cred,
+                             FLUX_KVS_READDIR,
+                             NULL)) != NULL,
+        "lookup_create dir w/ FLUX_KVS_READDIR");
+    ok (lookup (lh) == LOOKUP_PROCESS_FINISHED,
+        "lookup found result");
+    ok ((o = lookup_get_value (lh)) != NULL
+        && treeobj_is_dir (o)
+        && treeobj_get_count (o) == 40,
+        "lookup_get_value returned dir with all 40 entries");
+    json_decref (o);
+    lookup_destroy (lh);
+
+    /* FLUX_KVS_TREEOBJ lookup of an hdir returns the dirref */
+    ok ((lh = lookup_create (cache,
+                             krm,
+                             KVS_PRIMARY_NAMESPACE,
+                             newroot2,
+                             0,
+                             "dir",
+                             cred,
+                             FLUX_KVS_TREEOBJ,
+                             NULL)) != NULL,
+        "lookup_create dir w/ FLUX_KVS_TREEOBJ");
+    ok (lookup (lh) == LOOKUP_PROCESS_FINISHED,
+        "lookup found result");
+    ok ((o = lookup_get_value (lh)) != NULL
+        && treeobj_is_dirref (o)
+        && treeobj_get_count (o) == count2,
+        "lookup_get_value returned dirref with %d blobrefs", count2);
+    json_decref (o);
+    lookup_destroy (lh);
+
+    /* with threshold = 0, new large dirs are stored as dir */
+    ok (kvstxn_mgr_set_hdir_limits (ktm, 0, 4) == 0,
+        "kvstxn_mgr_set_hdir_limits threshold=0 works");
+    ops = json_array ();
+    for (i = 0; i < 12; i++) {
+        snprintf (key, sizeof (key), "dir2.key%d", i);
+        ops_append (ops, key, "x", 0);
+    }
+    hdir_commit (ktm, ops, newroot2, newroot3, sizeof (newroot3));
+    json_decref (ops);
+    ok (hdir_bucket_count (cache, newroot3, "dir2") < 0,
+        "dir2 was stored as dir");
+    ok (hdir_bucket_count (cache, newroot3, "dir") == count2,
+        "existing hdir was not changed");
+
+    kvstxn_mgr_destroy (ktm);
+    kvsroot_mgr_destroy (krm);
+    cache_destroy (cache);
+}
+
 int main (int argc, char *argv[])
 {
     plan (NO_PLAN);
@@ -3319,6 +3530,7 @@ int main (int argc, char *argv[])
     kvstxn_process_append_errors ();
     kvstxn_process_append_no_duplicate ();
     kvstxn_process_fallback_merge ();
+    kvstxn_process_hdir ();
 
     done_testing ();
     return (0);
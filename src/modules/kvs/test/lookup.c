@@ -327,6 +327,8 @@ void basic_api_errors (void)
         "lookup_get_root_ref fails on NULL pointer");
     ok (lookup_get_root_seq (NULL) < 0,
         "lookup_get_root_seq fails on NULL pointer");
+    ok (lookup_get_age (NULL) == 0.,
+        "lookup_get_age returns 0 on NULL pointer");
     /* lookup_destroy ok on NULL pointer */
     lookup_destroy (NULL);
 
@@ -3321,6 +3323,234 @@ void lookup_stall_ref_expire_cache_entries (void) {
     json_decref (root);
 }
 
+/* lookup prefetch tests */
+void lookup_prefetch (void) {
+    json_t *root;
+    json_t *dirref1;
+    json_t *dirref2;
+    json_t *test;
+    struct cache *cache;
+    kvsroot_mgr_t *krm;
+    struct cache_entry *entry;
+    lookup_t *lh;
+    struct lookup_ref_data ld;
+    char dirref1_ref[BLOBREF_MAX_STRING_SIZE];
+    char dirref2_ref[BLOBREF_MAX_STRING_SIZE];
+    char root_ref[BLOBREF_MAX_STRING_SIZE];
+
+    ltest_init (&cache, &krm);
+
+    /* This cache is
+     *
+     * dirref1_ref
+     * "val" : val to "foo"
+     *
+     * dirref2_ref
+     * "val" : val to "bar"
+     *
+     * root_ref
+     * "val" : val to "baz"
+     * "dirref1" : dirref to dirref1_ref
+     * "dirref2" : dirref to dirref2_ref
+     *
+     * Only root_ref is in the cache initially.
+     */
+
+    dirref1 = treeobj_create_dir ();
+    _treeobj_insert_entry_val (dirref1, "val", "foo", 3);
+    treeobj_hash ("sha1", dirref1, dirref1_ref, sizeof (dirref1_ref));
+
+    dirref2 = treeobj_create_dir ();
+    _treeobj_insert_entry_val (dirref2, "val", "bar", 3);
+    treeobj_hash ("sha1", dirref2, dirref2_ref, sizeof (dirref2_ref));
+
+    root = treeobj_create_dir ();
+    _treeobj_insert_entry_val (root, "val", "baz", 3);
+    _treeobj_insert_entry_dirref (root, "dirref1", dirref1_ref);
+    _treeobj_insert_entry_dirref (root, "dirref2", dirref2_ref);
+    treeobj_hash ("sha1", root, root_ref, sizeof (root_ref));
+
+    (void)cache_insert (cache, create_cache_entry_treeobj (root_ref, root));
+
+    setup_kvsroot (krm, KVS_PRIMARY_NAMESPACE, cache, root_ref, 0);
+
+    /* prefetch disabled by default */
+    ok ((lh = lookup_create (cache,
+                             krm,
+                             KVS_PRIMARY_NAMESPACE,
+                             NULL,
+                             0,
+                             ".",
+                             owner_cred,
+                             FLUX_KVS_READDIR,
+                             NULL)) != NULL,
+        "lookup_create on root w/ flag = FLUX_KVS_READDIR");
+    ok (lookup (lh) == LOOKUP_PROCESS_FINISHED,
+        "lookup on root finished");
+    ld.ref = NULL;
+    ld.count = 0;
+    ok (lookup_iter_prefetch_refs (lh, lookup_ref, &ld) == 0
+        && ld.count == 0,
+        "lookup_iter_prefetch_refs returns no refs by default");
+    lookup_destroy (lh);
+
+    /* prefetch both sub-directories */
+    ok ((lh = lookup_create (cache,
+                             krm,
+                             KVS_PRIMARY_NAMESPACE,
+                             NULL,
+                             0,
+                             ".",
+                             owner_cred,
+                             FLUX_KVS_READDIR,
+                             NULL)) != NULL,
+        "lookup_create on root w/ flag = FLUX_KVS_READDIR");
+    ok (lookup_set_prefetch (lh, -1) < 0 && errno == EINVAL,
+        "lookup_set_prefetch fails with EINVAL on negative max");
+    ok (lookup_set_prefetch (lh, 8) == 0,
+        "lookup_set_prefetch works");
+    ld.ref = NULL;
+    ld.count = 0;
+    ok (lookup_iter_prefetch_refs (lh, lookup_ref, &ld) == 0
+        && ld.count == 0,
+        "lookup_iter_prefetch_refs returns no refs before lookup");
+    ok (lookup (lh) == LOOKUP_PROCESS_FINISHED,
+        "lookup on root finished");
+    ok (lookup_iter_prefetch_refs (lh, lookup_ref, &ld) == 0
+        && ld.count == 2,
+        "lookup_iter_prefetch_refs returns both sub-directory refs");
+    ok (lookup_iter_prefetch_refs (lh, lookup_ref_error, NULL) < 0
+        && errno == EMLINK,
+        "lookup_iter_prefetch_refs returns callback error");
+    lookup_destroy (lh);
+
+    /* prefetch is limited to max */
+    ok ((lh = lookup_create (cache,
+                             krm,
+                             KVS_PRIMARY_NAMESPACE,
+                             NULL,
+                             0,
+                             ".",
+                             owner_cred,
+                             FLUX_KVS_READDIR,
+                             NULL)) != NULL,
+        "lookup_create on root w/ flag = FLUX_KVS_READDIR");
+    ok (lookup_set_prefetch (lh, 1) == 0,
+        "lookup_set_prefetch works");
+    ok (lookup (lh) == LOOKUP_PROCESS_FINISHED,
+        "lookup on root finished");
+    ld.ref = NULL;
+    ld.count = 0;
+    ok (lookup_iter_prefetch_refs (lh, lookup_ref, &ld) == 0
+        && ld.count == 1,
+        "lookup_iter_prefetch_refs returns one ref with max = 1");
+    lookup_destroy (lh);
+
+    /* no prefetch unless FLUX_KVS_READDIR */
+    ok ((lh = lookup_create (cache,
+                             krm,
+                             KVS_PRIMARY_NAMESPACE,
+                             NULL,
+                             0,
+                             "val",
+                             owner_cred,
+                             0,
+                             NULL)) != NULL,
+        "lookup_create val");
+    ok (lookup_set_prefetch (lh, 8) == 0,
+        "lookup_set_prefetch works");
+    ok (lookup (lh) == LOOKUP_PROCESS_FINISHED,
+        "lookup val finished");
+    ld.ref = NULL;
+    ld.count = 0;
+    ok (lookup_iter_prefetch_refs (lh, lookup_ref, &ld) == 0
+        && ld.count == 0,
+        "lookup_iter_prefetch_refs returns no refs on non-directory");
+    lookup_destroy (lh);
+
+    /* "prefetch" dirref1, only dirref2 remains a candidate, and
+     * lookup of dirref1 counts a prefetch hit
+     */
+    entry = create_cache_entry_treeobj (dirref1_ref, dirref1);
+    cache_entry_set_prefetched (entry, true);
+    (void)cache_insert (cache, entry);
+
+    ok ((lh = lookup_create (cache,
+                             krm,
+                             KVS_PRIMARY_NAMESPACE,
+                             NULL,
+                             0,
+                             ".",
+                             owner_cred,
+                             FLUX_KVS_READDIR,
+                             NULL)) != NULL,
+        "lookup_create on root w/ flag = FLUX_KVS_READDIR");
+    ok (lookup_set_prefetch (lh, 8) == 0,
+        "lookup_set_prefetch works");
+    ok (lookup (lh) == LOOKUP_PROCESS_FINISHED,
+        "lookup on root finished");
+    ld.ref = NULL;
+    ld.count = 0;
+    ok (lookup_iter_prefetch_refs (lh, lookup_ref, &ld) == 0
+        && ld.count == 1
+        && ld.ref != NULL
+        && !strcmp (ld.ref, dirref2_ref),
+        "lookup_iter_prefetch_refs skips cached sub-directory");
+    ok (lookup_get_prefetch_hits (lh) == 0,
+        "lookup_get_prefetch_hits returns 0");
+    lookup_destroy (lh);
+
+    ok ((lh = lookup_create (cache,
+                             krm,
+                             KVS_PRIMARY_NAMESPACE,
+                             NULL,
+                             0,
+                             "dirref1.val",
+                             owner_cred,
+                             0,
+                             NULL)) != NULL,
+        "lookup_create dirref1.val");
+    test = treeobj_create_val ("foo", 3);
+    check_common (lh,
+                  LOOKUP_PROCESS_FINISHED,
+                  0,
+                  false,
+                  test,
+                  1,
+                  NULL,
+                  "dirref1.val",
+                  false);
+    json_decref (test);
+    ok (lookup_get_prefetch_hits (lh) == 1,
+        "lookup_get_prefetch_hits returns 1");
+    ok (cache_entry_get_prefetched (entry) == false,
+        "prefetched bit cleared on first use");
+    lookup_destroy (lh);
+
+    ok ((lh = lookup_create (cache,
+                             krm,
+                             KVS_PRIMARY_NAMESPACE,
+                             NULL,
+                             0,
+                             "dirref1.val",
+                             owner_cred,
+                             0,
+                             NULL)) != NULL,
+        "lookup_create dirref1.val");
+    ok (lookup (lh) == LOOKUP_PROCESS_FINISHED,
+        "lookup dirref1.val finished");
+    ok (lookup_get_prefetch_hits (lh) == 0,
+        "lookup_get_prefetch_hits returns 0 on second use");
+    ok (lookup_get_age (lh) >= 0.,
+        "lookup_get_age returns non-negative age");
+    lookup_destroy (lh);
+
+    ltest_finalize (cache, krm);
+    json_decref (dirref1);
+    json_decref (dirref2);
+    json_decref (root);
+}
+
 int main (int argc, char *argv[])
 {
     plan (NO_PLAN);
@@ -3343,6 +3573,7 @@ int main (int argc, char *argv[])
     lookup_stall_ref ();
     lookup_stall_namespace_removed ();
     lookup_stall_ref_expire_cache_entries ();
+    lookup_prefetch ();
 
     done_testing ();
     return (0);
@@ -23,6 +23,7 @@
 
 #include "src/common/libczmqcontainers/czmq_containers.h"
 #include "src/common/libutil/errno_safe.h"
+#include "src/common/libutil/monotime.h"
 
 #include "treq.h"
 
@@ -40,6 +41,7 @@ struct treq {
     json_t *ops;
     int flags;
     bool processed;
+    struct timespec t_create;
 };
 
 /*
@@ -202,6 +204,7 @@ static treq_t *treq_create_common (int nprocs, int flags)
     tr->nprocs = nprocs;
     tr->flags = flags;
     tr->processed = false;
+    monotime (&tr->t_create);
 
     return tr;
 error:
@@ -335,6 +338,11 @@ int treq_iter_request_copies (treq_t *tr, treq_msg_cb cb, void *data)
     return 0;
 }
 
+double treq_get_age (treq_t *tr)
+{
+    return monotime_since (tr->t_create);
+}
+
 bool treq_get_processed (treq_t *tr)
 {
     return tr->processed;
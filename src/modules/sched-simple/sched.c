@@ -16,6 +16,7 @@
 
 #include "src/common/libczmqcontainers/czmq_containers.h"
 #include "src/common/libutil/errno_safe.h"
+#include "src/common/libutil/monotime.h"
 #include "src/common/libjob/job.h"
 #include "src/common/librlist/rlist.h"
 #include "libjj.h"
@@ -36,6 +37,7 @@ struct jobreq {
     flux_jobid_t id;
     struct jj_counts jj;
     int errnum;
+    struct timespec t_alloc;    /* time alloc request was received */
 };
 
 struct simple_sched {
@@ -49,6 +51,7 @@ struct simple_sched {
     struct rlist *rlist;    /* list of resources */
     zlistx_t *queue;        /* job queue */
     schedutil_t *util_ctx;
+    ssize_t alloc_count;    /* for stats */
 
     flux_watcher_t *prep;
     flux_watcher_t *check;
@@ -103,6 +106,7 @@ jobreq_create (const flux_msg_t *msg)
 
     if (job == NULL)
         return NULL;
+    monotime (&job->t_alloc);
 
     if (flux_msg_unpack (msg, "{s:I s:i s:i s:f s:o}",
                          "id", &job->id,
@@ -177,15 +181,18 @@ static int try_alloc (flux_t *h, struct simple_sched *ss)
     struct jobreq *job = zlistx_first (ss->queue);
     double now = flux_reactor_now (flux_get_reactor (h));
     bool fail_alloc = flux_module_debug_test (h, DEBUG_FAIL_ALLOC, false);
+    struct timespec t_match;
 
     if (!job)
         return -1;
 
     jj = &job->jj;
     if (!fail_alloc) {
+        monotime (&t_match);
         errno = 0;
         alloc = rlist_alloc (ss->rlist, ss->alloc_mode,
                              jj->nnodes, jj->nslots, jj->slot_size);
+        flux_stats_timing (h, "sched-simple.match", monotime_since (t_match));
     }
     if (!alloc || !(R = Rstring_create (alloc, now, jj->duration))) {
         const char *note = "unable to allocate provided jobspec";
@@ -222,10 +229,17 @@ static int try_alloc (flux_t *h, struct simple_sched *ss)
         flux_log_error (h, "schedutil_alloc_respond_success_pack");
 
     flux_log (h, LOG_DEBUG, "alloc: %ju: %s", (uintmax_t) job->id, s);
+    ss->alloc_count++;
+    if (flux_stats_enabled (h, NULL)) {
+        flux_stats_timing (h, "sched-simple.alloc-latency",
+                           monotime_since (job->t_alloc));
+        flux_stats_count (h, "sched-simple.alloc", ss->alloc_count);
+    }
     rc = 0;
 
 out:
     zlistx_delete (ss->queue, job->handle);
+    flux_stats_gauge_set (h, "sched-simple.queue", zlistx_size (ss->queue));
     rlist_destroy (alloc);
     free (R);
     free (s);
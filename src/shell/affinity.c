@@ -156,14 +156,73 @@ static void shell_affinity_destroy (void *arg)
     free (sa);
 }
 
+/*  Load topology from XML exported by the broker on this node.
+ *  Since the XML describes this system, say so, or hwloc will not
+ *  allow binding with the resulting topology.
+ */
+static hwloc_topology_t topology_load_xml (const char *xml)
+{
+    hwloc_topology_t topo;
+
+    if (hwloc_topology_init (&topo) < 0)
+        return NULL;
+    if (hwloc_topology_set_flags (topo, HWLOC_TOPOLOGY_FLAG_IS_THISSYSTEM) < 0
+        || hwloc_topology_set_xmlbuffer (topo, xml, strlen (xml) + 1) < 0
+        || hwloc_topology_load (topo) < 0) {
+        hwloc_topology_destroy (topo);
+        return NULL;
+    }
+    return topo;
+}
+
+/*  Fetch the topology already discovered by the resource module on
+ *  the local broker, avoiding the cost of discovery in every shell.
+ *  Returns NULL if unavailable, e.g. in standalone mode.
+ */
+static hwloc_topology_t topology_from_broker (flux_shell_t *shell)
+{
+    flux_t *h;
+    flux_future_t *f;
+    const char *xml;
+    uint32_t rank;
+    int standalone = 0;
+    hwloc_topology_t topo = NULL;
+
+    if (flux_shell_info_unpack (shell,
+                                "{s:{s:b}}",
+                                "options",
+                                  "standalone", &standalone) < 0
+        || standalone
+        || !(h = flux_shell_get_flux (shell))
+        || flux_get_rank (h, &rank) < 0)
+        return NULL;
+    if (!(f = flux_rpc (h, "resource.topo-get", NULL, rank, 0))
+        || flux_rpc_get (f, &xml) < 0) {
+        shell_debug ("unable to fetch broker topology: %s",
+                     future_strerror (f, errno));
+        goto out;
+    }
+    if (!(topo = topology_load_xml (xml)))
+        shell_debug ("unable to load broker topology");
+out:
+    flux_future_destroy (f);
+    return topo;
+}
+
 /*  Initialize topology object for affinity processing.
+ *  Prefer the broker's cached topology, falling back to discovery.
  */
-static int shell_affinity_topology_init (struct shell_affinity *sa)
+static int shell_affinity_topology_init (struct shell_affinity *sa,
+                                         flux_shell_t *shell)
 {
-    if (hwloc_topology_init (&sa->topo) < 0)
-        return shell_log_errno ("hwloc_topology_init");
-    if (hwloc_topology_load (sa->topo) < 0)
-        return shell_log_errno ("hwloc_topology_load");
+    if (!(sa->topo = topology_from_broker (shell))) {
+        if (hwloc_topology_init (&sa->topo) < 0)
+            return shell_log_errno ("hwloc_topology_init");
+        if (hwloc_topology_load (sa->topo) < 0)
+            return shell_log_errno ("hwloc_topology_load");
+    }
+    else
+        shell_debug ("using broker topology");
     if (topology_restrict_current (sa->topo) < 0)
         return shell_log_errno ("topology_restrict_current");
     return 0;
@@ -178,7 +237,7 @@ static struct shell_affinity * shell_affinity_create (flux_shell_t *shell)
     struct shell_affinity *sa = calloc (1, sizeof (*sa));
     if (!sa)
         return NULL;
-    if (shell_affinity_topology_init (sa) < 0)
+    if (shell_affinity_topology_init (sa, shell) < 0)
         goto err;
     if (flux_shell_rank_info_unpack (shell,
                                      -1,
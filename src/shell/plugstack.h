@@ -61,6 +61,10 @@ int plugstack_call (struct plugstack *st,
                     const char *name,
                     flux_plugin_arg_t *args);
 
+/*  Return true if any plugin in the stack has a handler matching `name`.
+ */
+bool plugstack_has_handler (struct plugstack *st, const char *name);
+
 #endif /* !_SHELL_PLUGSTACK_H */
 
 /* vi: ts=4 sw=4 expandtab
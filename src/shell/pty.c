@@ -62,6 +62,11 @@ shell_terminus_server_start (flux_shell_t *shell, const char *shell_service)
     return t;
 }
 
+static int pty_task_exec (flux_plugin_t *p,
+                          const char *topic,
+                          flux_plugin_arg_t *args,
+                          void *arg);
+
 static int pty_init (flux_plugin_t *p,
                      const char *topic,
                      flux_plugin_arg_t *args,
@@ -102,6 +107,14 @@ static int pty_init (flux_plugin_t *p,
         if (flux_shell_aux_set (shell, "builtin::pty.0", pty, NULL) < 0)
             goto error;
 
+        /*  Only register task.exec when a pty is in use, so tasks
+         *   launched without one need no pre_exec hook.
+         */
+        if (flux_plugin_add_handler (p, "task.exec", pty_task_exec, NULL) < 0) {
+            shell_log_errno ("flux_plugin_add_handler");
+            goto error;
+        }
+
         if (flux_shell_add_event_context (shell,
                                           "shell.init",
                                           0,
@@ -192,7 +205,6 @@ static int pty_task_exit (flux_plugin_t *p,
 struct shell_builtin builtin_pty = {
     .name = FLUX_SHELL_PLUGIN_NAME,
     .init = pty_init,
-    .task_exec = pty_task_exec,
     .task_exit = pty_task_exit,
 };
 
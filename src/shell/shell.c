@@ -1347,8 +1347,6 @@ int main (int argc, char *argv[])
         if (!(task = shell_task_create (shell.info, i)))
             shell_die (1, "shell_task_create index=%d", i);
 
-        task->pre_exec_cb = shell_task_exec;
-        task->pre_exec_arg = &shell;
         shell.current_task = task;
 
         /*  Call all plugin task_init callbacks:
@@ -1356,6 +1354,17 @@ int main (int argc, char *argv[])
         if (shell_task_init (&shell) < 0)
             shell_die (1, "failed to initialize taskid=%d", i);
 
+        /*  Only run task.exec plugins in the child if any are registered,
+         *   since a task with no pre_exec hook can be launched with vfork(2).
+         *   This is checked after task.init, which may register handlers.
+         */
+        if (plugstack_has_handler (shell.plugstack, "task.exec")) {
+            task->pre_exec_cb = shell_task_exec;
+            task->pre_exec_arg = &shell;
+        }
+        else
+            shell_trace ("task %d: no task.exec plugins, no pre_exec hook", i);
+
         if (shell_task_start (task, shell.r, task_completion_cb, &shell) < 0) {
             int ec = 1;
             /* bash standard, 126 for permission/access denied, 127
@@ -199,7 +199,15 @@ int shell_task_start (struct shell_task *task,
         .pre_exec_arg = task,
     };
 
-    task->proc = flux_local_exec (r, flags, task->cmd, &subproc_ops, &hooks);
+    /*  Only register the pre_exec hook if there is something to run in
+     *   the child.  Without any hooks, libsubprocess launches the task
+     *   with vfork(2), which is much cheaper from a large shell process.
+     */
+    task->proc = flux_local_exec (r,
+                                  flags,
+                                  task->cmd,
+                                  &subproc_ops,
+                                  task->pre_exec_cb ? &hooks : NULL);
     if (!task->proc)
         return -1;
     if (flux_subprocess_aux_set (task->proc, "flux::task", task, NULL) < 0) {
@@ -165,8 +165,14 @@ int main (int argc, char **argv)
     if (!(args = flux_plugin_arg_create ()))
         BAIL_OUT ("flux_plugin_args_create");
 
+    ok (plugstack_has_handler (st, "callback") == false,
+        "plugstack_has_handler returns false for empty stack");
     ok (plugstack_push (st, p1) == 0,
         "plugstack_push (st, p1)");
+    ok (plugstack_has_handler (st, "callback") == true,
+        "plugstack_has_handler (st, 'callback') returns true");
+    ok (plugstack_has_handler (st, "nosuchtopic") == false,
+        "plugstack_has_handler (st, 'nosuchtopic') returns false");
     ok (plugstack_call (st, "callback", args) == 0,
         "plugstack_call (st, 'callback')");
     ok (flux_plugin_arg_unpack (args, FLUX_PLUGIN_ARG_OUT,
@@ -0,0 +1,71 @@
+###############################################################
+# Copyright 2021 Lawrence Livermore National Security, LLC
+# (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+#
+# This file is part of the Flux resource manager framework.
+# For details, see https://github.com/flux-framework.
+#
+# SPDX-License-Identifier: LGPL-3.0
+###############################################################
+
+# Usage: flux python events-watch.py ids JOBID...
+#        flux python events-watch.py own OTHER_JOBID
+#        flux python events-watch.py cancel
+#        flux python events-watch.py hang
+#
+# ids:    watch JOBIDs, printing "jobid name" for each event until the
+#         stream terminates.
+# own:    watch without ids, submit a job on the same handle, and print
+#         "jobid name" for each event until that job is clean.
+#         Wait for OTHER_JOBID (submitted elsewhere) to be clean first,
+#         so its events would be seen if the watch were not scoped.
+# cancel: watch without ids, cancel, and print "cancelled" once the
+#         stream terminates.
+# hang:   watch without ids, print "ready", then wait forever.
+#
+
+import sys
+import time
+
+import flux
+from flux import job
+from flux.job import JobspecV1
+
+h = flux.Flux()
+cmd = sys.argv[1]
+
+if cmd == "ids":
+    watch = job.events_watch_async(h, [job.JobID(x) for x in sys.argv[2:]])
+elif cmd == "own":
+    watch = job.events_watch_async(h)
+    job.event_wait(h, job.JobID(sys.argv[2]), "clean")
+    own = job.submit(h, JobspecV1.from_command(["/bin/true"]))
+else:
+    watch = job.events_watch_async(h)
+
+if cmd == "hang":
+    # make sure the watch request has been received before reporting
+    h.rpc("job-manager.stats.get").get()
+    print("ready", flush=True)
+    while True:
+        time.sleep(60)
+
+if cmd == "cancel":
+    watch.cancel()
+
+try:
+    events = watch.get_events()
+    while events is not None:
+        for jobid, event in events:
+            print(f"{jobid} {event.name}", flush=True)
+            if cmd == "own" and jobid == own and event.name == "clean":
+                sys.exit(0)
+        events = watch.get_events()
+except OSError as exc:
+    print(f"events-watch: {exc.strerror}", file=sys.stderr)
+    sys.exit(1)
+
+if cmd == "cancel":
+    print("cancelled")
+for jobid in watch.inactive:
+    print(f"{jobid} inactive")
@@ -0,0 +1,193 @@
+/************************************************************\
+ * Copyright 2021 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+/* queuebench - time alloc queue operations
+ *
+ * Enqueue jobs with random priority, reorder a fraction of them after
+ * changing their priority, then dequeue all of them in order, as the
+ * job manager does with its alloc queue.  Optionally, use zlistx, as the
+ * job manager did before, for comparison.
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <flux/core.h>
+#include <flux/optparse.h>
+
+#include "src/common/libutil/log.h"
+#include "src/common/libutil/monotime.h"
+#include "src/common/libutil/skiplist.h"
+#include "src/common/libczmqcontainers/czmq_containers.h"
+
+struct job {
+    flux_jobid_t id;
+    int64_t priority;
+    void *handle;
+};
+
+static struct optparse_option opts[] =  {
+    { .name = "count", .key = 'c', .has_arg = 1, .arginfo = "N",
+      .usage = "Enqueue N jobs (default 100000)",
+    },
+    { .name = "reorder", .key = 'r', .has_arg = 1, .arginfo = "N",
+      .usage = "Change priority of N jobs (default count/10)",
+    },
+    { .name = "zlistx", .key = 'z', .has_arg = 0,
+      .usage = "Use zlistx instead of skiplist",
+    },
+    OPTPARSE_TABLE_END
+};
+
+/* Same order as job-manager job_comparator(): priority, then job id.
+ */
+static int job_cmp (const void *a1, const void *a2)
+{
+    const struct job *j1 = a1;
+    const struct job *j2 = a2;
+
+    if (j1->priority != j2->priority)
+        return j1->priority > j2->priority ? -1 : 1;
+    if (j1->id != j2->id)
+        return j1->id < j2->id ? -1 : 1;
+    return 0;
+}
+
+static int64_t random_priority (void)
+{
+    return random () % FLUX_JOB_PRIORITY_MAX;
+}
+
+static void report (const char *name, int count, struct timespec t0)
+{
+    double t = monotime_since (t0) / 1000.;
+
+    printf ("%-8s %8d %8.3fs %12.0f/s\n",
+            name,
+            count,
+            t,
+            t > 0. ? count / t : 0.);
+}
+
+static void bench_skiplist (struct job *jobs, int count, int reorder)
+{
+    struct skiplist *sl;
+    struct timespec t0;
+    struct job *job;
+    int i;
+
+    if (!(sl = skiplist_create (job_cmp)))
+        log_err_exit ("skiplist_create");
+
+    monotime (&t0);
+    for (i = 0; i < count; i++) {
+        if (!(jobs[i].handle = skiplist_insert (sl, &jobs[i])))
+            log_err_exit ("skiplist_insert");
+    }
+    report ("enqueue", count, t0);
+
+    monotime (&t0);
+    for (i = 0; i < reorder; i++) {
+        job = &jobs[random () % count];
+        job->priority = random_priority ();
+        skiplist_reorder (sl, job->handle);
+    }
+    report ("reorder", reorder, t0);
+
+    monotime (&t0);
+    while ((job = skiplist_first (sl)))
+        skiplist_delete (sl, job->handle);
+    report ("dequeue", count, t0);
+
+    skiplist_destroy (sl);
+}
+
+static void bench_zlistx (struct job *jobs, int count, int reorder)
+{
+    zlistx_t *l;
+    struct timespec t0;
+    struct job *job;
+    bool fwd;
+    int i;
+
+    if (!(l = zlistx_new ()))
+        log_msg_exit ("zlistx_new");
+    zlistx_set_comparator (l, job_cmp);
+
+    monotime (&t0);
+    for (i = 0; i < count; i++) {
+        fwd = jobs[i].priority > (FLUX_JOB_PRIORITY_MAX / 2);
+        if (!(jobs[i].handle = zlistx_insert (l, &jobs[i], fwd)))
+            log_msg_exit ("zlistx_insert");
+    }
+    report ("enqueue", count, t0);
+
+    monotime (&t0);
+    for (i = 0; i < reorder; i++) {
+        job = &jobs[random () % count];
+        job->priority = random_priority ();
+        fwd = job->priority > (FLUX_JOB_PRIORITY_MAX / 2);
+        zlistx_reorder (l, job->handle, fwd);
+    }
+    report ("reorder", reorder, t0);
+
+    monotime (&t0);
+    while ((job = zlistx_first (l)))
+        zlistx_delete (l, job->handle);
+    report ("dequeue", count, t0);
+
+    zlistx_destroy (&l);
+}
+
+int main (int argc, char *argv[])
+{
+    optparse_t *p;
+    struct job *jobs;
+    int count;
+    int reorder;
+    int i;
+
+    log_init ("queuebench");
+
+    if (!(p = optparse_create ("queuebench"))
+        || optparse_add_option_table (p, opts) != OPTPARSE_SUCCESS)
+        log_msg_exit ("error setting up option parsing");
+    if (optparse_parse_args (p, argc, argv) < 0)
+        exit (1);
+    count = optparse_get_int (p, "count", 100000);
+    reorder = optparse_get_int (p, "reorder", count / 10);
+    if (count < 1 || reorder < 0)
+        log_msg_exit ("invalid count or reorder value");
+
+    if (!(jobs = calloc (count, sizeof (jobs[0]))))
+        log_err_exit ("out of memory");
+    srandom (42);
+    for (i = 0; i < count; i++) {
+        jobs[i].id = i + 1;
+        jobs[i].priority = random_priority ();
+    }
+
+    if (optparse_hasopt (p, "zlistx"))
+        bench_zlistx (jobs, count, reorder);
+    else
+        bench_skiplist (jobs, count, reorder);
+
+    free (jobs);
+    optparse_destroy (p);
+    log_fini ();
+    return 0;
+}
+
+/*
+ * vi:ts=4 sw=4 expandtab
+ */
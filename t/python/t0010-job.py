@@ -198,6 +198,31 @@ class TestJob(unittest.TestCase):
         self.assertEqual(return_id, jobid)
         self.assertFalse(success)
 
+    def test_17_submit_bulk(self):
+        jobspecs = [self.basic_jobspec] * 4
+        future = job.submit_bulk_async(self.fh, jobspecs)
+        jobids = future.get_ids()
+        self.assertEqual(len(jobids), 4)
+        self.assertEqual(len(set(jobids)), 4)
+        for jobid in jobids:
+            job.event_wait(self.fh, jobid, name="submit")
+
+    def test_18_submit_bulk_shared_signature(self):
+        jobspecs = [JobspecV1.from_command(["true"]) for i in range(3)]
+        future = job.submit_bulk_async(self.fh, jobspecs, shared_signature=True)
+        for jobid in future.get_ids():
+            job.event_wait(self.fh, jobid, name="submit")
+
+    def test_19_submit_bulk_partial_failure(self):
+        jobspecs = [self.basic_jobspec, "{", self.basic_jobspec]
+        future = job.submit_bulk_async(self.fh, jobspecs, shared_signature=True)
+        self.assertGreater(future.get_id(0), 0)
+        with self.assertRaises(OSError):
+            future.get_id(1)
+        self.assertGreater(future.get_id(2), 0)
+        with self.assertRaises(OSError):
+            future.get_ids()
+
     def test_20_000_job_event_functions_invalid_args(self):
         with self.assertRaises(OSError) as cm:
             for event in job.event_watch(self.fh, 123):
@@ -339,6 +364,49 @@ class TestJob(unittest.TestCase):
             self.assertEqual(err.errno, errno.ENODATA)
         self.assertIs(event, None)
 
+    def test_20_008_job_events_watch_ids(self):
+        jobids = [
+            job.submit(self.fh, JobspecV1.from_command(["sleep", "0"]))
+            for i in range(2)
+        ]
+        future = job.events_watch_async(self.fh, jobids)
+        self.assertIsInstance(future, job.JobEventsWatchFuture)
+        events = {jobid: [] for jobid in jobids}
+        while True:
+            result = future.get_events()
+            if result is None:
+                break
+            for jobid, event in result:
+                self.assertIsInstance(event, job.EventLogEvent)
+                events[jobid].append(event.name)
+        self.assertEqual(future.inactive, [])
+        for jobid in jobids:
+            self.assertEqual(events[jobid][0], "submit")
+            self.assertEqual(events[jobid][-1], "clean")
+
+    def test_20_009_job_events_watch_all(self):
+        future = job.events_watch_async(self.fh)
+        jobid = job.submit(self.fh, JobspecV1.from_command(["sleep", "0"]))
+        events = []
+        while "clean" not in events:
+            for event_jobid, event in future.get_events():
+                if event_jobid == jobid:
+                    events.append(event.name)
+        future.cancel()
+        self.assertEqual(events[0], "submit")
+        self.assertEqual(events[-1], "clean")
+
+    def test_20_010_job_events_watch_inactive(self):
+        jobid = job.submit(
+            self.fh, JobspecV1.from_command(["sleep", "0"]), waitable=True
+        )
+        job.wait(self.fh, jobid)
+        job.event_wait(self.fh, jobid, "clean")
+        future = job.events_watch_async(self.fh, [jobid])
+        self.assertEqual(future.get_events(), [])
+        self.assertEqual(future.inactive, [jobid])
+        self.assertIsNone(future.get_events())
+
     def test_21_stdio(self):
         """Test getter/setter methods for stdio properties"""
         jobspec = Jobspec.from_yaml_stream(self.basic_jobspec)
@@ -0,0 +1,160 @@
+/************************************************************\
+ * Copyright 2021 Lawrence Livermore National Security, LLC
+ * (c.f. AUTHORS, NOTICE.LLNS, COPYING)
+ *
+ * This file is part of the Flux resource manager framework.
+ * For details, see https://github.com/flux-framework.
+ *
+ * SPDX-License-Identifier: LGPL-3.0
+\************************************************************/
+
+/* rpcbench - time broker.ping RPCs over the local connector
+ *
+ * Run the same RPC workload over a plain local:// connection, then over
+ * a connection that has been switched to shared memory rings
+ * (FLUX_LOCAL_CONNECTOR_SHMEM), and report latency and throughput of each.
+ */
+
+#if HAVE_CONFIG_H
+#include "config.h"
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <flux/core.h>
+#include <flux/optparse.h>
+
+#include "src/common/libutil/log.h"
+#include "src/common/libutil/monotime.h"
+
+struct bench {
+    flux_t *h;
+    char *pad;
+    int count;
+    int window;
+    int sent;
+    int received;
+    double latency;     // sum of RPC round trip times (ms)
+};
+
+static struct optparse_option opts[] =  {
+    { .name = "count", .key = 'c', .has_arg = 1, .arginfo = "N",
+      .usage = "Send N RPCs (default 10000)",
+    },
+    { .name = "pad", .key = 'p', .has_arg = 1, .arginfo = "BYTES",
+      .usage = "Pad each request with BYTES of payload (default 0)",
+    },
+    { .name = "window", .key = 'w', .has_arg = 1, .arginfo = "N",
+      .usage = "Keep up to N RPCs outstanding (default 1)",
+    },
+    OPTPARSE_TABLE_END
+};
+
+static void ping_continuation (flux_future_t *f, void *arg);
+
+static void send_ping (struct bench *b)
+{
+    flux_future_t *f;
+    struct timespec *t0;
+
+    if (!(t0 = malloc (sizeof (*t0))))
+        log_err_exit ("out of memory");
+    monotime (t0);
+    if (!(f = flux_rpc_pack (b->h,
+                             "broker.ping",
+                             FLUX_NODEID_ANY,
+                             0,
+                             "{s:s}",
+                             "pad", b->pad))
+        || flux_future_aux_set (f, "t0", t0, free) < 0
+        || flux_future_then (f, -1., ping_continuation, b) < 0)
+        log_err_exit ("error sending broker.ping request");
+    b->sent++;
+}
+
+static void ping_continuation (flux_future_t *f, void *arg)
+{
+    struct bench *b = arg;
+    struct timespec *t0 = flux_future_aux_get (f, "t0");
+
+    if (flux_rpc_get (f, NULL) < 0)
+        log_err_exit ("broker.ping");
+    b->latency += monotime_since (*t0);
+    b->received++;
+    flux_future_destroy (f);
+    if (b->sent < b->count)
+        send_ping (b);
+    else if (b->received == b->count)
+        flux_reactor_stop (flux_get_reactor (b->h));
+}
+
+static void run (const char *name, struct bench *b)
+{
+    struct timespec t0;
+    double t;
+
+    if (!(b->h = flux_open (NULL, 0)))
+        log_err_exit ("flux_open");
+    b->sent = b->received = 0;
+    b->latency = 0.;
+
+    monotime (&t0);
+    while (b->sent < b->window && b->sent < b->count)
+        send_ping (b);
+    if (flux_reactor_run (flux_get_reactor (b->h), 0) < 0)
+        log_err_exit ("flux_reactor_run");
+    t = monotime_since (t0) / 1000.;
+
+    printf ("%-8s %8d %8.3fs %10.0f/s %10.1fus\n",
+            name,
+            b->count,
+            t,
+            t > 0. ? b->count / t : 0.,
+            b->latency * 1000. / b->count);
+    flux_close (b->h);
+}
+
+int main (int argc, char *argv[])
+{
+    optparse_t *p;
+    struct bench b;
+    int pad;
+
+    log_init ("rpcbench");
+
+    if (!(p = optparse_create ("rpcbench"))
+        || optparse_add_option_table (p, opts) != OPTPARSE_SUCCESS)
+        log_msg_exit ("error setting up option parsing");
+    if (optparse_parse_args (p, argc, argv) < 0)
+        exit (1);
+
+    memset (&b, 0, sizeof (b));
+    b.count = optparse_get_int (p, "count", 10000);
+    b.window = optparse_get_int (p, "window", 1);
+    pad = optparse_get_int (p, "pad", 0);
+    if (b.count < 1 || b.window < 1 || pad < 0)
+        log_msg_exit ("invalid count, window, or pad value");
+    if (!(b.pad = malloc (pad + 1)))
+        log_err_exit ("out of memory");
+    memset (b.pad, 'x', pad);
+    b.pad[pad] = '\0';
+
+    printf ("%-8s %8s %9s %12s %12s\n",
+            "MODE", "COUNT", "TIME", "RATE", "LATENCY");
+
+    unsetenv ("FLUX_LOCAL_CONNECTOR_SHMEM");
+    run ("socket", &b);
+
+    if (setenv ("FLUX_LOCAL_CONNECTOR_SHMEM", "1", 1) < 0)
+        log_err_exit ("setenv");
+    run ("shmem", &b);
+
+    free (b.pad);
+    optparse_destroy (p);
+    log_fini ();
+    return 0;
+}
+
+/*
+ * vi:ts=4 sw=4 expandtab
+ */
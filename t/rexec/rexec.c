@@ -17,6 +17,7 @@
 #include <string.h>
 #include <inttypes.h>
 #include <flux/core.h>
+#include <flux/idset.h>
 #include <flux/optparse.h>
 
 #include "src/common/libutil/log.h"
@@ -27,6 +28,8 @@ extern char **environ;
 static struct optparse_option cmdopts[] = {
     { .name = "rank", .key = 'r', .has_arg = 1, .arginfo = "rank",
       .usage = "Specify rank for test" },
+    { .name = "ranks", .key = 'R', .has_arg = 1, .arginfo = "IDSET",
+      .usage = "Run on all ranks in IDSET with flux_rexec_tree()" },
     { .name = "kill-immediately", .key = 'K', .has_arg = 0,
       .usage = "kill subprocesses immediately after exec" },
     { .name = "kill", .key = 'k', .has_arg = 0,
@@ -124,7 +127,8 @@ int main (int argc, char *argv[])
     flux_reactor_t *reactor;
     flux_cmd_t *cmd;
     char *cwd;
-    flux_subprocess_t *p = NULL;
+    flux_subprocess_t **procs = NULL;
+    int nprocs = 1;
     flux_subprocess_ops_t ops = {
         .on_completion = completion_cb,
         .on_state_change = state_cb,
@@ -181,24 +185,46 @@ int main (int argc, char *argv[])
     if (!(reactor = flux_get_reactor (h)))
         log_err_exit ("flux_get_reactor");
 
-    if (!(p = flux_rexec (h, rank, 0, cmd, &ops)))
-        log_err_exit ("flux_rexec");
+    if (optparse_getopt (opts, "ranks", &optargp) > 0) {
+        struct idset *ranks;
+
+        if (!(ranks = idset_decode (optargp)))
+            log_err_exit ("idset_decode");
+        nprocs = idset_count (ranks);
+        if (!(procs = calloc (nprocs, sizeof (procs[0]))))
+            log_err_exit ("calloc");
+        if (flux_rexec_tree (h, ranks, 0, cmd, &ops, procs) < 0)
+            log_err_exit ("flux_rexec_tree");
+        idset_destroy (ranks);
+    }
+    else {
+        if (!(procs = calloc (1, sizeof (procs[0]))))
+            log_err_exit ("calloc");
+        if (!(procs[0] = flux_rexec (h, rank, 0, cmd, &ops)))
+            log_err_exit ("flux_rexec");
+    }
 
     if ((n = optparse_getopt (opts, "kill-immediately", NULL)) > 0) {
         /* For testing -K is allowed multiple times */
-        while (n--)
-            send_sigterm (p);
+        while (n--) {
+            for (int i = 0; i < nprocs; i++)
+                send_sigterm (procs[i]);
+        }
     }
 
-    if (optparse_getopt (opts, "stdin2stream", &optargp) > 0)
-        stdin2stream (p, optargp);
+    if (optparse_getopt (opts, "stdin2stream", &optargp) > 0) {
+        for (int i = 0; i < nprocs; i++)
+            stdin2stream (procs[i], optargp);
+    }
 
     if (flux_reactor_run (reactor, 0) < 0)
         log_err_exit ("flux_reactor_run");
 
     /* Clean up.
      */
-    flux_subprocess_destroy (p);
+    for (int i = 0; i < nprocs; i++)
+        flux_subprocess_destroy (procs[i]);
+    free (procs);
     flux_cmd_destroy (cmd);
     flux_close (h);
     log_fini ();
@@ -69,7 +69,7 @@ else:
 
 if args.validate:
     metrics = str.splitlines("".join([_.decode("utf-8") for _ in p]))
-    ex = re.compile("^\w+:[\+\-]*\d+\|ms|[gC]$")
+    ex = re.compile(r"^[\w.\-]+:[+\-]?\d+(\.\d+)?\|(ms|g|C)(\|@[\d.e\-]+)?$")
 
     for m in metrics:
         if not ex.search(m):
@@ -315,6 +315,49 @@ test_expect_success 'hostlist attr is set on size 1 instance' '
 test_expect_success 'hostlist attr is set on all ranks of size 4 instance' '
 	flux start ${ARGS} -s4 flux exec flux getattr hostlist
 '
+test_expect_success 'hostlist attr matches with allgather exchange' '
+	flux start ${ARGS} -s4 flux exec flux getattr hostlist >hl.rank0 &&
+	flux start ${ARGS} -s4 -o,-Sbroker.boot-exchange=allgather \
+		flux exec flux getattr hostlist >hl.allgather &&
+	test $(wc -l <hl.rank0) -eq 4 &&
+	test_cmp hl.rank0 hl.allgather
+'
+# Usage: fake_hosts COUNT LENGTH
+# Print a hostlist of COUNT distinct, uncompressible LENGTH character names
+fake_hosts() {
+	pad=$(printf "%*s" $(($2 - 1)) "" | tr " " x) &&
+	for c in $(echo a b c d e f g h i j k l m n o p | cut -d" " -f1-$1); do
+		printf "%s%s\n" $c $pad || return 1
+	done | paste -sd, -
+}
+test_expect_success 'hostlist longer than one PMI chunk is exchanged' '
+	fake_hosts 9 63 >hl_long.exp &&
+	test $(wc -c <hl_long.exp) -gt 513 &&
+	flux start ${ARGS} -s9 --test-hosts=$(cat hl_long.exp) \
+		flux exec flux getattr hostlist >hl_long.out &&
+	test $(wc -l <hl_long.out) -eq 9 &&
+	sort -u hl_long.out | test_cmp hl_long.exp -
+'
+test_expect_success 'hostlist of exactly one PMI chunk is exchanged' '
+	fake_hosts 9 56 >hl_exact.exp &&
+	test $(wc -c <hl_exact.exp) -eq 513 &&
+	flux start ${ARGS} -s9 --test-hosts=$(cat hl_exact.exp) \
+		flux exec flux getattr hostlist >hl_exact.out &&
+	test $(wc -l <hl_exact.out) -eq 9 &&
+	sort -u hl_exact.out | test_cmp hl_exact.exp -
+'
+test_expect_success 'unknown broker.boot-exchange method fails' '
+	test_must_fail flux start ${ARGS} -s2 \
+		-o,-Sbroker.boot-exchange=badmethod /bin/true 2>exchange.err &&
+	grep "unknown broker.boot-exchange method" exchange.err
+'
+test_expect_success 'boot timing attributes are set on all ranks' '
+	flux start ${ARGS} -s4 flux exec sh -c \
+		"flux getattr broker.boot-pmi-init && \
+		 flux getattr broker.boot-pmi-exchange && \
+		 flux getattr broker.boot-time" >boottime.out &&
+	test $(wc -l <boottime.out) -eq 12
+'
 test_expect_success 'setting hostlist on command line fails' '
 	test_must_fail flux start ${ARGS} -o,-Shostlist=xxx 2>hostlist.err &&
 	grep "failed to set hostlist attribute" hostlist.err
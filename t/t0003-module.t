@@ -198,6 +198,18 @@ test_expect_success 'flux module stats --parse "#event (tx)" counts events' '
 	test "$EVENT_TX" = $((${EVENT_TX2}-1))
 '
 
+test_expect_success HAVE_JQ 'flux module stats reports connector-local client I/O' '
+	flux module stats $TESTMOD >conn.stats &&
+	test $(jq ".\"connection-count\"" conn.stats) -ge 1 &&
+	jq -e "[.connections[] | .\"recv-count\"] | add > 0" conn.stats &&
+	jq -e "[.connections[] | .\"recv-calls\"] | add > 0" conn.stats
+'
+
+test_expect_success 'flux module stats connector-local works for guest' '
+	FLUX_HANDLE_ROLEMASK=0x2 flux module stats $TESTMOD >conn-guest.stats &&
+	grep -q connection-count conn-guest.stats
+'
+
 test_expect_success 'flux module stats --clear works' '
 	flux event pub xyz &&
 	flux module stats --clear $TESTMOD &&
@@ -231,4 +231,63 @@ test_expect_success 'rexec read_getline call works on remote streams' '
         test_cmp expected output
 '
 
+test_expect_success 'rexec tree runs command on all ranks' '
+	${FLUX_BUILD_DIR}/t/rexec/rexec -R 0-3 flux getattr rank \
+		| sort -n > tree.out &&
+	printf "0\n1\n2\n3\n" > tree.exp &&
+	test_cmp tree.exp tree.out
+'
+
+test_expect_success 'rexec tree works on ranks below the root only' '
+	${FLUX_BUILD_DIR}/t/rexec/rexec -R 2-3 flux getattr rank \
+		| sort -n > tree2.out &&
+	printf "2\n3\n" > tree2.exp &&
+	test_cmp tree2.exp tree2.out
+'
+
+test_expect_success 'rexec tree propagates largest exit code' '
+	test_expect_code 3 ${FLUX_BUILD_DIR}/t/rexec/rexec -R 0-3 \
+		sh -c "test \$(flux getattr rank) -ne 3 || exit 3"
+'
+
+test_expect_success 'rexec tree reports exec failure on every rank' '
+	! ${FLUX_BUILD_DIR}/t/rexec/rexec -R 0-3 /usr/bin/foobarbaz \
+		> tree3.out 2>&1 &&
+	test $(grep -c "No such file or directory" tree3.out) -eq 4
+'
+
+test_expect_success 'rexec tree with invalid rank fails' '
+	! ${FLUX_BUILD_DIR}/t/rexec/rexec -R 0,32 /bin/true > tree4.out 2>&1 &&
+	grep -q "Invalid argument" tree4.out
+'
+
+wait_rexec_ps_count() {
+	local rank=$1
+	local count=$2
+	local i=0
+	while test "$(${FLUX_BUILD_DIR}/t/rexec/rexec_ps -r $rank | wc -l)" != "$count" \
+	       && test $i -lt 50
+	do
+		sleep 0.1
+		i=$((i + 1))
+	done
+	test $i -lt 50
+}
+
+test_expect_success NO_CHAIN_LINT 'rexec tree disconnect terminates processes on all ranks' '
+	${FLUX_BUILD_DIR}/t/rexec/rexec -R 0-3 sleep 100 &
+	pid=$!
+	for rank in 0 1 2 3; do
+		wait_rexec_ps_count $rank 1 || return 1
+	done &&
+	for rank in 0 1 2 3; do
+		${FLUX_BUILD_DIR}/t/rexec/rexec_ps -r $rank | cut -f1
+	done | sort -u > tree_senders.out &&
+	test $(wc -l < tree_senders.out) -eq 1 &&
+	kill -TERM $pid &&
+	for rank in 0 1 2 3; do
+		wait_rexec_ps_count $rank 0 || return 1
+	done
+'
+
 test_done
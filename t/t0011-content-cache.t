@@ -181,6 +181,67 @@ test_expect_success 'store 1K blobs from all ranks using async RPC' '
 	flux exec -n flux content spam 1024 256 >/dev/null
 '
 
+test_expect_success 'content stats include LRU segment counters' '
+	flux module stats --type int --parse probation.hits content &&
+	flux module stats --type int --parse protected.evictions content &&
+	flux module stats --type int --parse misses content
+'
+
+test_expect_success 'set content.size-limit on rank 1' '
+	flux exec -n -r 1 flux setattr content.size-limit 8192 &&
+	flux exec -n -r 1 flux content dropcache
+'
+test_expect_success 'loading blobs on rank 1 does not exceed size limit' '
+	for hash in $(cat 64.0.hash 4k.0.hash 1m.0.hash 64.3.hash 4k.3.hash); do \
+	    flux exec -n -r 1 flux content load $hash >/dev/null || return 1; \
+	done &&
+	SIZE=$(flux exec -n -r 1 \
+	    flux module stats --type int --parse size content) &&
+	test $SIZE -le 8192
+'
+test_expect_success 'large blob was evicted from probation on rank 1' '
+	EVICT=$(flux exec -n -r 1 \
+	    flux module stats --type int --parse probation.evictions content) &&
+	test $EVICT -gt 0
+'
+test_expect_success 'reloaded blob is promoted to protected segment' '
+	flux exec -n -r 1 flux content load $(cat 64.3.hash) >/dev/null &&
+	HITS=$(flux exec -n -r 1 \
+	    flux module stats --type int --parse probation.hits content) &&
+	test $HITS -gt 0 &&
+	COUNT=$(flux exec -n -r 1 \
+	    flux module stats --type int --parse protected.count content) &&
+	test $COUNT -gt 0
+'
+test_expect_success 'unset content.size-limit on rank 1' '
+	flux exec -n -r 1 flux setattr content.size-limit 0
+'
+
+test_expect_success 'load blobs in one batch on all ranks' '
+	cat 64.0.store 4k.0.store 64.3.store 4k.3.store >batch.expect &&
+	flux exec -n sh -c "flux content load \
+		$(cat 64.0.hash 4k.0.hash 64.3.hash 4k.3.hash) \
+		| $BLOBREF $HASHFUN" >batch.all.output &&
+	cat batch.expect | $BLOBREF $HASHFUN >batch.hash &&
+	for i in $(seq 1 $SIZE); do cat batch.hash; done >batch.all.expect &&
+	test_cmp batch.all.expect batch.all.output
+'
+
+test_expect_success 'batch load of missing blob fails on all ranks' '
+	MISSING=$(echo nonexistent | $BLOBREF $HASHFUN) &&
+	test_must_fail flux exec -n flux content load \
+		$(cat 64.0.hash) $MISSING
+'
+
+test_expect_success 'store blobs in batches from rank 3' '
+	flux exec -n -r 3 flux content spam --batch=8 64 2 >batch.hashes &&
+	test $(sort -u batch.hashes | wc -l) -eq 64
+'
+
+test_expect_success 'batch stored on rank 3 can be loaded from rank 0' '
+	flux content load $(cat batch.hashes) >/dev/null
+'
+
 test_expect_success 'load request with empty payload fails with EPROTO(71)' '
 	${RPC} content.load 71 </dev/null
 '
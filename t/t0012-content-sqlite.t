@@ -75,6 +75,19 @@ test_expect_success 'load 1m blob bypassing cache' '
 	test_cmp 1m.0.store 1m.0.load
 '
 
+test_expect_success 'load multiple blobs in one batch bypassing cache' '
+	cat 0.0.store 64.0.store 4k.0.store 1m.0.store >batch.expect &&
+	flux content load --bypass-cache \
+		$(cat 0.0.hash 64.0.hash 4k.0.hash 1m.0.hash) >batch.out &&
+	test_cmp batch.expect batch.out
+'
+
+test_expect_success 'batch load of missing blob bypassing cache fails' '
+	MISSING=$(echo nonexistent | $BLOBREF $HASHFUN) &&
+	test_must_fail flux content load --bypass-cache \
+		$(cat 64.0.hash) $MISSING
+'
+
 # Verify same blobs on all ranks
 # forcing content to fault in from the content backing service
 
@@ -110,6 +123,27 @@ test_expect_success 'exercise batching of synchronous flush to backing store' '
 	test ${NDIRTY} -eq 0
 '
 
+test_expect_success 'store blobs in batches through the cache' '
+	flux content spam --batch=50 1000 4 >batch.hashes &&
+	test $(sort -u batch.hashes | wc -l) -eq 1000 &&
+	flux content flush &&
+	NDIRTY=`flux module stats --type int --parse dirty content` &&
+	test ${NDIRTY} -eq 0
+'
+
+test_expect_success 'load batch of blobs faults in from backing store' '
+	flux content dropcache &&
+	flux content load $(head -100 batch.hashes) >batch.rank0.out &&
+	flux exec -n -r 1 flux content load $(head -100 batch.hashes) \
+		>batch.rank1.out &&
+	test_cmp batch.rank0.out batch.rank1.out &&
+	test $(wc -c <batch.rank0.out) -eq 25600
+'
+
+test_expect_success 'store blobs in batches from all ranks' '
+	flux exec -n flux content spam --batch=16 256 4 >/dev/null
+'
+
 test_expect_success 'drop the cache' '
 	flux content dropcache
 '
@@ -161,6 +195,93 @@ test_expect_success HAVE_JQ 'kvs-checkpoint.get noexist fails with No such...' '
 	grep "No such file or directory" badkey.err
 '
 
+test_expect_success 'reload content-sqlite module in durable mode' '
+	flux content flush &&
+	flux module reload content-sqlite durable group-size=16 group-timeout=10ms
+'
+
+test_expect_success HAVE_JQ 'content-sqlite stats report durable mode' '
+	flux module stats content-sqlite >durable.stats &&
+	jq -e ".durable == true" <durable.stats &&
+	jq -e ".\"group-size-limit\" == 16" <durable.stats
+'
+
+test_expect_success 'store and flush blobs in durable mode' '
+	flux content spam 100 100 >/dev/null &&
+	flux content spam --batch=10 100 100 >/dev/null &&
+	flux content flush &&
+	NDIRTY=`flux module stats --type int --parse dirty content` &&
+	test $NDIRTY -eq 0
+'
+
+test_expect_success HAVE_JQ 'content-sqlite committed groups of stores' '
+	flux module stats content-sqlite >durable2.stats &&
+	jq -e ".\"group-size\".count > 0" <durable2.stats &&
+	jq -e ".\"group-size\".max <= 25" <durable2.stats
+'
+
+test_expect_success HAVE_JQ 'kvs-checkpoint.get foo returns baz in durable mode' '
+	echo baz >value4.exp &&
+	kvs_checkpoint_get foo | jq -r .value >value4.out &&
+	test_cmp value4.exp value4.out
+'
+
+test_expect_success 'content-sqlite rejects invalid group-size' '
+	flux module remove content-sqlite &&
+	test_must_fail flux module load content-sqlite group-size=0 &&
+	flux module load content-sqlite
+'
+
+test_expect_success 'reload content-sqlite module with lz4-dict codec' '
+	flux content flush &&
+	flux module reload content-sqlite codec=lz4-dict dict-size=4096
+'
+
+test_expect_success 'store small blobs to fill dictionary' '
+	for i in $(seq 1 100); do \
+		echo "{\"data\":{\"key$i\":[\"sha1-000000000000000000000000000000000000000$i\"]},\"type\":\"dir\",\"ver\":1}" >dict.$i.store && \
+		flux content store --bypass-cache <dict.$i.store >dict.$i.hash || return 1; \
+	done
+'
+
+test_expect_success 'flux content stats reports dictionary' '
+	flux content stats >dict.stats &&
+	grep "codec: lz4-dict" dict.stats &&
+	grep "dictionaries: 1" dict.stats
+'
+
+test_expect_success 'blobs stored with dictionary can be loaded' '
+	for i in $(seq 1 100); do \
+		flux content load --bypass-cache $(cat dict.$i.hash) >dict.$i.load && \
+		test_cmp dict.$i.store dict.$i.load || return 1; \
+	done
+'
+
+test_expect_success 'reload content-sqlite module with lz4hc codec' '
+	flux module reload content-sqlite codec=lz4hc:12
+'
+
+test_expect_success 'blobs stored with dictionary can be loaded after reload' '
+	for i in $(seq 1 100); do \
+		flux content load --bypass-cache $(cat dict.$i.hash) >dict2.$i.load && \
+		test_cmp dict.$i.store dict2.$i.load || return 1; \
+	done
+'
+
+test_expect_success 'store and load 1m blob with lz4hc codec' '
+	dd if=/dev/zero count=256 bs=4096 >1m.hc.store 2>/dev/null &&
+	flux content store --bypass-cache <1m.hc.store >1m.hc.hash &&
+	flux content load --bypass-cache $(cat 1m.hc.hash) >1m.hc.load &&
+	test_cmp 1m.hc.store 1m.hc.load
+'
+
+test_expect_success 'content-sqlite rejects invalid codec' '
+	flux module remove content-sqlite &&
+	test_must_fail flux module load content-sqlite codec=lz5 &&
+	test_must_fail flux module load content-sqlite codec=lz4hc:99 &&
+	flux module load content-sqlite
+'
+
 test_expect_success 'content-backing.load invalid blobref fails' '
 	echo -n sha999-000 >bad.blobref &&
 	$RPC content-backing.load 2 <bad.blobref 2>load.err
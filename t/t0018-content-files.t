@@ -189,6 +189,24 @@ test_expect_success LONGTEST 'reload/verify various size large blobs through cac
 	test $err -eq 0
 '
 
+test_expect_success HAVE_JQ 'gc without a KVS removes all blobs' '
+	flux content gc >gc.out &&
+	cat gc.out &&
+	grep -E "removed ([1-9][0-9]*) of \1 blobs" gc.out &&
+	flux module stats content-files | jq -e ".gc.runs == 1"
+'
+
+test_expect_success 'gc removed blob files but not checkpoint key' '
+	test_must_fail backing_load $(cat blobref.1024) &&
+	test -f $(flux getattr content.backing-path)/foo &&
+	test -f $(flux getattr content.backing-path)/testkey1
+'
+
+test_expect_success 'gc of an empty store removes nothing' '
+	flux content gc --rate=100 >gc2.out &&
+	grep "removed 0 of 0" gc2.out
+'
+
 test_expect_success 'remove content-files module' '
 	flux module remove content-files
 '
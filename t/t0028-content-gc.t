@@ -0,0 +1,96 @@
+#!/bin/sh
+
+test_description='Test content backing store garbage collection'
+
+. `dirname $0`/sharness.sh
+
+test_under_flux 2 kvs
+
+test_expect_success 'create some KVS garbage by overwriting values' '
+	for i in $(seq 1 20); do \
+		flux kvs put test.a=$(seq $i 1000 | tr -d "\n") \
+		             test.b.c=$(seq 1 $((i*10)) | tr -d "\n") || return 1; \
+	done &&
+	flux kvs put test.keep=$(seq 1 500 | tr -d "\n") &&
+	flux kvs get test.a >a.exp &&
+	flux kvs get test.b.c >c.exp &&
+	flux kvs get test.keep >keep.exp
+'
+
+test_expect_success 'create and remove a namespace' '
+	flux kvs namespace create gcns &&
+	flux kvs put --namespace=gcns x=$(seq 1 300 | tr -d "\n") &&
+	flux kvs namespace create gcns2 &&
+	flux kvs put --namespace=gcns2 y=$(seq 1 400 | tr -d "\n") &&
+	flux kvs get --namespace=gcns2 y >y.exp &&
+	flux kvs namespace remove gcns
+'
+
+test_expect_success 'flux content gc removes unreachable blobs' '
+	flux content gc >gc.out &&
+	cat gc.out &&
+	grep -E "removed [1-9][0-9]* of" gc.out
+'
+
+test_expect_success HAVE_JQ 'content-sqlite stats report gc results' '
+	flux module stats content-sqlite | jq -e ".gc.runs == 1" &&
+	flux module stats content-sqlite | jq -e ".gc.removed > 0" &&
+	flux module stats content-sqlite | jq -e ".gc.state == \"idle\""
+'
+
+test_expect_success 'drop caches on all ranks' '
+	flux kvs dropcache --all &&
+	flux exec -n flux content dropcache
+'
+
+test_expect_success 'reachable values survive gc' '
+	flux kvs get test.a >a.out &&
+	test_cmp a.exp a.out &&
+	flux kvs get test.b.c >c.out &&
+	test_cmp c.exp c.out &&
+	flux kvs get test.keep >keep.out &&
+	test_cmp keep.exp keep.out &&
+	flux exec -n -r 1 flux kvs get test.keep >keep1.out &&
+	test_cmp keep.exp keep1.out
+'
+
+test_expect_success 'values in other namespaces survive gc' '
+	flux kvs get --namespace=gcns2 y >y.out &&
+	test_cmp y.exp y.out
+'
+
+test_expect_success 'second gc removes nothing' '
+	flux content gc >gc2.out &&
+	grep "removed 0 of" gc2.out
+'
+
+test_expect_success 'rewriting a collected value works' '
+	flux kvs put test.a=$(seq 1 1000 | tr -d "\n") &&
+	flux kvs dropcache --all &&
+	flux exec -n flux content dropcache &&
+	flux kvs get test.a | tr -d "\n" >a2.out &&
+	seq 1 1000 | tr -d "\n" >a2.exp &&
+	test_cmp a2.exp a2.out
+'
+
+test_expect_success 'rate limited gc with concurrent updates' '
+	(for i in $(seq 1 50); do \
+		flux kvs put test.bg.$i=$(seq $i 200 | tr -d "\n"); \
+	done) &
+	pid=$! &&
+	flux content gc --rate=1000 --compact &&
+	wait $pid &&
+	flux kvs dropcache --all &&
+	flux exec -n flux content dropcache &&
+	for i in $(seq 1 50); do \
+		flux kvs get test.bg.$i | tr -d "\n" >bg.out && \
+		seq $i 200 | tr -d "\n" >bg.exp && \
+		test_cmp bg.exp bg.out || return 1; \
+	done
+'
+
+test_expect_success 'gc request with negative rate fails' '
+	test_must_fail flux content gc --rate=-1
+'
+
+test_done
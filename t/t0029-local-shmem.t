@@ -0,0 +1,73 @@
+#!/bin/sh
+
+test_description='Test local connector shared memory transport'
+
+. `dirname $0`/sharness.sh
+
+test_under_flux 1 kvs
+
+RPCBENCH=${FLUX_BUILD_DIR}/t/request/rpcbench
+
+connector_stats() {
+	flux module stats connector-local
+}
+
+test_expect_success HAVE_JQ 'socket connection does not use shmem' '
+	connector_stats >socket.stats &&
+	jq -e "[.connections[] | .shmem] | any | not" socket.stats
+'
+test_expect_success HAVE_JQ 'FLUX_LOCAL_CONNECTOR_SHMEM=1 switches connection to shmem' '
+	FLUX_LOCAL_CONNECTOR_SHMEM=1 connector_stats >shmem.stats &&
+	jq -e "[.connections[] | .shmem] | any" shmem.stats
+'
+test_expect_success HAVE_JQ 'FLUX_LOCAL_CONNECTOR_SHMEM=0 does not use shmem' '
+	FLUX_LOCAL_CONNECTOR_SHMEM=0 connector_stats >zero.stats &&
+	jq -e "[.connections[] | .shmem] | any | not" zero.stats
+'
+test_expect_success 'FLUX_LOCAL_CONNECTOR_SHMEM=bad fails' '
+	test_must_fail env FLUX_LOCAL_CONNECTOR_SHMEM=bad flux getattr rank
+'
+test_expect_success 'RPCs work over shmem' '
+	FLUX_LOCAL_CONNECTOR_SHMEM=1 flux getattr rank &&
+	FLUX_LOCAL_CONNECTOR_SHMEM=1 flux kvs put shmem.test=42 &&
+	test $(FLUX_LOCAL_CONNECTOR_SHMEM=1 flux kvs get shmem.test) = 42
+'
+test_expect_success 'events work over shmem' '
+	FLUX_LOCAL_CONNECTOR_SHMEM=1 \
+		flux event sub --count=1 shmem.test >event.out &
+	pid=$! &&
+	for i in $(seq 1 100); do \
+		test -s event.out && break; \
+		flux event pub shmem.test; \
+		sleep 0.1; \
+	done &&
+	wait $pid &&
+	grep shmem.test event.out
+'
+test_expect_success 'large messages work over a small ring' '
+	dd if=/dev/urandom bs=1024 count=256 2>/dev/null \
+		| base64 -w0 >large.in &&
+	FLUX_LOCAL_CONNECTOR_SHMEM=4096 flux kvs put --raw shmem.large=- \
+		<large.in &&
+	FLUX_LOCAL_CONNECTOR_SHMEM=4096 flux kvs get --raw shmem.large \
+		>large.out &&
+	test_cmp large.in large.out
+'
+test_expect_success 'rpcbench compares socket and shmem' '
+	$RPCBENCH --count=2000 >bench.out &&
+	cat bench.out &&
+	grep "^socket" bench.out &&
+	grep "^shmem" bench.out
+'
+test_expect_success 'rpcbench works with a window and padding' '
+	$RPCBENCH --count=1000 --window=32 --pad=10000 >bench2.out &&
+	cat bench2.out &&
+	grep "^shmem" bench2.out
+'
+test_expect_success HAVE_JQ 'shmem connection avoids most socket system calls' '
+	FLUX_LOCAL_CONNECTOR_SHMEM=1 connector_stats >calls.stats &&
+	jq -e "[.connections[] | select(.shmem) | .\"recv-calls\"] \
+		| max < 10" calls.stats
+'
+
+test_done
@@ -105,6 +105,26 @@ test_expect_success 'kvs: store 10,000 keys in one dir' '
 	${FLUX_BUILD_DIR}/t/kvs/torture --prefix $DIR.bigdir --count 10000
 '
 
+test_expect_success HAVE_JQ 'kvs: large dir is stored as hashed directory' '
+	flux kvs get --treeobj $DIR.bigdir >bigdir.json &&
+	$jq -e ".type == \"dirref\" and (.data | length) > 1" bigdir.json &&
+	REF=$($jq -r ".data[1]" bigdir.json) &&
+	flux content load $REF | $jq -e ".type == \"dir\""
+'
+
+test_expect_success 'kvs: hashed directory can be listed' '
+	test $(flux kvs ls -1 $DIR.bigdir | wc -l) -eq 10000
+'
+
+test_expect_success 'kvs: hashed directory entries can be updated' '
+	KEY=$(flux kvs ls -1 $DIR.bigdir | head -1) &&
+	flux kvs put $DIR.bigdir.$KEY=updated &&
+	test $(flux kvs get $DIR.bigdir.$KEY) = "updated" &&
+	flux kvs unlink $DIR.bigdir.$KEY &&
+	test_must_fail flux kvs get $DIR.bigdir.$KEY &&
+	test $(flux kvs ls -1 $DIR.bigdir | wc -l) -eq 9999
+'
+
 test_expect_success LONGTEST 'kvs: store 100,000 keys in one dir' '
 	${FLUX_BUILD_DIR}/t/kvs/torture --prefix $DIR.bigdir2 --count 100000
 '
@@ -131,4 +151,16 @@ test_expect_success 'kvs: transaction-merge disabling works' '
 	test "$OUTPUT" = "${THREADS}"
 '
 
+# prefetch option test
+test_expect_success 'kvs: prefetch loads sub-directories on readdir' '
+	flux module reload kvs transaction-merge=0 prefetch=64 &&
+	for i in $(seq 1 16); do
+	    flux kvs put $DIR.prefetch.dir$i.a=$i || return 1
+	done &&
+	flux kvs dropcache &&
+	flux kvs dir -R $DIR.prefetch >/dev/null &&
+	PREFETCH=$(flux module stats --parse "cache.#prefetch" kvs) &&
+	test $PREFETCH -gt 0
+'
+
 test_done
@@ -457,6 +457,42 @@ flux-kvs: test.append.test: Invalid argument
         test_cmp expected append10.out
 '
 
+test_expect_success NO_CHAIN_LINT 'flux kvs get: --append works through symlink' '
+        flux kvs unlink -Rf test &&
+        flux kvs put test.append.test="abc" &&
+        flux kvs link test.append.test test.append.link &&
+        flux kvs get --watch --append --count=4 \
+                     test.append.link > append11.out 2>&1 &
+        pid=$! &&
+        wait_watcherscount_nonzero primary &&
+        flux kvs put --append test.append.test="d" &&
+        flux kvs put --append test.append.test="e" &&
+        flux kvs put --append test.append.test="f" &&
+        wait $pid &&
+	cat >expected <<-EOF &&
+abc
+d
+e
+f
+	EOF
+        test_cmp expected append11.out
+'
+
+test_expect_success NO_CHAIN_LINT 'kvs-watch stats reports --append bytes not reloaded' '
+        flux kvs unlink -Rf test &&
+        flux kvs put test.append.test="abc" &&
+        avoided=$(flux module stats --parse=append.bytes-avoided kvs-watch) &&
+        flux kvs get --watch --append --count=3 \
+                     test.append.test > append12.out 2>&1 &
+        pid=$! &&
+        wait_watcherscount_nonzero primary &&
+        flux kvs put --append test.append.test="d" &&
+        flux kvs put --append test.append.test="e" &&
+        wait $pid &&
+        avoided2=$(flux module stats --parse=append.bytes-avoided kvs-watch) &&
+        test $avoided2 -gt $avoided
+'
+
 # full checks
 
 # in full checks, we create a directory that we will use to
@@ -39,6 +39,62 @@ test_expect_success 'valid content-cache packets received' '
 	$timeout 20 flux python $udp -s content-cache -V flux start sleep 1
 '
 
+test_expect_success 'valid packets received with instrumented services' '
+	$timeout 20 flux python $udp -V -w 3 flux start \
+	"flux mini run hostname && sleep 1"
+'
+
+test_expect_success 'flux stats formats metrics in Prometheus format' '
+	cat >send.py <<-EOT &&
+	import os, socket
+	host, port = os.environ["FLUX_FRIPP_STATSD"].split(":")
+	s = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+	s.sendto(b"flux.0.a.b:3|C\\nflux.0.c-d:2|g\\nflux.0.c-d:+1|g\\n"
+	         b"flux.1.e:1500.0|ms\\nflux.1.e:500.0|ms\\n"
+	         b"flux.1.f:250.0|ms|@0.25\\nflux.1.f.max:400.0|g\\n",
+	         (host, int(port)))
+	EOT
+	flux stats -l 0.5 flux python send.py >send.out &&
+	cat >send.expected <<-EOT &&
+	# TYPE flux_a_b_total counter
+	flux_a_b_total{rank="0"} 3
+	# TYPE flux_c_d gauge
+	flux_c_d{rank="0"} 3
+	# TYPE flux_f_max gauge
+	flux_f_max{rank="1"} 400
+	# TYPE flux_e_seconds summary
+	flux_e_seconds_sum{rank="1"} 2
+	flux_e_seconds_count{rank="1"} 2
+	# TYPE flux_f_seconds summary
+	flux_f_seconds_sum{rank="1"} 1
+	flux_f_seconds_count{rank="1"} 4
+	EOT
+	test_cmp send.expected send.out
+'
+
+test_expect_success 'flux stats exits with command exit code' '
+	test_expect_code 3 flux stats -l 0 sh -c "exit 3"
+'
+
+test_expect_success 'flux stats without command exits after timeout' '
+	flux stats -t 0.5 -o empty.prom 2>listen.err &&
+	grep "listening on 127.0.0.1:" listen.err &&
+	test -f empty.prom
+'
+
+test_expect_success 'flux stats collects broker, kvs, and scheduler metrics' '
+	$timeout 60 flux stats -o instance.prom flux start \
+		"flux mini run hostname && sleep 4" &&
+	grep "^flux_broker_msg_request_total{rank=\"0\"}" instance.prom &&
+	grep "^flux_overlay_child_connected" instance.prom &&
+	grep "^flux_kvs_commit_latency_seconds_count" instance.prom &&
+	grep "^flux_kvs_commit_latency_max" instance.prom &&
+	grep "^flux_kvs_cache_hits_total" instance.prom &&
+	grep "^flux_job_manager_state_run_total" instance.prom &&
+	grep "^flux_job_ingest_batches_total" instance.prom &&
+	grep "^flux_sched_simple_alloc_latency_seconds_count" instance.prom
+'
+
 test_expect_success 'nothing received with no endpoint' '
 	unset FLUX_FRIPP_STATSD && test_expect_code 137 $timeout 5 flux python $udp -n flux start
 '
@@ -146,6 +146,73 @@ test_expect_success 'submit request with empty payload fails with EPROTO(71)' '
 	${RPC} job-ingest.submit 71 </dev/null
 '
 
+test_expect_success 'submit-bulk request with empty payload fails with EPROTO(71)' '
+	${RPC} job-ingest.submit-bulk 71 </dev/null
+'
+
+cat >submit_bulk.py <<EOF
+import sys
+import flux
+from flux import job
+
+shared = sys.argv[1] == "shared"
+jobspecs = [open(path).read() for path in sys.argv[2:]]
+future = job.submit_bulk_async(flux.Flux(), jobspecs, shared_signature=shared)
+for jobid in future.get_ids():
+    print(jobid)
+EOF
+
+test_expect_success 'job-ingest: submit-bulk works' '
+	flux python submit_bulk.py unshared basic.json basic.json >bulk.out &&
+	test $(sort -u bulk.out | wc -l) -eq 2
+'
+
+test_expect_success 'job-ingest: submit-bulk with shared signature works' '
+	flux python submit_bulk.py shared basic.json basic.json \
+		basic.json >bulk_shared.out &&
+	test $(sort -u bulk_shared.out | wc -l) -eq 3 &&
+	for id in $(cat bulk_shared.out); do \
+		flux job eventlog $id | grep submit || return 1; \
+	done
+'
+
+test_expect_success 'job-ingest: guest cannot submit-bulk with shared signature' '
+	test_must_fail bash -c "FLUX_HANDLE_ROLEMASK=0x2 \
+		flux python submit_bulk.py shared basic.json" 2>bulk_guest.err &&
+	grep -q "shared signature" bulk_guest.err
+'
+
+test_expect_success 'job-ingest: submit-bulk fails if any job is invalid' '
+	echo "{" >bad.json &&
+	test_must_fail flux python submit_bulk.py shared \
+		basic.json bad.json 2>bulk_bad.err
+'
+
+test_expect_success HAVE_JQ 'job-ingest: stats report batch size and commit latency' '
+	flux mini submit --cc=1-8 hostname &&
+	flux module stats job-ingest >batchstats.json &&
+	jq -e ".batch.size.count > 0" <batchstats.json &&
+	jq -e ".batch.size.count == .batch[\"commit-latency\"].count" \
+		<batchstats.json &&
+	jq -e ".batch.size.histogram.inf == 0" <batchstats.json &&
+	jq -e ".batch[\"max-inflight\"] == 4" <batchstats.json
+'
+
+test_expect_success 'job-ingest: batch-max-inflight can be set' '
+	ingest_module reload batch-max-inflight=1 &&
+	flux module stats --parse batch.max-inflight job-ingest >inflight.out &&
+	test "$(cat inflight.out)" = "1" &&
+	flux mini submit --cc=1-16 hostname &&
+	flux module stats --parse batch.commits-active job-ingest >active.out &&
+	test "$(cat active.out)" = "0"
+'
+
+test_expect_success 'job-ingest: invalid batch-max-inflight fails' '
+	ingest_module remove &&
+	test_must_fail flux module load job-ingest batch-max-inflight=0 &&
+	ingest_module load
+'
+
 test_expect_success 'job-ingest: reload dummy job-manager in fail mode' '
 	ingest_module reload batch-count=4 &&
 	flux module remove job-manager &&
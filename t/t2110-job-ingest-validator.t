@@ -158,4 +158,44 @@ test_expect_success 'job-ingest: validator unexpected exit is handled' '
 		test_must_fail flux mini submit hostname 2>badvalidator.out &&
 	grep "unexpectedly exited" badvalidator.out
 '
+test_expect_success 'job-ingest: load builtin validator' '
+	ingest_module reload builtin-validator-threads=2 &&
+	flux module stats --parse validate.builtin-enabled job-ingest \
+		>builtin-enabled.out &&
+	test "$(cat builtin-enabled.out)" = "true" &&
+	flux module stats --parse validate.external-enabled job-ingest \
+		>external-enabled.out &&
+	test "$(cat external-enabled.out)" = "false" &&
+	flux module stats --parse validate.builtin-wake-errors job-ingest \
+		>wake-errors.out &&
+	test "$(cat wake-errors.out)" = "0"
+'
+test_expect_success 'job-ingest: builtin validator accepts valid jobspec' '
+	flux mini submit hostname &&
+	flux mini run --dry-run hostname | $SUBMITBENCH --urgency=0 -
+'
+test_expect_success HAVE_JQ 'job-ingest: builtin validator rejects invalid jobspec' '
+	flux mini run --dry-run hostname | jq ".version = 2" \
+		| test_must_fail $SUBMITBENCH - 2>builtin-version.err &&
+	grep "version" builtin-version.err &&
+	echo "{" | test_must_fail $SUBMITBENCH - 2>builtin-json.err &&
+	grep "invalid JSON" builtin-json.err
+'
+test_expect_success HAVE_JQ 'job-ingest: builtin validator records latency stats' '
+	count=$(flux module stats --parse validate.builtin.count job-ingest) &&
+	test $count -ge 4 &&
+	flux module stats --parse validate.builtin.histogram-ms job-ingest
+'
+test_expect_success 'job-ingest: builtin validator runs with external plugins' '
+	ingest_module reload builtin-validator \
+		validator-plugins=feasibility &&
+	flux mini submit -n 1 hostname &&
+	test_must_fail flux mini submit -N 12 -n12 hostname 2>builtin-feas.err &&
+	grep "request is not satisfiable" builtin-feas.err &&
+	count=$(flux module stats --parse validate.external.count job-ingest) &&
+	test $count -ge 2
+'
+test_expect_success 'job-ingest: reload with default validator' '
+	ingest_module reload
+'
 test_done
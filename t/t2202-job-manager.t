@@ -13,6 +13,8 @@ flux setattr log-stderr-level 1
 DRAIN_CANCEL="flux python ${FLUX_SOURCE_DIR}/t/job-manager/drain-cancel.py"
 RPC=${FLUX_BUILD_DIR}/t/request/rpc
 LIST_JOBS=${FLUX_BUILD_DIR}/t/job-manager/list-jobs
+QUEUEBENCH=${FLUX_BUILD_DIR}/t/job-manager/queuebench
+SUBMITBENCH=${FLUX_BUILD_DIR}/t/ingest/submitbench
 JOB_CONV="flux python ${FLUX_SOURCE_DIR}/t/job-manager/job-conv.py"
 
 test_expect_success 'job-manager: generate jobspec for simple test job' '
@@ -381,6 +383,48 @@ test_expect_success HAVE_JQ 'job-manager stats works' '
 	cat stats.out | $jq -e .journal.listeners
 '
 
+test_expect_success HAVE_JQ 'job-manager stats reports restart statistics' '
+	$jq -e ".restart.jobs >= 0" stats.out &&
+	$jq -e ".restart.time >= 0" stats.out &&
+	$jq -e ".restart[\"jobs-per-sec\"] >= 0" stats.out
+'
+
+# Submit more jobs than the restart pipeline keeps in flight (256) so that
+# the window refills while responses are handled.
+test_expect_success HAVE_JQ 'job-manager: get restart job count before bulk submit' '
+	flux module reload job-manager &&
+	flux module stats job-manager | $jq .restart.jobs >restart0.out
+'
+
+test_expect_success 'job-manager: submit more jobs than the restart window' '
+	${SUBMITBENCH} -r 300 basic.json >restart_submit.out &&
+	test $(wc -l <restart_submit.out) -eq 300
+'
+
+test_expect_success HAVE_JQ 'job-manager: restart loads exactly those jobs' '
+	flux module reload job-manager &&
+	flux module stats job-manager | $jq .restart.jobs >restart1.out &&
+	test $(cat restart1.out) -eq $(($(cat restart0.out) + 300))
+'
+
+test_expect_success HAVE_JQ 'job-manager: all submitted jobs are active after restart' '
+	${LIST_JOBS} | $jq .id >restart_list.out &&
+	for id in $(cat restart_submit.out); do \
+		grep -qx ${id} restart_list.out || return 1; \
+	done
+'
+
+test_expect_success 'job-manager: cancel bulk submitted jobs' '
+	flux job cancelall -f &&
+	run_timeout 30 flux queue drain &&
+	test $(${LIST_JOBS} | wc -l) -eq 0
+'
+
+test_expect_success 'job-manager: queuebench runs with skiplist and zlistx' '
+	${QUEUEBENCH} --count 1000 &&
+	${QUEUEBENCH} --count 1000 --zlistx
+'
+
 test_expect_success 'job-manager: remove job-info, job-manager, job-ingest' '
 	flux module remove job-info &&
 	flux module remove job-manager &&
@@ -19,6 +19,8 @@ test_under_flux 4
 
 RPC=${FLUX_BUILD_DIR}/t/request/rpc
 EVENTS_JOURNAL_STREAM=${FLUX_BUILD_DIR}/t/job-manager/events_journal_stream
+EVENTS_WATCH="flux python ${FLUX_SOURCE_DIR}/t/job-manager/events-watch.py"
+waitfile=${SHARNESS_TEST_SRCDIR}/scripts/waitfile.lua
 
 flux setattr log-stderr-level 1
 
@@ -291,4 +293,68 @@ test_expect_success HAVE_JQ 'job-manager: events-journal request fails if deny n
 	grep "deny should be an object" cc3.err
 '
 
+test_expect_success 'job-manager: events-watch with ids streams until clean' '
+	jobid=$(flux job submit basic.json | flux job id) &&
+	$EVENTS_WATCH ids ${jobid} >watch1.out &&
+	grep "^${jobid} submit" watch1.out &&
+	grep "^${jobid} clean" watch1.out
+'
+
+test_expect_success 'job-manager: events-watch reports inactive ids' '
+	$EVENTS_WATCH ids ${jobid} >watch2.out &&
+	grep "^${jobid} inactive" watch2.out
+'
+
+test_expect_success 'job-manager: events-watch w/o ids only sees own jobs' '
+	other=$(flux job submit basic.json | flux job id) &&
+	$EVENTS_WATCH own ${other} >watch3.out &&
+	grep "clean" watch3.out &&
+	test_must_fail grep "^${other} " watch3.out
+'
+
+test_expect_success 'job-manager: events-watch of active job works for owner' '
+	sleepid=$(flux mini submit sleep 300 | flux job id) &&
+	flux job wait-event ${sleepid} start &&
+	$EVENTS_WATCH ids ${sleepid} >watch4.out &
+	pid=$! &&
+	flux job cancel ${sleepid} &&
+	wait $pid &&
+	grep "^${sleepid} exception" watch4.out
+'
+
+test_expect_success 'job-manager: guest cannot events-watch another user job' '
+	sleepid=$(flux mini submit sleep 300 | flux job id) &&
+	flux job wait-event ${sleepid} start &&
+	test_must_fail env FLUX_HANDLE_USERID=$(($(id -u)+1)) \
+		FLUX_HANDLE_ROLEMASK=0x2 \
+		$EVENTS_WATCH ids ${sleepid} >watch5.out 2>watch5.err &&
+	grep "guests can only watch their own jobs" watch5.err &&
+	test_must_fail grep "^${sleepid} " watch5.out &&
+	flux job cancel ${sleepid}
+'
+
+test_expect_success 'job-manager: events-watch-cancel ends the stream' '
+	$EVENTS_WATCH cancel >watch6.out &&
+	grep cancelled watch6.out
+'
+
+watchers_count() {
+	flux module stats job-manager | $jq .journal.watchers
+}
+
+test_expect_success HAVE_JQ,NO_CHAIN_LINT 'job-manager: events-watch is cleaned up on disconnect' '
+	$EVENTS_WATCH hang >watch7.out &
+	pid=$! &&
+	$waitfile --count=1 --timeout=10 --pattern=ready watch7.out &&
+	test $(watchers_count) -eq 1 &&
+	kill $pid &&
+	wait $pid;
+	i=0 &&
+	while test $(watchers_count) -ne 0 && test $i -lt 50; do
+		sleep 0.1
+		i=$((i + 1))
+	done &&
+	test $(watchers_count) -eq 0
+'
+
 test_done
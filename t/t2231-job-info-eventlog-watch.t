@@ -346,13 +346,67 @@ test_expect_success NO_CHAIN_LINT 'flux job wait-event -p guest.exec.eventlog wo
 	flux job cancel ${jobidall}
 '
 
+#
+# eventlog-seek
+#
+
+test_expect_success HAVE_JQ 'eventlog-seek returns first event by name' '
+	jobid=$(submit_job) &&
+	echo "{\"id\":$(flux job id $jobid), \"name\":\"start\"}" \
+		| ${RPC} job-info.eventlog-seek >seek1.out &&
+	jq -e ".events | length == 1" <seek1.out &&
+	jq -e ".events[0].name == \"start\"" <seek1.out &&
+	flux job eventlog $jobid | grep -n "^[^ ]* start" | cut -d: -f1 \
+		>seek1.line &&
+	test $(jq .seq <seek1.out) -eq $(($(cat seek1.line) - 1))
+'
+test_expect_success HAVE_JQ 'eventlog-seek returns events after seq' '
+	jobid=$(submit_job) &&
+	id=$(flux job id $jobid) &&
+	echo "{\"id\":$id, \"after\":0}" \
+		| ${RPC} job-info.eventlog-seek >seek2.out &&
+	flux job eventlog $jobid | wc -l >seek2.count &&
+	test $(jq ".events | length" <seek2.out) -eq $(($(cat seek2.count) - 1)) &&
+	jq -e ".events[0].name != \"submit\"" <seek2.out &&
+	jq -e ".events[-1].name == \"clean\"" <seek2.out &&
+	test $(jq .seq <seek2.out) -eq $(($(cat seek2.count) - 1))
+'
+test_expect_success HAVE_JQ 'eventlog-seek with name after seq finds later event' '
+	jobid=$(submit_job) &&
+	id=$(flux job id $jobid) &&
+	echo "{\"id\":$id, \"name\":\"submit\", \"after\":0}" \
+		| ${RPC} job-info.eventlog-seek 2 &&
+	echo "{\"id\":$id, \"name\":\"clean\", \"after\":0}" \
+		| ${RPC} job-info.eventlog-seek >seek3.out &&
+	jq -e ".events[0].name == \"clean\"" <seek3.out
+'
+test_expect_success 'eventlog-seek of missing event fails with ENOENT(2)' '
+	jobid=$(submit_job) &&
+	echo "{\"id\":$(flux job id $jobid), \"name\":\"nosuchevent\"}" \
+		| ${RPC} job-info.eventlog-seek 2
+'
+test_expect_success 'eventlog-seek of unknown job fails with ENOENT(2)' '
+	echo "{\"id\":1234567}" | ${RPC} job-info.eventlog-seek 2
+'
+test_expect_success 'eventlog-seek request with empty payload fails with EPROTO(71)' '
+	${RPC} job-info.eventlog-seek 71 </dev/null
+'
+test_expect_success HAVE_JQ 'flux job wait-event works on completed job via seek' '
+	jobid=$(submit_job) &&
+	fj_wait_event $jobid start >wait_event_seek.out &&
+	grep start wait_event_seek.out &&
+	fj_wait_event --format=json $jobid clean >wait_event_seek2.out &&
+	jq -e ".name == \"clean\"" <wait_event_seek2.out
+'
+
 #
 # stats & corner cases
 #
 
 test_expect_success 'job-info stats works' '
 	flux module stats --parse watchers job-info &&
-	flux module stats --parse guest_watchers job-info
+	flux module stats --parse guest_watchers job-info &&
+	flux module stats --parse eventlog_cache job-info
 '
 
 test_expect_success 'eventlog-watch request with empty payload fails with EPROTO(71)' '
@@ -7,6 +7,7 @@ test_description='Test flux job list services'
 test_under_flux 4 job
 
 RPC=${FLUX_BUILD_DIR}/t/request/rpc
+RPC_STREAM=${FLUX_BUILD_DIR}/t/request/rpc_stream
 listRPC="flux python ${SHARNESS_TEST_SRCDIR}/job-list/list-rpc.py"
 PERMISSIVE_SCHEMA=${FLUX_SOURCE_DIR}/t/job-list/jobspec-permissive.jsonschema
 JOB_CONV="flux python ${FLUX_SOURCE_DIR}/t/job-manager/job-conv.py"
@@ -374,6 +375,31 @@ test_expect_success HAVE_JQ 'flux job list all jobs works' '
         test_cmp all.ids list_all_jobids.out
 '
 
+test_expect_success HAVE_JQ 'job-list.list resumes after a cursor job' '
+        after=$(sed -n 6p all.ids) &&
+        $jq -j -c -n  "{max_entries:0, userid:4294967295, states:0, results:0, attrs:[], after:${after}}" \
+          | $RPC job-list.list | $jq .jobs | $jq -c ".[]" | $jq .id > list_after.out &&
+        tail -n +7 all.ids > list_after.exp &&
+        test_cmp list_after.exp list_after.out
+'
+
+test_expect_success HAVE_JQ 'job-list.list cursor works with userid and max_entries' '
+        id=$(id -u) &&
+        after=$(sed -n 2p all.ids) &&
+        $jq -j -c -n  "{max_entries:3, userid:${id}, states:0, results:0, attrs:[], after:${after}}" \
+          | $RPC job-list.list | $jq .jobs | $jq -c ".[]" | $jq .id > list_after_count.out &&
+        sed -n 3,5p all.ids > list_after_count.exp &&
+        test_cmp list_after_count.exp list_after_count.out
+'
+
+test_expect_success HAVE_JQ 'job-list.list streams jobs and terminates with ENODATA' '
+        $jq -j -c -n  "{max_entries:0, userid:4294967295, states:0, results:0, attrs:[]}" \
+          | test_must_fail $RPC_STREAM job-list.list > list_stream.out 2> list_stream.err &&
+        grep "No data available" list_stream.err &&
+        $jq -c ".jobs[]" < list_stream.out | $jq .id > list_stream_ids.out &&
+        test_cmp all.ids list_stream_ids.out
+'
+
 test_expect_success HAVE_JQ 'job stats lists jobs in correct state (mix)' '
         flux job stats | jq -e ".job_states.depend == 0" &&
         flux job stats | jq -e ".job_states.priority == 0" &&
@@ -384,6 +410,41 @@ test_expect_success HAVE_JQ 'job stats lists jobs in correct state (mix)' '
         flux job stats | jq -e ".job_states.total == $(state_count all)"
 '
 
+test_expect_success HAVE_JQ 'job-list.list returns a cursor when max_entries is reached' '
+        $jq -j -c -n  "{max_entries:3, userid:4294967295, states:0, results:0, attrs:[]}" \
+          | $RPC job-list.list > list_page1.out &&
+        $jq ".jobs[].id" < list_page1.out > list_page1_ids.out &&
+        head -n 3 all.ids > list_page1.exp &&
+        test_cmp list_page1.exp list_page1_ids.out &&
+        $jq -e ".cursor.id == $(sed -n 3p all.ids)" < list_page1.out
+'
+
+# the cursor job is pending when the first page is listed, and inactive
+# when the second page is listed.  Listing resumes after the cursor's
+# position in the pending list, and the job is listed again as inactive.
+test_expect_success HAVE_JQ 'job-list.list cursor survives cursor job state change' '
+        cursor=$($jq -c .cursor < list_page1.out) &&
+        id=$(sed -n 3p all.ids) &&
+        flux job cancel $id &&
+        fj_wait_event $id clean &&
+        wait_jobid_state $id inactive &&
+        $jq -j -c -n  "{max_entries:0, userid:4294967295, states:0, results:0, attrs:[], after:${cursor}}" \
+          | $RPC job-list.list | $jq .jobs | $jq -c ".[]" | $jq .id > list_page2.out &&
+        sed -n "4,\$p" pending.ids > list_page2.exp &&
+        cat running.ids >> list_page2.exp &&
+        echo $id >> list_page2.exp &&
+        cat inactive.ids >> list_page2.exp &&
+        test_cmp list_page2.exp list_page2.out
+'
+
+test_expect_success HAVE_JQ 'job-list.list cursor works when cursor job left its list' '
+        cursor=$($jq -c .cursor < list_page1.out) &&
+        $jq -j -c -n  "{max_entries:0, userid:4294967295, states:14, results:0, attrs:[], after:${cursor}}" \
+          | $RPC job-list.list | $jq .jobs | $jq -c ".[]" | $jq .id > list_page3.out &&
+        sed -n "4,\$p" pending.ids > list_page3.exp &&
+        test_cmp list_page3.exp list_page3.out
+'
+
 test_expect_success 'cleanup job listing jobs ' '
         for jobid in `cat active.ids`; do \
             flux job cancel $jobid; \
@@ -943,7 +1004,16 @@ test_expect_success 'job-list stats works' '
         flux module stats --parse jobs.running job-list &&
         flux module stats --parse jobs.inactive job-list &&
         flux module stats --parse idsync.lookups job-list &&
-        flux module stats --parse idsync.waits job-list
+        flux module stats --parse idsync.waits job-list &&
+        flux module stats --parse memory.job_size job-list &&
+        flux module stats --parse memory.strings job-list &&
+        flux module stats --parse memory.string_bytes job-list &&
+        flux module stats --parse memory.bytes_per_job job-list
+'
+test_expect_success 'job-list interns job strings' '
+        strings=$(flux module stats --parse memory.strings job-list) &&
+        njobs=$(flux job list -a | wc -l) &&
+        test $strings -lt $((njobs * 3))
 '
 test_expect_success 'list request with empty payload fails with EPROTO(71)' '
 	${RPC} job-list.list 71 </dev/null
@@ -958,6 +1028,26 @@ test_expect_success HAVE_JQ 'list request with invalid input fails with EPROTO(7
 	EOF
 	test_cmp ${name}.expected ${name}.out
 '
+test_expect_success HAVE_JQ 'list request with unknown cursor job fails with ENOENT(2)' '
+	name="after-unknown" &&
+        id=$(id -u) &&
+        $jq -j -c -n  "{max_entries:5, userid:${id}, states:0, results:0, attrs:[], after:123}" \
+          | $listRPC >${name}.out &&
+	cat <<-EOF >${name}.expected &&
+	errno 2: invalid payload: unknown job in after
+	EOF
+	test_cmp ${name}.expected ${name}.out
+'
+test_expect_success HAVE_JQ 'list request with invalid cursor fails with EPROTO(71)' '
+	name="after-invalid" &&
+        id=$(id -u) &&
+        $jq -j -c -n  "{max_entries:5, userid:${id}, states:0, results:0, attrs:[], after:{state:4}}" \
+          | $listRPC >${name}.out &&
+	cat <<-EOF >${name}.expected &&
+	errno 71: invalid payload: invalid cursor in after
+	EOF
+	test_cmp ${name}.expected ${name}.out
+'
 test_expect_success HAVE_JQ 'list request with invalid input fails with EINVAL(22) (attrs non-string)' '
 	name="attr-not-string" &&
         id=$(id -u) &&
@@ -33,6 +33,16 @@ test_expect_success 'job-exec: execute dummy job shell across all ranks' '
 	test $(flux kvs get ${kvsdir}.test1.2) = 2 &&
 	test $(flux kvs get ${kvsdir}.test1.3) = 3
 '
+test_expect_success 'job-exec: execute job shells without tree launch' '
+	flux module reload job-exec tree-launch=0 &&
+	id=$(flux mini submit -n4 -N4 \
+		"flux kvs put test2.\$BROKER_RANK=\$JOB_SHELL_RANK") &&
+	flux job wait-event $id clean &&
+	kvsdir=$(flux job id --to=kvs $id).guest &&
+	test $(flux kvs get ${kvsdir}.test2.0) = 0 &&
+	test $(flux kvs get ${kvsdir}.test2.3) = 3 &&
+	flux module reload job-exec
+'
 test_expect_success 'job-exec: job shell output available in flux-job attach' '
 	id=$(flux mini submit "echo Hello from job \$JOBID") &&
 	flux job attach -vEX $id &&
@@ -101,4 +101,23 @@ test_expect_success 'job-exec: bad imp config causes module failure' '
 	grep "error reading config value exec.imp" ${name}.log
 '
 
+test_expect_success 'job-exec: tree launch can be disabled on cmdline' '
+	flux dmesg -C &&
+	flux module reload -f job-exec tree-launch=0 &&
+	flux dmesg | grep "tree launch disabled" &&
+	flux module reload -f job-exec
+'
+test_expect_success 'job-exec: bad tree-launch config causes module failure' '
+	name=bad-treeconf &&
+	mkdir ${name}.d &&
+	cat <<-EOF > ${name}.d/exec.toml &&
+	[exec]
+	tree-launch = "yes"
+	EOF
+	( export FLUX_CONF_DIR=${name}.d &&
+	  test_must_fail flux start -s1 flux dmesg > ${name}.log 2>&1
+	) &&
+	grep "error reading config value exec.tree-launch" ${name}.log
+'
+
 test_done
@@ -171,4 +171,39 @@ test_expect_success 'flux-shell: shell forwards signals to tasks' '
 	grep "forwarding signal 15" sigterm.err
 '
 
+if strace -f -o /dev/null true >/dev/null 2>&1; then
+	test_set_prereq STRACE
+fi
+
+#  Count child processes created by vfork(2), which appears either as
+#   the vfork syscall or as clone(2) with CLONE_VFORK depending on arch.
+count_vforks() {
+	grep -E "vfork\(|CLONE_VFORK" $1 | wc -l
+}
+test_expect_success STRACE 'flux-shell: tasks are launched with vfork' '
+	run_timeout 60 strace -f -o vfork.trace \
+		-e trace=fork,vfork,clone,clone3 \
+		flux ${FLUX_BUILD_DIR}/src/shell/flux-shell \
+		-vv -s -r 0 -j j2 -R R2 42 >vfork.out 2>vfork.err &&
+	grep "no task.exec plugins" vfork.err &&
+	test $(count_vforks vfork.trace) -eq 2
+'
+test_expect_success STRACE 'flux-shell: task.exec plugin forces fork' '
+	cat >task-exec.lua <<-EOF &&
+	plugin.register {
+	  name = "task-exec-test",
+	  handlers = {
+	    { topic = "task.exec", fn = function () end }
+	  }
+	}
+	EOF
+	run_timeout 60 strace -f -o fork.trace \
+		-e trace=fork,vfork,clone,clone3 \
+		flux ${FLUX_BUILD_DIR}/src/shell/flux-shell \
+		-vv -s -r 0 -j j2 -R R2 --initrc=task-exec.lua 42 \
+		>fork.out 2>fork.err &&
+	test_must_fail grep "no task.exec plugins" fork.err &&
+	test $(count_vforks fork.trace) -eq 0
+'
+
 test_done
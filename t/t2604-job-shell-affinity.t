@@ -51,6 +51,24 @@ test_expect_success 'flux-shell: per-task affinity sanity check' '
     flux mini run --label-io -ocpu-affinity=per-task -n1 -c1 \
 		hwloc-bind --get
 '
+test_expect_success 'flux-shell: affinity uses broker topology' '
+    flux mini run -o verbose=2 -n1 -c1 true 2>broker-topo.err &&
+    test_debug "cat broker-topo.err" &&
+    grep "using broker topology" broker-topo.err
+'
+test_expect_success 'flux-shell: affinity uses hwloc discovery in standalone mode' '
+    cat >R.standalone <<-EOF &&
+	{"version": 1, "execution":{ "R_lite":[
+	    { "children": { "core": "0" }, "rank": "0" }
+	]}}
+	EOF
+    flux mini run -n1 -c1 --dry-run $CPUS_ALLOWED_COUNT >j.standalone &&
+    ${FLUX_SHELL} -s -v -v -r 0 -j j.standalone -R R.standalone 0 \
+        >standalone.out 2>standalone.err &&
+    test_debug "cat standalone.err" &&
+    test "$(cat standalone.out)" = "1" &&
+    test_must_fail grep "using broker topology" standalone.err
+'
 test_expect_success 'flux-shell: affinity can be disabled' '
     hwloc-bind --get > affinity-off.expected &&
     flux mini run -ocpu-affinity=off -n1 hwloc-bind --get >affinity-off.out &&